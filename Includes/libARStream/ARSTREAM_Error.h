@@ -64,6 +64,10 @@ typedef enum {
     ARSTREAM_ERROR_FRAME_TOO_LARGE, /**< Bad parameter : frame too large */
     ARSTREAM_ERROR_BUSY, /**< Object is busy and can not be deleted yet */
     ARSTREAM_ERROR_QUEUE_FULL, /**< Frame queue is full */
+    ARSTREAM_ERROR_BUFFER_EMPTY, /**< No data was received before the timeout */
+    ARSTREAM_ERROR_TRANSPORT, /**< The transport failed to send or receive data */
+    ARSTREAM_ERROR_NOT_SUPPORTED, /**< The feature is not available on this system */
+    ARSTREAM_ERROR_PERMISSION, /**< The system denied the operation (e.g. real-time scheduling without privileges) */
 } eARSTREAM_ERROR;
 
 /**
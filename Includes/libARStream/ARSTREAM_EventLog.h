@@ -0,0 +1,191 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_EventLog.h
+ * @brief Binary event log of libARStream, cheap enough to stay enabled in production
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_EVENTLOG_H_
+#define _ARSTREAM_EVENTLOG_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Error.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Magic number of an event log file ("AREV")
+ */
+#define ARSTREAM_EVENTLOG_MAGIC (0x41524556)
+
+/**
+ * @brief Version of the event log file format
+ */
+#define ARSTREAM_EVENTLOG_VERSION (1)
+
+/**
+ * @brief Default number of events buffered for each thread
+ */
+#define ARSTREAM_EVENTLOG_DEFAULT_EVENTS_PER_THREAD (4096)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Ids of the events recorded by libARStream
+ * The arguments of each event are given in their description, in order.
+ * Frame numbers are the 16 bits numbers sent on the network.
+ * The ids are part of the file format : new events are only added before ARSTREAM_EVENT_MAX.
+ */
+typedef enum {
+    ARSTREAM_EVENT_LOST = 0, /**< Events were lost because a thread recorded them faster than they were written. Args : number of lost events */
+    ARSTREAM_EVENT_SENDER_FRAME_QUEUED, /**< A frame was added to the queue of a sender. Args : frame number, frame size, flush flag */
+    ARSTREAM_EVENT_SENDER_FRAME_STARTED, /**< A sender started to send a frame. Args : frame number, frame size, number of fragments */
+    ARSTREAM_EVENT_SENDER_FRAGMENT_SENT, /**< A fragment of the current frame was sent. Args : frame number, fragment index */
+    ARSTREAM_EVENT_SENDER_LATE_FRAGMENT_SENT, /**< A fragment of a previous frame was sent. Args : frame number of the fragment, current frame number */
+    ARSTREAM_EVENT_SENDER_ACK_RECEIVED, /**< An ack of the current frame was received. Args : frame number, number of acknowledged fragments, number of fragments */
+    ARSTREAM_EVENT_SENDER_FRAME_CANCELLED, /**< A frame was replaced before being fully acknowledged. Args : frame number, number of acknowledged fragments, number of fragments */
+    ARSTREAM_EVENT_SENDER_FLUSH_REQUESTED, /**< The reader requested a flush frame. Args : last frame number seen by the reader */
+    ARSTREAM_EVENT_READER_FRAGMENT_RECEIVED, /**< A fragment was received. Args : frame number, fragment index, 1 if the fragment was already received */
+    ARSTREAM_EVENT_READER_FRAME_COMPLETE, /**< A complete frame was given to the application. Args : frame number, frame size, flush flag */
+    ARSTREAM_EVENT_READER_FRAME_DROPPED, /**< An incomplete frame was dropped. Args : frame number, number of missing fragments */
+    ARSTREAM_EVENT_READER_FRAME_DISCARDED, /**< A frame was discarded while waiting for a flush frame. Args : frame number */
+    ARSTREAM_EVENT_READER_FRAMES_MISSED, /**< Frames were never received. Args : frame number of the next received frame, number of missed frames */
+    ARSTREAM_EVENT_READER_FLUSH_REQUESTED, /**< The reference was lost, and a flush frame was requested */
+    ARSTREAM_EVENT_SENDER_FRAME_REJECTED, /**< A frame was refused because the queue of the sender was full. Args : frame size */
+    ARSTREAM_EVENT_SENDER_FRAME_POPPED, /**< The sender took a frame from its queue. Args : frame number, number of frames left in the queue */
+    ARSTREAM_EVENT_SENDER_SEND_ROUND, /**< The sender (re)sent the fragments of the current frame which were not acknowledged. Args : frame number, number of fragments sent, round (0 for the first transmission) */
+    ARSTREAM_EVENT_SENDER_FRAME_ACKNOWLEDGED, /**< All the fragments of the current frame were acknowledged. Args : frame number, time since the frame was queued, in us */
+    ARSTREAM_EVENT_SENDER_CALLBACK_BEGIN, /**< The sender calls the application callback. Args : status (eARSTREAM_SENDER_STATUS) */
+    ARSTREAM_EVENT_SENDER_CALLBACK_END, /**< The application callback of the sender returned. Args : status */
+    ARSTREAM_EVENT_READER_FRAME_STARTED, /**< The first fragment of a frame was received. Args : frame number, number of fragments, flush flag */
+    ARSTREAM_EVENT_READER_FRAME_INCOMPLETE, /**< An incomplete frame was given to the application. Args : frame number, number of received fragments, number of fragments */
+    ARSTREAM_EVENT_READER_CALLBACK_BEGIN, /**< The reader gives a frame to the application callback. Args : cause (eARSTREAM_READER_CAUSE), frame number */
+    ARSTREAM_EVENT_READER_CALLBACK_END, /**< The application callback of the reader returned. Args : cause, frame number */
+    ARSTREAM_EVENT_LOCK_WAIT, /**< A thread had to wait for a lock. Args : lock (eARSTREAM_EVENT_LOCK), wait duration in us. The event time is the end of the wait */
+    ARSTREAM_EVENT_MAX, /**< Number of libARStream events. Do not use */
+
+    ARSTREAM_EVENT_USER = 0x8000, /**< First id available for application events */
+} eARSTREAM_EVENT;
+
+/**
+ * @brief Locks whose waits are recorded (ARSTREAM_EVENT_LOCK_WAIT)
+ */
+typedef enum {
+    ARSTREAM_EVENT_LOCK_SENDER_NEXT_FRAME = 0, /**< Frame queue of a sender */
+    ARSTREAM_EVENT_LOCK_SENDER_PACKETS_TO_SEND, /**< Fragments of a sender to (re)send */
+    ARSTREAM_EVENT_LOCK_SENDER_ACK, /**< Acknowledged fragments of a sender */
+    ARSTREAM_EVENT_LOCK_READER_ACK_PACKET, /**< Received fragments of a reader */
+    ARSTREAM_EVENT_LOCK_READER_ACK_SEND, /**< Ack thread wake-up of a reader */
+    ARSTREAM_EVENT_LOCK_MAX, /**< Number of locks. Do not use */
+} eARSTREAM_EVENT_LOCK;
+
+/**
+ * @brief Header of an event log file
+ * The header is followed by ARSTREAM_EventLog_Event_t records, in the byte order of the host which wrote them
+ */
+typedef struct {
+    uint32_t magic; /**< ARSTREAM_EVENTLOG_MAGIC */
+    uint16_t version; /**< ARSTREAM_EVENTLOG_VERSION */
+    uint16_t eventSize; /**< sizeof (ARSTREAM_EventLog_Event_t) */
+    uint64_t startTimeUs; /**< Monotonic time at which the log was started, in us */
+} ARSTREAM_EventLog_FileHeader_t;
+
+/**
+ * @brief An event record
+ */
+typedef struct {
+    uint64_t timeUs; /**< Monotonic time of the event, in us */
+    uint16_t id; /**< Id of the event (eARSTREAM_EVENT, or an application id from ARSTREAM_EVENT_USER) */
+    uint16_t threadId; /**< Index of the thread which recorded the event, from 1, in order of their first event */
+    uint32_t args [3]; /**< Arguments of the event */
+} ARSTREAM_EventLog_Event_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Starts recording events to a file
+ *
+ * Each thread records its events in its own lock-free ring, allocated on its first event.
+ * A background thread writes the rings to the file every few milliseconds.
+ * When a ring is full, its new events are lost and counted, and an ARSTREAM_EVENT_LOST event is written instead.
+ *
+ * @param path Path of the file. Truncated if it exists
+ * @param eventsPerThread Size of the rings of the threads, in events (must be a power of two, or 0 for ARSTREAM_EVENTLOG_DEFAULT_EVENTS_PER_THREAD). Only applies to threads which did not record any event yet
+ * @return ARSTREAM_OK, ARSTREAM_ERROR_BUSY if the log is already started, ARSTREAM_ERROR_BAD_PARAMETERS if the file can not be created
+ */
+eARSTREAM_ERROR ARSTREAM_EventLog_Start (const char *path, uint32_t eventsPerThread);
+
+/**
+ * @brief Stops recording events, writes the remaining ones and closes the file
+ * @note Does nothing if the log is not started
+ */
+void ARSTREAM_EventLog_Stop (void);
+
+/**
+ * @brief Records an event
+ * Costs a few tens of nanoseconds when the log is started (no lock, no syscall, no formatting), and a test when it is not
+ * @param id Id of the event
+ * @param arg0 First argument
+ * @param arg1 Second argument
+ * @param arg2 Third argument
+ */
+void ARSTREAM_EventLog_Record (uint16_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+
+/**
+ * @brief Gets the name of a libARStream event
+ * @param id Id of the event
+ * @return A static string ("USER" for application events, "UNKNOWN" for invalid ids)
+ */
+const char* ARSTREAM_EventLog_GetEventName (uint16_t id);
+
+/**
+ * @brief Gets the name of a lock of ARSTREAM_EVENT_LOCK_WAIT events
+ * @param lock The lock
+ * @return A static string ("UNKNOWN" for invalid locks)
+ */
+const char* ARSTREAM_EventLog_GetLockName (uint32_t lock);
+
+#endif /* _ARSTREAM_EVENTLOG_H_ */
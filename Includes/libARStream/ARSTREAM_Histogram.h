@@ -0,0 +1,105 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Histogram.h
+ * @brief Log-linear histograms of durations, used for libARStream statistics
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_HISTOGRAM_H_
+#define _ARSTREAM_HISTOGRAM_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Number of linear sub-buckets in each power of two, as a power of two
+ * Gives a relative precision of 1 / (2 ^ ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS)
+ */
+#define ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS (3)
+
+/**
+ * @brief Number of buckets of an histogram (covers the whole uint32_t range)
+ */
+#define ARSTREAM_HISTOGRAM_NB_BUCKETS ((33 - ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS) << ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Histogram of values (typically durations, in microseconds)
+ *
+ * Values below (2 ^ ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS) have their own bucket.
+ * Above, each power of two is split into (2 ^ ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS) linear buckets.
+ */
+typedef struct {
+    uint64_t count; /**< Number of values in the histogram */
+    uint64_t sum; /**< Sum of all values in the histogram */
+    uint32_t min; /**< Smallest value in the histogram (UINT32_MAX if empty) */
+    uint32_t max; /**< Largest value in the histogram */
+    uint32_t buckets [ARSTREAM_HISTOGRAM_NB_BUCKETS]; /**< Number of values in each bucket */
+} ARSTREAM_Histogram_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Gets the smallest value which belongs to a bucket
+ * @param[in] bucket Index of the bucket
+ * @return The lower bound of the bucket, or UINT32_MAX if the index is out of range
+ */
+uint32_t ARSTREAM_Histogram_GetBucketLowerBound (int bucket);
+
+/**
+ * @brief Gets the value at a given percentile of an histogram
+ * @param[in] histogram The histogram
+ * @param[in] percentile The percentile, from 0.0 to 100.0 (e.g. 99.9)
+ * @return The upper bound of the bucket which holds the percentile (clamped to the max value of the histogram), or 0 if the histogram is empty
+ */
+uint32_t ARSTREAM_Histogram_GetPercentile (const ARSTREAM_Histogram_t *histogram, float percentile);
+
+/**
+ * @brief Gets the mean value of an histogram
+ * @param[in] histogram The histogram
+ * @return The mean value, or 0 if the histogram is empty
+ */
+uint32_t ARSTREAM_Histogram_GetMean (const ARSTREAM_Histogram_t *histogram);
+
+#endif /* _ARSTREAM_HISTOGRAM_H_ */
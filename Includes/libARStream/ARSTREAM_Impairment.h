@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Impairment.h
+ * @brief Network impairment emulation between a stream and its transport
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_IMPAIRMENT_H_
+#define _ARSTREAM_IMPAIRMENT_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Transport.h>
+
+/*
+ * Macros
+ */
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Packet loss models
+ */
+typedef enum {
+    ARSTREAM_IMPAIRMENT_LOSS_NONE = 0, /**< No loss */
+    ARSTREAM_IMPAIRMENT_LOSS_BERNOULLI, /**< Independent losses, with probability lossRate */
+    ARSTREAM_IMPAIRMENT_LOSS_GILBERT_ELLIOTT, /**< Bursty losses : a two states (good / bad) Markov chain, with a loss rate per state */
+    ARSTREAM_IMPAIRMENT_LOSS_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_IMPAIRMENT_LOSS;
+
+/**
+ * @brief Distributions of the packet delays
+ */
+typedef enum {
+    ARSTREAM_IMPAIRMENT_DELAY_UNIFORM = 0, /**< Uniform in [delayUs - jitterUs, delayUs + jitterUs] */
+    ARSTREAM_IMPAIRMENT_DELAY_NORMAL, /**< Normal, of mean delayUs and standard deviation jitterUs */
+    ARSTREAM_IMPAIRMENT_DELAY_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_IMPAIRMENT_DELAY;
+
+/**
+ * @brief Impairments of one direction of a link
+ * A zeroed structure means a perfect link
+ */
+typedef struct {
+    eARSTREAM_IMPAIRMENT_LOSS lossModel; /**< Loss model */
+    float lossRate; /**< Bernoulli : probability to lose a packet, in [0, 1] */
+    float goodToBadRate; /**< Gilbert-Elliott : probability to go from the good to the bad state, for each packet */
+    float badToGoodRate; /**< Gilbert-Elliott : probability to go from the bad to the good state, for each packet */
+    float goodLossRate; /**< Gilbert-Elliott : probability to lose a packet in the good state */
+    float badLossRate; /**< Gilbert-Elliott : probability to lose a packet in the bad state */
+
+    eARSTREAM_IMPAIRMENT_DELAY delayDistribution; /**< Distribution of the delays */
+    uint32_t delayUs; /**< Mean one-way delay, in us */
+    uint32_t jitterUs; /**< Delay variation, in us (see eARSTREAM_IMPAIRMENT_DELAY). Jitter alone never reorders packets */
+    float reorderRate; /**< Probability that a packet skips the delay, and overtakes the delayed packets */
+
+    uint32_t rateKbps; /**< Bandwidth cap, in kbit/s (0 for no cap) */
+    uint32_t burstBytes; /**< Size of the token bucket, in bytes (0 : every packet waits for its own transmission time) */
+    uint32_t queueBytes; /**< Size of the link queue, in bytes. Packets which do not fit are dropped (0 for no limit) */
+} ARSTREAM_Impairment_Direction_t;
+
+/**
+ * @brief Impairments of a link
+ */
+typedef struct {
+    uint32_t seed; /**< Seed of the random generators. The same seed with the same traffic gives the same impairments */
+    ARSTREAM_Impairment_Direction_t data; /**< Impairments of the data channel (sender to reader) */
+    ARSTREAM_Impairment_Direction_t ack; /**< Impairments of the ack channel (reader to sender) */
+} ARSTREAM_Impairment_Config_t;
+
+/**
+ * @brief Counters of an impaired direction
+ */
+typedef struct {
+    uint64_t packets; /**< Packets given to the impaired transport */
+    uint64_t bytes; /**< Bytes given to the impaired transport */
+    uint64_t lost; /**< Packets dropped by the loss model */
+    uint64_t overflows; /**< Packets dropped because the link queue was full */
+    uint64_t reordered; /**< Packets which skipped the delay */
+    uint64_t delivered; /**< Packets given to the underlying transport */
+} ARSTREAM_Impairment_Stats_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Creates a transport which impairs the packets sent through another transport
+ * The impairments are applied to the packets sent by this endpoint : wrap the transports of both the sender and
+ * the reader (with the same configuration) to impair both directions. Received packets are not modified.
+ * Lost packets are reported as sent, as they would be on a real network. Delayed packets are copied, and given to
+ * the underlying transport by an internal thread when their time comes.
+ * @param[in] transport The underlying transport. It is not owned, and must be deleted after the impaired transport
+ * @param[in] config The impairments to apply. Copied
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Transport_t, or NULL if an error occured
+ */
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewImpaired (ARSTREAM_Transport_t *transport, const ARSTREAM_Impairment_Config_t *config, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Gets the counters of an impaired transport
+ * @param[in] transport A transport created by ARSTREAM_Transport_NewImpaired()
+ * @param[in] channel The direction to query (data or ack)
+ * @param[out] stats The counters
+ * @return ARSTREAM_OK, or ARSTREAM_ERROR_BAD_PARAMETERS if transport is not an impaired transport
+ */
+eARSTREAM_ERROR ARSTREAM_Impairment_GetStats (ARSTREAM_Transport_t *transport, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Impairment_Stats_t *stats);
+
+#endif /* _ARSTREAM_IMPAIRMENT_H_ */
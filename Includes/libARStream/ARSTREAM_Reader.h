@@ -48,12 +48,26 @@
  */
 #include <libARNetwork/ARNETWORK_Manager.h>
 #include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Histogram.h>
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARStream/ARSTREAM_Thread.h>
 
 /*
  * Macros
  */
 #define ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT (5)
 
+/**
+ * @brief Maximum number of fragments in a frame
+ */
+#define ARSTREAM_READER_MAX_FRAGMENTS_PER_FRAME (128)
+
+/**
+ * @brief Value of minPercentOfFragments which disables the incomplete frames delivery (default)
+ * @see ARSTREAM_Reader_SetIncompleteFramesDelivery()
+ */
+#define ARSTREAM_READER_INCOMPLETE_FRAMES_DISABLED (-1)
+
 /*
  * Types
  */
@@ -66,6 +80,7 @@ typedef enum {
     ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, /**< Frame buffer is too small for the frame on the network */
     ARSTREAM_READER_CAUSE_COPY_COMPLETE, /**< Copy of previous frame buffer is complete (called only after ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL) */
     ARSTREAM_READER_CAUSE_CANCEL, /**< Reader is closing, so buffer is no longer used */
+    ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE, /**< Frame is incomplete, but was delivered as incomplete frames delivery is enabled */
     ARSTREAM_READER_CAUSE_MAX,
 } eARSTREAM_READER_CAUSE;
 
@@ -86,12 +101,70 @@ typedef enum {
  * @note If cause is ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, datas will be copied into the new frame. Old frame buffer will still be in use until the callback is called again with ARSTREAM_READER_CAUSE_COPY_COMPLETE cause. If the new frame is still too small, the callback will be called again, until a suitable buffer is provided. newBufferCapacity holds a suitable capacity for the new buffer, but still has to be updated by the application.
  * @note If cause is ARSTREAM_READER_CAUSE_COPY_COMPLETE, the return value and newBufferCapacity are unused. If numberOfSkippedFrames is non-zero, then the current frame will be skipped (usually because the buffer returned after the ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL was smaller than the previous buffer).
  * @note If cause is ARSTREAM_READER_CAUSE_CANCEL, the return value and newBufferCapacity are unused
+ * @note If cause is ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE, framePointer contains a frame with missing fragments. It is handled like ARSTREAM_READER_CAUSE_FRAME_COMPLETE, and the missing parts of the frame can be retrieved with ARSTREAM_Reader_GetFrameInfo()
  *
  * @warning If the cause is ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL, returning a buffer shorter than 'frameSize' will cause the library to skip the current frame
  * @warning In any case, returning a NULL buffer is not supported.
  */
 typedef uint8_t* (*ARSTREAM_Reader_FrameCompleteCallback_t) (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
 
+/**
+ * @brief A range of bytes within a frame buffer
+ */
+typedef struct {
+    uint32_t offset; /**< Offset of the first byte of the range */
+    uint32_t size; /**< Size of the range, in bytes */
+} ARSTREAM_Reader_ByteRange_t;
+
+/**
+ * @brief Description of the last frame given to the application
+ */
+typedef struct {
+    uint16_t frameNumber; /**< Network frame number */
+    uint32_t nbFragments; /**< Number of fragments of the frame on the network */
+    uint32_t nbReceivedFragments; /**< Number of fragments actually received */
+    uint32_t fragmentSize; /**< Size of a full fragment. Fragment i starts at offset (i * fragmentSize) in the frame buffer */
+    uint8_t receivedFragments [ARSTREAM_READER_MAX_FRAGMENTS_PER_FRAME / 8]; /**< Bitfield of the received fragments (bit (i % 8) of byte (i / 8) is set if fragment i was received) */
+    uint32_t nbMissingRanges; /**< Number of valid entries in missingRanges */
+    ARSTREAM_Reader_ByteRange_t missingRanges [ARSTREAM_READER_MAX_FRAGMENTS_PER_FRAME / 2]; /**< Byte ranges of the frame buffer which hold no valid data */
+    int hasTimestamps; /**< Boolean-like (0-1) flag, active if the sender timestamped the frame (see ARSTREAM_Sender_SetFrameTimestamps). If not, the latency fields are zero */
+    uint32_t senderQueueDurationUs; /**< Time spent by the frame in the sender queue before its first transmission */
+    uint32_t firstFragmentLatencyUs; /**< Estimated time between the first transmission of the frame and the reception of its first fragment */
+    uint32_t completionLatencyUs; /**< Estimated time between the first transmission of the frame and its delivery to the application (including retries) */
+    int64_t clockOffsetUs; /**< Estimated offset of the reader clock relative to the sender clock, used for the latency fields */
+} ARSTREAM_Reader_FrameInfo_t;
+
+/**
+ * @brief Latency histograms of an ARSTREAM_Reader_t
+ * All histograms hold durations in microseconds, and are only filled by timestamped frames
+ * @see ARSTREAM_Reader_GetHistogram()
+ */
+typedef enum {
+    ARSTREAM_READER_HISTOGRAM_SENDER_QUEUE_DURATION = 0, /**< Time spent by the frames in the sender queue */
+    ARSTREAM_READER_HISTOGRAM_FIRST_FRAGMENT_LATENCY, /**< Latency of the first fragment of the frames */
+    ARSTREAM_READER_HISTOGRAM_COMPLETION_LATENCY, /**< Latency of the frames delivery to the application */
+    ARSTREAM_READER_HISTOGRAM_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_READER_HISTOGRAM;
+
+/**
+ * @brief Cumulative counters of an ARSTREAM_Reader_t
+ * All counters start at zero when the reader is created, and are never reset
+ * @see ARSTREAM_Reader_GetCounter()
+ */
+typedef enum {
+    ARSTREAM_READER_COUNTER_FRAGMENTS_RECEIVED = 0, /**< Data fragments received from the network */
+    ARSTREAM_READER_COUNTER_DUPLICATE_FRAGMENTS, /**< Data fragments received again, while already acknowledged */
+    ARSTREAM_READER_COUNTER_FRAMES_COMPLETE, /**< Frames fully received and given to the application */
+    ARSTREAM_READER_COUNTER_FRAMES_INCOMPLETE, /**< Frames given to the application with missing fragments */
+    ARSTREAM_READER_COUNTER_FRAMES_DROPPED, /**< Frames dropped because the application gave no large enough buffer */
+    ARSTREAM_READER_COUNTER_FRAMES_MISSED, /**< Frames of which no fragment was ever received */
+    ARSTREAM_READER_COUNTER_FRAMES_DISCARDED, /**< Frames discarded while waiting for a flush frame */
+    ARSTREAM_READER_COUNTER_FLUSH_FRAMES_REQUESTED, /**< Flush frame requests sent to the sender */
+    ARSTREAM_READER_COUNTER_LATE_FRAGMENTS, /**< Data fragments of a frame older than the current one, dropped (only when incomplete frames are delivered) */
+    ARSTREAM_READER_COUNTER_DISCARDED_FRAGMENTS, /**< Data fragments of the frames discarded while waiting for a flush frame */
+    ARSTREAM_READER_COUNTER_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_READER_COUNTER;
+
 /**
  * @brief An ARSTREAM_Reader_t instance allow reading streamed frames from a network
  */
@@ -140,6 +213,133 @@ void ARSTREAM_Reader_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
  */
 ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error);
 
+/**
+ * @brief Creates a new ARSTREAM_Reader_t which uses a custom transport
+ * @warning This function allocates memory. An ARSTREAM_Reader_t muse be deleted by a call to ARSTREAM_Reader_Delete
+ *
+ * @param[in] transport The transport which will be used to stream frames. The reader does not take ownership of the transport, which must be deleted after the reader
+ * @param[in] callback The callback which will be called every time a new frame is available
+ * @param[in] frameBuffer The adress of the first frameBuffer to use
+ * @param[in] frameBufferSize The length of the frameBuffer (to avoid overflow)
+ * @param[in] maxFragmentSize Maximum allowed size for a video data fragment. Video frames larger that will be fragmented.
+ * @param[in] maxAckInterval Maximum interval between sending ACKs. 0 disables only periodic ACKs. -1 disables ACKs completely.
+ * If unsure, use the default value in ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT.
+ * @param[in] custom Custom pointer which will be passed to callback
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Reader_t, or NULL if an error occured
+ * @see ARSTREAM_Reader_New()
+ */
+ARSTREAM_Reader_t* ARSTREAM_Reader_NewWithTransport (ARSTREAM_Transport_t *transport, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Enables or disables the delivery of incomplete frames
+ * When enabled, a frame which is abandoned by the reader (because a newer frame arrived, or because it is
+ * waiting for its missing fragments since more than maxWaitTimeMs) is given to the application with the
+ * ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE cause, if at least minPercentOfFragments percent of its fragments were received.
+ *
+ * @param[in] reader The ARSTREAM_Reader_t to configure
+ * @param[in] minPercentOfFragments Minimum percentage (0-100) of received fragments for a frame to be delivered. ARSTREAM_READER_INCOMPLETE_FRAMES_DISABLED disables the incomplete frames delivery
+ * @param[in] maxWaitTimeMs Maximum time to wait for the missing fragments of a frame, after its first fragment was received. 0 means no timeout (the frame is only delivered when a newer frame arrives)
+ *
+ * @return ARSTREAM_OK if the configuration was applied
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is invalid, or if a parameter is out of range
+ *
+ * @note Incomplete frame delivery is disabled by default
+ * @note The missing parts of the frame buffer contain stale data from previous frames
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetIncompleteFramesDelivery (ARSTREAM_Reader_t *reader, int minPercentOfFragments, int maxWaitTimeMs);
+
+/**
+ * @brief Enables or disables the skipping of the frames which depend on a lost frame
+ * When enabled, after a frame was skipped (never received, or abandoned while incomplete), the reader
+ * discards all the following frames until the next flush frame (typically an I-Frame), as they can not
+ * be decoded without the missing reference. Discarded frames are neither copied nor given to the application,
+ * and they are acknowledged as a whole as soon as they are seen, so the sender stops sending them.
+ *
+ * @param[in] reader The ARSTREAM_Reader_t to configure
+ * @param[in] enable Boolean-like (0-1) flag to enable or disable the skipping
+ *
+ * @return ARSTREAM_OK if the configuration was applied
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is invalid
+ *
+ * @note Frames delivered as incomplete frames (see ARSTREAM_Reader_SetIncompleteFramesDelivery()) are not considered as skipped
+ * @note The first frames received by the reader are also discarded until a flush frame is received
+ * @note Disabled by default
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetSkipFramesUntilFlush (ARSTREAM_Reader_t *reader, int enable);
+
+/**
+ * @brief Enables or disables the automatic flush frame requests
+ * When enabled, the reader requests a flush frame (typically an I-Frame) to the sender as soon as
+ * it lost a reference frame, and repeats the request every requestIntervalMs until it receives a flush frame.
+ *
+ * @param[in] reader The ARSTREAM_Reader_t to configure
+ * @param[in] requestIntervalMs Minimum time between two requests. 0 disables the automatic requests
+ *
+ * @return ARSTREAM_OK if the configuration was applied
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is invalid, or if requestIntervalMs is negative
+ *
+ * @note Disabled by default
+ * @see ARSTREAM_Reader_RequestFlushFrame()
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_SetAutomaticFlushFrameRequests (ARSTREAM_Reader_t *reader, int requestIntervalMs);
+
+/**
+ * @brief Requests a flush frame (typically an I-Frame) to the sender
+ * This can be used by the application when its decoder lost its reference (e.g. on decoding errors)
+ *
+ * @param[in] reader The ARSTREAM_Reader_t
+ *
+ * @return ARSTREAM_OK if the request will be sent
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader is invalid
+ *
+ * @note The request is sent by the ack thread, on the ack buffer
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_RequestFlushFrame (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Gets the description of the frame which is currently given to the application
+ * @warning This function must only be called from within the reader callback, during an ARSTREAM_READER_CAUSE_FRAME_COMPLETE or ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE call
+ *
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[out] info Pointer to an ARSTREAM_Reader_FrameInfo_t which will be filled
+ *
+ * @return ARSTREAM_OK if info was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader or info is invalid, or if the callback is not currently called for a frame
+ *
+ * @note For missing last fragments, as their actual size is unknown, missingRanges may extend beyond the frame size
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_GetFrameInfo (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_FrameInfo_t *info);
+
+/**
+ * @brief Gets a copy of a latency histogram of the reader
+ * The latencies are one-way latencies, computed from the sender timestamps (see ARSTREAM_Sender_SetFrameTimestamps)
+ * and from an estimation of the offset between the sender and reader clocks. This estimation assumes
+ * that the fastest fragments take half of the network round trip time.
+ *
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] histogram Which histogram to get
+ * @param[out] snapshot Pointer to an ARSTREAM_Histogram_t which will be filled
+ *
+ * @return ARSTREAM_OK if snapshot was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader, histogram or snapshot is invalid
+ *
+ * @note This function can be called from any thread, while the reader is running
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_GetHistogram (ARSTREAM_Reader_t *reader, eARSTREAM_READER_HISTOGRAM histogram, ARSTREAM_Histogram_t *snapshot);
+
+/**
+ * @brief Gets the value of a cumulative counter of the reader
+ *
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] counter Which counter to get
+ *
+ * @return The value of the counter, or 0 if reader or counter is invalid
+ *
+ * @note This function can be called from any thread, while the reader is running
+ */
+uint64_t ARSTREAM_Reader_GetCounter (ARSTREAM_Reader_t *reader, eARSTREAM_READER_COUNTER counter);
+
 /**
  * @brief Stops a running ARSTREAM_Reader_t
  * @warning Once stopped, an ARSTREAM_Reader_t can not be restarted
@@ -180,6 +380,28 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param);
  */
 void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param);
 
+/**
+ * @brief Starts the data and acknowledge threads of the ARSTREAM_Reader_t, with their own CPU affinity and scheduling
+ * The library creates and owns the threads : the application must not call ARSTREAM_Reader_RunDataThread()
+ * and ARSTREAM_Reader_RunAckThread() itself. Both settings are applied before either thread runs : on error,
+ * no thread was started.
+ * @post Stop the threads by calling ARSTREAM_Reader_StopReader(). ARSTREAM_Reader_Delete() then joins them
+ *
+ * @param[in] reader The ARSTREAM_Reader_t
+ * @param[in] dataConfig Settings of the data thread. NULL keeps the settings inherited from the calling thread
+ * @param[in] ackConfig Settings of the acknowledge thread. NULL keeps the settings inherited from the calling thread
+ *
+ * @return ARSTREAM_OK if both threads were started
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if reader or a setting is invalid, or if a mask holds no usable CPU
+ * @return ARSTREAM_ERROR_BUSY if the threads of the reader were already started
+ * @return ARSTREAM_ERROR_PERMISSION if the system refused a setting (SCHED_FIFO or negative nice values need privileges)
+ * @return ARSTREAM_ERROR_NOT_SUPPORTED if the system does not support a setting
+ * @return ARSTREAM_ERROR_ALLOC if a thread could not be created
+ *
+ * @see ARSTREAM_Thread_MeasureSchedulingLatency() to check the settings on the target
+ */
+eARSTREAM_ERROR ARSTREAM_Reader_StartThreads (ARSTREAM_Reader_t *reader, const ARSTREAM_Thread_Config_t *dataConfig, const ARSTREAM_Thread_Config_t *ackConfig);
+
 /**
  * @brief Gets the estimated network efficiency for the ARSTREAM link
  * An efficiency of 1.0f means that we did not receive any useless packet.
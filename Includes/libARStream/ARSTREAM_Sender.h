@@ -48,6 +48,9 @@
  */
 #include <libARNetwork/ARNETWORK_Manager.h>
 #include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Histogram.h>
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARStream/ARSTREAM_Thread.h>
 
 /*
  * Macros
@@ -64,9 +67,43 @@ typedef enum {
     ARSTREAM_SENDER_STATUS_FRAME_SENT = 0, /**< Frame was sent and acknowledged by peer */
     ARSTREAM_SENDER_STATUS_FRAME_CANCEL, /**< Frame was not sent, and was cancelled by a new frame */
     ARSTREAM_SENDER_STATUS_FRAME_LATE_ACK, /**< We received a full ack for an old frame. The callback will be called with null pointer and zero size. */
+    ARSTREAM_SENDER_STATUS_FLUSH_FRAME_REQUESTED, /**< The reader lost a reference frame and requests a flush frame (typically an I-Frame). The callback will be called with null pointer and zero size. */
     ARSTREAM_SENDER_STATUS_MAX,
 } eARSTREAM_SENDER_STATUS;
 
+/**
+ * @brief Frame lifecycle histograms of an ARSTREAM_Sender_t
+ * All histograms hold durations in microseconds
+ * @see ARSTREAM_Sender_GetHistogram()
+ */
+typedef enum {
+    ARSTREAM_SENDER_HISTOGRAM_QUEUED = 0, /**< Time spent by the frames in the queue, from ARSTREAM_Sender_SendNewFrame until the sender starts processing them */
+    ARSTREAM_SENDER_HISTOGRAM_FIRST_FRAGMENT, /**< Time from the start of the processing of the frames until their first fragment is given to the network */
+    ARSTREAM_SENDER_HISTOGRAM_SENT, /**< Time from the first fragment given to the network until all the fragments of the first transmission are sent */
+    ARSTREAM_SENDER_HISTOGRAM_ACKNOWLEDGED, /**< Time from the first fragment given to the network until the frames are fully acknowledged (including retries) */
+    ARSTREAM_SENDER_HISTOGRAM_CANCELLED, /**< Time from ARSTREAM_Sender_SendNewFrame until the frames are cancelled */
+    ARSTREAM_SENDER_HISTOGRAM_TOTAL, /**< Time from ARSTREAM_Sender_SendNewFrame until the frames are fully acknowledged */
+    ARSTREAM_SENDER_HISTOGRAM_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_SENDER_HISTOGRAM;
+
+/**
+ * @brief Cumulative counters of an ARSTREAM_Sender_t
+ * All counters start at zero when the sender is created, and are never reset
+ * @see ARSTREAM_Sender_GetCounter()
+ */
+typedef enum {
+    ARSTREAM_SENDER_COUNTER_FRAMES_QUEUED = 0, /**< Frames accepted by ARSTREAM_Sender_SendNewFrame */
+    ARSTREAM_SENDER_COUNTER_FRAMES_REJECTED, /**< Frames refused by ARSTREAM_Sender_SendNewFrame because the queue was full */
+    ARSTREAM_SENDER_COUNTER_FRAMES_ACKNOWLEDGED, /**< Frames fully acknowledged by the reader */
+    ARSTREAM_SENDER_COUNTER_FRAMES_CANCELLED, /**< Frames cancelled before being fully acknowledged */
+    ARSTREAM_SENDER_COUNTER_FRAGMENTS_SENT, /**< Fragments given to the network, including the retries */
+    ARSTREAM_SENDER_COUNTER_FRAGMENTS_RETRANSMITTED, /**< Fragments given to the network again, after a retry timeout */
+    ARSTREAM_SENDER_COUNTER_LATE_FRAGMENTS_SENT, /**< Fragments given to the network after the frame was already replaced */
+    ARSTREAM_SENDER_COUNTER_ACKS_RECEIVED, /**< Acknowledge packets received from the reader */
+    ARSTREAM_SENDER_COUNTER_FLUSH_FRAMES_REQUESTED, /**< Flush frame requests reported to the application */
+    ARSTREAM_SENDER_COUNTER_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_SENDER_COUNTER;
+
 /**
  * @brief Callback type for sender informations
  * This callback is called when a frame pointer is no longer needed by the library.
@@ -77,11 +114,15 @@ typedef enum {
  * is no way to identify the "old" frame, but the library guarantees that the LATE_ACK status
  * will only be called for previously cancelled frames, and at most once per cancelled frame.
  *
+ * This callback is also used when the reader requests a flush frame. In this case, the application
+ * should send its next frame as a flush frame (typically an I-Frame) with ARSTREAM_Sender_SendNewFrame.
+ * Requests which are already answered by a flush frame in the queue, or in flight, are not reported.
+ *
  * @param[in] status Why the call was made
  * @param[in] framePointer Pointer to the frame which was sent/cancelled
  * @param[in] frameSize Size, in bytes, of the frame
  * @param[in] custom Custom pointer passed during ARSTREAM_Sender_New
- * @warning If the status is ARSTREAM_SENDER_STATUS_FRAME_LATE_ACK, then the framePointer will be NULL.
+ * @warning If the status is ARSTREAM_SENDER_STATUS_FRAME_LATE_ACK or ARSTREAM_SENDER_STATUS_FLUSH_FRAME_REQUESTED, then the framePointer will be NULL.
  * @see eARSTREAM_SENDER_STATUS
  */
 typedef void (*ARSTREAM_Sender_FrameUpdateCallback_t)(eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
@@ -153,6 +194,23 @@ void ARSTREAM_Sender_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
  */
 ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment,  void *custom, eARSTREAM_ERROR *error);
 
+/**
+ * @brief Creates a new ARSTREAM_Sender_t which uses a custom transport
+ * @warning This function allocates memory. An ARSTREAM_Sender_t muse be deleted by a call to ARSTREAM_Sender_Delete
+ *
+ * @param[in] transport The transport which will be used to stream frames. The sender does not take ownership of the transport, which must be deleted after the sender
+ * @param[in] callback The status update callback which will be called every time the status of a send-frame is updated
+ * @param[in] framesBufferSize Number of frames that the ARSTREAM_Sender_t instance will be able to hold in queue
+ * @param[in] maxFragmentSize Maximum allowed size for a video data fragment. Video frames larger that will be fragmented.
+ * @param[in] maxNumberOfFragment number maximum of fragment of one frame.
+ * @param[in] custom Custom pointer which will be passed to callback
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Sender_t, or NULL if an error occured
+ *
+ * @see ARSTREAM_Sender_New()
+ */
+ARSTREAM_Sender_t* ARSTREAM_Sender_NewWithTransport (ARSTREAM_Transport_t *transport, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment,  void *custom, eARSTREAM_ERROR *error);
+
 /**
  * @brief Sets the minimum and maximum time between retries.
  * Setting a small retry time might increase reliability, at the cost of network and cpu loads.
@@ -175,6 +233,24 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
  */
 eARSTREAM_ERROR ARSTREAM_Sender_SetTimeBetweenRetries (ARSTREAM_Sender_t *sender, int minWaitTimeMs, int maxWaitTimeMs);
 
+/**
+ * @brief Enables or disables the frame timestamps
+ * When enabled, each fragment carries the sender monotonic time of the first transmission
+ * of its frame, and the time that the frame spent in the sender queue. This allows the
+ * ARSTREAM_Reader_t to estimate the one-way latency of the stream.
+ *
+ * The timestamps use a few more bytes per fragment (see ARSTREAM_Sender_InitStreamDataBuffer),
+ * and are disabled by default.
+ *
+ * @note The new setting is applied from the next frame.
+ * @param sender The ARSTREAM_Sender_t
+ * @param enable Boolean-like (0-1) flag. If active, timestamps are added to the frames.
+ *
+ * @return ARSTREAM_OK if the setting was applied.
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender is NULL, or if enable is not 0 or 1.
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_SetFrameTimestamps (ARSTREAM_Sender_t *sender, int enable);
+
 /**
  * @brief Stops a running ARSTREAM_Sender_t
  * @warning Once stopped, an ARSTREAM_Sender_t can not be restarted
@@ -239,6 +315,28 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param);
  */
 void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param);
 
+/**
+ * @brief Starts the data and acknowledge threads of the ARSTREAM_Sender_t, with their own CPU affinity and scheduling
+ * The library creates and owns the threads : the application must not call ARSTREAM_Sender_RunDataThread()
+ * and ARSTREAM_Sender_RunAckThread() itself. Both settings are applied before either thread runs : on error,
+ * no thread was started.
+ * @post Stop the threads by calling ARSTREAM_Sender_StopSender(). ARSTREAM_Sender_Delete() then joins them
+ *
+ * @param[in] sender The ARSTREAM_Sender_t
+ * @param[in] dataConfig Settings of the data thread. NULL keeps the settings inherited from the calling thread
+ * @param[in] ackConfig Settings of the acknowledge thread. NULL keeps the settings inherited from the calling thread
+ *
+ * @return ARSTREAM_OK if both threads were started
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender or a setting is invalid, or if a mask holds no usable CPU
+ * @return ARSTREAM_ERROR_BUSY if the threads of the sender were already started
+ * @return ARSTREAM_ERROR_PERMISSION if the system refused a setting (SCHED_FIFO or negative nice values need privileges)
+ * @return ARSTREAM_ERROR_NOT_SUPPORTED if the system does not support a setting
+ * @return ARSTREAM_ERROR_ALLOC if a thread could not be created
+ *
+ * @see ARSTREAM_Thread_MeasureSchedulingLatency() to check the settings on the target
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_StartThreads (ARSTREAM_Sender_t *sender, const ARSTREAM_Thread_Config_t *dataConfig, const ARSTREAM_Thread_Config_t *ackConfig);
+
 /**
  * @brief Gets the estimated network efficiency for the ARSTREAM link
  * An efficiency of 1.0f means that we did not do any retries
@@ -247,6 +345,32 @@ void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param);
  */
 float ARSTREAM_Sender_GetEstimatedEfficiency (ARSTREAM_Sender_t *sender);
 
+/**
+ * @brief Gets a copy of a frame lifecycle histogram of the sender
+ *
+ * @param[in] sender The ARSTREAM_Sender_t
+ * @param[in] histogram Which histogram to get
+ * @param[out] snapshot Pointer to an ARSTREAM_Histogram_t which will be filled
+ *
+ * @return ARSTREAM_OK if snapshot was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if sender, histogram or snapshot is invalid
+ *
+ * @note This function can be called from any thread, while the sender is running
+ */
+eARSTREAM_ERROR ARSTREAM_Sender_GetHistogram (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_HISTOGRAM histogram, ARSTREAM_Histogram_t *snapshot);
+
+/**
+ * @brief Gets the value of a cumulative counter of the sender
+ *
+ * @param[in] sender The ARSTREAM_Sender_t
+ * @param[in] counter Which counter to get
+ *
+ * @return The value of the counter, or 0 if sender or counter is invalid
+ *
+ * @note This function can be called from any thread, while the sender is running
+ */
+uint64_t ARSTREAM_Sender_GetCounter (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_COUNTER counter);
+
 /**
  * @brief Gets the custom pointer associated with the sender
  * @param[in] sender The ARSTREAM_Sender_t
@@ -0,0 +1,101 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Thread.h
+ * @brief CPU affinity and scheduling of the threads started by the library
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_THREAD_H_
+#define _ARSTREAM_THREAD_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Histogram.h>
+
+/*
+ * Macros
+ */
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Roles of the threads of an ARSTREAM_Sender_t or an ARSTREAM_Reader_t
+ */
+typedef enum {
+    ARSTREAM_THREAD_ROLE_DATA = 0, /**< Data thread (RunDataThread) */
+    ARSTREAM_THREAD_ROLE_ACK, /**< Acknowledge thread (RunAckThread) */
+    ARSTREAM_THREAD_ROLE_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_THREAD_ROLE;
+
+/**
+ * @brief CPU affinity and scheduling settings of a thread
+ * A zeroed structure keeps the settings inherited from the creating thread
+ */
+typedef struct {
+    uint64_t cpuMask; /**< CPUs allowed to run the thread (bit n for CPU n). 0 keeps the inherited affinity */
+    int fifoPriority; /**< SCHED_FIFO priority, in [1, 99]. 0 keeps the normal time-sharing policy */
+    int niceValue; /**< Nice value, in [-20, 19], for the time-sharing policy (ignored with SCHED_FIFO). 0 keeps the inherited value */
+} ARSTREAM_Thread_Config_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Measures the scheduling latency of a thread with given settings
+ * A probe thread, created with the settings, sleeps until periodic deadlines, and records
+ * how late it wakes up. Run it on the target, under the usual load (encoder ...), to choose
+ * the settings of the stream threads.
+ *
+ * @param[in] config Settings of the probe thread. NULL keeps the inherited settings
+ * @param[in] periodUs Period of the deadlines, in us
+ * @param[in] nbSamples Number of deadlines (the call lasts about periodUs * nbSamples)
+ * @param[out] latencies Histogram of the wake up latencies, in us
+ *
+ * @return ARSTREAM_OK if latencies was filled
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if a parameter is invalid, or if the mask holds no usable CPU
+ * @return ARSTREAM_ERROR_PERMISSION if the system refused the settings (SCHED_FIFO or negative nice values need privileges)
+ * @return ARSTREAM_ERROR_NOT_SUPPORTED if the system does not support the settings
+ */
+eARSTREAM_ERROR ARSTREAM_Thread_MeasureSchedulingLatency (const ARSTREAM_Thread_Config_t *config, uint32_t periodUs, uint32_t nbSamples, ARSTREAM_Histogram_t *latencies);
+
+#endif /* _ARSTREAM_THREAD_H_ */
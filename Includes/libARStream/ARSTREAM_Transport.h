@@ -0,0 +1,322 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Transport.h
+ * @brief Transport interface used by the stream sender and reader
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_TRANSPORT_H_
+#define _ARSTREAM_TRANSPORT_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARNetwork/ARNETWORK_Manager.h>
+#include <libARStream/ARSTREAM_Error.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Default number of frame slots of a shared memory transport
+ * @see ARSTREAM_Transport_CreateSharedMemory()
+ */
+#define ARSTREAM_TRANSPORT_SHARED_MEMORY_DEFAULT_NB_SLOTS (16)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Channels of a stream transport
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_CHANNEL_DATA = 0, /**< Stream data fragments, from the sender to the reader */
+    ARSTREAM_TRANSPORT_CHANNEL_ACK, /**< Acknowledges and control packets, from the reader to the sender */
+    ARSTREAM_TRANSPORT_CHANNEL_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_TRANSPORT_CHANNEL;
+
+/**
+ * @brief Status of a packet given to a transport
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_SEND_STATUS_SENT = 0, /**< The packet was sent on the network */
+    ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL, /**< The packet was dropped before being sent */
+    ARSTREAM_TRANSPORT_SEND_STATUS_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_TRANSPORT_SEND_STATUS;
+
+/**
+ * @brief Callback called by a transport when a packet is sent or dropped
+ * @param[in] callbackData Custom pointer given with the packet
+ * @param[in] status What happened to the packet
+ * @note The callback is called exactly once per packet successfully given to the transport
+ */
+typedef void (*ARSTREAM_Transport_SendCallback_t) (void *callbackData, eARSTREAM_TRANSPORT_SEND_STATUS status);
+
+/**
+ * @brief Options of the raw UDP transport (bitmask)
+ * @see ARSTREAM_Transport_NewUDP()
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_UDP_FLAG_NONE = 0, /**< One system call per fragment */
+    ARSTREAM_TRANSPORT_UDP_FLAG_BATCH = (1 << 0), /**< Send the fragments of a frame with sendmmsg(), and read bursts with recvmmsg() */
+    ARSTREAM_TRANSPORT_UDP_FLAG_GSO = (1 << 1), /**< Let the kernel split the fragments of a frame (UDP_SEGMENT, Linux only) */
+    ARSTREAM_TRANSPORT_UDP_FLAG_GRO = (1 << 2), /**< Let the kernel coalesce the received fragments (UDP_GRO, Linux only) */
+    ARSTREAM_TRANSPORT_UDP_FLAG_DEFAULT = (ARSTREAM_TRANSPORT_UDP_FLAG_BATCH | ARSTREAM_TRANSPORT_UDP_FLAG_GSO | ARSTREAM_TRANSPORT_UDP_FLAG_GRO), /**< All the features supported by the system */
+} eARSTREAM_TRANSPORT_UDP_FLAG;
+
+/**
+ * @brief Role of an endpoint of a shared memory transport
+ * @see ARSTREAM_Transport_NewSharedMemory()
+ */
+typedef enum {
+    ARSTREAM_TRANSPORT_ROLE_SENDER = 0, /**< The endpoint is used by an ARSTREAM_Sender_t */
+    ARSTREAM_TRANSPORT_ROLE_READER, /**< The endpoint is used by an ARSTREAM_Reader_t */
+    ARSTREAM_TRANSPORT_ROLE_MAX, /**< Max of the enum, do not use ! */
+} eARSTREAM_TRANSPORT_ROLE;
+
+/**
+ * @brief Description of a packet for batched sends
+ * The packet sent on the network is the header followed by the payload
+ */
+typedef struct {
+    uint8_t *header; /**< Packet header */
+    uint32_t headerSize; /**< Size of the header, in bytes */
+    uint8_t *payload; /**< Packet payload */
+    uint32_t payloadSize; /**< Size of the payload, in bytes */
+    ARSTREAM_Transport_SendCallback_t callback; /**< Called when the packet is sent or dropped. Can be NULL */
+    void *callbackData; /**< Custom pointer given to the callback */
+} ARSTREAM_Transport_Packet_t;
+
+/**
+ * @brief Functions of a transport implementation
+ * All functions receive the context pointer of the ARSTREAM_Transport_t
+ */
+typedef struct {
+    /**
+     * @brief Sends a packet
+     * The data is copied (or sent) before this function returns, so the buffer can be reused at once
+     * @param[in] context The transport context
+     * @param[in] channel The channel to send on
+     * @param[in] data The packet data
+     * @param[in] size The packet size, in bytes
+     * @param[in] callback Called when the packet is sent or dropped. Can be NULL
+     * @param[in] callbackData Custom pointer given to the callback
+     * @return ARSTREAM_OK if the packet will be sent. In this case only, the callback will be called
+     * @return ARSTREAM_ERROR_TRANSPORT if the packet can not be sent
+     */
+    eARSTREAM_ERROR (*send) (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData);
+
+    /**
+     * @brief Receives a packet
+     * @param[in] context The transport context
+     * @param[in] channel The channel to read from
+     * @param[out] buffer The buffer in which the packet is copied
+     * @param[in] bufferSize The size of the buffer, in bytes
+     * @param[out] receivedSize The size of the received packet, in bytes
+     * @param[in] timeoutMs Maximum time to wait for a packet, in ms
+     * @return ARSTREAM_OK if a packet was received
+     * @return ARSTREAM_ERROR_BUFFER_EMPTY if no packet was received before the timeout
+     * @return ARSTREAM_ERROR_TRANSPORT on any other error
+     */
+    eARSTREAM_ERROR (*receive) (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs);
+
+    /**
+     * @brief Sends a batch of packets (optional, can be NULL)
+     * When available, this function is used instead of send() to give all the pending fragments of a frame at once.
+     * The headers and payloads are sent (or copied) before this function returns.
+     * @param[in] context The transport context
+     * @param[in] channel The channel to send on
+     * @param[in] packets The packets to send
+     * @param[in] nbPackets Number of packets in the array
+     * @return ARSTREAM_OK if all the packets will be sent
+     * @return ARSTREAM_ERROR_TRANSPORT if some packets can not be sent
+     * @note Unlike send(), the callback of every packet is called, with the CANCEL status for packets which can not be sent
+     */
+    eARSTREAM_ERROR (*sendPackets) (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+
+    /**
+     * @brief Receives a packet without copying it (optional, can be NULL)
+     * When available, this function is used instead of receive(). The packet stays owned by the transport,
+     * and must be released by a call to receiveEnd() before the next receiveBegin() call.
+     * @param[in] context The transport context
+     * @param[in] channel The channel to read from
+     * @param[out] data Pointer to the packet data
+     * @param[out] receivedSize The size of the received packet, in bytes
+     * @param[in] timeoutMs Maximum time to wait for a packet, in ms
+     * @return ARSTREAM_OK if a packet was received
+     * @return ARSTREAM_ERROR_BUFFER_EMPTY if no packet was received before the timeout
+     * @return ARSTREAM_ERROR_TRANSPORT on any other error
+     */
+    eARSTREAM_ERROR (*receiveBegin) (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs);
+
+    /**
+     * @brief Releases a packet received by receiveBegin() (mandatory if receiveBegin is set)
+     * @param[in] context The transport context
+     * @param[in] channel The channel of the packet
+     */
+    void (*receiveEnd) (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+
+    /**
+     * @brief Drops the packets which are waiting to be sent on a channel
+     * @param[in] context The transport context
+     * @param[in] channel The channel to flush
+     * @return ARSTREAM_OK, or ARSTREAM_ERROR_TRANSPORT if the channel can not be flushed
+     * @note The callback of each dropped packet is called with the CANCEL status
+     */
+    eARSTREAM_ERROR (*flush) (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+
+    /**
+     * @brief Gets the estimated round trip time of the link
+     * @param[in] context The transport context
+     * @return The estimated round trip time in ms, or a negative value if unknown
+     */
+    int (*getEstimatedLatency) (void *context);
+
+    /**
+     * @brief Frees the transport context
+     * Called by ARSTREAM_Transport_Delete. Can be NULL if the context does not need to be freed
+     * @param[in] context The transport context
+     */
+    void (*destroy) (void *context);
+} ARSTREAM_Transport_Ops_t;
+
+/**
+ * @brief A stream transport : a set of functions and their context
+ */
+typedef struct {
+    const ARSTREAM_Transport_Ops_t *ops; /**< Functions of the transport */
+    void *context; /**< Context given to the functions */
+} ARSTREAM_Transport_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Creates a new transport from a custom implementation
+ * @param[in] ops The functions of the transport. Must stay valid until the transport is deleted. The send, receive, flush and getEstimatedLatency functions are mandatory
+ * @param[in] context The context given to the functions
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Transport_t, or NULL if an error occured
+ */
+ARSTREAM_Transport_t* ARSTREAM_Transport_New (const ARSTREAM_Transport_Ops_t *ops, void *context, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Creates a new transport which uses an ARNETWORK_Manager_t
+ * This is the transport used by ARSTREAM_Sender_New and ARSTREAM_Reader_New
+ * @param[in] manager The ARNETWORK_Manager_t to use. Must stay valid until the transport is deleted
+ * @param[in] dataBufferID ID of the data buffer (see ARSTREAM_Sender_InitStreamDataBuffer)
+ * @param[in] ackBufferID ID of the ack buffer (see ARSTREAM_Sender_InitStreamAckBuffer)
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Transport_t, or NULL if an error occured
+ */
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewNetwork (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Creates a new transport which uses a raw UDP socket
+ * Each endpoint binds a socket on localPort and sends to remoteAddress:remotePort, so the sender and the reader
+ * must use swapped port numbers. The channel is implied by the role of the endpoint : the sender sends data and
+ * receives acks, the reader receives data and sends acks.
+ * When available, sendmmsg() and recvmmsg() are used to send all the fragments of a frame in one call, and to read
+ * bursts of fragments into preallocated slots. On Linux, the kernel can also segment the frames (GSO) and coalesce
+ * the received fragments (GRO).
+ * Features which are not supported by the system are silently disabled.
+ * @param[in] remoteAddress IPv4 address of the other endpoint
+ * @param[in] localPort UDP port to bind
+ * @param[in] remotePort UDP port of the other endpoint
+ * @param[in] maxFragmentSize Maximum fragment size used by the sender (see ARSTREAM_Sender_NewWithTransport)
+ * @param[in] flags Bitmask of eARSTREAM_TRANSPORT_UDP_FLAG values (typically ARSTREAM_TRANSPORT_UDP_FLAG_DEFAULT)
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Transport_t, or NULL if an error occured
+ * @note This transport does not retransmit nor estimate latency : the reliability is provided by the stream acks
+ */
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewUDP (const char *remoteAddress, int localPort, int remotePort, uint32_t maxFragmentSize, uint32_t flags, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Creates the shared memory area of a same-host sender/reader pair
+ * The area is an anonymous memory file (memfd) holding a ring of frame slots from the sender to the reader,
+ * and a small ring of acks from the reader to the sender. Its size is fixed and sealed.
+ * Both endpoints then call ARSTREAM_Transport_NewSharedMemory() with the file descriptor. To reach another
+ * process, the descriptor can be inherited through fork(), or sent on a unix socket (SCM_RIGHTS).
+ * @param[in] maxFragmentSize Maximum fragment size of the sender. Choose it larger than the largest frame, so frames are never fragmented
+ * @param[in] nbSlots Number of frame slots, must be a power of two (see ARSTREAM_TRANSPORT_SHARED_MEMORY_DEFAULT_NB_SLOTS)
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return The file descriptor of the area (close-on-exec), or -1 if an error occured. The caller must close it
+ * @note If the system has no memfd support, this function returns -1 with the ARSTREAM_ERROR_NOT_SUPPORTED error
+ */
+int ARSTREAM_Transport_CreateSharedMemory (uint32_t maxFragmentSize, uint32_t nbSlots, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Creates a new transport over a shared memory area
+ * The sender copies each fragment once into a frame slot, and the reader reads it in place. Waiting readers
+ * sleep on a futex, which the other process only wakes when a reader actually waits.
+ * @param[in] fd File descriptor of an area created by ARSTREAM_Transport_CreateSharedMemory(). The transport maps it, so it can be closed after this call
+ * @param[in] role Role of this endpoint. An area must be used by one sender and one reader only
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Transport_t, or NULL if an error occured
+ * @note When the frame ring is full, new fragments are dropped : they are sent again like any lost fragment
+ */
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewSharedMemory (int fd, eARSTREAM_TRANSPORT_ROLE role, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Creates a pair of transports which connect a sender and a reader of the same process
+ * The endpoints exchange packets through lock-free rings in memory, with no system call unless a reader
+ * has to wait for a packet. This makes the cost of the library itself measurable, without any network noise.
+ * @param[in] maxFragmentSize Maximum fragment size of the sender
+ * @param[in] nbSlots Number of fragment slots, must be a power of two (see ARSTREAM_TRANSPORT_SHARED_MEMORY_DEFAULT_NB_SLOTS)
+ * @param[out] senderTransport The transport to give to ARSTREAM_Sender_NewWithTransport()
+ * @param[out] readerTransport The transport to give to ARSTREAM_Reader_NewWithTransport()
+ * @return ARSTREAM_OK if both transports were created
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if a parameter is invalid
+ * @return ARSTREAM_ERROR_ALLOC if the rings can not be allocated
+ * @note Both transports must be deleted with ARSTREAM_Transport_Delete(). The rings are freed with the last one
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_NewLoopback (uint32_t maxFragmentSize, uint32_t nbSlots, ARSTREAM_Transport_t **senderTransport, ARSTREAM_Transport_t **readerTransport);
+
+/**
+ * @brief Deletes a transport
+ * @warning The transport must not be used by a sender or a reader anymore
+ * @param transport Pointer to the ARSTREAM_Transport_t * to delete
+ * @return ARSTREAM_OK if the transport was deleted
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if transport does not point to a valid ARSTREAM_Transport_t
+ */
+eARSTREAM_ERROR ARSTREAM_Transport_Delete (ARSTREAM_Transport_t **transport);
+
+#endif /* _ARSTREAM_TRANSPORT_H_ */
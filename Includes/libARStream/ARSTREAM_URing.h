@@ -0,0 +1,127 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_URing.h
+ * @brief io_uring event loop shared by many stream transports
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_URING_H_
+#define _ARSTREAM_URING_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Transport.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Default number of registered buffers of an ARSTREAM_URing_t
+ */
+#define ARSTREAM_URING_DEFAULT_NB_BUFFERS (4096)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief An ARSTREAM_URing_t drives the network I/O of many stream transports from a single thread
+ *
+ * All the transports created on a ring share its registered buffers : fragments are copied once into a
+ * registered buffer, then sent by the kernel without any further copy, and fragments are received directly
+ * into registered buffers. Sends and receives are submitted and reaped in batches, so the number of system
+ * calls does not grow with the number of streams.
+ *
+ * @note This feature needs Linux 5.6 or later, and a libARStream built with liburing
+ */
+typedef struct ARSTREAM_URing_t ARSTREAM_URing_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Creates a new io_uring event loop
+ * @param[in] nbBuffers Number of registered buffers, shared by all the transports of the ring (see ARSTREAM_URING_DEFAULT_NB_BUFFERS)
+ * @param[in] bufferSize Size of each buffer. Must be at least the maximum fragment size of the streams, plus 17 bytes for the stream headers. Larger received packets are dropped
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_URing_t, or NULL if an error occured
+ * @note If the library was built without io_uring support, this function returns NULL with the ARSTREAM_ERROR_NOT_SUPPORTED error
+ */
+ARSTREAM_URing_t* ARSTREAM_URing_New (uint32_t nbBuffers, uint32_t bufferSize, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Runs the event loop of the ARSTREAM_URing_t
+ * @warning This function never returns until ARSTREAM_URing_Stop() is called. Thus, it should be called on its own thread
+ * @post Stop the ARSTREAM_URing_t by calling ARSTREAM_URing_Stop() before joining the thread calling this function
+ * @param[in] ARSTREAM_URing_t_Param A valid (ARSTREAM_URing_t *) casted as a (void *)
+ */
+void* ARSTREAM_URing_RunThread (void *ARSTREAM_URing_t_Param);
+
+/**
+ * @brief Stops the event loop of the ARSTREAM_URing_t
+ * @warning All the transports of the ring must be deleted before calling this function
+ * @param[in] ring The ARSTREAM_URing_t to stop
+ */
+void ARSTREAM_URing_Stop (ARSTREAM_URing_t *ring);
+
+/**
+ * @brief Deletes an ARSTREAM_URing_t
+ * @param ring Pointer to the ARSTREAM_URing_t * to delete
+ * @return ARSTREAM_OK if the ring was deleted
+ * @return ARSTREAM_ERROR_BUSY if the event loop is still running, or if some transports still use the ring
+ * @return ARSTREAM_ERROR_BAD_PARAMETERS if ring does not point to a valid ARSTREAM_URing_t
+ */
+eARSTREAM_ERROR ARSTREAM_URing_Delete (ARSTREAM_URing_t **ring);
+
+/**
+ * @brief Creates a new transport which uses a UDP socket driven by an ARSTREAM_URing_t
+ * The socket setup is the same as ARSTREAM_Transport_NewUDP() : the sender and the reader must use swapped port numbers.
+ * @param[in] ring The ARSTREAM_URing_t which drives the socket. Its event loop must run while the transport is used and deleted
+ * @param[in] remoteAddress IPv4 address of the other endpoint
+ * @param[in] localPort UDP port to bind
+ * @param[in] remotePort UDP port of the other endpoint
+ * @param[out] error Optionnal pointer to an eARSTREAM_ERROR to hold any error information
+ * @return A pointer to the new ARSTREAM_Transport_t, or NULL if an error occured
+ */
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewURing (ARSTREAM_URing_t *ring, const char *remoteAddress, int localPort, int remotePort, eARSTREAM_ERROR *error);
+
+#endif /* _ARSTREAM_URING_H_ */
@@ -39,6 +39,12 @@
 #define _ARSTREAM_H_
 
 #include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Histogram.h>
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARStream/ARSTREAM_URing.h>
+#include <libARStream/ARSTREAM_Impairment.h>
+#include <libARStream/ARSTREAM_EventLog.h>
+#include <libARStream/ARSTREAM_Thread.h>
 #include <libARStream/ARSTREAM_Sender.h>
 #include <libARStream/ARSTREAM_Reader.h>
 
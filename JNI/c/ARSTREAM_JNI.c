@@ -0,0 +1,392 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_JNI.c
+ * @brief Helpers shared by the JNI wrappers
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#include <jni.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <libARSAL/ARSAL_Print.h>
+
+#include "ARSTREAM_JNI.h"
+
+#define JNI_TAG "ARSTREAM_JNI"
+
+#define JNI_ATTACHED_THREAD_NAME "ARStream native"
+
+/* The key holds the JNIEnv of the threads attached by ARSTREAM_JNI_GetEnv, NULL for the others */
+static pthread_once_t g_attachKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t g_attachKey;
+static int g_attachKeyValid = 0;
+static JavaVM *g_attachVm = NULL;
+
+static jmethodID g_benchCallback_id = 0;
+static jclass g_benchClass = NULL;
+static JavaVM *g_vm = NULL;
+
+static void detachThread (void *env)
+{
+    /* Called at the exit of a thread attached by ARSTREAM_JNI_GetEnv */
+    if ((env != NULL) && (g_attachVm != NULL))
+    {
+        (*g_attachVm)->DetachCurrentThread(g_attachVm);
+    }
+}
+
+static void createAttachKey (void)
+{
+    if (pthread_key_create (&g_attachKey, detachThread) == 0)
+    {
+        g_attachKeyValid = 1;
+    }
+    else
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Unable to create the thread attachment key, threads will be attached for each callback");
+    }
+}
+
+JNIEnv* ARSTREAM_JNI_GetEnv (JavaVM *vm)
+{
+    JNIEnv *env = NULL;
+    int envStatus;
+    JavaVMAttachArgs args;
+
+    pthread_once (&g_attachKeyOnce, createAttachKey);
+    if (g_attachKeyValid == 1)
+    {
+        env = (JNIEnv *)pthread_getspecific (g_attachKey);
+        if (env != NULL)
+        {
+            return env;
+        }
+    }
+
+    envStatus = (*vm)->GetEnv(vm, (void **)&env, JNI_VERSION_1_6);
+    if (envStatus == JNI_OK)
+    {
+        /* Attached by the application (e.g. a java thread running one of the Runnables) */
+        return env;
+    }
+    else if (envStatus != JNI_EDETACHED)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Error %d while getting JNI Environment", envStatus);
+        return NULL;
+    }
+
+    if (g_attachKeyValid == 0)
+    {
+        /* Without the key, the caller can not know when to detach : do not attach at all */
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Unable to attach thread to VM");
+        return NULL;
+    }
+
+    args.version = JNI_VERSION_1_6;
+    args.name = JNI_ATTACHED_THREAD_NAME;
+    args.group = NULL;
+    if ((*vm)->AttachCurrentThreadAsDaemon(vm, &env, &args) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Unable to attach thread to VM");
+        return NULL;
+    }
+    g_attachVm = vm;
+    if (pthread_setspecific (g_attachKey, env) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Unable to keep the thread attached to VM");
+        (*vm)->DetachCurrentThread(vm);
+        return NULL;
+    }
+
+    return env;
+}
+
+int ARSTREAM_JNI_Slots_Init (JNIEnv *env, jobjectArray buffers, ARSTREAM_JNI_Slots_t *slots)
+{
+    jsize nbSlots;
+    int i;
+
+    slots->nbSlots = 0;
+    slots->addresses = NULL;
+    slots->capacities = NULL;
+    if (buffers == NULL)
+    {
+        return -1;
+    }
+    nbSlots = (*env)->GetArrayLength(env, buffers);
+    if (nbSlots <= 0)
+    {
+        return -1;
+    }
+
+    slots->addresses = malloc (nbSlots * sizeof (uint8_t *));
+    slots->capacities = malloc (nbSlots * sizeof (uint32_t));
+    if ((slots->addresses == NULL) || (slots->capacities == NULL))
+    {
+        ARSTREAM_JNI_Slots_Free (slots);
+        return -1;
+    }
+
+    for (i = 0; i < nbSlots; i++)
+    {
+        jobject buffer = (*env)->GetObjectArrayElement(env, buffers, i);
+        uint8_t *address = (buffer != NULL) ? (*env)->GetDirectBufferAddress(env, buffer) : NULL;
+        jlong capacity = (buffer != NULL) ? (*env)->GetDirectBufferCapacity(env, buffer) : -1;
+        if (buffer != NULL)
+        {
+            (*env)->DeleteLocalRef (env, buffer);
+        }
+        if ((address == NULL) || (capacity <= 0))
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Frame slot %d is not a direct ByteBuffer", i);
+            ARSTREAM_JNI_Slots_Free (slots);
+            return -1;
+        }
+        slots->addresses[i] = address;
+        slots->capacities[i] = (capacity > UINT32_MAX) ? UINT32_MAX : (uint32_t)capacity;
+    }
+    slots->nbSlots = nbSlots;
+
+    return 0;
+}
+
+void ARSTREAM_JNI_Slots_Free (ARSTREAM_JNI_Slots_t *slots)
+{
+    free (slots->addresses);
+    free (slots->capacities);
+    slots->addresses = NULL;
+    slots->capacities = NULL;
+    slots->nbSlots = 0;
+}
+
+ARSTREAM_JNI_EventRing_t* ARSTREAM_JNI_EventRing_New (JNIEnv *env, jobject buffer, jint nbRecords)
+{
+    ARSTREAM_JNI_EventRing_t *ring = NULL;
+    void *address = NULL;
+    jlong capacity = 0;
+
+    if ((buffer == NULL) || (nbRecords <= 0) || ((nbRecords & (nbRecords - 1)) != 0))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Invalid number of events %d (must be a power of two)", nbRecords);
+        return NULL;
+    }
+    address = (*env)->GetDirectBufferAddress(env, buffer);
+    capacity = (*env)->GetDirectBufferCapacity(env, buffer);
+    if ((address == NULL) || (capacity < (jlong)nbRecords * ARSTREAM_JNI_EVENT_NB_FIELDS * sizeof (int32_t)))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "The events buffer is not a direct ByteBuffer of %d events", nbRecords);
+        return NULL;
+    }
+
+    ring = calloc (1, sizeof (ARSTREAM_JNI_EventRing_t));
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+    if (pthread_mutex_init (&ring->mutex, NULL) != 0)
+    {
+        free (ring);
+        return NULL;
+    }
+    ring->records = (int32_t *)address;
+    ring->nbRecords = nbRecords;
+
+    return ring;
+}
+
+void ARSTREAM_JNI_EventRing_Delete (ARSTREAM_JNI_EventRing_t **ring)
+{
+    if ((ring != NULL) && (*ring != NULL))
+    {
+        pthread_mutex_destroy (&(*ring)->mutex);
+        free (*ring);
+        *ring = NULL;
+    }
+}
+
+int ARSTREAM_JNI_EventRing_PushLocked (ARSTREAM_JNI_EventRing_t *ring, const int32_t *record, uint32_t nbReserved)
+{
+    /* The records of the last drain are still read by the Java side : they count as used */
+    if ((uint64_t)(ring->writeIndex - ring->readIndex) + nbReserved >= ring->nbRecords)
+    {
+        ring->nbDropped++;
+        return -1;
+    }
+    memcpy (&ring->records[(ring->writeIndex & (ring->nbRecords - 1)) * ARSTREAM_JNI_EVENT_NB_FIELDS], record, ARSTREAM_JNI_EVENT_NB_FIELDS * sizeof (int32_t));
+    ring->writeIndex++;
+    return 0;
+}
+
+jint ARSTREAM_JNI_EventRing_DrainLocked (ARSTREAM_JNI_EventRing_t *ring)
+{
+    ring->readIndex += ring->nbDrained;
+    ring->nbDrained = ring->writeIndex - ring->readIndex;
+    return (jint)ring->nbDrained;
+}
+
+jlong* ARSTREAM_JNI_Stats_PutHistogram (jlong *values, const ARSTREAM_Histogram_t *histogram)
+{
+    int i;
+    *values++ = (jlong)histogram->count;
+    *values++ = (jlong)histogram->sum;
+    /* An empty histogram has a UINT32_MAX min : report 0, like the percentiles */
+    *values++ = (histogram->count > 0) ? (jlong)histogram->min : 0;
+    *values++ = (jlong)histogram->max;
+    for (i = 0; i < ARSTREAM_HISTOGRAM_NB_BUCKETS; i++)
+    {
+        *values++ = (jlong)histogram->buckets [i];
+    }
+    return values;
+}
+
+/*
+ * Stats layout, for ARStreamStats
+ */
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamStats_nativeGetNbBuckets (JNIEnv *env, jclass clazz)
+{
+    return ARSTREAM_HISTOGRAM_NB_BUCKETS;
+}
+
+JNIEXPORT void JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamStats_nativeGetBucketLowerBounds (JNIEnv *env, jclass clazz, jlongArray lowerBounds)
+{
+    jlong bounds [ARSTREAM_HISTOGRAM_NB_BUCKETS];
+    int i;
+
+    if ((lowerBounds == NULL) ||
+        ((*env)->GetArrayLength (env, lowerBounds) < ARSTREAM_HISTOGRAM_NB_BUCKETS))
+    {
+        return;
+    }
+    for (i = 0; i < ARSTREAM_HISTOGRAM_NB_BUCKETS; i++)
+    {
+        bounds [i] = (jlong)ARSTREAM_Histogram_GetBucketLowerBound (i);
+    }
+    (*env)->SetLongArrayRegion (env, lowerBounds, 0, ARSTREAM_HISTOGRAM_NB_BUCKETS, bounds);
+}
+
+/*
+ * Callback round-trip benchmark
+ */
+
+typedef struct {
+    int nbCalls;
+    int persistentAttach;
+    jlong nsPerCall;
+} ARSTREAM_JNI_BenchParams_t;
+
+static jlong getTimeNs (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (jlong)ts.tv_sec * 1000000000LL + (jlong)ts.tv_nsec;
+}
+
+static void* benchThread (void *param)
+{
+    ARSTREAM_JNI_BenchParams_t *params = (ARSTREAM_JNI_BenchParams_t *)param;
+    JNIEnv *env = NULL;
+    jlong start, end;
+    int i;
+
+    params->nsPerCall = -1;
+    start = getTimeNs ();
+    for (i = 0; i < params->nbCalls; i++)
+    {
+        if (params->persistentAttach == 1)
+        {
+            /* What the sender and reader callbacks do now */
+            env = ARSTREAM_JNI_GetEnv (g_vm);
+            if (env == NULL)
+            {
+                return NULL;
+            }
+            (*env)->CallStaticVoidMethod(env, g_benchClass, g_benchCallback_id);
+        }
+        else
+        {
+            /* What the sender and reader callbacks did before : attach and detach around each call */
+            if ((*g_vm)->AttachCurrentThread(g_vm, &env, NULL) != 0)
+            {
+                return NULL;
+            }
+            (*env)->CallStaticVoidMethod(env, g_benchClass, g_benchCallback_id);
+            (*g_vm)->DetachCurrentThread(g_vm);
+        }
+    }
+    end = getTimeNs ();
+    params->nsPerCall = (end - start) / params->nbCalls;
+
+    return NULL;
+}
+
+JNIEXPORT void JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamBenchmark_nativeInitClass (JNIEnv *env, jclass clazz)
+{
+    jint res = (*env)->GetJavaVM(env, &g_vm);
+    if (res < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Unable to get JavaVM pointer");
+    }
+    g_benchClass = (jclass)(*env)->NewGlobalRef(env, clazz);
+    g_benchCallback_id = (*env)->GetStaticMethodID (env, clazz, "benchCallback", "()V");
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamBenchmark_nativeCallbackRoundTrip (JNIEnv *env, jclass clazz, jint nbCalls, jboolean persistentAttach)
+{
+    ARSTREAM_JNI_BenchParams_t params;
+    pthread_t thread;
+
+    if ((nbCalls <= 0) || (g_vm == NULL) || (g_benchCallback_id == 0))
+    {
+        return -1;
+    }
+    params.nbCalls = nbCalls;
+    params.persistentAttach = (persistentAttach == JNI_TRUE) ? 1 : 0;
+    params.nsPerCall = -1;
+
+    /* A native thread, never attached by the application, like the network threads of the library */
+    if (pthread_create (&thread, NULL, benchThread, &params) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_TAG, "Unable to create the benchmark thread");
+        return -1;
+    }
+    pthread_join (thread, NULL);
+
+    return params.nsPerCall;
+}
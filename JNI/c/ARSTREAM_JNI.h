@@ -0,0 +1,189 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_JNI.h
+ * @brief Helpers shared by the JNI wrappers
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_JNI_H_
+#define _ARSTREAM_JNI_H_
+
+#include <jni.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <libARStream/ARSTREAM_Histogram.h>
+
+/**
+ * @brief Number of int32 fields of an event record (see eARSTREAM_JNI_EVENT_FIELD)
+ */
+#define ARSTREAM_JNI_EVENT_NB_FIELDS (6)
+
+/**
+ * @brief Fields of an event record, as read by the Java side
+ */
+typedef enum {
+    ARSTREAM_JNI_EVENT_FIELD_CAUSE = 0, /**< Sender status or reader cause */
+    ARSTREAM_JNI_EVENT_FIELD_SLOT, /**< Index of the frame slot, or -1 */
+    ARSTREAM_JNI_EVENT_FIELD_FRAME_SIZE, /**< Size of the frame, in bytes */
+    ARSTREAM_JNI_EVENT_FIELD_IS_FLUSH, /**< 1 for flush frames, 0 otherwise */
+    ARSTREAM_JNI_EVENT_FIELD_NB_SKIPPED, /**< Number of skipped frames */
+    ARSTREAM_JNI_EVENT_FIELD_RESERVED, /**< Zero */
+} eARSTREAM_JNI_EVENT_FIELD;
+
+/**
+ * @brief Number of jlong values of an histogram in a stats array : count, sum, min, max, then the buckets
+ */
+#define ARSTREAM_JNI_STATS_HISTOGRAM_SIZE (4 + ARSTREAM_HISTOGRAM_NB_BUCKETS)
+
+/**
+ * @brief Number of jlong values of a stats array
+ * A stats array holds the counters, the estimated efficiency (in millionths), then the histograms
+ */
+#define ARSTREAM_JNI_STATS_SIZE(nbCounters, nbHistograms) ((nbCounters) + 1 + ((nbHistograms) * ARSTREAM_JNI_STATS_HISTOGRAM_SIZE))
+
+/**
+ * @brief Frame slots : direct ByteBuffers given once by the application, and then designated by their index
+ * The addresses are read at creation, so that frames cross the JNI boundary as a slot index,
+ * without any array allocation, boxing or map lookup.
+ */
+typedef struct {
+    int nbSlots; /**< Number of slots (0 : no slot) */
+    uint8_t **addresses; /**< Address of each slot */
+    uint32_t *capacities; /**< Capacity of each slot, in bytes */
+} ARSTREAM_JNI_Slots_t;
+
+/**
+ * @brief Ring of events, stored in a direct ByteBuffer shared with the Java side
+ * The network threads push the events, and the Java side reads them in place, after one
+ * native call (ARSTREAM_JNI_EventRing_DrainLocked()) per batch. The records given by a drain
+ * stay untouched until the next drain. Java is never called from the network threads : when the
+ * ring is full, the event is dropped and counted.
+ */
+typedef struct {
+    int32_t *records; /**< Records, in the direct ByteBuffer */
+    uint32_t nbRecords; /**< Number of records (a power of two) */
+    uint32_t writeIndex; /**< Index of the next record to write */
+    uint32_t readIndex; /**< Index of the oldest record which was not released by a drain */
+    uint32_t nbDrained; /**< Number of records given to the Java side by the last drain */
+    uint64_t nbDropped; /**< Number of events dropped because the ring was full */
+    pthread_mutex_t mutex; /**< Protects the indexes, and the state of the caller if needed */
+} ARSTREAM_JNI_EventRing_t;
+
+/**
+ * @brief Gets the JNIEnv of the calling thread, attaching the thread to the VM if needed
+ * A thread attached by this function stays attached (as a daemon) until it exits : a pthread
+ * key destructor detaches it then. The library owned threads thus pay the attachment, and
+ * the allocation of its java.lang.Thread, only once, instead of once per callback.
+ * Threads already attached by the application are left as they are.
+ * @param vm The Java VM
+ * @return The JNIEnv of the thread, or NULL if the thread can not be attached
+ */
+JNIEnv* ARSTREAM_JNI_GetEnv (JavaVM *vm);
+
+/**
+ * @brief Reads the addresses and capacities of an array of direct ByteBuffers
+ * The application must keep a reference on the buffers as long as the slots are used
+ * @param env The JNIEnv of the calling thread
+ * @param buffers Array of direct ByteBuffers
+ * @param[out] slots The slots to fill
+ * @return 0 on success, -1 if the array is empty, or holds a non direct buffer (slots is then empty)
+ */
+int ARSTREAM_JNI_Slots_Init (JNIEnv *env, jobjectArray buffers, ARSTREAM_JNI_Slots_t *slots);
+
+/**
+ * @brief Frees the slots tables (not the buffers, which belong to the application)
+ * @param slots The slots to free
+ */
+void ARSTREAM_JNI_Slots_Free (ARSTREAM_JNI_Slots_t *slots);
+
+/**
+ * @brief Creates an event ring in a direct ByteBuffer
+ * @param env The JNIEnv of the calling thread
+ * @param buffer Direct ByteBuffer of at least (nbRecords * ARSTREAM_JNI_EVENT_NB_FIELDS * 4) bytes, in native order
+ * @param nbRecords Number of records (a power of two)
+ * @return The ring, or NULL if the parameters are invalid
+ */
+ARSTREAM_JNI_EventRing_t* ARSTREAM_JNI_EventRing_New (JNIEnv *env, jobject buffer, jint nbRecords);
+
+/**
+ * @brief Deletes an event ring (not its buffer, which belongs to the application)
+ * @param ring Pointer to the ring to delete. Set to NULL
+ */
+void ARSTREAM_JNI_EventRing_Delete (ARSTREAM_JNI_EventRing_t **ring);
+
+/**
+ * @brief Pushes an event in a ring. The caller must hold ring->mutex
+ * @param ring The ring
+ * @param record The ARSTREAM_JNI_EVENT_NB_FIELDS fields of the event
+ * @param nbReserved Number of records which must stay free after this one, for more important events
+ * @return 0 on success, -1 if the ring is full (the event is then dropped, and counted in ring->nbDropped)
+ */
+int ARSTREAM_JNI_EventRing_PushLocked (ARSTREAM_JNI_EventRing_t *ring, const int32_t *record, uint32_t nbReserved);
+
+/**
+ * @brief Releases the records of the previous drain, and gives the pending ones to the Java side
+ * The caller must hold ring->mutex. The Java side reads the records from the index following
+ * the ones of the previous drain (both sides start at 0), modulo the number of records
+ * @param ring The ring
+ * @return The number of records to read
+ */
+jint ARSTREAM_JNI_EventRing_DrainLocked (ARSTREAM_JNI_EventRing_t *ring);
+
+/**
+ * @brief Writes an histogram in a stats array
+ * @param values Where to write the ARSTREAM_JNI_STATS_HISTOGRAM_SIZE values of the histogram
+ * @param histogram The histogram
+ * @return The position following the histogram in the stats array
+ */
+jlong* ARSTREAM_JNI_Stats_PutHistogram (jlong *values, const ARSTREAM_Histogram_t *histogram);
+
+/**
+ * @brief Gets the index of the slot holding a frame
+ * @param slots The slots
+ * @param address Address of the frame
+ * @return The index of the slot, or -1 if the frame is not in a slot
+ */
+static inline int ARSTREAM_JNI_Slots_Find (const ARSTREAM_JNI_Slots_t *slots, const uint8_t *address)
+{
+    int i;
+    for (i = 0; i < slots->nbSlots; i++)
+    {
+        if (slots->addresses[i] == address)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#endif /* _ARSTREAM_JNI_H_ */
@@ -29,38 +29,159 @@
     SUCH DAMAGE.
 */
 #include <jni.h>
+#include <stdlib.h>
 #include <libARStream/ARSTREAM_Reader.h>
 #include <libARSAL/ARSAL_Print.h>
 
+#include "ARSTREAM_JNI.h"
+
 #define JNI_READER_TAG "ARSTREAM_JNIReader"
 
 static jmethodID g_cbWrapper_id = 0;
+static jmethodID g_slotCbWrapper_id = 0;
 static JavaVM *g_vm = NULL;
 
-static uint8_t* internalCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *thizz)
+/* Custom pointer of the native reader */
+typedef struct {
+    jobject thizz; /* Global reference to the ARStreamReader */
+    ARSTREAM_JNI_Slots_t slots; /* Frame slots, empty when the frames are ARNativeData */
+    ARSTREAM_JNI_EventRing_t *events; /* Batched events, NULL when the events are delivered by upcalls */
+    uint64_t freeSlots; /* Batched events : bitfield of the slots owned by neither the reader nor the application (under events->mutex) */
+    int readerSlot; /* Batched events : slot used by the reader (under events->mutex) */
+    pthread_mutex_t mutex; /* Protects threadsStarted, so that events can not be set once the threads run */
+    int threadsStarted; /* 1 once a Runnable was run */
+} ARSTREAM_JNIReader_t;
+
+/* Marks the threads as started : after this, the events can not be changed anymore */
+static void setThreadsStarted (ARSTREAM_JNIReader_t *jniReader)
 {
-    JNIEnv *env = NULL;
-    int wasAlreadyAttached = 1;
-    int envStatus = (*g_vm)->GetEnv(g_vm, (void **)&env, JNI_VERSION_1_6);
-    if (envStatus == JNI_EDETACHED)
+    pthread_mutex_lock (&jniReader->mutex);
+    jniReader->threadsStarted = 1;
+    pthread_mutex_unlock (&jniReader->mutex);
+}
+
+/* Batched events : takes the first free slot of at least minCapacity bytes, or returns -1 */
+static int takeFreeSlot (ARSTREAM_JNIReader_t *jniReader, uint32_t minCapacity)
+{
+    int slot;
+    for (slot = 0; slot < jniReader->slots.nbSlots; slot++)
     {
-        wasAlreadyAttached = 0;
-        if ((*g_vm)->AttachCurrentThread(g_vm, &env, NULL) != 0)
+        if (((jniReader->freeSlots & (1ULL << slot)) != 0) &&
+            (jniReader->slots.capacities[slot] >= minCapacity))
         {
-            ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_READER_TAG, "Unable to attach thread to VM");
-            *newBufferCapacity = 0;
-            return NULL;
+            jniReader->freeSlots &= ~(1ULL << slot);
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Batched events : the next slots are chosen here, among the ones released by the application
+ * in the drains, and the complete frames are pushed in the event ring. Java is never called.
+ * When no slot is free, the complete frame is dropped (its slot is reused, and its event has no
+ * slot), and a frame too small for the current slot is skipped. When the ring is full, the frame
+ * and its event are dropped, and the event is counted in the ring.
+ */
+static uint8_t* batchedCallback (ARSTREAM_JNIReader_t *jniReader, eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity)
+{
+    int32_t record [ARSTREAM_JNI_EVENT_NB_FIELDS] = { 0 };
+    int slot = ARSTREAM_JNI_Slots_Find (&jniReader->slots, framePointer);
+    int nextSlot = -1;
+    int deliver = 0;
+
+    pthread_mutex_lock (&jniReader->events->mutex);
+    switch (cause)
+    {
+    case ARSTREAM_READER_CAUSE_FRAME_COMPLETE:
+    case ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE:
+        deliver = 1;
+        nextSlot = takeFreeSlot (jniReader, 0);
+        if (nextSlot < 0)
+        {
+            nextSlot = slot;
+            slot = -1;
         }
+        break;
+    case ARSTREAM_READER_CAUSE_FRAME_TOO_SMALL:
+        nextSlot = takeFreeSlot (jniReader, *newBufferCapacity);
+        if (nextSlot >= 0)
+        {
+            jniReader->readerSlot = nextSlot;
+        }
+        break;
+    case ARSTREAM_READER_CAUSE_COPY_COMPLETE:
+    case ARSTREAM_READER_CAUSE_CANCEL:
+        /* The slot goes back to the free ones, unless the reader still uses it (no free slot after a too small) */
+        if ((slot >= 0) && ((slot != jniReader->readerSlot) || (cause == ARSTREAM_READER_CAUSE_CANCEL)))
+        {
+            jniReader->freeSlots |= (1ULL << slot);
+        }
+        break;
+    default:
+        break;
+    }
+    if (deliver == 1)
+    {
+        record[ARSTREAM_JNI_EVENT_FIELD_CAUSE] = (int32_t)cause;
+        record[ARSTREAM_JNI_EVENT_FIELD_SLOT] = slot;
+        record[ARSTREAM_JNI_EVENT_FIELD_FRAME_SIZE] = (int32_t)frameSize;
+        record[ARSTREAM_JNI_EVENT_FIELD_IS_FLUSH] = (isFlushFrame == 1) ? 1 : 0;
+        record[ARSTREAM_JNI_EVENT_FIELD_NB_SKIPPED] = numberOfSkippedFrames;
+        if ((ARSTREAM_JNI_EventRing_PushLocked (jniReader->events, record, 0) != 0) &&
+            (slot >= 0))
+        {
+            /* Ring full : the frame is dropped, and the reader keeps its slot */
+            jniReader->freeSlots |= (1ULL << nextSlot);
+            nextSlot = slot;
+        }
+        jniReader->readerSlot = nextSlot;
+    }
+    pthread_mutex_unlock (&jniReader->events->mutex);
+
+    if (nextSlot < 0)
+    {
+        *newBufferCapacity = 0;
+        return framePointer;
+    }
+    *newBufferCapacity = jniReader->slots.capacities[nextSlot];
+    return jniReader->slots.addresses[nextSlot];
+}
+
+static uint8_t* internalCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom)
+{
+    ARSTREAM_JNIReader_t *jniReader = (ARSTREAM_JNIReader_t *)custom;
+    JNIEnv *env = NULL;
+
+    if (jniReader->events != NULL)
+    {
+        return batchedCallback (jniReader, cause, framePointer, frameSize, numberOfSkippedFrames, isFlushFrame, newBufferCapacity);
     }
-    else if (envStatus != JNI_OK)
+
+    /* Library threads stay attached once attached : see ARSTREAM_JNI_GetEnv */
+    env = ARSTREAM_JNI_GetEnv (g_vm);
+    if (env == NULL)
     {
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_READER_TAG, "Error %d while getting JNI Environment", envStatus);
         *newBufferCapacity = 0;
         return NULL;
     }
 
     jboolean isFlush = (isFlushFrame == 1) ? JNI_TRUE : JNI_FALSE;
-    jlongArray newNativeDataInfos = (*env)->CallObjectMethod(env, (jobject)thizz, g_cbWrapper_id, (jint)cause, (jlong)(intptr_t)framePointer, (jint)frameSize, isFlush, (jint)numberOfSkippedFrames, (jint)*newBufferCapacity);
+    if (jniReader->slots.nbSlots > 0)
+    {
+        /* Slots : the next buffer is given as a slot index, no array to unpack */
+        jint slot = ARSTREAM_JNI_Slots_Find (&jniReader->slots, framePointer);
+        jint nextSlot = (*env)->CallIntMethod(env, jniReader->thizz, g_slotCbWrapper_id, (jint)cause, slot, (jint)frameSize, isFlush, (jint)numberOfSkippedFrames, (jint)*newBufferCapacity);
+        if ((nextSlot < 0) || (nextSlot >= jniReader->slots.nbSlots))
+        {
+            *newBufferCapacity = 0;
+            return NULL;
+        }
+        *newBufferCapacity = jniReader->slots.capacities[nextSlot];
+        return jniReader->slots.addresses[nextSlot];
+    }
+
+    jlongArray newNativeDataInfos = (*env)->CallObjectMethod(env, jniReader->thizz, g_cbWrapper_id, (jint)cause, (jlong)(intptr_t)framePointer, (jint)frameSize, isFlush, (jint)numberOfSkippedFrames, (jint)*newBufferCapacity);
 
     uint8_t *retVal = NULL;
     *newBufferCapacity = 0;
@@ -74,11 +195,6 @@ static uint8_t* internalCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePo
         (*env)->DeleteLocalRef (env, newNativeDataInfos);
     }
 
-    if (wasAlreadyAttached == 0)
-    {
-        (*g_vm)->DetachCurrentThread(g_vm);
-    }
-
     return retVal;
 }
 
@@ -91,6 +207,7 @@ Java_com_parrot_arsdk_arstream_ARStreamReader_nativeInitClass (JNIEnv *env, jcla
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_READER_TAG, "Unable to get JavaVM pointer");
     }
     g_cbWrapper_id = (*env)->GetMethodID (env, clazz, "callbackWrapper", "(IJIZII)[J");
+    g_slotCbWrapper_id = (*env)->GetMethodID (env, clazz, "slotCallbackWrapper", "(IIIZII)I");
 }
 
 JNIEXPORT jint JNICALL
@@ -111,29 +228,72 @@ Java_com_parrot_arsdk_arstream_ARStreamReader_nativeSetAckBufferParams (JNIEnv *
     ARSTREAM_Reader_InitStreamAckBuffer ((ARNETWORK_IOBufferParam_t *)(intptr_t)cParams, id);
 }
 
-JNIEXPORT jlong JNICALL
-Java_com_parrot_arsdk_arstream_ARStreamReader_nativeConstructor (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, jlong frameBuffer, jint frameBufferSize, jint maxFragmentSize, jint maxAckInterval)
+static jlong createReader (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, uint8_t *frameBuffer, uint32_t frameBufferSize, jint maxFragmentSize, jint maxAckInterval, ARSTREAM_JNIReader_t *jniReader)
 {
     eARSTREAM_ERROR err = ARSTREAM_OK;
-    jobject g_thizz = (*env)->NewGlobalRef(env, thizz);
-    ARSTREAM_Reader_t *retReader = ARSTREAM_Reader_New ((ARNETWORK_Manager_t *)(intptr_t)cNetManager, dataBufferId, ackBufferId, internalCallback, (uint8_t *)(intptr_t)frameBuffer, frameBufferSize, maxFragmentSize, maxAckInterval, (void *)g_thizz, &err);
+    ARSTREAM_Reader_t *retReader = NULL;
+
+    if (pthread_mutex_init (&jniReader->mutex, NULL) != 0)
+    {
+        ARSTREAM_JNI_Slots_Free (&jniReader->slots);
+        free (jniReader);
+        return 0;
+    }
+    jniReader->thizz = (*env)->NewGlobalRef(env, thizz);
+    retReader = ARSTREAM_Reader_New ((ARNETWORK_Manager_t *)(intptr_t)cNetManager, dataBufferId, ackBufferId, internalCallback, frameBuffer, frameBufferSize, maxFragmentSize, maxAckInterval, (void *)jniReader, &err);
 
     if (err != ARSTREAM_OK)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_READER_TAG, "Error while creating reader : %s", ARSTREAM_Error_ToString (err));
+        (*env)->DeleteGlobalRef(env, jniReader->thizz);
+        ARSTREAM_JNI_Slots_Free (&jniReader->slots);
+        pthread_mutex_destroy (&jniReader->mutex);
+        free (jniReader);
     }
     return (jlong)(intptr_t)retReader;
 }
 
+JNIEXPORT jlong JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeConstructor (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, jlong frameBuffer, jint frameBufferSize, jint maxFragmentSize, jint maxAckInterval)
+{
+    ARSTREAM_JNIReader_t *jniReader = calloc (1, sizeof (ARSTREAM_JNIReader_t));
+    if (jniReader == NULL)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_READER_TAG, "Unable to allocate the reader context");
+        return 0;
+    }
+    return createReader (env, thizz, cNetManager, dataBufferId, ackBufferId, (uint8_t *)(intptr_t)frameBuffer, frameBufferSize, maxFragmentSize, maxAckInterval, jniReader);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeSlotConstructor (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, jobjectArray frameSlots, jint maxFragmentSize, jint maxAckInterval)
+{
+    ARSTREAM_JNIReader_t *jniReader = calloc (1, sizeof (ARSTREAM_JNIReader_t));
+    if (jniReader == NULL)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_READER_TAG, "Unable to allocate the reader context");
+        return 0;
+    }
+    if (ARSTREAM_JNI_Slots_Init (env, frameSlots, &jniReader->slots) != 0)
+    {
+        free (jniReader);
+        return 0;
+    }
+    /* The first frame is received in the first slot */
+    return createReader (env, thizz, cNetManager, dataBufferId, ackBufferId, jniReader->slots.addresses[0], jniReader->slots.capacities[0], maxFragmentSize, maxAckInterval, jniReader);
+}
+
 JNIEXPORT void JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamReader_nativeRunDataThread (JNIEnv *env, jobject thizz, jlong cReader)
 {
+    setThreadsStarted ((ARSTREAM_JNIReader_t *)ARSTREAM_Reader_GetCustom ((ARSTREAM_Reader_t *)(intptr_t)cReader));
     ARSTREAM_Reader_RunDataThread ((void *)(intptr_t)cReader);
 }
 
 JNIEXPORT void JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamReader_nativeRunAckThread (JNIEnv *env, jobject thizz, jlong cReader)
 {
+    setThreadsStarted ((ARSTREAM_JNIReader_t *)ARSTREAM_Reader_GetCustom ((ARSTREAM_Reader_t *)(intptr_t)cReader));
     ARSTREAM_Reader_RunAckThread ((void *)(intptr_t)cReader);
 }
 
@@ -148,20 +308,24 @@ Java_com_parrot_arsdk_arstream_ARStreamReader_nativeDispose (JNIEnv *env, jobjec
 {
     jboolean retVal = JNI_TRUE;
     ARSTREAM_Reader_t *reader = (ARSTREAM_Reader_t *)(intptr_t)cReader;
-    void *ref = ARSTREAM_Reader_GetCustom(reader);
+    ARSTREAM_JNIReader_t *jniReader = (ARSTREAM_JNIReader_t *)ARSTREAM_Reader_GetCustom(reader);
     eARSTREAM_ERROR err = ARSTREAM_Reader_Delete (&reader);
     if (err != ARSTREAM_OK)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_READER_TAG, "Unable to delete reader : %s", ARSTREAM_Error_ToString (err));
         retVal = JNI_FALSE;
     }
-    if (retVal == JNI_TRUE && ref != NULL)
+    if (retVal == JNI_TRUE && jniReader != NULL)
     {
-        (*env)->DeleteGlobalRef(env, (jobject)ref);
+        (*env)->DeleteGlobalRef(env, jniReader->thizz);
 	if ((*env)->ExceptionOccurred(env) != NULL)
 	{
 	    (*env)->ExceptionDescribe(env);
 	}
+        ARSTREAM_JNI_Slots_Free (&jniReader->slots);
+        ARSTREAM_JNI_EventRing_Delete (&jniReader->events);
+        pthread_mutex_destroy (&jniReader->mutex);
+        free (jniReader);
     }
     return retVal;
 }
@@ -171,3 +335,141 @@ Java_com_parrot_arsdk_arstream_ARStreamReader_nativeGetEfficiency (JNIEnv *env,
 {
     return ARSTREAM_Reader_GetEstimatedEfficiency ((ARSTREAM_Reader_t *)(intptr_t)cReader);
 }
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeGetNbCounters (JNIEnv *env, jclass clazz)
+{
+    return ARSTREAM_READER_COUNTER_MAX;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeGetNbHistograms (JNIEnv *env, jclass clazz)
+{
+    return ARSTREAM_READER_HISTOGRAM_MAX;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeGetStats (JNIEnv *env, jobject thizz, jlong cReader, jlongArray stats)
+{
+    ARSTREAM_Reader_t *reader = (ARSTREAM_Reader_t *)(intptr_t)cReader;
+    jlong values [ARSTREAM_JNI_STATS_SIZE (ARSTREAM_READER_COUNTER_MAX, ARSTREAM_READER_HISTOGRAM_MAX)];
+    jlong *value = values;
+    ARSTREAM_Histogram_t histogram;
+    int i;
+
+    if ((reader == NULL) ||
+        (stats == NULL) ||
+        ((*env)->GetArrayLength (env, stats) < (jsize)(sizeof (values) / sizeof (values [0]))))
+    {
+        return JNI_FALSE;
+    }
+
+    /* Everything is copied natively, then given to Java by a single JNI call */
+    for (i = 0; i < ARSTREAM_READER_COUNTER_MAX; i++)
+    {
+        *value++ = (jlong)ARSTREAM_Reader_GetCounter (reader, i);
+    }
+    *value++ = (jlong)(ARSTREAM_Reader_GetEstimatedEfficiency (reader) * 1000000.f);
+    for (i = 0; i < ARSTREAM_READER_HISTOGRAM_MAX; i++)
+    {
+        ARSTREAM_Reader_GetHistogram (reader, i, &histogram);
+        value = ARSTREAM_JNI_Stats_PutHistogram (value, &histogram);
+    }
+    (*env)->SetLongArrayRegion (env, stats, 0, (jsize)(sizeof (values) / sizeof (values [0])), values);
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeSetIncompleteFramesDelivery (JNIEnv *env, jobject thizz, jlong cReader, jint minPercentOfFragments, jint maxWaitTimeMs)
+{
+    eARSTREAM_ERROR err = ARSTREAM_Reader_SetIncompleteFramesDelivery ((ARSTREAM_Reader_t *)(intptr_t)cReader, minPercentOfFragments, maxWaitTimeMs);
+    return (err == ARSTREAM_OK) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeSetSkipFramesUntilFlush (JNIEnv *env, jobject thizz, jlong cReader, jboolean enable)
+{
+    eARSTREAM_ERROR err = ARSTREAM_Reader_SetSkipFramesUntilFlush ((ARSTREAM_Reader_t *)(intptr_t)cReader, (enable == JNI_TRUE) ? 1 : 0);
+    return (err == ARSTREAM_OK) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeSetAutomaticFlushFrameRequests (JNIEnv *env, jobject thizz, jlong cReader, jint requestIntervalMs)
+{
+    eARSTREAM_ERROR err = ARSTREAM_Reader_SetAutomaticFlushFrameRequests ((ARSTREAM_Reader_t *)(intptr_t)cReader, requestIntervalMs);
+    return (err == ARSTREAM_OK) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeRequestFlushFrame (JNIEnv *env, jobject thizz, jlong cReader)
+{
+    eARSTREAM_ERROR err = ARSTREAM_Reader_RequestFlushFrame ((ARSTREAM_Reader_t *)(intptr_t)cReader);
+    return (err == ARSTREAM_OK) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeSetBatchedEvents (JNIEnv *env, jobject thizz, jlong cReader, jobject eventsBuffer, jint nbEvents)
+{
+    ARSTREAM_JNIReader_t *jniReader = (ARSTREAM_JNIReader_t *)ARSTREAM_Reader_GetCustom ((ARSTREAM_Reader_t *)(intptr_t)cReader);
+    int nbSlots = (jniReader != NULL) ? jniReader->slots.nbSlots : 0;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((nbSlots == 0) || (nbSlots > 64))
+    {
+        return (jint)ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    /* The network threads read events without lock : it can only be set before they run */
+    pthread_mutex_lock (&jniReader->mutex);
+    if ((jniReader->threadsStarted == 1) || (jniReader->events != NULL))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+    else
+    {
+        jniReader->events = ARSTREAM_JNI_EventRing_New (env, eventsBuffer, nbEvents);
+        if (jniReader->events != NULL)
+        {
+            /* The reader starts in the first slot, the others are free */
+            jniReader->readerSlot = 0;
+            jniReader->freeSlots = ((nbSlots == 64) ? ~0ULL : ((1ULL << nbSlots) - 1)) & ~1ULL;
+        }
+        else
+        {
+            err = ARSTREAM_ERROR_BAD_PARAMETERS;
+        }
+    }
+    pthread_mutex_unlock (&jniReader->mutex);
+    return (jint)err;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeDrainEvents (JNIEnv *env, jobject thizz, jlong cReader, jlong releasedSlots)
+{
+    ARSTREAM_JNIReader_t *jniReader = (ARSTREAM_JNIReader_t *)ARSTREAM_Reader_GetCustom ((ARSTREAM_Reader_t *)(intptr_t)cReader);
+    int nbSlots = (jniReader != NULL) ? jniReader->slots.nbSlots : 0;
+    uint64_t validSlots = (nbSlots == 64) ? ~0ULL : ((1ULL << nbSlots) - 1);
+    jint nbEvents = 0;
+    if ((jniReader == NULL) || (jniReader->events == NULL))
+    {
+        return 0;
+    }
+    pthread_mutex_lock (&jniReader->events->mutex);
+    jniReader->freeSlots |= ((uint64_t)releasedSlots & validSlots & ~(1ULL << jniReader->readerSlot));
+    nbEvents = ARSTREAM_JNI_EventRing_DrainLocked (jniReader->events);
+    pthread_mutex_unlock (&jniReader->events->mutex);
+    return nbEvents;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamReader_nativeGetNbDroppedEvents (JNIEnv *env, jobject thizz, jlong cReader)
+{
+    ARSTREAM_JNIReader_t *jniReader = (ARSTREAM_JNIReader_t *)ARSTREAM_Reader_GetCustom ((ARSTREAM_Reader_t *)(intptr_t)cReader);
+    jlong nbDropped = 0;
+    if ((jniReader == NULL) || (jniReader->events == NULL))
+    {
+        return 0;
+    }
+    pthread_mutex_lock (&jniReader->events->mutex);
+    nbDropped = (jlong)jniReader->events->nbDropped;
+    pthread_mutex_unlock (&jniReader->events->mutex);
+    return nbDropped;
+}
@@ -29,40 +29,74 @@
     SUCH DAMAGE.
 */
 #include <jni.h>
+#include <stdlib.h>
 #include <libARStream/ARSTREAM_Sender.h>
 #include <libARSAL/ARSAL_Print.h>
 
+#include "ARSTREAM_JNI.h"
+
 #define JNI_SENDER_TAG "ARSTREAM_JNISender"
 
 static jmethodID g_cbWrapper_id = 0;
+static jmethodID g_slotCbWrapper_id = 0;
 static JavaVM *g_vm = NULL;
 
+/* Custom pointer of the native sender */
+typedef struct {
+    jobject thizz; /* Global reference to the ARStreamSender */
+    ARSTREAM_JNI_Slots_t slots; /* Frame slots, empty when the frames are ARNativeData */
+    ARSTREAM_JNI_EventRing_t *events; /* Batched events, NULL when the events are delivered by upcalls. Set before the threads run */
+    pthread_mutex_t mutex; /* Protects threadsStarted, so that events can not be set once the threads run */
+    int threadsStarted; /* 1 once a Runnable was run */
+} ARSTREAM_JNISender_t;
+
+/* Events of the slots are never dropped : the application would never get its slot back.
+ * A slot has at most two events in the ring (one given by the last drain, then one pending),
+ * so room is kept for them, and only the other events can be dropped */
+#define ARSTREAM_JNI_SENDER_RESERVED_EVENTS(jniSender) (2 * (uint32_t)(jniSender)->slots.nbSlots)
+
+/* Marks the threads as started : after this, the events can not be changed anymore */
+static void setThreadsStarted (ARSTREAM_JNISender_t *jniSender)
+{
+    pthread_mutex_lock (&jniSender->mutex);
+    jniSender->threadsStarted = 1;
+    pthread_mutex_unlock (&jniSender->mutex);
+}
+
 
-static void internalCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *thizz)
+static void internalCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
 {
+    ARSTREAM_JNISender_t *jniSender = (ARSTREAM_JNISender_t *)custom;
     JNIEnv *env = NULL;
-    int wasAlreadyAttached = 1;
-    int envStatus = (*g_vm)->GetEnv(g_vm, (void **)&env, JNI_VERSION_1_6);
-    if (envStatus == JNI_EDETACHED)
+
+    if (jniSender->events != NULL)
     {
-        wasAlreadyAttached = 0;
-        if ((*g_vm)->AttachCurrentThread(g_vm, &env, NULL) != 0)
-        {
-            ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Unable to attach thread to VM");
-            return;
-        }
+        /* Batched events : no JNI call from the network thread. If the ring is full, the event is dropped */
+        int32_t record [ARSTREAM_JNI_EVENT_NB_FIELDS] = { 0 };
+        record[ARSTREAM_JNI_EVENT_FIELD_CAUSE] = (int32_t)status;
+        record[ARSTREAM_JNI_EVENT_FIELD_SLOT] = ARSTREAM_JNI_Slots_Find (&jniSender->slots, framePointer);
+        record[ARSTREAM_JNI_EVENT_FIELD_FRAME_SIZE] = (int32_t)frameSize;
+        pthread_mutex_lock (&jniSender->events->mutex);
+        ARSTREAM_JNI_EventRing_PushLocked (jniSender->events, record, (record[ARSTREAM_JNI_EVENT_FIELD_SLOT] < 0) ? ARSTREAM_JNI_SENDER_RESERVED_EVENTS (jniSender) : 0);
+        pthread_mutex_unlock (&jniSender->events->mutex);
+        return;
     }
-    else if (envStatus != JNI_OK)
+
+    /* Library threads stay attached once attached : see ARSTREAM_JNI_GetEnv */
+    env = ARSTREAM_JNI_GetEnv (g_vm);
+    if (env == NULL)
     {
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Error %d while getting JNI Environment", envStatus);
         return;
     }
 
-    (*env)->CallVoidMethod(env, (jobject)thizz, g_cbWrapper_id, (jint)status, (jlong)(intptr_t)framePointer, (jint)frameSize);
-
-    if (wasAlreadyAttached == 0)
+    if (jniSender->slots.nbSlots > 0)
+    {
+        jint slot = ARSTREAM_JNI_Slots_Find (&jniSender->slots, framePointer);
+        (*env)->CallVoidMethod(env, jniSender->thizz, g_slotCbWrapper_id, (jint)status, slot);
+    }
+    else
     {
-        (*g_vm)->DetachCurrentThread(g_vm);
+        (*env)->CallVoidMethod(env, jniSender->thizz, g_cbWrapper_id, (jint)status, (jlong)(intptr_t)framePointer, (jint)frameSize);
     }
 
     return;
@@ -95,6 +129,7 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeInitClass (JNIEnv *env, jcla
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Unable to get JavaVM pointer");
     }
     g_cbWrapper_id = (*env)->GetMethodID (env, clazz, "callbackWrapper", "(IJI)V");
+    g_slotCbWrapper_id = (*env)->GetMethodID (env, clazz, "slotCallbackWrapper", "(II)V");
 }
 
 JNIEXPORT void JNICALL
@@ -109,20 +144,57 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSetAckBufferParams (JNIEnv *
     ARSTREAM_Sender_InitStreamAckBuffer ((ARNETWORK_IOBufferParam_t *)(intptr_t)cParams, id);
 }
 
-JNIEXPORT jlong JNICALL
-Java_com_parrot_arsdk_arstream_ARStreamSender_nativeConstructor (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, jint framesBufferSize, jint maxFragmentSize, jint maxNumberOfFragment)
+static jlong createSender (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, jint framesBufferSize, jint maxFragmentSize, jint maxNumberOfFragment, jobjectArray frameSlots)
 {
     eARSTREAM_ERROR err = ARSTREAM_OK;
-    jobject g_thizz = (*env)->NewGlobalRef(env, thizz);
-    ARSTREAM_Sender_t *retSender = ARSTREAM_Sender_New ((ARNETWORK_Manager_t *)(intptr_t)cNetManager, dataBufferId, ackBufferId, internalCallback, framesBufferSize, maxFragmentSize, maxNumberOfFragment, (void *)g_thizz, &err);
+    ARSTREAM_Sender_t *retSender = NULL;
+    ARSTREAM_JNISender_t *jniSender = calloc (1, sizeof (ARSTREAM_JNISender_t));
+
+    if (jniSender == NULL)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Unable to allocate the sender context");
+        return 0;
+    }
+    if ((frameSlots != NULL) &&
+        (ARSTREAM_JNI_Slots_Init (env, frameSlots, &jniSender->slots) != 0))
+    {
+        free (jniSender);
+        return 0;
+    }
+    if (pthread_mutex_init (&jniSender->mutex, NULL) != 0)
+    {
+        ARSTREAM_JNI_Slots_Free (&jniSender->slots);
+        free (jniSender);
+        return 0;
+    }
+
+    jniSender->thizz = (*env)->NewGlobalRef(env, thizz);
+    retSender = ARSTREAM_Sender_New ((ARNETWORK_Manager_t *)(intptr_t)cNetManager, dataBufferId, ackBufferId, internalCallback, framesBufferSize, maxFragmentSize, maxNumberOfFragment, (void *)jniSender, &err);
 
     if (err != ARSTREAM_OK)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Error while creating sender : %s", ARSTREAM_Error_ToString (err));
+        (*env)->DeleteGlobalRef(env, jniSender->thizz);
+        ARSTREAM_JNI_Slots_Free (&jniSender->slots);
+        pthread_mutex_destroy (&jniSender->mutex);
+        free (jniSender);
     }
     return (jlong)(intptr_t)retSender;
 }
 
+JNIEXPORT jlong JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeConstructor (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, jint framesBufferSize, jint maxFragmentSize, jint maxNumberOfFragment)
+{
+    return createSender (env, thizz, cNetManager, dataBufferId, ackBufferId, framesBufferSize, maxFragmentSize, maxNumberOfFragment, NULL);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSlotConstructor (JNIEnv *env, jobject thizz, jlong cNetManager, jint dataBufferId, jint ackBufferId, jobjectArray frameSlots, jint maxFragmentSize, jint maxNumberOfFragment)
+{
+    jint framesBufferSize = (frameSlots != NULL) ? (*env)->GetArrayLength(env, frameSlots) : 0;
+    return createSender (env, thizz, cNetManager, dataBufferId, ackBufferId, framesBufferSize, maxFragmentSize, maxNumberOfFragment, frameSlots);
+}
+
 JNIEXPORT jint JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSetTimeBetweenRetries(JNIEnv *env, jobject thizz, jlong cSender, jint minWaitTimeMs, jint maxWaitTimeMs)
 {
@@ -130,15 +202,24 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSetTimeBetweenRetries(JNIEnv
     return (jint)err;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSetFrameTimestamps(JNIEnv *env, jobject thizz, jlong cSender, jboolean enable)
+{
+    eARSTREAM_ERROR err = ARSTREAM_Sender_SetFrameTimestamps ((ARSTREAM_Sender_t *)(intptr_t)cSender, (enable == JNI_TRUE) ? 1 : 0);
+    return (jint)err;
+}
+
 JNIEXPORT void JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamSender_nativeRunDataThread (JNIEnv *env, jobject thizz, jlong cSender)
 {
+    setThreadsStarted ((ARSTREAM_JNISender_t *)ARSTREAM_Sender_GetCustom ((ARSTREAM_Sender_t *)(intptr_t)cSender));
     ARSTREAM_Sender_RunDataThread ((void *)(intptr_t)cSender);
 }
 
 JNIEXPORT void JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamSender_nativeRunAckThread (JNIEnv *env, jobject thizz, jlong cSender)
 {
+    setThreadsStarted ((ARSTREAM_JNISender_t *)ARSTREAM_Sender_GetCustom ((ARSTREAM_Sender_t *)(intptr_t)cSender));
     ARSTREAM_Sender_RunAckThread ((void *)(intptr_t)cSender);
 }
 
@@ -153,16 +234,20 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeDispose (JNIEnv *env, jobjec
 {
     jboolean retVal = JNI_TRUE;
     ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)(intptr_t)cSender;
-    void *ref = ARSTREAM_Sender_GetCustom (sender);
+    ARSTREAM_JNISender_t *jniSender = (ARSTREAM_JNISender_t *)ARSTREAM_Sender_GetCustom (sender);
     eARSTREAM_ERROR err = ARSTREAM_Sender_Delete (&sender);
     if (err != ARSTREAM_OK)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, JNI_SENDER_TAG, "Unable to delete sender : %s", ARSTREAM_Error_ToString (err));
         retVal = JNI_FALSE;
     }
-    if (retVal == JNI_TRUE && ref != NULL)
+    if (retVal == JNI_TRUE && jniSender != NULL)
     {
-        (*env)->DeleteGlobalRef(env, (jobject)ref);
+        (*env)->DeleteGlobalRef(env, jniSender->thizz);
+        ARSTREAM_JNI_Slots_Free (&jniSender->slots);
+        ARSTREAM_JNI_EventRing_Delete (&jniSender->events);
+        pthread_mutex_destroy (&jniSender->mutex);
+        free (jniSender);
     }
     return retVal;
 }
@@ -173,6 +258,49 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetEfficiency (JNIEnv *env,
     return ARSTREAM_Sender_GetEstimatedEfficiency ((ARSTREAM_Sender_t *)(intptr_t)cSender);
 }
 
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetNbCounters (JNIEnv *env, jclass clazz)
+{
+    return ARSTREAM_SENDER_COUNTER_MAX;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetNbHistograms (JNIEnv *env, jclass clazz)
+{
+    return ARSTREAM_SENDER_HISTOGRAM_MAX;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetStats (JNIEnv *env, jobject thizz, jlong cSender, jlongArray stats)
+{
+    ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)(intptr_t)cSender;
+    jlong values [ARSTREAM_JNI_STATS_SIZE (ARSTREAM_SENDER_COUNTER_MAX, ARSTREAM_SENDER_HISTOGRAM_MAX)];
+    jlong *value = values;
+    ARSTREAM_Histogram_t histogram;
+    int i;
+
+    if ((sender == NULL) ||
+        (stats == NULL) ||
+        ((*env)->GetArrayLength (env, stats) < (jsize)(sizeof (values) / sizeof (values [0]))))
+    {
+        return JNI_FALSE;
+    }
+
+    /* Everything is copied natively, then given to Java by a single JNI call */
+    for (i = 0; i < ARSTREAM_SENDER_COUNTER_MAX; i++)
+    {
+        *value++ = (jlong)ARSTREAM_Sender_GetCounter (sender, i);
+    }
+    *value++ = (jlong)(ARSTREAM_Sender_GetEstimatedEfficiency (sender) * 1000000.f);
+    for (i = 0; i < ARSTREAM_SENDER_HISTOGRAM_MAX; i++)
+    {
+        ARSTREAM_Sender_GetHistogram (sender, i, &histogram);
+        value = ARSTREAM_JNI_Stats_PutHistogram (value, &histogram);
+    }
+    (*env)->SetLongArrayRegion (env, stats, 0, (jsize)(sizeof (values) / sizeof (values [0])), values);
+    return JNI_TRUE;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSendNewFrame (JNIEnv *env, jobject thizz, jlong cSender, jlong frameBuffer, jint frameSize, jboolean flushPreviousFrames)
 {
@@ -181,6 +309,79 @@ Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSendNewFrame (JNIEnv *env, j
     return (jint)err;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSendSlot (JNIEnv *env, jobject thizz, jlong cSender, jint slot, jint frameSize, jboolean flushPreviousFrames)
+{
+    ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)(intptr_t)cSender;
+    ARSTREAM_JNISender_t *jniSender = (ARSTREAM_JNISender_t *)ARSTREAM_Sender_GetCustom (sender);
+    int flush = (flushPreviousFrames == JNI_TRUE) ? 1 : 0;
+    eARSTREAM_ERROR err;
+
+    if ((jniSender == NULL) ||
+        (slot < 0) || (slot >= jniSender->slots.nbSlots) ||
+        (frameSize < 0) || ((uint32_t)frameSize > jniSender->slots.capacities[slot]))
+    {
+        return (jint)ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    err = ARSTREAM_Sender_SendNewFrame (sender, jniSender->slots.addresses[slot], frameSize, flush, NULL);
+    return (jint)err;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeSetBatchedEvents (JNIEnv *env, jobject thizz, jlong cSender, jobject eventsBuffer, jint nbEvents)
+{
+    ARSTREAM_JNISender_t *jniSender = (ARSTREAM_JNISender_t *)ARSTREAM_Sender_GetCustom ((ARSTREAM_Sender_t *)(intptr_t)cSender);
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((jniSender == NULL) || (jniSender->slots.nbSlots == 0) ||
+        (nbEvents <= (jint)ARSTREAM_JNI_SENDER_RESERVED_EVENTS (jniSender)))
+    {
+        return (jint)ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    /* The network threads read events without lock : it can only be set before they run */
+    pthread_mutex_lock (&jniSender->mutex);
+    if ((jniSender->threadsStarted == 1) || (jniSender->events != NULL))
+    {
+        err = ARSTREAM_ERROR_BUSY;
+    }
+    else
+    {
+        jniSender->events = ARSTREAM_JNI_EventRing_New (env, eventsBuffer, nbEvents);
+        err = (jniSender->events != NULL) ? ARSTREAM_OK : ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    pthread_mutex_unlock (&jniSender->mutex);
+    return (jint)err;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeDrainEvents (JNIEnv *env, jobject thizz, jlong cSender)
+{
+    ARSTREAM_JNISender_t *jniSender = (ARSTREAM_JNISender_t *)ARSTREAM_Sender_GetCustom ((ARSTREAM_Sender_t *)(intptr_t)cSender);
+    jint nbEvents = 0;
+    if ((jniSender == NULL) || (jniSender->events == NULL))
+    {
+        return 0;
+    }
+    pthread_mutex_lock (&jniSender->events->mutex);
+    nbEvents = ARSTREAM_JNI_EventRing_DrainLocked (jniSender->events);
+    pthread_mutex_unlock (&jniSender->events->mutex);
+    return nbEvents;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_parrot_arsdk_arstream_ARStreamSender_nativeGetNbDroppedEvents (JNIEnv *env, jobject thizz, jlong cSender)
+{
+    ARSTREAM_JNISender_t *jniSender = (ARSTREAM_JNISender_t *)ARSTREAM_Sender_GetCustom ((ARSTREAM_Sender_t *)(intptr_t)cSender);
+    jlong nbDropped = 0;
+    if ((jniSender == NULL) || (jniSender->events == NULL))
+    {
+        return 0;
+    }
+    pthread_mutex_lock (&jniSender->events->mutex);
+    nbDropped = (jlong)jniSender->events->nbDropped;
+    pthread_mutex_unlock (&jniSender->events->mutex);
+    return nbDropped;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_parrot_arsdk_arstream_ARStreamSender_nativeFlushFrameQueue (JNIEnv *env, jobject thizz, jlong cSender)
 {
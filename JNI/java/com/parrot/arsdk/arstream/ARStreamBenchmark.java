@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+package com.parrot.arsdk.arstream;
+
+/**
+ * Native benchmarks of the ARStream JNI bindings.<br>
+ * <br>
+ * Measures the round-trip cost of a callback from a native thread (like the
+ * network threads of the library) to Java, with and without the persistent
+ * thread attachment used by the ARStreamSender and ARStreamReader callbacks.
+ */
+public final class ARStreamBenchmark
+{
+    private ARStreamBenchmark ()
+    {
+    }
+
+    /* **************** */
+    /* PUBLIC FUNCTIONS */
+    /* **************** */
+
+    /**
+     * Measures the cost of a callback from a native thread to Java.<br>
+     * The callbacks are called from a new native thread, which is not attached to the VM.
+     * @param nbCalls Number of callbacks to time
+     * @param persistentAttach <code>true</code> to attach the thread once (what the bindings do),
+     * <code>false</code> to attach and detach it around each callback (what they did before)
+     * @return The mean time of a callback, in ns, or -1 on error
+     */
+    public static long callbackRoundTripNs (int nbCalls, boolean persistentAttach)
+    {
+        return nativeCallbackRoundTrip (nbCalls, persistentAttach);
+    }
+
+    /* ***************** */
+    /* PRIVATE FUNCTIONS */
+    /* ***************** */
+
+    /**
+     * Empty callback, called from the native benchmark thread
+     */
+    private static void benchCallback ()
+    {
+    }
+
+    /* **************** */
+    /* NATIVE FUNCTIONS */
+    /* **************** */
+
+    /**
+     * Runs the callback benchmark in a native thread
+     * @param nbCalls Number of callbacks to time
+     * @param persistentAttach Attach the thread once, instead of once per callback
+     * @return The mean time of a callback, in ns, or -1 on error
+     */
+    private native static long nativeCallbackRoundTrip (int nbCalls, boolean persistentAttach);
+
+    /**
+     * Gets the VM and the callback method id
+     */
+    private native static void nativeInitClass ();
+
+    static {
+        nativeInitClass ();
+    }
+}
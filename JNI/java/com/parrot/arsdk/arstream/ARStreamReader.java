@@ -30,6 +30,11 @@
 */
 package com.parrot.arsdk.arstream;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.IntBuffer;
+import java.util.concurrent.atomic.AtomicLong;
+
 import com.parrot.arsdk.arsal.ARNativeData;
 import com.parrot.arsdk.arsal.ARSALPrint;
 
@@ -43,6 +48,16 @@ import com.parrot.arsdk.arnetwork.ARNetworkIOBufferParamBuilder;
  * To create an ARStreamReader, the application must provide a suitable
  * <code>ARStreamReaderListener</code> to handle the events.<br>
  * <br>
+ * Alternatively, the frames can be received in preallocated direct ByteBuffers
+ * (frame slots), designated by their index, with an
+ * <code>ARStreamReaderSlotListener</code>. Frames then cross the JNI boundary
+ * without any allocation, boxing or array unpacking.<br>
+ * <br>
+ * With frame slots, the events can also be batched (see <code>setBatchedEvents()</code>):
+ * the network threads then write them in a shared direct buffer, and the
+ * application delivers them to its listener from its own thread, with one
+ * native call per batch (<code>dispatchEvents()</code>).<br>
+ * <br>
  * The two ARStreamReader Runnables must be run in independant threads<br>
  */
 public class ARStreamReader
@@ -73,6 +88,41 @@ public class ARStreamReader
      */
     private ARStreamReaderListener eventListener;
 
+    /**
+     * Frame slots (null when the frames are ARNativeData)
+     */
+    private ByteBuffer[] frameSlots;
+
+    /**
+     * Event listener of the frame slots
+     */
+    private ARStreamReaderSlotListener slotListener;
+
+    /**
+     * Batched events, shared with the native code (null when the events are delivered by upcalls)
+     */
+    private ByteBuffer eventsBuffer;
+
+    /**
+     * Int view of the batched events
+     */
+    private IntBuffer events;
+
+    /**
+     * Number of batched events minus one (the number is a power of two)
+     */
+    private int eventsMask;
+
+    /**
+     * Index of the next batched event to dispatch
+     */
+    private int eventsIndex;
+
+    /**
+     * Bitfield of the slots released by the application since the last dispatch
+     */
+    private final AtomicLong releasedSlots = new AtomicLong (0);
+
     /**
      * Check validity before all function calls
      */
@@ -92,6 +142,48 @@ public class ARStreamReader
     /* PUBLIC CONSTANTS */
     /* **************** */
     public static final int DEFAULT_MAX_ACK_INTERVAL = nativeGetDefaultMaxAckInterval();
+    public static final int INCOMPLETE_FRAMES_DISABLED = -1;
+    public static final int NO_FRAME_SLOT = -1;
+
+    /*
+     * Counters of the ARStreamStats (must match eARSTREAM_READER_COUNTER)
+     */
+    public static final int COUNTER_FRAGMENTS_RECEIVED = 0;
+    public static final int COUNTER_DUPLICATE_FRAGMENTS = 1;
+    public static final int COUNTER_FRAMES_COMPLETE = 2;
+    public static final int COUNTER_FRAMES_INCOMPLETE = 3;
+    public static final int COUNTER_FRAMES_DROPPED = 4;
+    public static final int COUNTER_FRAMES_MISSED = 5;
+    public static final int COUNTER_FRAMES_DISCARDED = 6;
+    public static final int COUNTER_FLUSH_FRAMES_REQUESTED = 7;
+    public static final int COUNTER_LATE_FRAGMENTS = 8;
+    public static final int COUNTER_DISCARDED_FRAGMENTS = 9;
+
+    /*
+     * Histograms of the ARStreamStats (must match eARSTREAM_READER_HISTOGRAM)
+     */
+    public static final int HISTOGRAM_SENDER_QUEUE_DURATION = 0;
+    public static final int HISTOGRAM_FIRST_FRAGMENT_LATENCY = 1;
+    public static final int HISTOGRAM_COMPLETION_LATENCY = 2;
+
+    private static final int NB_COUNTERS = nativeGetNbCounters();
+    private static final int NB_HISTOGRAMS = nativeGetNbHistograms();
+
+    /**
+     * Causes from their native value, without the map lookup of getFromValue
+     */
+    private static final ARSTREAM_READER_CAUSE_ENUM[] causeFromValue = buildCauseTable ();
+
+    /*
+     * Layout of a batched event (must match eARSTREAM_JNI_EVENT_FIELD)
+     */
+    private static final int EVENT_NB_FIELDS = 6;
+    private static final int EVENT_FIELD_CAUSE = 0;
+    private static final int EVENT_FIELD_SLOT = 1;
+    private static final int EVENT_FIELD_FRAME_SIZE = 2;
+    private static final int EVENT_FIELD_IS_FLUSH = 3;
+    private static final int EVENT_FIELD_NB_SKIPPED = 4;
+    private static final int MAX_BATCHED_FRAME_SLOTS = 64;
 
     /* **************** */
     /* STATIC FUNCTIONS */
@@ -123,6 +215,23 @@ public class ARStreamReader
         return retParam;
     }
 
+    /**
+     * Builds the table of the causes, indexed by their native value
+     */
+    private static ARSTREAM_READER_CAUSE_ENUM[] buildCauseTable () {
+        int maxValue = -1;
+        for (ARSTREAM_READER_CAUSE_ENUM cause : ARSTREAM_READER_CAUSE_ENUM.values ()) {
+            maxValue = Math.max (maxValue, cause.getValue ());
+        }
+        ARSTREAM_READER_CAUSE_ENUM[] table = new ARSTREAM_READER_CAUSE_ENUM[maxValue + 1];
+        for (ARSTREAM_READER_CAUSE_ENUM cause : ARSTREAM_READER_CAUSE_ENUM.values ()) {
+            if (cause.getValue () >= 0) {
+                table[cause.getValue ()] = cause;
+            }
+        }
+        return table;
+    }
+
     /* *********** */
     /* CONSTRUCTOR */
     /* *********** */
@@ -142,9 +251,41 @@ public class ARStreamReader
     {
         this.cReader = nativeConstructor (netManager.getManager (), dataBufferId, ackBufferId, initialFrameBuffer.getData (), initialFrameBuffer.getCapacity (), maxFragmentSize, maxAckInterval);
         if (this.cReader != 0) {
-            this.valid = true;
             this.eventListener = theEventListener;
             this.currentFrameBuffer = initialFrameBuffer;
+        }
+        initRunnables ();
+    }
+
+    /**
+     * Constructor for ARStreamReader object, with frame slots<br>
+     * Create a new instance of an ARStreamReader for a given ARNetworkManager,
+     * and given buffer ids within the ARNetworkManager.<br>
+     * The first frame is received in the first slot, the listener gives the slot of each next frame.
+     * @param netManager The ARNetworkManager to use (must be initialized and valid)
+     * @param dataBufferId The id to use for data transferts on network (must be a valid buffer id in <code>netManager</code>
+     * @param ackBufferId The id to use for ack transferts on network (must be a valid buffer id in <code>netManager</code>
+     * @param theFrameSlots The frame slots (direct ByteBuffers, allocated with <code>ByteBuffer.allocateDirect()</code>)
+     * @param theSlotListener The event listener to use for this instance
+     * @param maxFragmentSize Maximum allowed size for a video data fragment. Video frames larger that will be fragmented.
+     */
+    public ARStreamReader (ARNetworkManager netManager, int dataBufferId, int ackBufferId, ByteBuffer[] theFrameSlots, ARStreamReaderSlotListener theSlotListener, int maxFragmentSize, int maxAckInterval)
+    {
+        this.cReader = nativeSlotConstructor (netManager.getManager (), dataBufferId, ackBufferId, theFrameSlots, maxFragmentSize, maxAckInterval);
+        if (this.cReader != 0) {
+            this.slotListener = theSlotListener;
+            this.frameSlots = theFrameSlots.clone ();
+        }
+        initRunnables ();
+    }
+
+    /**
+     * Creates the Runnables after the native constructor, or marks the object as invalid
+     */
+    private void initRunnables ()
+    {
+        if (this.cReader != 0) {
+            this.valid = true;
             this.dataRunnable = new Runnable () {
                     public void run () {
                         nativeRunDataThread (ARStreamReader.this.cReader);
@@ -249,6 +390,167 @@ public class ARStreamReader
         return nativeGetEfficiency (cReader);
     }
 
+    /**
+     * Creates a statistics snapshot for this reader<br>
+     * The snapshot is empty until <code>updateStats()</code> is called
+     * @return A new snapshot, to reuse across <code>updateStats()</code> calls
+     */
+    public ARStreamStats newStats () {
+        return new ARStreamStats (NB_COUNTERS, NB_HISTOGRAMS);
+    }
+
+    /**
+     * Refreshes a statistics snapshot with the current counters and histograms of the reader<br>
+     * All the values are copied by a single native call, without any allocation.
+     * Can be called from any thread while the reader is running.
+     * @param stats A snapshot created by <code>newStats()</code>
+     * @return <code>true</code> if the snapshot was refreshed
+     */
+    public boolean updateStats (ARStreamStats stats) {
+        if (!valid || stats == null) {
+            return false;
+        }
+        return nativeGetStats (cReader, stats.getValues ());
+    }
+
+    /**
+     * Enables or disables the delivery of incomplete frames<br>
+     * When enabled, frames which can not be completed are given to the listener
+     * with the ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE cause, if enough of their
+     * fragments were received.
+     * @param minPercentOfFragments Minimum percentage (0-100) of received fragments, or INCOMPLETE_FRAMES_DISABLED
+     * @param maxWaitTimeMs Maximum time to wait for the missing fragments of a frame (0 to only deliver when a newer frame arrives)
+     * @return true if the configuration was applied
+     */
+    public boolean setIncompleteFramesDelivery (int minPercentOfFragments, int maxWaitTimeMs) {
+        return nativeSetIncompleteFramesDelivery (cReader, minPercentOfFragments, maxWaitTimeMs);
+    }
+
+    /**
+     * Enables or disables the skipping of the frames which depend on a lost frame<br>
+     * When enabled, after a frame was lost, the reader discards all the following
+     * frames until the next flush frame (typically an I-Frame).
+     * @param enable true to enable the skipping
+     * @return true if the configuration was applied
+     */
+    public boolean setSkipFramesUntilFlush (boolean enable) {
+        return nativeSetSkipFramesUntilFlush (cReader, enable);
+    }
+
+    /**
+     * Enables or disables the automatic flush frame requests<br>
+     * When enabled, the reader requests a flush frame (typically an I-Frame)
+     * to the sender as soon as it lost a reference frame.
+     * @param requestIntervalMs Minimum time between two requests (0 to disable)
+     * @return true if the configuration was applied
+     */
+    public boolean setAutomaticFlushFrameRequests (int requestIntervalMs) {
+        return nativeSetAutomaticFlushFrameRequests (cReader, requestIntervalMs);
+    }
+
+    /**
+     * Requests a flush frame (typically an I-Frame) to the sender
+     * @return true if the request will be sent
+     */
+    public boolean requestFlushFrame () {
+        return nativeRequestFlushFrame (cReader);
+    }
+
+    /**
+     * Gets a frame slot
+     * @param slot Index of the frame slot
+     * @return The frame slot, or null if the reader has no such slot
+     */
+    public ByteBuffer getFrameSlot (int slot) {
+        if (frameSlots == null || slot < 0 || slot >= frameSlots.length) {
+            return null;
+        }
+        return frameSlots[slot];
+    }
+
+    /**
+     * Gets the number of frame slots
+     * @return The number of frame slots (0 if the reader uses ARNativeData frames)
+     */
+    public int getNbFrameSlots () {
+        return (frameSlots != null) ? frameSlots.length : 0;
+    }
+
+    /**
+     * Enables the batched delivery of the events.<br>
+     * Only for readers created with at most 64 frame slots, before the Runnables are started.<br>
+     * The network threads then only write the complete (and incomplete) frames in a shared
+     * buffer, and the listener is called by <code>dispatchEvents()</code>, in the thread of
+     * the application. The listener is never called from the network threads: if the buffer
+     * is full, the frame and its event are dropped (see <code>getNbDroppedEvents()</code>).<br>
+     * The return value of the listener is then ignored: the reader picks the next slots
+     * itself, among the slots released with <code>releaseFrameSlot()</code>. When no slot is
+     * free, the frame is dropped, and its event has the NO_FRAME_SLOT slot.
+     * @param nbEvents Capacity of the buffer, in events (a power of two)
+     * @return ARSTREAM_OK if the events are now batched, ARSTREAM_ERROR_BUSY if the Runnables were already started
+     */
+    public ARSTREAM_ERROR_ENUM setBatchedEvents (int nbEvents) {
+        if (frameSlots == null || frameSlots.length > MAX_BATCHED_FRAME_SLOTS || nbEvents <= 0 || (nbEvents & (nbEvents - 1)) != 0) {
+            return ARSTREAM_ERROR_ENUM.ARSTREAM_ERROR_BAD_PARAMETERS;
+        }
+        if (events != null) {
+            return ARSTREAM_ERROR_ENUM.ARSTREAM_ERROR_BUSY;
+        }
+        ByteBuffer buffer = ByteBuffer.allocateDirect (nbEvents * EVENT_NB_FIELDS * 4).order (ByteOrder.nativeOrder ());
+        ARSTREAM_ERROR_ENUM err = ARSTREAM_ERROR_ENUM.getFromValue (nativeSetBatchedEvents (cReader, buffer, nbEvents));
+        if (err == ARSTREAM_ERROR_ENUM.ARSTREAM_OK) {
+            this.eventsBuffer = buffer;
+            this.events = buffer.asIntBuffer ();
+            this.eventsMask = nbEvents - 1;
+        }
+        return err;
+    }
+
+    /**
+     * Gets the number of batched events dropped because the buffer was full.<br>
+     * Their frames were dropped too.
+     * @return The number of dropped events since <code>setBatchedEvents()</code>
+     */
+    public long getNbDroppedEvents () {
+        return (events != null) ? nativeGetNbDroppedEvents (cReader) : 0;
+    }
+
+    /**
+     * Gives a frame slot back to the reader, once its frame was used (batched events only).<br>
+     * The slot is reused after the next <code>dispatchEvents()</code>. Can be called from any thread.
+     * @param slot Index of the frame slot
+     */
+    public void releaseFrameSlot (int slot) {
+        if (slot < 0 || slot >= MAX_BATCHED_FRAME_SLOTS) {
+            return;
+        }
+        long mask = 1L << slot;
+        long current;
+        do {
+            current = releasedSlots.get ();
+        } while (! releasedSlots.compareAndSet (current, current | mask));
+    }
+
+    /**
+     * Gives the released slots back to the reader, and delivers the pending batched events to the listener.<br>
+     * Must always be called from the same thread (or with external synchronization).
+     * @return The number of delivered events
+     */
+    public int dispatchEvents () {
+        if (events == null) {
+            return 0;
+        }
+        int nbEvents = nativeDrainEvents (cReader, releasedSlots.getAndSet (0));
+        for (int i = 0; i < nbEvents; i++) {
+            int record = ((eventsIndex + i) & eventsMask) * EVENT_NB_FIELDS;
+            slotCallbackWrapper (events.get (record + EVENT_FIELD_CAUSE), events.get (record + EVENT_FIELD_SLOT),
+                                 events.get (record + EVENT_FIELD_FRAME_SIZE), events.get (record + EVENT_FIELD_IS_FLUSH) != 0,
+                                 events.get (record + EVENT_FIELD_NB_SKIPPED), 0);
+        }
+        eventsIndex += nbEvents;
+        return nbEvents;
+    }
+
     /* ***************** */
     /* PRIVATE FUNCTIONS */
     /* ***************** */
@@ -271,6 +573,7 @@ public class ARStreamReader
 
         switch (cause) {
         case ARSTREAM_READER_CAUSE_FRAME_COMPLETE:
+        case ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE:
             currentFrameBuffer.setUsedSize(ndSize);
             currentFrameBuffer = eventListener.didUpdateFrameStatus (cause, currentFrameBuffer, isFlush, nbSkip, newBufferCapacity);
             break;
@@ -299,6 +602,19 @@ public class ARStreamReader
         }
     }
 
+    /**
+     * Callback wrapper for the slot listener
+     * @return The slot of the next frame, or NO_FRAME_SLOT
+     */
+    private int slotCallbackWrapper (int icause, int slot, int frameSize, boolean isFlush, int nbSkip, int newBufferCapacity) {
+        ARSTREAM_READER_CAUSE_ENUM cause = (icause >= 0 && icause < causeFromValue.length) ? causeFromValue[icause] : null;
+        if (cause == null) {
+            ARSALPrint.e (TAG, "Bad cause : " + icause);
+            return NO_FRAME_SLOT;
+        }
+        return slotListener.didUpdateSlotStatus (cause, slot, frameSize, isFlush, nbSkip, newBufferCapacity);
+    }
+
     /* **************** */
     /* NATIVE FUNCTIONS */
     /* **************** */
@@ -308,6 +624,16 @@ public class ARStreamReader
      */
     private native static int nativeGetDefaultMaxAckInterval ();
 
+    /**
+     * Gets the number of counters of the native reader
+     */
+    private native static int nativeGetNbCounters ();
+
+    /**
+     * Gets the number of histograms of the native reader
+     */
+    private native static int nativeGetNbHistograms ();
+
     /**
      * Sets an ARNetworkIOBufferParams internal values to represent an
      * ARStream data buffer.
@@ -340,6 +666,40 @@ public class ARStreamReader
      */
     private native long nativeConstructor (long cNetManager, int dataBufferId, int ackBufferId, long frameBuffer, int frameBufferSize, int maxFragmentSize, int maxAckInterval);
 
+    /**
+     * Constructor in native memory space, with frame slots<br>
+     * This function created a C-Managed ARSTREAM_Reader object, receiving its first frame in the first slot
+     * @param cNetManager C-Pointer to the ARNetworkManager internal object
+     * @param dataBufferId id of the data buffer to use
+     * @param ackBufferId id of the ack buffer to use
+     * @param frameSlots The frame slots (direct ByteBuffers)
+     * @param maxFragmentSize Maximum size of the fragment to send
+     * @param maxAckInterval Maximum duration without sending an ACK.
+     * @return C-Pointer to the ARSTREAM_Reader object (or null if any error occured)
+     */
+    private native long nativeSlotConstructor (long cNetManager, int dataBufferId, int ackBufferId, ByteBuffer[] frameSlots, int maxFragmentSize, int maxAckInterval);
+
+    /**
+     * Enables the batched events.
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     * @param eventsBuffer Direct buffer of the events, in native order
+     * @param nbEvents Capacity of the buffer, in events
+     */
+    private native int nativeSetBatchedEvents (long cReader, ByteBuffer eventsBuffer, int nbEvents);
+
+    /**
+     * Frees the released slots, releases the events of the previous call, and gets the number of pending events.
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     * @param releasedSlots Bitfield of the slots released by the application
+     */
+    private native int nativeDrainEvents (long cReader, long releasedSlots);
+
+    /**
+     * Gets the number of batched events dropped because the buffer was full.
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     */
+    private native long nativeGetNbDroppedEvents (long cReader);
+
     /**
      * Entry point for the data thread<br>
      * This function never returns until <code>stop</code> is called
@@ -372,6 +732,41 @@ public class ARStreamReader
      */
     private native float nativeGetEfficiency (long cReader);
 
+    /**
+     * Copies the counters, the efficiency and the histograms of the reader
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     * @param stats Values array of an ARStreamStats
+     */
+    private native boolean nativeGetStats (long cReader, long[] stats);
+
+    /**
+     * Sets the incomplete frames delivery parameters of the reader
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     * @param minPercentOfFragments Minimum percentage of received fragments
+     * @param maxWaitTimeMs Maximum time to wait for the missing fragments
+     */
+    private native boolean nativeSetIncompleteFramesDelivery (long cReader, int minPercentOfFragments, int maxWaitTimeMs);
+
+    /**
+     * Enables or disables the skipping of the frames which depend on a lost frame
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     * @param enable true to enable the skipping
+     */
+    private native boolean nativeSetSkipFramesUntilFlush (long cReader, boolean enable);
+
+    /**
+     * Sets the automatic flush frame requests interval
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     * @param requestIntervalMs Minimum time between two requests (0 to disable)
+     */
+    private native boolean nativeSetAutomaticFlushFrameRequests (long cReader, int requestIntervalMs);
+
+    /**
+     * Requests a flush frame to the sender
+     * @param cReader C-Pointer to the ARSTREAM_Reader C object
+     */
+    private native boolean nativeRequestFlushFrame (long cReader);
+
     /**
      * Initializes global static references in native code
      */
@@ -45,6 +45,8 @@ public interface ARStreamReaderListener
      *    - 'nbSkippedFrames' contains the number of skipped frames since the last complete frame<br>
      *    - 'newBufferCapacity' is undefined<br>
      *    - Return value is the storing location of the next frame<br>
+     *  - Frame incomplete: (only if enabled with ARStreamReader.setIncompleteFramesDelivery)<br>
+     *    - Same as Frame complete, but 'currentFrame' has missing fragments<br>
      *  - Frame too small:<br>
      *    - 'currentFrame' should not be modified (it is still used by the ARStreamReader)<br>
      *    - 'isFlushFrame' is undefined<br>
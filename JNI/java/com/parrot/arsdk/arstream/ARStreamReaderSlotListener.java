@@ -0,0 +1,74 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+package com.parrot.arsdk.arstream;
+
+/**
+ * This interface describes a listener of the events of an ARStreamReader
+ * created with frame slots
+ */
+public interface ARStreamReaderSlotListener
+{
+    /**
+     * This callback can be called in different cases:<br>
+     *  - Frame complete:<br>
+     *    - 'slot' contains a complete frame of 'frameSize' bytes, and won't be used by ARStreamReader again<br>
+     *    - 'isFlushFrame' is true if the complete frame occured after a buffer flush (on most cases, the complete frame is an I-Frame)<br>
+     *    - 'nbSkippedFrames' contains the number of skipped frames since the last complete frame<br>
+     *    - 'newBufferCapacity' is undefined<br>
+     *    - Return value is the slot of the next frame<br>
+     *  - Frame incomplete: (only if enabled with ARStreamReader.setIncompleteFramesDelivery)<br>
+     *    - Same as Frame complete, but the frame of 'slot' has missing fragments<br>
+     *  - Frame too small:<br>
+     *    - 'slot' should not be modified (it is still used by the ARStreamReader)<br>
+     *    - 'newBufferCapacity' holds a suitable capacity for the new slot.<br>
+     *    - Return value is a slot with a greater capacity than 'slot'.<br>
+     *      -- If the returned slot is -1 or smaller than 'slot', the frame is discarded<br>
+     *  - Copy complete: (only called after a Frame too small)<br>
+     *    - 'slot' is the previous slot, which can now be reused<br>
+     *    - Return value is unused and should be -1<br>
+     *  - Cancel:<br>
+     *    - 'slot' is the slot which is cancelled, and which can be reused<br>
+     *    - Return value is unused and should be -1<br>
+     *  - With batched events (see ARStreamReader.setBatchedEvents), only the complete and
+     *    incomplete frames are delivered, and the return value is unused: the application gives
+     *    the slots back with ARStreamReader.releaseFrameSlot. 'slot' is -1 if the frame was
+     *    dropped because no slot was free. The listener is then only called from
+     *    ARStreamReader.dispatchEvents.
+     * @param cause The event that triggered this call (see global func description)
+     * @param slot Index of the frame slot for the event (see global func description)
+     * @param frameSize Size of the frame in the slot, in bytes (see global func description)
+     * @param isFlushFrame Indicates if the frame forced a sender flush. This is typically set on I-Frames (see global func description)
+     * @param nbSkippedFrames The number of frames skipped since last complete frame (see global func description)
+     * @param newBufferCapacity Capacity needed for the next slot
+     * @return The index of the next slot, or -1 (depending on cause, see global func description)
+     */
+    public int didUpdateSlotStatus (ARSTREAM_READER_CAUSE_ENUM cause, int slot, int frameSize, boolean isFlushFrame, int nbSkippedFrames, int newBufferCapacity);
+}
@@ -32,6 +32,9 @@ package com.parrot.arsdk.arstream;
 
 import java.util.Map;
 import java.util.HashMap;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.IntBuffer;
 
 import com.parrot.arsdk.arsal.ARNativeData;
 import com.parrot.arsdk.arsal.ARSALPrint;
@@ -46,6 +49,16 @@ import com.parrot.arsdk.arnetwork.ARNetworkIOBufferParamBuilder;
  * To create an ARStreamSender, the application must provide a suitable
  * <code>ARStreamSenderListener</code> to handle the events.<br>
  * <br>
+ * Alternatively, the frames can be given as preallocated direct ByteBuffers
+ * (frame slots), designated by their index, with an
+ * <code>ARStreamSenderSlotListener</code>. Frames then cross the JNI boundary
+ * without any allocation, boxing or map lookup.<br>
+ * <br>
+ * With frame slots, the events can also be batched (see <code>setBatchedEvents()</code>):
+ * the network threads then write them in a shared direct buffer, and the
+ * application delivers them to its listener from its own thread, with one
+ * native call per batch (<code>dispatchEvents()</code>).<br>
+ * <br>
  * The two ARStreamSender Runnables must be run in independant threads<br>
  */
 public class ARStreamSender
@@ -71,6 +84,36 @@ public class ARStreamSender
      */
     private ARStreamSenderListener eventListener;
 
+    /**
+     * Frame slots (null when the frames are ARNativeData)
+     */
+    private ByteBuffer[] frameSlots;
+
+    /**
+     * Event listener of the frame slots
+     */
+    private ARStreamSenderSlotListener slotListener;
+
+    /**
+     * Batched events, shared with the native code (null when the events are delivered by upcalls)
+     */
+    private ByteBuffer eventsBuffer;
+
+    /**
+     * Int view of the batched events
+     */
+    private IntBuffer events;
+
+    /**
+     * Number of batched events minus one (the number is a power of two)
+     */
+    private int eventsMask;
+
+    /**
+     * Index of the next batched event to dispatch
+     */
+    private int eventsIndex;
+
     /**
      * Check validity before all function calls
      */
@@ -93,6 +136,44 @@ public class ARStreamSender
     public static final int DEFAULT_MAXIUMU_TIME_BETWEEN_RETRIES_MS = nativeGetDefaultMaxTimeBetweenRetries();
     public static final int INFINITE_TIME_BETWEEN_RETRIES = nativeGetInfiniteTimeBetweenRetries();
 
+    /*
+     * Counters of the ARStreamStats (must match eARSTREAM_SENDER_COUNTER)
+     */
+    public static final int COUNTER_FRAMES_QUEUED = 0;
+    public static final int COUNTER_FRAMES_REJECTED = 1;
+    public static final int COUNTER_FRAMES_ACKNOWLEDGED = 2;
+    public static final int COUNTER_FRAMES_CANCELLED = 3;
+    public static final int COUNTER_FRAGMENTS_SENT = 4;
+    public static final int COUNTER_FRAGMENTS_RETRANSMITTED = 5;
+    public static final int COUNTER_LATE_FRAGMENTS_SENT = 6;
+    public static final int COUNTER_ACKS_RECEIVED = 7;
+    public static final int COUNTER_FLUSH_FRAMES_REQUESTED = 8;
+
+    /*
+     * Histograms of the ARStreamStats (must match eARSTREAM_SENDER_HISTOGRAM)
+     */
+    public static final int HISTOGRAM_QUEUED = 0;
+    public static final int HISTOGRAM_FIRST_FRAGMENT = 1;
+    public static final int HISTOGRAM_SENT = 2;
+    public static final int HISTOGRAM_ACKNOWLEDGED = 3;
+    public static final int HISTOGRAM_CANCELLED = 4;
+    public static final int HISTOGRAM_TOTAL = 5;
+
+    private static final int NB_COUNTERS = nativeGetNbCounters();
+    private static final int NB_HISTOGRAMS = nativeGetNbHistograms();
+
+    /**
+     * Status from their native value, without the map lookup of getFromValue
+     */
+    private static final ARSTREAM_SENDER_STATUS_ENUM[] statusFromValue = buildStatusTable ();
+
+    /*
+     * Layout of a batched event (must match eARSTREAM_JNI_EVENT_FIELD)
+     */
+    private static final int EVENT_NB_FIELDS = 6;
+    private static final int EVENT_FIELD_STATUS = 0;
+    private static final int EVENT_FIELD_SLOT = 1;
+
     /* **************** */
     /* STATIC FUNCTIONS */
     /* **************** */
@@ -123,6 +204,23 @@ public class ARStreamSender
         return retParam;
     }
 
+    /**
+     * Builds the table of the status, indexed by their native value
+     */
+    private static ARSTREAM_SENDER_STATUS_ENUM[] buildStatusTable () {
+        int maxValue = -1;
+        for (ARSTREAM_SENDER_STATUS_ENUM status : ARSTREAM_SENDER_STATUS_ENUM.values ()) {
+            maxValue = Math.max (maxValue, status.getValue ());
+        }
+        ARSTREAM_SENDER_STATUS_ENUM[] table = new ARSTREAM_SENDER_STATUS_ENUM[maxValue + 1];
+        for (ARSTREAM_SENDER_STATUS_ENUM status : ARSTREAM_SENDER_STATUS_ENUM.values ()) {
+            if (status.getValue () >= 0) {
+                table[status.getValue ()] = status;
+            }
+        }
+        return table;
+    }
+
     /* *********** */
     /* CONSTRUCTOR */
     /* *********** */
@@ -143,10 +241,45 @@ public class ARStreamSender
     {
         this.cSender = nativeConstructor (netManager.getManager (), dataBufferId, ackBufferId, frameBufferSize, maxFragmentSize, maxNumberOfFragment);
         if (this.cSender != 0) {
-            this.valid = true;
             this.eventListener = theEventListener;
             // HashMap will realloc when over 75% of its capacity, so put a greater capacity than needed to avoid that
             this.frames = new HashMap<Long, ARNativeData> (frameBufferSize * 2);
+        }
+        initRunnables ();
+    }
+
+    /**
+     * Constructor for ARStreamSender object, with frame slots<br>
+     * Create a new instance of an ARStreamSender for a given ARNetworkManager,
+     * and given buffer ids within the ARNetworkManager.<br>
+     * The frames are written by the application in the frame slots, and sent
+     * with <code>sendFrameSlot()</code>. The internal frameBuffer can hold as
+     * many frames as there are slots.
+     * @param netManager The ARNetworkManager to use (must be initialized and valid)
+     * @param dataBufferId The id to use for data transferts on network (must be a valid buffer id in <code>netManager</code>
+     * @param ackBufferId The id to use for ack transferts on network (must be a valid buffer id in <code>netManager</code>
+     * @param theFrameSlots The frame slots (direct ByteBuffers, allocated with <code>ByteBuffer.allocateDirect()</code>)
+     * @param theSlotListener The event listener to use for this instance
+     * @param maxFragmentSize Maximum size of the fragment to send
+     * @param maxNumberOfFragment Maximum number of the fragment to send
+     */
+    public ARStreamSender (ARNetworkManager netManager, int dataBufferId, int ackBufferId, ByteBuffer[] theFrameSlots, ARStreamSenderSlotListener theSlotListener, int maxFragmentSize, int maxNumberOfFragment)
+    {
+        this.cSender = nativeSlotConstructor (netManager.getManager (), dataBufferId, ackBufferId, theFrameSlots, maxFragmentSize, maxNumberOfFragment);
+        if (this.cSender != 0) {
+            this.slotListener = theSlotListener;
+            this.frameSlots = theFrameSlots.clone ();
+        }
+        initRunnables ();
+    }
+
+    /**
+     * Creates the Runnables after the native constructor, or marks the object as invalid
+     */
+    private void initRunnables ()
+    {
+        if (this.cSender != 0) {
+            this.valid = true;
             this.dataRunnable = new Runnable () {
                     public void run () {
                         nativeRunDataThread (ARStreamSender.this.cSender);
@@ -208,6 +341,18 @@ public class ARStreamSender
         return ARSTREAM_ERROR_ENUM.getFromValue(err);
     }
 
+    /**
+     * Enables or disables the frame timestamps.<br>
+     * When enabled, the reader can estimate the one-way latency of the stream.<br>
+     * Timestamps are disabled by default.
+     * @param enable true to add timestamps to the frames
+     */
+    public ARSTREAM_ERROR_ENUM setFrameTimestamps(boolean enable)
+    {
+        int err = nativeSetFrameTimestamps(cSender, enable);
+        return ARSTREAM_ERROR_ENUM.getFromValue(err);
+    }
+
     /**
      * Checks if the current manager is valid.<br>
      * A valid manager is a manager which can be used to send video frames.
@@ -263,6 +408,96 @@ public class ARStreamSender
         return err;
     }
 
+    /**
+     * Sends the frame of a frame slot with the ARStreamSender.<br>
+     * Only for senders created with frame slots.<br>
+     * The application should not modify the slot until an event is called
+     * for it (either cancel or sent).<br>
+     * Modifying the slot before that leads to undefined behavior.
+     * @param slot Index of the frame slot
+     * @param frameSize Size of the frame, in bytes, from the start of the slot
+     * @param flush If active, the ARStreamSender will cancel any remaining prevous frame, and start sending this one immediately
+     */
+    public ARSTREAM_ERROR_ENUM sendFrameSlot (int slot, int frameSize, boolean flush) {
+        int intErr = nativeSendSlot (cSender, slot, frameSize, flush);
+        return ARSTREAM_ERROR_ENUM.getFromValue (intErr);
+    }
+
+    /**
+     * Gets a frame slot
+     * @param slot Index of the frame slot
+     * @return The frame slot, or null if the sender has no such slot
+     */
+    public ByteBuffer getFrameSlot (int slot) {
+        if (frameSlots == null || slot < 0 || slot >= frameSlots.length) {
+            return null;
+        }
+        return frameSlots[slot];
+    }
+
+    /**
+     * Gets the number of frame slots
+     * @return The number of frame slots (0 if the sender uses ARNativeData frames)
+     */
+    public int getNbFrameSlots () {
+        return (frameSlots != null) ? frameSlots.length : 0;
+    }
+
+    /**
+     * Enables the batched delivery of the events.<br>
+     * Only for senders created with frame slots, before the Runnables are started.<br>
+     * The network threads then only write the events in a shared buffer, and the
+     * listener is called by <code>dispatchEvents()</code>, in the thread of the application.
+     * The listener is never called from the network threads: if the buffer is full, the events
+     * are dropped (see <code>getNbDroppedEvents()</code>). Room is kept for the events of the
+     * frame slots, which are never dropped.
+     * @param nbEvents Capacity of the buffer, in events (a power of two, more than twice the number of frame slots)
+     * @return ARSTREAM_OK if the events are now batched, ARSTREAM_ERROR_BUSY if the Runnables were already started
+     */
+    public ARSTREAM_ERROR_ENUM setBatchedEvents (int nbEvents) {
+        if (frameSlots == null || nbEvents <= 0 || (nbEvents & (nbEvents - 1)) != 0) {
+            return ARSTREAM_ERROR_ENUM.ARSTREAM_ERROR_BAD_PARAMETERS;
+        }
+        if (events != null) {
+            return ARSTREAM_ERROR_ENUM.ARSTREAM_ERROR_BUSY;
+        }
+        ByteBuffer buffer = ByteBuffer.allocateDirect (nbEvents * EVENT_NB_FIELDS * 4).order (ByteOrder.nativeOrder ());
+        ARSTREAM_ERROR_ENUM err = ARSTREAM_ERROR_ENUM.getFromValue (nativeSetBatchedEvents (cSender, buffer, nbEvents));
+        if (err == ARSTREAM_ERROR_ENUM.ARSTREAM_OK) {
+            this.eventsBuffer = buffer;
+            this.events = buffer.asIntBuffer ();
+            this.eventsMask = nbEvents - 1;
+        }
+        return err;
+    }
+
+    /**
+     * Gets the number of batched events dropped because the buffer was full.<br>
+     * Only the events without frame slot (late acks, flush frame requests) can be dropped.
+     * @return The number of dropped events since <code>setBatchedEvents()</code>
+     */
+    public long getNbDroppedEvents () {
+        return (events != null) ? nativeGetNbDroppedEvents (cSender) : 0;
+    }
+
+    /**
+     * Delivers the pending batched events to the listener.<br>
+     * Must always be called from the same thread (or with external synchronization).
+     * @return The number of delivered events
+     */
+    public int dispatchEvents () {
+        if (events == null) {
+            return 0;
+        }
+        int nbEvents = nativeDrainEvents (cSender);
+        for (int i = 0; i < nbEvents; i++) {
+            int record = ((eventsIndex + i) & eventsMask) * EVENT_NB_FIELDS;
+            slotCallbackWrapper (events.get (record + EVENT_FIELD_STATUS), events.get (record + EVENT_FIELD_SLOT));
+        }
+        eventsIndex += nbEvents;
+        return nbEvents;
+    }
+
     /**
      * Flushes all currently queued frames on the ARStreamSender.
      */
@@ -300,6 +535,29 @@ public class ARStreamSender
         return nativeGetEfficiency (cSender);
     }
 
+    /**
+     * Creates a statistics snapshot for this sender<br>
+     * The snapshot is empty until <code>updateStats()</code> is called
+     * @return A new snapshot, to reuse across <code>updateStats()</code> calls
+     */
+    public ARStreamStats newStats () {
+        return new ARStreamStats (NB_COUNTERS, NB_HISTOGRAMS);
+    }
+
+    /**
+     * Refreshes a statistics snapshot with the current counters and histograms of the sender<br>
+     * All the values are copied by a single native call, without any allocation.
+     * Can be called from any thread while the sender is running.
+     * @param stats A snapshot created by <code>newStats()</code>
+     * @return <code>true</code> if the snapshot was refreshed
+     */
+    public boolean updateStats (ARStreamStats stats) {
+        if (!valid || stats == null) {
+            return false;
+        }
+        return nativeGetStats (cSender, stats.getValues ());
+    }
+
     /* ***************** */
     /* PRIVATE FUNCTIONS */
     /* ***************** */
@@ -324,12 +582,27 @@ public class ARStreamSender
             eventListener.didUpdateFrameStatus (status, data);
             break;
 
+        case ARSTREAM_SENDER_STATUS_FLUSH_FRAME_REQUESTED:
+            eventListener.didUpdateFrameStatus (status, null);
+            break;
+
         default:
             ARSALPrint.e (TAG, "Unknown status :" + status);
             break;
         }
     }
 
+    /**
+     * Callback wrapper for the slot listener
+     */
+    private void slotCallbackWrapper (int istatus, int slot) {
+        ARSTREAM_SENDER_STATUS_ENUM status = (istatus >= 0 && istatus < statusFromValue.length) ? statusFromValue[istatus] : null;
+        if (status == null) {
+            return;
+        }
+        slotListener.didUpdateSlotStatus (status, slot);
+    }
+
     /* **************** */
     /* NATIVE FUNCTIONS */
     /* **************** */
@@ -364,6 +637,19 @@ public class ARStreamSender
      */
     private native long nativeConstructor (long cNetManager, int dataBufferId, int ackBufferId, int nbFramesToBuffer, int maxFragmentSize, int maxNumberOfFragment);
 
+    /**
+     * Constructor in native memory space, with frame slots<br>
+     * This function created a C-Managed ARSTREAM_Sender object, which can buffer one frame per slot
+     * @param cNetManager C-Pointer to the ARNetworkManager internal object
+     * @param dataBufferId id of the data buffer to use
+     * @param ackBufferId id of the ack buffer to use
+     * @param frameSlots The frame slots (direct ByteBuffers)
+     * @param maxFragmentSize Maximum size of the fragment to send
+     * @param maxNumberOfFragment Maximum number of the fragment to send
+     * @return C-Pointer to the ARSTREAM_Sender object (or null if any error occured)
+     */
+    private native long nativeSlotConstructor (long cNetManager, int dataBufferId, int ackBufferId, ByteBuffer[] frameSlots, int maxFragmentSize, int maxNumberOfFragment);
+
     /**
      * Entry point for the data thread<br>
      * This function never returns until <code>stop</code> is called
@@ -396,6 +682,13 @@ public class ARStreamSender
      */
     private native float nativeGetEfficiency (long cSender);
 
+    /**
+     * Copies the counters, the efficiency and the histograms of the sender
+     * @param cSender C-Pointer to the ARSTREAM_Sender C object
+     * @param stats Values array of an ARStreamStats
+     */
+    private native boolean nativeGetStats (long cSender, long[] stats);
+
     /**
      * Tries to send a new frame.
      * @param cSender C-Pointer to the ARSTREAM_Sender C object
@@ -405,6 +698,35 @@ public class ARStreamSender
      */
     private native int nativeSendNewFrame (long cSender, long frameBuffer, int frameSize, boolean flushPreviousFrame);
 
+    /**
+     * Tries to send the frame of a frame slot.
+     * @param cSender C-Pointer to the ARSTREAM_Sender C object
+     * @param slot Index of the frame slot
+     * @param frameSize The size in bytes of the frame.
+     * @param flushPreviousFrame Whether to flush any queued frames or not.
+     */
+    private native int nativeSendSlot (long cSender, int slot, int frameSize, boolean flushPreviousFrame);
+
+    /**
+     * Enables the batched events.
+     * @param cSender C-Pointer to the ARSTREAM_Sender C object
+     * @param eventsBuffer Direct buffer of the events, in native order
+     * @param nbEvents Capacity of the buffer, in events
+     */
+    private native int nativeSetBatchedEvents (long cSender, ByteBuffer eventsBuffer, int nbEvents);
+
+    /**
+     * Releases the events of the previous call, and gets the number of pending events.
+     * @param cSender C-Pointer to the ARSTREAM_Sender C object
+     */
+    private native int nativeDrainEvents (long cSender);
+
+    /**
+     * Gets the number of batched events dropped because the buffer was full.
+     * @param cSender C-Pointer to the ARSTREAM_Sender C object
+     */
+    private native long nativeGetNbDroppedEvents (long cSender);
+
     /**
      * Flushes the frames queue.
      * @param cSender C-Pointer to the ARSTREAM_Sender C object
@@ -419,6 +741,13 @@ public class ARStreamSender
      */
     private native int nativeSetTimeBetweenRetries(long cSender, int min, int max);
 
+    /**
+     * Enables or disables the frame timestamps.
+     * @param cSender C-Pointer to the ARSTREAM_Sender C object
+     * @param enable true to add timestamps to the frames
+     */
+    private native int nativeSetFrameTimestamps(long cSender, boolean enable);
+
     /**
      * Initializes global static references in native code
      */
@@ -430,6 +759,8 @@ public class ARStreamSender
     private native static int nativeGetDefaultMinTimeBetweenRetries();
     private native static int nativeGetDefaultMaxTimeBetweenRetries();
     private native static int nativeGetInfiniteTimeBetweenRetries();
+    private native static int nativeGetNbCounters();
+    private native static int nativeGetNbHistograms();
 
     /* *********** */
     /* STATIC BLOC */
@@ -0,0 +1,55 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+package com.parrot.arsdk.arstream;
+
+/**
+ * This interface describes a listener of the events of an ARStreamSender
+ * created with frame slots
+ */
+public interface ARStreamSenderSlotListener
+{
+    /**
+     * This callback can be called in three different cases:<br>
+     *    - Frame sent:<br>
+     *       The frame of the slot was successfully sent to the reader.
+     *       The slot can be reused<br>
+     *    - Frame cancel:<br>
+     *       The frame of the slot was cancelled before it was acknowledged.
+     *       The slot can be reused<br>
+     *       This does not ensure that the frame was not received.<br>
+     *    - Flush frame requested:<br>
+     *       The reader lost a reference frame, and the next frame should be
+     *       sent as a flush frame (typically an I-Frame). 'slot' is -1.
+     * @param status The event that triggered this call (see global func description)
+     * @param slot Index of the frame slot for the event (see global func description)
+     */
+    public void didUpdateSlotStatus (ARSTREAM_SENDER_STATUS_ENUM status, int slot);
+}
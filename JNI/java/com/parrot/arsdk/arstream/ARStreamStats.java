@@ -0,0 +1,293 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+package com.parrot.arsdk.arstream;
+
+/**
+ * Snapshot of the counters and histograms of an ARStreamSender or an ARStreamReader.<br>
+ * <br>
+ * A snapshot is created once by <code>ARStreamSender.newStats()</code> or
+ * <code>ARStreamReader.newStats()</code>, then refreshed as often as needed by
+ * <code>updateStats()</code>, which fills its array with a single native call.
+ * Refreshing a snapshot does not allocate anything.<br>
+ * <br>
+ * Counters and histograms are designated by the <code>COUNTER_*</code> and
+ * <code>HISTOGRAM_*</code> constants of the class which created the snapshot.
+ * All histograms hold durations, in microseconds.<br>
+ * A snapshot is not thread safe : each thread should use its own.
+ */
+public class ARStreamStats
+{
+    /* *********************** */
+    /* INTERNAL REPRESENTATION */
+    /* *********************** */
+
+    /*
+     * Layout of an histogram in the values array (must match ARSTREAM_JNI_Stats_PutHistogram)
+     */
+    private static final int HISTOGRAM_COUNT = 0;
+    private static final int HISTOGRAM_SUM = 1;
+    private static final int HISTOGRAM_MIN = 2;
+    private static final int HISTOGRAM_MAX = 3;
+    private static final int HISTOGRAM_BUCKETS = 4;
+
+    /**
+     * Number of buckets of the histograms
+     */
+    private static final int NB_BUCKETS = nativeGetNbBuckets ();
+
+    /**
+     * Smallest value of each bucket, read once from the native histograms
+     */
+    private static final long[] bucketLowerBounds = buildBucketLowerBounds ();
+
+    /**
+     * Largest value which fits in a native histogram
+     */
+    private static final long HISTOGRAM_MAX_VALUE = 0xFFFFFFFFL;
+
+    private final int nbCounters;
+    private final int nbHistograms;
+
+    /**
+     * Counters, efficiency (in millionths), then the histograms
+     */
+    private final long[] values;
+
+    /* *********** */
+    /* CONSTRUCTOR */
+    /* *********** */
+
+    /**
+     * Creates an empty snapshot
+     * @param nbCounters Number of counters of the native object
+     * @param nbHistograms Number of histograms of the native object
+     */
+    ARStreamStats (int nbCounters, int nbHistograms)
+    {
+        this.nbCounters = nbCounters;
+        this.nbHistograms = nbHistograms;
+        this.values = new long[nbCounters + 1 + nbHistograms * (HISTOGRAM_BUCKETS + NB_BUCKETS)];
+    }
+
+    /* **************** */
+    /* PUBLIC FUNCTIONS */
+    /* **************** */
+
+    /**
+     * Gets the number of counters of the snapshot
+     */
+    public int getNbCounters () {
+        return nbCounters;
+    }
+
+    /**
+     * Gets the number of histograms of the snapshot
+     */
+    public int getNbHistograms () {
+        return nbHistograms;
+    }
+
+    /**
+     * Gets the value of a counter
+     * @param counter Index of the counter (<code>COUNTER_*</code> constants)
+     * @return The value of the counter, or 0 if the index is invalid
+     */
+    public long getCounter (int counter) {
+        if (counter < 0 || counter >= nbCounters) {
+            return 0;
+        }
+        return values[counter];
+    }
+
+    /**
+     * Gets the estimated efficiency of the network link
+     * @return Estimated network link efficiency (0.0-1.0)
+     */
+    public float getEstimatedEfficiency () {
+        return values[nbCounters] / 1000000.f;
+    }
+
+    /**
+     * Gets the number of values in an histogram
+     * @param histogram Index of the histogram (<code>HISTOGRAM_*</code> constants)
+     */
+    public long getHistogramCount (int histogram) {
+        return getHistogramValue (histogram, HISTOGRAM_COUNT);
+    }
+
+    /**
+     * Gets the smallest value of an histogram, in us
+     * @param histogram Index of the histogram
+     * @return The smallest value, or 0 if the histogram is empty
+     */
+    public long getHistogramMin (int histogram) {
+        return getHistogramValue (histogram, HISTOGRAM_MIN);
+    }
+
+    /**
+     * Gets the largest value of an histogram, in us
+     * @param histogram Index of the histogram
+     */
+    public long getHistogramMax (int histogram) {
+        return getHistogramValue (histogram, HISTOGRAM_MAX);
+    }
+
+    /**
+     * Gets the mean value of an histogram, in us
+     * @param histogram Index of the histogram
+     * @return The mean value, or 0 if the histogram is empty
+     */
+    public long getHistogramMean (int histogram) {
+        long count = getHistogramValue (histogram, HISTOGRAM_COUNT);
+        if (count == 0) {
+            return 0;
+        }
+        return getHistogramValue (histogram, HISTOGRAM_SUM) / count;
+    }
+
+    /**
+     * Gets the value at a given percentile of an histogram, in us<br>
+     * Computed like ARSTREAM_Histogram_GetPercentile
+     * @param histogram Index of the histogram
+     * @param percentile The percentile, from 0.0 to 100.0 (e.g. 99.9)
+     * @return The upper bound of the bucket which holds the percentile (clamped to the max value of the histogram), or 0 if the histogram is empty
+     */
+    public long getHistogramPercentile (int histogram, float percentile) {
+        long count = getHistogramValue (histogram, HISTOGRAM_COUNT);
+        long max = getHistogramValue (histogram, HISTOGRAM_MAX);
+        long rank;
+        long seen = 0;
+        int base;
+        if (count == 0) {
+            return 0;
+        }
+        percentile = Math.max (0.f, Math.min (100.f, percentile));
+        rank = Math.min ((long)((percentile / 100.f) * count), count - 1);
+        base = getHistogramBase (histogram) + HISTOGRAM_BUCKETS;
+        for (int i = 0; i < NB_BUCKETS; i++) {
+            seen += values[base + i];
+            if (seen > rank) {
+                long upperBound = (i + 1 < NB_BUCKETS) ? bucketLowerBounds[i + 1] - 1 : HISTOGRAM_MAX_VALUE;
+                return Math.min (upperBound, max);
+            }
+        }
+        return max;
+    }
+
+    /**
+     * Gets the number of values in a bucket of an histogram
+     * @param histogram Index of the histogram
+     * @param bucket Index of the bucket, in [0, getNbBuckets()[
+     * @return The number of values, or 0 if an index is invalid
+     */
+    public long getHistogramBucket (int histogram, int bucket) {
+        if (bucket < 0 || bucket >= NB_BUCKETS) {
+            return 0;
+        }
+        return getHistogramValue (histogram, HISTOGRAM_BUCKETS + bucket);
+    }
+
+    /**
+     * Gets the number of buckets of the histograms
+     */
+    public static int getNbBuckets () {
+        return NB_BUCKETS;
+    }
+
+    /**
+     * Gets the smallest value which belongs to a bucket, in us
+     * @param bucket Index of the bucket
+     * @return The lower bound of the bucket, or -1 if the index is invalid
+     */
+    public static long getBucketLowerBound (int bucket) {
+        if (bucket < 0 || bucket >= NB_BUCKETS) {
+            return -1;
+        }
+        return bucketLowerBounds[bucket];
+    }
+
+    /* ***************** */
+    /* PACKAGE FUNCTIONS */
+    /* ***************** */
+
+    /**
+     * Gets the array filled by the native code
+     */
+    long[] getValues () {
+        return values;
+    }
+
+    /* ***************** */
+    /* PRIVATE FUNCTIONS */
+    /* ***************** */
+
+    /**
+     * Gets the index of the first value of an histogram, or -1 if the histogram is invalid
+     */
+    private int getHistogramBase (int histogram) {
+        if (histogram < 0 || histogram >= nbHistograms) {
+            return -1;
+        }
+        return nbCounters + 1 + histogram * (HISTOGRAM_BUCKETS + NB_BUCKETS);
+    }
+
+    /**
+     * Gets a value of an histogram, or 0 if the histogram is invalid
+     */
+    private long getHistogramValue (int histogram, int offset) {
+        int base = getHistogramBase (histogram);
+        if (base < 0) {
+            return 0;
+        }
+        return values[base + offset];
+    }
+
+    private static long[] buildBucketLowerBounds () {
+        long[] bounds = new long[NB_BUCKETS];
+        nativeGetBucketLowerBounds (bounds);
+        return bounds;
+    }
+
+    /* **************** */
+    /* NATIVE FUNCTIONS */
+    /* **************** */
+
+    /**
+     * Gets the number of buckets of the native histograms
+     */
+    private native static int nativeGetNbBuckets ();
+
+    /**
+     * Fills an array with the lower bound of each bucket
+     * @param lowerBounds Array of at least nativeGetNbBuckets() values
+     */
+    private native static void nativeGetBucketLowerBounds (long[] lowerBounds);
+}
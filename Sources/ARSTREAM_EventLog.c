@@ -0,0 +1,497 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_EventLog.c
+ * @brief Binary event log of libARStream, cheap enough to stay enabled in production
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_EventLog.h"
+#include "ARSTREAM_Time.h"
+#include "ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_EVENTLOG_TAG "ARSTREAM_EventLog"
+
+/**
+ * Period of the writes of the rings to the file
+ */
+#define ARSTREAM_EVENTLOG_DRAIN_PERIOD_MS (10)
+
+/**
+ * Alignment of the rings, to keep the writer and the drain thread on different cache lines
+ */
+#define ARSTREAM_EVENTLOG_CACHE_LINE (64)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Ring of events of one thread
+ * Written only by its thread, read only by the drain thread. Rings are pushed on a lock-free
+ * list by their threads, and only the drain thread removes them (once their thread exited).
+ */
+typedef struct ARSTREAM_EventLog_ThreadRing_t {
+    /* Writer side */
+    ARSTREAM_EventLog_Event_t *events;
+    uint32_t mask;
+    uint32_t writeIndex;
+    uint32_t nbLost;
+    int isDead;
+    uint16_t threadId;
+    struct ARSTREAM_EventLog_ThreadRing_t *next;
+
+    /* Drain thread side */
+    uint32_t readIndex __attribute__ ((aligned (ARSTREAM_EVENTLOG_CACHE_LINE)));
+} ARSTREAM_EventLog_ThreadRing_t;
+
+/*
+ * Globals
+ */
+
+int ARSTREAM_EventLog_IsStarted = 0;
+
+static pthread_once_t s_eventLogOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t s_eventLogKey;
+static ARSAL_Mutex_t s_eventLogMutex;
+static ARSAL_Cond_t s_eventLogCond;
+static ARSAL_Thread_t s_eventLogThread;
+static int s_eventLogThreadShouldStop = 0;
+static FILE *s_eventLogFile = NULL;
+static uint32_t s_eventLogEventsPerThread = ARSTREAM_EVENTLOG_DEFAULT_EVENTS_PER_THREAD;
+static uint32_t s_eventLogNbThreads = 0;
+static ARSTREAM_EventLog_ThreadRing_t *s_eventLogRings = NULL;
+static __thread ARSTREAM_EventLog_ThreadRing_t *s_eventLogThreadRing = NULL;
+
+static const char *s_eventLogNames [ARSTREAM_EVENT_MAX] = {
+    "LOST",
+    "SENDER_FRAME_QUEUED",
+    "SENDER_FRAME_STARTED",
+    "SENDER_FRAGMENT_SENT",
+    "SENDER_LATE_FRAGMENT_SENT",
+    "SENDER_ACK_RECEIVED",
+    "SENDER_FRAME_CANCELLED",
+    "SENDER_FLUSH_REQUESTED",
+    "READER_FRAGMENT_RECEIVED",
+    "READER_FRAME_COMPLETE",
+    "READER_FRAME_DROPPED",
+    "READER_FRAME_DISCARDED",
+    "READER_FRAMES_MISSED",
+    "READER_FLUSH_REQUESTED",
+    "SENDER_FRAME_REJECTED",
+    "SENDER_FRAME_POPPED",
+    "SENDER_SEND_ROUND",
+    "SENDER_FRAME_ACKNOWLEDGED",
+    "SENDER_CALLBACK_BEGIN",
+    "SENDER_CALLBACK_END",
+    "READER_FRAME_STARTED",
+    "READER_FRAME_INCOMPLETE",
+    "READER_CALLBACK_BEGIN",
+    "READER_CALLBACK_END",
+    "LOCK_WAIT",
+};
+
+static const char *s_eventLogLockNames [ARSTREAM_EVENT_LOCK_MAX] = {
+    "SENDER_NEXT_FRAME",
+    "SENDER_PACKETS_TO_SEND",
+    "SENDER_ACK",
+    "READER_ACK_PACKET",
+    "READER_ACK_SEND",
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Creates the thread key and the locks of the event log (called once)
+ */
+static void ARSTREAM_EventLog_InitOnce (void);
+
+/**
+ * @brief Marks the ring of an exiting thread as dead, so the drain thread frees it
+ * @param data The ring of the thread
+ */
+static void ARSTREAM_EventLog_ThreadExit (void *data);
+
+/**
+ * @brief Creates the ring of the calling thread, and registers it
+ * @return The ring, or NULL if it can not be allocated
+ */
+static ARSTREAM_EventLog_ThreadRing_t* ARSTREAM_EventLog_NewThreadRing (void);
+
+/**
+ * @brief Writes all pending events to a file, and frees the rings of the exited threads
+ * @param file The file, or NULL to drop the events
+ * @warning Must only be called by one thread at a time
+ */
+static void ARSTREAM_EventLog_Drain (FILE *file);
+
+/**
+ * @brief Drain thread : writes the rings to the file every ARSTREAM_EVENTLOG_DRAIN_PERIOD_MS
+ * @param param Unused
+ */
+static void* ARSTREAM_EventLog_RunDrainThread (void *param);
+
+/*
+ * Internal functions implementation
+ */
+
+static void ARSTREAM_EventLog_InitOnce (void)
+{
+    pthread_key_create (&s_eventLogKey, ARSTREAM_EventLog_ThreadExit);
+    ARSAL_Mutex_Init (&s_eventLogMutex);
+    ARSAL_Cond_Init (&s_eventLogCond);
+}
+
+static void ARSTREAM_EventLog_ThreadExit (void *data)
+{
+    ARSTREAM_EventLog_ThreadRing_t *ring = (ARSTREAM_EventLog_ThreadRing_t *)data;
+    /* An event recorded by a later thread destructor gets a new ring */
+    s_eventLogThreadRing = NULL;
+    __atomic_store_n (&(ring->isDead), 1, __ATOMIC_RELEASE);
+}
+
+static ARSTREAM_EventLog_ThreadRing_t* ARSTREAM_EventLog_NewThreadRing (void)
+{
+    ARSTREAM_EventLog_ThreadRing_t *ring = NULL;
+    uint32_t nbEvents = __atomic_load_n (&s_eventLogEventsPerThread, __ATOMIC_RELAXED);
+
+    pthread_once (&s_eventLogOnce, ARSTREAM_EventLog_InitOnce);
+
+    if (posix_memalign ((void **)&ring, ARSTREAM_EVENTLOG_CACHE_LINE, sizeof (ARSTREAM_EventLog_ThreadRing_t)) != 0)
+    {
+        return NULL;
+    }
+    memset (ring, 0, sizeof (ARSTREAM_EventLog_ThreadRing_t));
+    ring->events = malloc (nbEvents * sizeof (ARSTREAM_EventLog_Event_t));
+    if (ring->events == NULL)
+    {
+        free (ring);
+        return NULL;
+    }
+    ring->mask = nbEvents - 1;
+    ring->threadId = (uint16_t)__atomic_add_fetch (&s_eventLogNbThreads, 1, __ATOMIC_RELAXED);
+
+    pthread_setspecific (s_eventLogKey, ring);
+    s_eventLogThreadRing = ring;
+
+    ring->next = __atomic_load_n (&s_eventLogRings, __ATOMIC_RELAXED);
+    while (__atomic_compare_exchange_n (&s_eventLogRings, &(ring->next), ring, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED) == 0)
+    {
+        /* ring->next was updated with the new head, retry */
+    }
+    return ring;
+}
+
+static void ARSTREAM_EventLog_Drain (FILE *file)
+{
+    ARSTREAM_EventLog_ThreadRing_t *previous = NULL;
+    ARSTREAM_EventLog_ThreadRing_t *ring = __atomic_load_n (&s_eventLogRings, __ATOMIC_ACQUIRE);
+
+    while (ring != NULL)
+    {
+        ARSTREAM_EventLog_ThreadRing_t *next = ring->next;
+        /* Read isDead first : all the events of a dead thread are then visible */
+        int isDead = __atomic_load_n (&(ring->isDead), __ATOMIC_ACQUIRE);
+        uint32_t writeIndex = __atomic_load_n (&(ring->writeIndex), __ATOMIC_ACQUIRE);
+        uint32_t readIndex = ring->readIndex;
+        uint32_t nbLost;
+
+        while (readIndex != writeIndex)
+        {
+            uint32_t first = readIndex & ring->mask;
+            uint32_t count = writeIndex - readIndex;
+            if (count > ring->mask + 1 - first)
+            {
+                count = ring->mask + 1 - first;
+            }
+            if (file != NULL)
+            {
+                fwrite (&(ring->events [first]), sizeof (ARSTREAM_EventLog_Event_t), count, file);
+            }
+            readIndex += count;
+        }
+        __atomic_store_n (&(ring->readIndex), readIndex, __ATOMIC_RELEASE);
+
+        nbLost = __atomic_exchange_n (&(ring->nbLost), 0, __ATOMIC_RELAXED);
+        if ((nbLost > 0) &&
+            (file != NULL))
+        {
+            ARSTREAM_EventLog_Event_t lost;
+            memset (&lost, 0, sizeof (lost));
+            lost.timeUs = ARSTREAM_Time_GetMonotonicUs ();
+            lost.id = ARSTREAM_EVENT_LOST;
+            lost.threadId = ring->threadId;
+            lost.args [0] = nbLost;
+            fwrite (&lost, sizeof (lost), 1, file);
+        }
+
+        if (isDead == 0)
+        {
+            previous = ring;
+        }
+        else
+        {
+            /* Threads only push at the head of the list, so only the head needs a CAS */
+            if (previous != NULL)
+            {
+                previous->next = next;
+            }
+            else
+            {
+                ARSTREAM_EventLog_ThreadRing_t *head = ring;
+                if (__atomic_compare_exchange_n (&s_eventLogRings, &head, next, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == 0)
+                {
+                    /* New rings were pushed in front of the dead one */
+                    ARSTREAM_EventLog_ThreadRing_t *before = head;
+                    while (before->next != ring)
+                    {
+                        before = before->next;
+                    }
+                    before->next = next;
+                }
+            }
+            free (ring->events);
+            free (ring);
+        }
+        ring = next;
+    }
+}
+
+static void* ARSTREAM_EventLog_RunDrainThread (void *param)
+{
+    ARSAL_Mutex_Lock (&s_eventLogMutex);
+    while (s_eventLogThreadShouldStop == 0)
+    {
+        ARSAL_Mutex_Unlock (&s_eventLogMutex);
+        ARSTREAM_EventLog_Drain (s_eventLogFile);
+        fflush (s_eventLogFile);
+        ARSAL_Mutex_Lock (&s_eventLogMutex);
+        if (s_eventLogThreadShouldStop == 0)
+        {
+            ARSAL_Cond_Timedwait (&s_eventLogCond, &s_eventLogMutex, ARSTREAM_EVENTLOG_DRAIN_PERIOD_MS);
+        }
+    }
+    ARSAL_Mutex_Unlock (&s_eventLogMutex);
+    return (void *)0;
+}
+
+/*
+ * Implementation
+ */
+
+eARSTREAM_ERROR ARSTREAM_EventLog_Start (const char *path, uint32_t eventsPerThread)
+{
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    ARSTREAM_EventLog_FileHeader_t header;
+
+    if (eventsPerThread == 0)
+    {
+        eventsPerThread = ARSTREAM_EVENTLOG_DEFAULT_EVENTS_PER_THREAD;
+    }
+    if ((path == NULL) ||
+        ((eventsPerThread & (eventsPerThread - 1)) != 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    pthread_once (&s_eventLogOnce, ARSTREAM_EventLog_InitOnce);
+    ARSAL_Mutex_Lock (&s_eventLogMutex);
+    if (s_eventLogFile != NULL)
+    {
+        retVal = ARSTREAM_ERROR_BUSY;
+    }
+
+    if (retVal == ARSTREAM_OK)
+    {
+        s_eventLogFile = fopen (path, "wb");
+        if (s_eventLogFile == NULL)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_EVENTLOG_TAG, "Unable to create %s", path);
+            retVal = ARSTREAM_ERROR_BAD_PARAMETERS;
+        }
+    }
+
+    if (retVal == ARSTREAM_OK)
+    {
+        memset (&header, 0, sizeof (header));
+        header.magic = ARSTREAM_EVENTLOG_MAGIC;
+        header.version = ARSTREAM_EVENTLOG_VERSION;
+        header.eventSize = sizeof (ARSTREAM_EventLog_Event_t);
+        header.startTimeUs = ARSTREAM_Time_GetMonotonicUs ();
+        fwrite (&header, sizeof (header), 1, s_eventLogFile);
+
+        /* Drop the events recorded while the previous log was stopping */
+        ARSTREAM_EventLog_Drain (NULL);
+
+        __atomic_store_n (&s_eventLogEventsPerThread, eventsPerThread, __ATOMIC_RELAXED);
+        s_eventLogThreadShouldStop = 0;
+        if (ARSAL_Thread_Create (&s_eventLogThread, ARSTREAM_EventLog_RunDrainThread, NULL) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_EVENTLOG_TAG, "Unable to create the drain thread");
+            fclose (s_eventLogFile);
+            s_eventLogFile = NULL;
+            retVal = ARSTREAM_ERROR_ALLOC;
+        }
+    }
+
+    if (retVal == ARSTREAM_OK)
+    {
+        __atomic_store_n (&ARSTREAM_EventLog_IsStarted, 1, __ATOMIC_RELEASE);
+    }
+    ARSAL_Mutex_Unlock (&s_eventLogMutex);
+    return retVal;
+}
+
+void ARSTREAM_EventLog_Stop (void)
+{
+    FILE *file;
+
+    pthread_once (&s_eventLogOnce, ARSTREAM_EventLog_InitOnce);
+    ARSAL_Mutex_Lock (&s_eventLogMutex);
+    file = s_eventLogFile;
+    if ((file == NULL) ||
+        (s_eventLogThreadShouldStop == 1))
+    {
+        ARSAL_Mutex_Unlock (&s_eventLogMutex);
+        return;
+    }
+    __atomic_store_n (&ARSTREAM_EventLog_IsStarted, 0, __ATOMIC_RELEASE);
+    s_eventLogThreadShouldStop = 1;
+    ARSAL_Cond_Signal (&s_eventLogCond);
+    ARSAL_Mutex_Unlock (&s_eventLogMutex);
+
+    ARSAL_Thread_Join (s_eventLogThread, NULL);
+    ARSAL_Thread_Destroy (&s_eventLogThread);
+    ARSTREAM_EventLog_Drain (file);
+    fclose (file);
+
+    ARSAL_Mutex_Lock (&s_eventLogMutex);
+    s_eventLogFile = NULL;
+    ARSAL_Mutex_Unlock (&s_eventLogMutex);
+}
+
+void ARSTREAM_EventLog_Record (uint16_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    ARSTREAM_EventLog_ThreadRing_t *ring = s_eventLogThreadRing;
+    ARSTREAM_EventLog_Event_t *event;
+    uint32_t writeIndex;
+
+    if (__atomic_load_n (&ARSTREAM_EventLog_IsStarted, __ATOMIC_RELAXED) == 0)
+    {
+        return;
+    }
+    if (ring == NULL)
+    {
+        ring = ARSTREAM_EventLog_NewThreadRing ();
+        if (ring == NULL)
+        {
+            return;
+        }
+    }
+
+    writeIndex = ring->writeIndex;
+    if ((writeIndex - __atomic_load_n (&(ring->readIndex), __ATOMIC_ACQUIRE)) > ring->mask)
+    {
+        __atomic_fetch_add (&(ring->nbLost), 1, __ATOMIC_RELAXED);
+        return;
+    }
+    event = &(ring->events [writeIndex & ring->mask]);
+    event->timeUs = ARSTREAM_Time_GetMonotonicUs ();
+    event->id = id;
+    event->threadId = ring->threadId;
+    event->args [0] = arg0;
+    event->args [1] = arg1;
+    event->args [2] = arg2;
+    __atomic_store_n (&(ring->writeIndex), writeIndex + 1, __ATOMIC_RELEASE);
+}
+
+void ARSTREAM_EventLog_MutexLock (ARSAL_Mutex_t *mutex, eARSTREAM_EVENT_LOCK lock)
+{
+    uint64_t startUs, endUs;
+
+    if (ARSAL_Mutex_Trylock (mutex) == 0)
+    {
+        return;
+    }
+    startUs = ARSTREAM_Time_GetMonotonicUs ();
+    ARSAL_Mutex_Lock (mutex);
+    endUs = ARSTREAM_Time_GetMonotonicUs ();
+    ARSTREAM_EventLog_Record (ARSTREAM_EVENT_LOCK_WAIT, lock, (uint32_t)(endUs - startUs), 0);
+}
+
+const char* ARSTREAM_EventLog_GetEventName (uint16_t id)
+{
+    if (id >= ARSTREAM_EVENT_USER)
+    {
+        return "USER";
+    }
+    if (id >= ARSTREAM_EVENT_MAX)
+    {
+        return "UNKNOWN";
+    }
+    return s_eventLogNames [id];
+}
+
+const char* ARSTREAM_EventLog_GetLockName (uint32_t lock)
+{
+    if (lock >= ARSTREAM_EVENT_LOCK_MAX)
+    {
+        return "UNKNOWN";
+    }
+    return s_eventLogLockNames [lock];
+}
@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_EventLog.h
+ * @brief Recording of binary events from the library hot paths
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_EVENTLOG_PRIVATE_H_
+#define _ARSTREAM_EVENTLOG_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_EventLog.h>
+#include <libARSAL/ARSAL_Mutex.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Records an event if the event log is started
+ * Arguments are not evaluated when the log is stopped, so the hot paths only pay a load and a branch
+ */
+#define ARSTREAM_EVENT(id, arg0, arg1, arg2)                                                   \
+    do                                                                                         \
+    {                                                                                          \
+        if (__builtin_expect (__atomic_load_n (&ARSTREAM_EventLog_IsStarted, __ATOMIC_RELAXED), 0)) \
+        {                                                                                      \
+            ARSTREAM_EventLog_Record ((id), (uint32_t)(arg0), (uint32_t)(arg1), (uint32_t)(arg2)); \
+        }                                                                                      \
+    } while (0)
+
+/**
+ * @brief Locks a mutex. If the event log is started and the mutex is already held, the wait is recorded
+ * @param mutex Pointer to the ARSAL_Mutex_t
+ * @param lock Id of the lock (eARSTREAM_EVENT_LOCK)
+ */
+#define ARSTREAM_EVENT_MUTEX_LOCK(mutex, lock)                                                 \
+    do                                                                                         \
+    {                                                                                          \
+        if (__builtin_expect (__atomic_load_n (&ARSTREAM_EventLog_IsStarted, __ATOMIC_RELAXED), 0)) \
+        {                                                                                      \
+            ARSTREAM_EventLog_MutexLock ((mutex), (lock));                                     \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+            ARSAL_Mutex_Lock (mutex);                                                          \
+        }                                                                                      \
+    } while (0)
+
+/*
+ * Globals
+ */
+
+/**
+ * @brief 1 while the event log is started
+ */
+extern int ARSTREAM_EventLog_IsStarted;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Locks a mutex, and records an ARSTREAM_EVENT_LOCK_WAIT event if it was already held
+ * @param mutex The mutex
+ * @param lock Id of the lock (eARSTREAM_EVENT_LOCK)
+ * @note Use ARSTREAM_EVENT_MUTEX_LOCK(), which avoids the try-lock while the log is stopped
+ */
+void ARSTREAM_EventLog_MutexLock (ARSAL_Mutex_t *mutex, eARSTREAM_EVENT_LOCK lock);
+
+#endif /* _ARSTREAM_EVENTLOG_PRIVATE_H_ */
@@ -0,0 +1,202 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Histogram.c
+ * @brief Log-linear histograms of durations, used for libARStream statistics
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Private Headers
+ */
+#include "ARSTREAM_Histogram.h"
+
+/*
+ * ARSDK Headers
+ */
+
+/*
+ * Macros
+ */
+#define ARSTREAM_HISTOGRAM_SUB_BUCKETS (1 << ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS)
+
+/*
+ * Types
+ */
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Gets the bucket which holds a value
+ * @param value The value
+ * @return The index of the bucket
+ */
+static int ARSTREAM_Histogram_GetBucket (uint32_t value);
+
+/*
+ * Internal functions implementation
+ */
+
+static int ARSTREAM_Histogram_GetBucket (uint32_t value)
+{
+    int msb;
+    if (value < ARSTREAM_HISTOGRAM_SUB_BUCKETS)
+    {
+        return value;
+    }
+    msb = 31 - __builtin_clz (value);
+    return ((msb - ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS + 1) << ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS) +
+        (int)(value >> (msb - ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS)) - ARSTREAM_HISTOGRAM_SUB_BUCKETS;
+}
+
+/*
+ * Implementation
+ */
+
+void ARSTREAM_Histogram_Reset (ARSTREAM_Histogram_t *histogram)
+{
+    if (histogram != NULL)
+    {
+        memset (histogram, 0, sizeof (ARSTREAM_Histogram_t));
+        histogram->min = UINT32_MAX;
+    }
+}
+
+void ARSTREAM_Histogram_Record (ARSTREAM_Histogram_t *histogram, uint32_t value)
+{
+    uint32_t current;
+    __sync_fetch_and_add (&(histogram->buckets [ARSTREAM_Histogram_GetBucket (value)]), 1);
+    __sync_fetch_and_add (&(histogram->sum), (uint64_t)value);
+    __sync_fetch_and_add (&(histogram->count), 1);
+
+    current = histogram->min;
+    while ((value < current) &&
+           (__sync_bool_compare_and_swap (&(histogram->min), current, value) == 0))
+    {
+        current = histogram->min;
+    }
+    current = histogram->max;
+    while ((value > current) &&
+           (__sync_bool_compare_and_swap (&(histogram->max), current, value) == 0))
+    {
+        current = histogram->max;
+    }
+}
+
+void ARSTREAM_Histogram_Snapshot (ARSTREAM_Histogram_t *histogram, ARSTREAM_Histogram_t *snapshot)
+{
+    int i;
+    if ((histogram == NULL) ||
+        (snapshot == NULL))
+    {
+        return;
+    }
+    snapshot->count = __sync_fetch_and_add (&(histogram->count), 0);
+    snapshot->sum = __sync_fetch_and_add (&(histogram->sum), 0);
+    snapshot->min = __sync_fetch_and_add (&(histogram->min), 0);
+    snapshot->max = __sync_fetch_and_add (&(histogram->max), 0);
+    for (i = 0; i < ARSTREAM_HISTOGRAM_NB_BUCKETS; i++)
+    {
+        snapshot->buckets [i] = __sync_fetch_and_add (&(histogram->buckets [i]), 0);
+    }
+}
+
+uint32_t ARSTREAM_Histogram_GetBucketLowerBound (int bucket)
+{
+    int exponent;
+    if ((bucket < 0) ||
+        (bucket >= ARSTREAM_HISTOGRAM_NB_BUCKETS))
+    {
+        return UINT32_MAX;
+    }
+    if (bucket < ARSTREAM_HISTOGRAM_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    exponent = (bucket >> ARSTREAM_HISTOGRAM_SUB_BUCKETS_BITS) - 1;
+    return (uint32_t)(ARSTREAM_HISTOGRAM_SUB_BUCKETS + (bucket & (ARSTREAM_HISTOGRAM_SUB_BUCKETS - 1))) << exponent;
+}
+
+uint32_t ARSTREAM_Histogram_GetPercentile (const ARSTREAM_Histogram_t *histogram, float percentile)
+{
+    uint64_t rank;
+    uint64_t seen = 0;
+    int i;
+    if ((histogram == NULL) ||
+        (histogram->count == 0))
+    {
+        return 0;
+    }
+    if (percentile < 0.f)
+    {
+        percentile = 0.f;
+    }
+    if (percentile > 100.f)
+    {
+        percentile = 100.f;
+    }
+    rank = (uint64_t)((percentile / 100.f) * histogram->count);
+    if (rank >= histogram->count)
+    {
+        rank = histogram->count - 1;
+    }
+    for (i = 0; i < ARSTREAM_HISTOGRAM_NB_BUCKETS; i++)
+    {
+        seen += histogram->buckets [i];
+        if (seen > rank)
+        {
+            uint32_t upperBound = (i + 1 < ARSTREAM_HISTOGRAM_NB_BUCKETS) ? ARSTREAM_Histogram_GetBucketLowerBound (i + 1) - 1 : UINT32_MAX;
+            return (upperBound < histogram->max) ? upperBound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+uint32_t ARSTREAM_Histogram_GetMean (const ARSTREAM_Histogram_t *histogram)
+{
+    if ((histogram == NULL) ||
+        (histogram->count == 0))
+    {
+        return 0;
+    }
+    return (uint32_t)(histogram->sum / histogram->count);
+}
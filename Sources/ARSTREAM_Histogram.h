@@ -0,0 +1,78 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Histogram.h
+ * @brief Lock-free recording of log-linear histograms
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_HISTOGRAM_PRIVATE_H_
+#define _ARSTREAM_HISTOGRAM_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Histogram.h>
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Empties an histogram
+ * @param histogram The histogram to reset
+ * @warning This function is not thread safe, and must not be called while values are recorded
+ */
+void ARSTREAM_Histogram_Reset (ARSTREAM_Histogram_t *histogram);
+
+/**
+ * @brief Adds a value to an histogram
+ * @param histogram The histogram
+ * @param value The value to add
+ * @note This function is lock-free, and can be called concurrently from multiple threads
+ */
+void ARSTREAM_Histogram_Record (ARSTREAM_Histogram_t *histogram, uint32_t value);
+
+/**
+ * @brief Copies an histogram which may be updated concurrently
+ * @param histogram The histogram to copy
+ * @param snapshot The copy
+ * @note Each counter is read atomically, but values recorded during the copy may be only partially accounted for
+ */
+void ARSTREAM_Histogram_Snapshot (ARSTREAM_Histogram_t *histogram, ARSTREAM_Histogram_t *snapshot);
+
+#endif /* _ARSTREAM_HISTOGRAM_PRIVATE_H_ */
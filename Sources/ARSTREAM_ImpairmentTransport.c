@@ -0,0 +1,835 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_ImpairmentTransport.c
+ * @brief Stream transport decorator emulating loss, delay, jitter, reordering and bandwidth caps
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Private Headers
+ */
+
+#include "ARSTREAM_Time.h"
+#include "ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARStream/ARSTREAM_Impairment.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_IMPAIRMENT_TAG "ARSTREAM_Impairment"
+
+/**
+ * Initial capacity of the delayed packets heap
+ */
+#define ARSTREAM_IMPAIRMENT_HEAP_INITIAL_CAPACITY (256)
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief A delayed packet
+ */
+typedef struct {
+    uint64_t dueUs; /* Time to give the packet to the underlying transport */
+    uint64_t sequence; /* Keeps packets with the same due time in order */
+    eARSTREAM_TRANSPORT_CHANNEL channel;
+    uint8_t *data;
+    uint32_t size;
+} ARSTREAM_ImpairmentTransport_Packet_t;
+
+/**
+ * @brief State of one impaired direction
+ */
+typedef struct {
+    ARSTREAM_Impairment_Direction_t config;
+    int isPerfect; /* No delay, reordering nor rate cap : packets are sent synchronously */
+    uint64_t random; /* xorshift64* state */
+    int badState; /* Gilbert-Elliott state */
+    double tokens; /* Token bucket, in bytes. Negative when packets wait for the link */
+    uint64_t tokensTimeUs;
+    uint64_t lastDueUs; /* Jitter does not reorder packets : only reorderRate does */
+    ARSTREAM_Impairment_Stats_t stats;
+} ARSTREAM_ImpairmentTransport_Direction_t;
+
+typedef struct {
+    ARSTREAM_Transport_t *transport; /* Underlying transport */
+    ARSTREAM_Transport_Ops_t ops; /* Zero-copy receives are only offered if the underlying transport has them */
+    ARSTREAM_ImpairmentTransport_Direction_t directions [ARSTREAM_TRANSPORT_CHANNEL_MAX];
+
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t cond;
+    ARSAL_Thread_t thread;
+    int threadStarted;
+    int threadShouldStop;
+
+    /* Min-heap of the delayed packets, by due time */
+    ARSTREAM_ImpairmentTransport_Packet_t *heap;
+    int heapSize;
+    int heapCapacity;
+    uint64_t nextSequence;
+} ARSTREAM_ImpairmentTransport_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Gets the next number of a random generator
+ * @param state The generator state
+ * @return A uniform random number in [0, 1)
+ */
+static double ARSTREAM_ImpairmentTransport_Random (uint64_t *state);
+
+/**
+ * @brief Checks the configuration of a direction
+ * @param config The configuration
+ * @return 1 if the configuration is valid, 0 otherwise
+ */
+static int ARSTREAM_ImpairmentTransport_CheckConfig (const ARSTREAM_Impairment_Direction_t *config);
+
+/**
+ * @brief Runs the loss model of a direction
+ * @param direction The direction
+ * @return 1 if the packet is lost, 0 otherwise
+ */
+static int ARSTREAM_ImpairmentTransport_IsLost (ARSTREAM_ImpairmentTransport_Direction_t *direction);
+
+/**
+ * @brief Runs the token bucket of a direction
+ * @param direction The direction
+ * @param size The packet size, in bytes
+ * @param nowUs The current time
+ * @param[out] departureUs Time at which the packet has left the link queue
+ * @return 1 if the packet fits in the link queue, 0 if it overflows
+ */
+static int ARSTREAM_ImpairmentTransport_Shape (ARSTREAM_ImpairmentTransport_Direction_t *direction, uint32_t size, uint64_t nowUs, uint64_t *departureUs);
+
+/**
+ * @brief Draws the delay of a packet
+ * @param direction The direction
+ * @return The delay, in us
+ */
+static uint64_t ARSTREAM_ImpairmentTransport_GetDelay (ARSTREAM_ImpairmentTransport_Direction_t *direction);
+
+/**
+ * @brief Checks whether a delayed packet must be sent before another one
+ */
+static int ARSTREAM_ImpairmentTransport_IsBefore (ARSTREAM_ImpairmentTransport_Packet_t *a, ARSTREAM_ImpairmentTransport_Packet_t *b);
+
+/**
+ * @brief Adds a packet to the delayed packets heap (mutex must be locked)
+ * @return 1 on success, 0 on allocation failure
+ */
+static int ARSTREAM_ImpairmentTransport_HeapPush (ARSTREAM_ImpairmentTransport_t *transport, ARSTREAM_ImpairmentTransport_Packet_t *packet);
+
+/**
+ * @brief Removes the first packet of the delayed packets heap (mutex must be locked, heap must not be empty)
+ * @param[out] packet The removed packet
+ */
+static void ARSTREAM_ImpairmentTransport_HeapPop (ARSTREAM_ImpairmentTransport_t *transport, ARSTREAM_ImpairmentTransport_Packet_t *packet);
+
+/**
+ * @brief Sends a packet through the impairments of its channel
+ * As with the send() operation, the callback is only called if ARSTREAM_OK is returned
+ * @return ARSTREAM_OK if the packet was accepted (sent, delayed or lost), or an error from the underlying transport
+ */
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_SendOne (ARSTREAM_ImpairmentTransport_t *transport, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *header, uint32_t headerSize, uint8_t *payload, uint32_t payloadSize, ARSTREAM_Transport_SendCallback_t callback, void *callbackData);
+
+/**
+ * @brief Gives the delayed packets to the underlying transport when their time comes
+ * @param ARSTREAM_ImpairmentTransport_t_Param The impaired transport
+ */
+static void* ARSTREAM_ImpairmentTransport_RunThread (void *ARSTREAM_ImpairmentTransport_t_Param);
+
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData);
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs);
+static void ARSTREAM_ImpairmentTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static int ARSTREAM_ImpairmentTransport_GetEstimatedLatency (void *context);
+static void ARSTREAM_ImpairmentTransport_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static const ARSTREAM_Transport_Ops_t ARSTREAM_ImpairmentTransport_Ops = {
+    .send = ARSTREAM_ImpairmentTransport_Send,
+    .receive = ARSTREAM_ImpairmentTransport_Receive,
+    .sendPackets = ARSTREAM_ImpairmentTransport_SendPackets,
+    .receiveBegin = ARSTREAM_ImpairmentTransport_ReceiveBegin,
+    .receiveEnd = ARSTREAM_ImpairmentTransport_ReceiveEnd,
+    .flush = ARSTREAM_ImpairmentTransport_Flush,
+    .getEstimatedLatency = ARSTREAM_ImpairmentTransport_GetEstimatedLatency,
+    .destroy = ARSTREAM_ImpairmentTransport_Destroy,
+};
+
+static double ARSTREAM_ImpairmentTransport_Random (uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return (double)((x * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int ARSTREAM_ImpairmentTransport_CheckConfig (const ARSTREAM_Impairment_Direction_t *config)
+{
+    return ((config->lossModel >= ARSTREAM_IMPAIRMENT_LOSS_NONE) &&
+            (config->lossModel < ARSTREAM_IMPAIRMENT_LOSS_MAX) &&
+            (config->delayDistribution >= ARSTREAM_IMPAIRMENT_DELAY_UNIFORM) &&
+            (config->delayDistribution < ARSTREAM_IMPAIRMENT_DELAY_MAX) &&
+            (config->lossRate >= 0.f) && (config->lossRate <= 1.f) &&
+            (config->goodToBadRate >= 0.f) && (config->goodToBadRate <= 1.f) &&
+            (config->badToGoodRate >= 0.f) && (config->badToGoodRate <= 1.f) &&
+            (config->goodLossRate >= 0.f) && (config->goodLossRate <= 1.f) &&
+            (config->badLossRate >= 0.f) && (config->badLossRate <= 1.f) &&
+            (config->reorderRate >= 0.f) && (config->reorderRate <= 1.f)) ? 1 : 0;
+}
+
+static int ARSTREAM_ImpairmentTransport_IsLost (ARSTREAM_ImpairmentTransport_Direction_t *direction)
+{
+    int retVal = 0;
+    switch (direction->config.lossModel)
+    {
+    case ARSTREAM_IMPAIRMENT_LOSS_BERNOULLI:
+        retVal = (ARSTREAM_ImpairmentTransport_Random (&(direction->random)) < direction->config.lossRate) ? 1 : 0;
+        break;
+    case ARSTREAM_IMPAIRMENT_LOSS_GILBERT_ELLIOTT:
+        if (direction->badState == 0)
+        {
+            direction->badState = (ARSTREAM_ImpairmentTransport_Random (&(direction->random)) < direction->config.goodToBadRate) ? 1 : 0;
+        }
+        else
+        {
+            direction->badState = (ARSTREAM_ImpairmentTransport_Random (&(direction->random)) < direction->config.badToGoodRate) ? 0 : 1;
+        }
+        retVal = (ARSTREAM_ImpairmentTransport_Random (&(direction->random)) < ((direction->badState == 1) ? direction->config.badLossRate : direction->config.goodLossRate)) ? 1 : 0;
+        break;
+    default:
+        break;
+    }
+    return retVal;
+}
+
+static int ARSTREAM_ImpairmentTransport_Shape (ARSTREAM_ImpairmentTransport_Direction_t *direction, uint32_t size, uint64_t nowUs, uint64_t *departureUs)
+{
+    double bytesPerUs = (double)direction->config.rateKbps / 8000.0;
+
+    *departureUs = nowUs;
+    if (direction->config.rateKbps == 0)
+    {
+        return 1;
+    }
+
+    /* Refill, up to the bucket size */
+    direction->tokens += (double)(nowUs - direction->tokensTimeUs) * bytesPerUs;
+    direction->tokensTimeUs = nowUs;
+    if (direction->tokens > (double)direction->config.burstBytes)
+    {
+        direction->tokens = (double)direction->config.burstBytes;
+    }
+
+    /* Negative tokens are the bytes queued before this packet can leave */
+    if ((direction->config.queueBytes != 0) &&
+        ((direction->tokens - (double)size) < -(double)direction->config.queueBytes))
+    {
+        return 0;
+    }
+    direction->tokens -= (double)size;
+    if (direction->tokens < 0.0)
+    {
+        *departureUs = nowUs + (uint64_t)(-direction->tokens / bytesPerUs);
+    }
+    return 1;
+}
+
+static uint64_t ARSTREAM_ImpairmentTransport_GetDelay (ARSTREAM_ImpairmentTransport_Direction_t *direction)
+{
+    double delayUs = (double)direction->config.delayUs;
+
+    if (direction->config.jitterUs > 0)
+    {
+        if (direction->config.delayDistribution == ARSTREAM_IMPAIRMENT_DELAY_NORMAL)
+        {
+            /* Irwin-Hall : the sum of 12 uniform numbers, minus 6, is close to a standard normal (without libm) */
+            double sum = -6.0;
+            int i;
+            for (i = 0; i < 12; i++)
+            {
+                sum += ARSTREAM_ImpairmentTransport_Random (&(direction->random));
+            }
+            delayUs += (double)direction->config.jitterUs * sum;
+        }
+        else
+        {
+            delayUs += (double)direction->config.jitterUs * ((2.0 * ARSTREAM_ImpairmentTransport_Random (&(direction->random))) - 1.0);
+        }
+    }
+    return (delayUs > 0.0) ? (uint64_t)delayUs : 0;
+}
+
+static int ARSTREAM_ImpairmentTransport_IsBefore (ARSTREAM_ImpairmentTransport_Packet_t *a, ARSTREAM_ImpairmentTransport_Packet_t *b)
+{
+    return ((a->dueUs < b->dueUs) ||
+            ((a->dueUs == b->dueUs) && (a->sequence < b->sequence))) ? 1 : 0;
+}
+
+static int ARSTREAM_ImpairmentTransport_HeapPush (ARSTREAM_ImpairmentTransport_t *transport, ARSTREAM_ImpairmentTransport_Packet_t *packet)
+{
+    int index;
+
+    if (transport->heapSize == transport->heapCapacity)
+    {
+        int newCapacity = transport->heapCapacity * 2;
+        ARSTREAM_ImpairmentTransport_Packet_t *newHeap = realloc (transport->heap, newCapacity * sizeof (ARSTREAM_ImpairmentTransport_Packet_t));
+        if (newHeap == NULL)
+        {
+            return 0;
+        }
+        transport->heap = newHeap;
+        transport->heapCapacity = newCapacity;
+    }
+
+    index = transport->heapSize++;
+    while ((index > 0) &&
+           (ARSTREAM_ImpairmentTransport_IsBefore (packet, &(transport->heap [(index - 1) / 2])) == 1))
+    {
+        transport->heap [index] = transport->heap [(index - 1) / 2];
+        index = (index - 1) / 2;
+    }
+    transport->heap [index] = *packet;
+    return 1;
+}
+
+static void ARSTREAM_ImpairmentTransport_HeapPop (ARSTREAM_ImpairmentTransport_t *transport, ARSTREAM_ImpairmentTransport_Packet_t *packet)
+{
+    ARSTREAM_ImpairmentTransport_Packet_t last;
+    int index = 0;
+
+    *packet = transport->heap [0];
+    last = transport->heap [--transport->heapSize];
+    while (1)
+    {
+        int child = (2 * index) + 1;
+        if (child >= transport->heapSize)
+        {
+            break;
+        }
+        if (((child + 1) < transport->heapSize) &&
+            (ARSTREAM_ImpairmentTransport_IsBefore (&(transport->heap [child + 1]), &(transport->heap [child])) == 1))
+        {
+            child++;
+        }
+        if (ARSTREAM_ImpairmentTransport_IsBefore (&last, &(transport->heap [child])) == 1)
+        {
+            break;
+        }
+        transport->heap [index] = transport->heap [child];
+        index = child;
+    }
+    transport->heap [index] = last;
+}
+
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_SendOne (ARSTREAM_ImpairmentTransport_t *transport, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *header, uint32_t headerSize, uint8_t *payload, uint32_t payloadSize, ARSTREAM_Transport_SendCallback_t callback, void *callbackData)
+{
+    ARSTREAM_ImpairmentTransport_Direction_t *direction = &(transport->directions [channel]);
+    ARSTREAM_ImpairmentTransport_Packet_t packet;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    uint32_t size = headerSize + payloadSize;
+    uint64_t nowUs = ARSTREAM_Time_GetMonotonicUs ();
+    uint64_t departureUs;
+    int lost;
+    int accepted;
+
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    direction->stats.packets++;
+    direction->stats.bytes += size;
+    lost = ARSTREAM_ImpairmentTransport_IsLost (direction);
+    if (lost == 1)
+    {
+        direction->stats.lost++;
+    }
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+
+    if ((lost == 0) &&
+        (direction->isPerfect == 1))
+    {
+        /* Nothing to delay : send synchronously, the underlying transport reports the status */
+        if (payloadSize == 0)
+        {
+            retVal = transport->transport->ops->send (transport->transport->context, channel, header, headerSize, callback, callbackData);
+        }
+        else if (transport->transport->ops->sendPackets != NULL)
+        {
+            /* sendPackets always calls the callback : report the status ourselves, with the send() semantics */
+            ARSTREAM_Transport_Packet_t batchPacket = { header, headerSize, payload, payloadSize, NULL, NULL };
+            retVal = transport->transport->ops->sendPackets (transport->transport->context, channel, &batchPacket, 1);
+            if ((retVal == ARSTREAM_OK) &&
+                (callback != NULL))
+            {
+                callback (callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+            }
+        }
+        else
+        {
+            retVal = ARSTREAM_ERROR_ALLOC;
+            packet.data = malloc (size);
+            if (packet.data != NULL)
+            {
+                memcpy (packet.data, header, headerSize);
+                memcpy (&packet.data [headerSize], payload, payloadSize);
+                retVal = transport->transport->ops->send (transport->transport->context, channel, packet.data, size, callback, callbackData);
+                free (packet.data);
+            }
+        }
+        if (retVal == ARSTREAM_OK)
+        {
+            ARSAL_Mutex_Lock (&(transport->mutex));
+            direction->stats.delivered++;
+            ARSAL_Mutex_Unlock (&(transport->mutex));
+        }
+        return retVal;
+    }
+
+    if (lost == 0)
+    {
+        packet.data = malloc (size);
+        if (packet.data == NULL)
+        {
+            return ARSTREAM_ERROR_ALLOC;
+        }
+        memcpy (packet.data, header, headerSize);
+        if (payloadSize > 0)
+        {
+            memcpy (&packet.data [headerSize], payload, payloadSize);
+        }
+        packet.size = size;
+        packet.channel = channel;
+
+        ARSAL_Mutex_Lock (&(transport->mutex));
+        accepted = ARSTREAM_ImpairmentTransport_Shape (direction, size, nowUs, &departureUs);
+        if (accepted == 0)
+        {
+            direction->stats.overflows++;
+        }
+        else
+        {
+            packet.dueUs = departureUs;
+            if (ARSTREAM_ImpairmentTransport_Random (&(direction->random)) < direction->config.reorderRate)
+            {
+                direction->stats.reordered++;
+            }
+            else
+            {
+                packet.dueUs += ARSTREAM_ImpairmentTransport_GetDelay (direction);
+                if (packet.dueUs < direction->lastDueUs)
+                {
+                    packet.dueUs = direction->lastDueUs;
+                }
+                direction->lastDueUs = packet.dueUs;
+            }
+            packet.sequence = transport->nextSequence++;
+            accepted = ARSTREAM_ImpairmentTransport_HeapPush (transport, &packet);
+            if (accepted == 1)
+            {
+                ARSAL_Cond_Signal (&(transport->cond));
+            }
+            else
+            {
+                retVal = ARSTREAM_ERROR_ALLOC;
+            }
+        }
+        ARSAL_Mutex_Unlock (&(transport->mutex));
+
+        if (accepted == 0)
+        {
+            free (packet.data);
+        }
+    }
+
+    /* Lost, dropped by the link queue or delayed : the packet left the sender, as on a real network */
+    if ((retVal == ARSTREAM_OK) &&
+        (callback != NULL))
+    {
+        callback (callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+    return retVal;
+}
+
+static void* ARSTREAM_ImpairmentTransport_RunThread (void *ARSTREAM_ImpairmentTransport_t_Param)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)ARSTREAM_ImpairmentTransport_t_Param;
+    ARSTREAM_ImpairmentTransport_Packet_t packet;
+
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    while (transport->threadShouldStop == 0)
+    {
+        uint64_t nowUs = ARSTREAM_Time_GetMonotonicUs ();
+        if (transport->heapSize == 0)
+        {
+            ARSAL_Cond_Wait (&(transport->cond), &(transport->mutex));
+        }
+        else if (transport->heap [0].dueUs > nowUs)
+        {
+            ARSAL_Cond_Timedwait (&(transport->cond), &(transport->mutex), (int)(((transport->heap [0].dueUs - nowUs) + 999) / 1000));
+        }
+        else
+        {
+            ARSTREAM_ImpairmentTransport_HeapPop (transport, &packet);
+            ARSAL_Mutex_Unlock (&(transport->mutex));
+
+            if (transport->transport->ops->send (transport->transport->context, packet.channel, packet.data, packet.size, NULL, NULL) == ARSTREAM_OK)
+            {
+                ARSAL_Mutex_Lock (&(transport->mutex));
+                transport->directions [packet.channel].stats.delivered++;
+                ARSAL_Mutex_Unlock (&(transport->mutex));
+            }
+            free (packet.data);
+
+            ARSAL_Mutex_Lock (&(transport->mutex));
+        }
+    }
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+    return NULL;
+}
+
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    if ((channel < ARSTREAM_TRANSPORT_CHANNEL_DATA) ||
+        (channel >= ARSTREAM_TRANSPORT_CHANNEL_MAX))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    return ARSTREAM_ImpairmentTransport_SendOne (transport, channel, data, size, NULL, 0, callback, callbackData);
+}
+
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    return transport->transport->ops->receive (transport->transport->context, channel, buffer, bufferSize, receivedSize, timeoutMs);
+}
+
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    int i;
+
+    if ((channel < ARSTREAM_TRANSPORT_CHANNEL_DATA) ||
+        (channel >= ARSTREAM_TRANSPORT_CHANNEL_MAX))
+    {
+        retVal = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    for (i = 0; i < nbPackets; i++)
+    {
+        if (retVal == ARSTREAM_OK)
+        {
+            retVal = ARSTREAM_ImpairmentTransport_SendOne (transport, channel, packets [i].header, packets [i].headerSize, packets [i].payload, packets [i].payloadSize, packets [i].callback, packets [i].callbackData);
+        }
+        if ((retVal != ARSTREAM_OK) &&
+            (packets [i].callback != NULL))
+        {
+            packets [i].callback (packets [i].callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+        }
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    return transport->transport->ops->receiveBegin (transport->transport->context, channel, data, receivedSize, timeoutMs);
+}
+
+static void ARSTREAM_ImpairmentTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    transport->transport->ops->receiveEnd (transport->transport->context, channel);
+}
+
+static eARSTREAM_ERROR ARSTREAM_ImpairmentTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    int i;
+    int kept = 0;
+
+    /* Drop the delayed packets of the channel. Keeping the array order keeps it a valid heap */
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    for (i = 0; i < transport->heapSize; i++)
+    {
+        if (transport->heap [i].channel == channel)
+        {
+            free (transport->heap [i].data);
+        }
+        else
+        {
+            ARSTREAM_ImpairmentTransport_Packet_t packet = transport->heap [i];
+            int index = kept++;
+            while ((index > 0) &&
+                   (ARSTREAM_ImpairmentTransport_IsBefore (&packet, &(transport->heap [(index - 1) / 2])) == 1))
+            {
+                transport->heap [index] = transport->heap [(index - 1) / 2];
+                index = (index - 1) / 2;
+            }
+            transport->heap [index] = packet;
+        }
+    }
+    transport->heapSize = kept;
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+
+    return transport->transport->ops->flush (transport->transport->context, channel);
+}
+
+static int ARSTREAM_ImpairmentTransport_GetEstimatedLatency (void *context)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    int latency = transport->transport->ops->getEstimatedLatency (transport->transport->context);
+    int addedMs = (int)((transport->directions [ARSTREAM_TRANSPORT_CHANNEL_DATA].config.delayUs + transport->directions [ARSTREAM_TRANSPORT_CHANNEL_ACK].config.delayUs) / 1000);
+
+    /* The emulated round trip comes on top of the real one */
+    return (latency < 0) ? addedMs : latency + addedMs;
+}
+
+static void ARSTREAM_ImpairmentTransport_Destroy (void *context)
+{
+    ARSTREAM_ImpairmentTransport_t *transport = (ARSTREAM_ImpairmentTransport_t *)context;
+    int i;
+
+    if (transport->threadStarted == 1)
+    {
+        ARSAL_Mutex_Lock (&(transport->mutex));
+        transport->threadShouldStop = 1;
+        ARSAL_Cond_Signal (&(transport->cond));
+        ARSAL_Mutex_Unlock (&(transport->mutex));
+        ARSAL_Thread_Join (transport->thread, NULL);
+        ARSAL_Thread_Destroy (&(transport->thread));
+    }
+
+    /* Packets still delayed are lost with the link */
+    for (i = 0; i < transport->heapSize; i++)
+    {
+        free (transport->heap [i].data);
+    }
+    free (transport->heap);
+    ARSAL_Cond_Destroy (&(transport->cond));
+    ARSAL_Mutex_Destroy (&(transport->mutex));
+    free (transport);
+}
+
+/*
+ * Implementation
+ */
+
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewImpaired (ARSTREAM_Transport_t *transport, const ARSTREAM_Impairment_Config_t *config, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Transport_t *retTransport = NULL;
+    ARSTREAM_ImpairmentTransport_t *impaired = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    int mutexWasInit = 0;
+    int condWasInit = 0;
+    int i;
+
+    /* ARGS Check */
+    if ((transport == NULL) ||
+        (config == NULL) ||
+        (ARSTREAM_ImpairmentTransport_CheckConfig (&(config->data)) == 0) ||
+        (ARSTREAM_ImpairmentTransport_CheckConfig (&(config->ack)) == 0))
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    /* Alloc new context */
+    impaired = calloc (1, sizeof (ARSTREAM_ImpairmentTransport_t));
+    if (impaired == NULL)
+    {
+        internalError = ARSTREAM_ERROR_ALLOC;
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        impaired->transport = transport;
+        impaired->ops = ARSTREAM_ImpairmentTransport_Ops;
+        if (transport->ops->receiveBegin == NULL)
+        {
+            impaired->ops.receiveBegin = NULL;
+            impaired->ops.receiveEnd = NULL;
+        }
+
+        impaired->directions [ARSTREAM_TRANSPORT_CHANNEL_DATA].config = config->data;
+        impaired->directions [ARSTREAM_TRANSPORT_CHANNEL_ACK].config = config->ack;
+        for (i = 0; i < ARSTREAM_TRANSPORT_CHANNEL_MAX; i++)
+        {
+            ARSTREAM_ImpairmentTransport_Direction_t *direction = &(impaired->directions [i]);
+            /* SplitMix64 of the seed : one independent (and never zero) sequence per direction */
+            uint64_t z = (uint64_t)config->seed + ((uint64_t)(i + 1) * 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            direction->random = ((z ^ (z >> 31)) != 0) ? (z ^ (z >> 31)) : 1;
+            direction->isPerfect = ((direction->config.delayUs == 0) &&
+                                    (direction->config.jitterUs == 0) &&
+                                    (direction->config.reorderRate == 0.f) &&
+                                    (direction->config.rateKbps == 0)) ? 1 : 0;
+            direction->tokens = (double)direction->config.burstBytes;
+            direction->tokensTimeUs = ARSTREAM_Time_GetMonotonicUs ();
+        }
+
+        impaired->heapCapacity = ARSTREAM_IMPAIRMENT_HEAP_INITIAL_CAPACITY;
+        impaired->heap = malloc (impaired->heapCapacity * sizeof (ARSTREAM_ImpairmentTransport_Packet_t));
+        if (impaired->heap == NULL)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Mutex_Init (&(impaired->mutex)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            mutexWasInit = 1;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Cond_Init (&(impaired->cond)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            condWasInit = 1;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Thread_Create (&(impaired->thread), ARSTREAM_ImpairmentTransport_RunThread, impaired) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_IMPAIRMENT_TAG, "Unable to create the delivery thread");
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            impaired->threadStarted = 1;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        retTransport = ARSTREAM_Transport_New (&(impaired->ops), impaired, &internalError);
+        if (internalError != ARSTREAM_OK)
+        {
+            ARSTREAM_ImpairmentTransport_Destroy (impaired);
+            impaired = NULL;
+        }
+    }
+
+    if ((internalError != ARSTREAM_OK) &&
+        (impaired != NULL))
+    {
+        if (condWasInit == 1)
+        {
+            ARSAL_Cond_Destroy (&(impaired->cond));
+        }
+        if (mutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy (&(impaired->mutex));
+        }
+        free (impaired->heap);
+        free (impaired);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retTransport;
+}
+
+eARSTREAM_ERROR ARSTREAM_Impairment_GetStats (ARSTREAM_Transport_t *transport, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Impairment_Stats_t *stats)
+{
+    ARSTREAM_ImpairmentTransport_t *impaired;
+
+    if ((transport == NULL) ||
+        (transport->ops->send != ARSTREAM_ImpairmentTransport_Send) ||
+        (channel < ARSTREAM_TRANSPORT_CHANNEL_DATA) ||
+        (channel >= ARSTREAM_TRANSPORT_CHANNEL_MAX) ||
+        (stats == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    impaired = (ARSTREAM_ImpairmentTransport_t *)transport->context;
+    ARSAL_Mutex_Lock (&(impaired->mutex));
+    *stats = impaired->directions [channel].stats;
+    ARSAL_Mutex_Unlock (&(impaired->mutex));
+    return ARSTREAM_OK;
+}
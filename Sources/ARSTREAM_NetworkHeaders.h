@@ -59,6 +59,12 @@
 #define ARSTREAM_NETWORK_HEADERS_MAX_FRAGMENTS_PER_FRAME (128)
 
 #define ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME (1)
+#define ARSTREAM_NETWORK_HEADERS_FLAG_TIMESTAMP (2)
+
+/**
+ * @brief Control packet type : the reader requests a flush frame
+ */
+#define ARSTREAM_NETWORK_HEADERS_CONTROL_FLUSH_FRAME_REQUEST (1)
 
 /*
  * Types
@@ -77,7 +83,7 @@ typedef struct {
 /* frameFlags structure :
  *  x x x x x x x x
  *  | | | | | | | \-> FLUSH FRAME
- *  | | | | | | \-> UNUSED
+ *  | | | | | | \-> TIMESTAMP (header is followed by an ARSTREAM_NetworkHeaders_TimestampExtension_t)
  *  | | | | | \-> UNUSED
  *  | | | | \-> UNUSED
  *  | | | \-> UNUSED
@@ -86,6 +92,17 @@ typedef struct {
  *  \-> UNUSED
  */
 
+/**
+ * @brief Header extension for stream data frames with the TIMESTAMP flag
+ *
+ * This extension is placed between the header and the fragment data.
+ * Its fields are sent in device endianness (see libARSAL/ARSAL_Endianness.h)
+ */
+typedef struct {
+    uint64_t sendTimestampUs; /**< Sender monotonic time of the first transmission of the frame */
+    uint32_t queueDurationUs; /**< Time spent by the frame in the sender queue before its first transmission */
+} __attribute__ ((packed)) ARSTREAM_NetworkHeaders_TimestampExtension_t;
+
 /**
  * @brief Content of stream ack frames
  *
@@ -102,6 +119,17 @@ typedef struct {
     uint64_t lowPacketsAck; /**< Lower 64 packets bitfield */
 } __attribute__ ((packed)) ARSTREAM_NetworkHeaders_AckPacket_t;
 
+/**
+ * @brief Content of stream control packets
+ *
+ * Control packets are sent by the reader on the ack buffer.
+ * They are distinguished from ack packets by their size.
+ */
+typedef struct {
+    uint16_t frameNumber; /**< id of the last frame seen by the reader */
+    uint8_t controlType; /**< Type of the control packet (ARSTREAM_NETWORK_HEADERS_CONTROL_xxx) */
+} __attribute__ ((packed)) ARSTREAM_NetworkHeaders_ControlPacket_t;
+
 /*
  * Functions declarations
  */
@@ -0,0 +1,337 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_NetworkTransport.c
+ * @brief Stream transport over an ARNETWORK_Manager_t
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+
+/*
+ * Private Headers
+ */
+
+#include "ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Mutex.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_NETWORK_TRANSPORT_TAG "ARSTREAM_NetworkTransport"
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+/*
+ * Types
+ */
+
+typedef struct ARSTREAM_NetworkTransport_CallbackParam_t ARSTREAM_NetworkTransport_CallbackParam_t;
+
+typedef struct {
+    ARNETWORK_Manager_t *manager;
+    int bufferIDs [ARSTREAM_TRANSPORT_CHANNEL_MAX];
+
+    /* Callback params given back by ARNETWORK, reused by the next sends */
+    ARSAL_Mutex_t freeParamsMutex;
+    ARSTREAM_NetworkTransport_CallbackParam_t *freeParams;
+} ARSTREAM_NetworkTransport_t;
+
+struct ARSTREAM_NetworkTransport_CallbackParam_t {
+    ARSTREAM_NetworkTransport_t *transport;
+    ARSTREAM_Transport_SendCallback_t callback;
+    void *callbackData;
+    ARSTREAM_NetworkTransport_CallbackParam_t *next; /* Only used in the free list */
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Gets a callback param, from the free list of the transport when possible
+ * @param transport The network transport
+ * @return The callback param, or NULL on allocation error
+ */
+static ARSTREAM_NetworkTransport_CallbackParam_t* ARSTREAM_NetworkTransport_GetCallbackParam (ARSTREAM_NetworkTransport_t *transport);
+
+/**
+ * @brief Gives a callback param back to the free list of its transport
+ * @param cbParams The callback param
+ */
+static void ARSTREAM_NetworkTransport_ReleaseCallbackParam (ARSTREAM_NetworkTransport_CallbackParam_t *cbParams);
+
+/**
+ * @brief ARNETWORK_Manager_Callback_t for ARNETWORK_Manager_SendData calls
+ * @param IoBufferId Unused
+ * @param dataPtr Unused as the data is copied by the manager
+ * @param customData (ARSTREAM_NetworkTransport_CallbackParam_t *) Transport callback and its data, or NULL
+ * @param status Network information
+ * @return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT
+ *
+ * @warning customData is given back to the transport within this callback, during last call
+ */
+static eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_NetworkTransport_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status);
+
+static eARSTREAM_ERROR ARSTREAM_NetworkTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData);
+static eARSTREAM_ERROR ARSTREAM_NetworkTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_NetworkTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static int ARSTREAM_NetworkTransport_GetEstimatedLatency (void *context);
+static void ARSTREAM_NetworkTransport_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static const ARSTREAM_Transport_Ops_t ARSTREAM_NetworkTransport_Ops = {
+    .send = ARSTREAM_NetworkTransport_Send,
+    .receive = ARSTREAM_NetworkTransport_Receive,
+    .flush = ARSTREAM_NetworkTransport_Flush,
+    .getEstimatedLatency = ARSTREAM_NetworkTransport_GetEstimatedLatency,
+    .destroy = ARSTREAM_NetworkTransport_Destroy,
+};
+
+static ARSTREAM_NetworkTransport_CallbackParam_t* ARSTREAM_NetworkTransport_GetCallbackParam (ARSTREAM_NetworkTransport_t *transport)
+{
+    ARSTREAM_NetworkTransport_CallbackParam_t *cbParams;
+
+    ARSAL_Mutex_Lock (&(transport->freeParamsMutex));
+    cbParams = transport->freeParams;
+    if (cbParams != NULL)
+    {
+        transport->freeParams = cbParams->next;
+    }
+    ARSAL_Mutex_Unlock (&(transport->freeParamsMutex));
+
+    /* Only the first sends allocate : there are never more params than fragments in flight */
+    if (cbParams == NULL)
+    {
+        cbParams = malloc (sizeof (ARSTREAM_NetworkTransport_CallbackParam_t));
+    }
+    if (cbParams != NULL)
+    {
+        cbParams->transport = transport;
+    }
+    return cbParams;
+}
+
+static void ARSTREAM_NetworkTransport_ReleaseCallbackParam (ARSTREAM_NetworkTransport_CallbackParam_t *cbParams)
+{
+    ARSTREAM_NetworkTransport_t *transport = cbParams->transport;
+
+    ARSAL_Mutex_Lock (&(transport->freeParamsMutex));
+    cbParams->next = transport->freeParams;
+    transport->freeParams = cbParams;
+    ARSAL_Mutex_Unlock (&(transport->freeParamsMutex));
+}
+
+static eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_NetworkTransport_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status)
+{
+    ARSTREAM_NetworkTransport_CallbackParam_t *cbParams = (ARSTREAM_NetworkTransport_CallbackParam_t *)customData;
+
+    /* Remove "unused parameter" warnings */
+    (void)IoBufferId;
+    (void)dataPtr;
+
+    if (cbParams != NULL)
+    {
+        switch (status)
+        {
+        case ARNETWORK_MANAGER_CALLBACK_STATUS_SENT:
+            cbParams->callback (cbParams->callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+            ARSTREAM_NetworkTransport_ReleaseCallbackParam (cbParams);
+            break;
+        case ARNETWORK_MANAGER_CALLBACK_STATUS_CANCEL:
+            cbParams->callback (cbParams->callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+            ARSTREAM_NetworkTransport_ReleaseCallbackParam (cbParams);
+            break;
+        default:
+            break;
+        }
+    }
+    return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT;
+}
+
+static eARSTREAM_ERROR ARSTREAM_NetworkTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData)
+{
+    ARSTREAM_NetworkTransport_t *transport = (ARSTREAM_NetworkTransport_t *)context;
+    ARSTREAM_NetworkTransport_CallbackParam_t *cbParams = NULL;
+    eARNETWORK_ERROR netError;
+
+    if (callback != NULL)
+    {
+        cbParams = ARSTREAM_NetworkTransport_GetCallbackParam (transport);
+        if (cbParams == NULL)
+        {
+            return ARSTREAM_ERROR_ALLOC;
+        }
+        cbParams->callback = callback;
+        cbParams->callbackData = callbackData;
+    }
+
+    netError = ARNETWORK_Manager_SendData (transport->manager, transport->bufferIDs [channel], data, size, (void *)cbParams, ARSTREAM_NetworkTransport_NetworkCallback, 1);
+    if (netError != ARNETWORK_OK)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_NETWORK_TRANSPORT_TAG, "Error while sending data : %s", ARNETWORK_Error_ToString (netError));
+        if (cbParams != NULL)
+        {
+            ARSTREAM_NetworkTransport_ReleaseCallbackParam (cbParams);
+        }
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_NetworkTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs)
+{
+    ARSTREAM_NetworkTransport_t *transport = (ARSTREAM_NetworkTransport_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    int recvSize = 0;
+    eARNETWORK_ERROR netError = ARNETWORK_Manager_ReadDataWithTimeout (transport->manager, transport->bufferIDs [channel], buffer, bufferSize, &recvSize, timeoutMs);
+    if (netError == ARNETWORK_ERROR_BUFFER_EMPTY)
+    {
+        retVal = ARSTREAM_ERROR_BUFFER_EMPTY;
+    }
+    else if (netError != ARNETWORK_OK)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_NETWORK_TRANSPORT_TAG, "Error while reading data : %s", ARNETWORK_Error_ToString (netError));
+        retVal = ARSTREAM_ERROR_TRANSPORT;
+    }
+    else
+    {
+        *receivedSize = recvSize;
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_NetworkTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    ARSTREAM_NetworkTransport_t *transport = (ARSTREAM_NetworkTransport_t *)context;
+    eARNETWORK_ERROR netError = ARNETWORK_Manager_FlushInputBuffer (transport->manager, transport->bufferIDs [channel]);
+    return (netError == ARNETWORK_OK) ? ARSTREAM_OK : ARSTREAM_ERROR_TRANSPORT;
+}
+
+static int ARSTREAM_NetworkTransport_GetEstimatedLatency (void *context)
+{
+    ARSTREAM_NetworkTransport_t *transport = (ARSTREAM_NetworkTransport_t *)context;
+    return ARNETWORK_Manager_GetEstimatedLatency (transport->manager);
+}
+
+static void ARSTREAM_NetworkTransport_Destroy (void *context)
+{
+    ARSTREAM_NetworkTransport_t *transport = (ARSTREAM_NetworkTransport_t *)context;
+    /* As for the sender, all the sends must be over (sent or cancelled) : ARNETWORK holds no param anymore */
+    while (transport->freeParams != NULL)
+    {
+        ARSTREAM_NetworkTransport_CallbackParam_t *cbParams = transport->freeParams;
+        transport->freeParams = cbParams->next;
+        free (cbParams);
+    }
+    ARSAL_Mutex_Destroy (&(transport->freeParamsMutex));
+    free (transport);
+}
+
+/*
+ * Implementation
+ */
+
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewNetwork (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Transport_t *retTransport = NULL;
+    ARSTREAM_NetworkTransport_t *transport = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    /* ARGS Check */
+    if (manager == NULL)
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    /* Alloc new context */
+    transport = malloc (sizeof (ARSTREAM_NetworkTransport_t));
+    if (transport == NULL)
+    {
+        internalError = ARSTREAM_ERROR_ALLOC;
+    }
+    else
+    {
+        transport->freeParams = NULL;
+        if (ARSAL_Mutex_Init (&(transport->freeParamsMutex)) != 0)
+        {
+            free (transport);
+            transport = NULL;
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+    }
+
+    /* Copy parameters */
+    if (internalError == ARSTREAM_OK)
+    {
+        transport->manager = manager;
+        transport->bufferIDs [ARSTREAM_TRANSPORT_CHANNEL_DATA] = dataBufferID;
+        transport->bufferIDs [ARSTREAM_TRANSPORT_CHANNEL_ACK] = ackBufferID;
+        retTransport = ARSTREAM_Transport_New (&ARSTREAM_NetworkTransport_Ops, transport, &internalError);
+    }
+
+    if ((internalError != ARSTREAM_OK) &&
+        (transport != NULL))
+    {
+        ARSTREAM_NetworkTransport_Destroy (transport);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retTransport;
+}
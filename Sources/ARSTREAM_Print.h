@@ -0,0 +1,75 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Print.h
+ * @brief Library logs, compiled out above the configured maximum level
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_PRINT_PRIVATE_H_
+#define _ARSTREAM_PRINT_PRIVATE_H_
+
+#include <config.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief Maximum level of the library logs (an eARSAL_PRINT_LEVEL)
+ * Set by configure (--with-max-log-level) in config.h. Builds without it keep all the logs
+ */
+#ifndef ARSTREAM_MAX_LOG_LEVEL
+#define ARSTREAM_MAX_LOG_LEVEL ARSAL_PRINT_VERBOSE
+#endif
+
+/**
+ * @brief Logs a message through ARSAL_PRINT, if its level is at most ARSTREAM_MAX_LOG_LEVEL
+ * The level must be a constant : above the maximum level, the call and its arguments are removed at
+ * compile time, so per-fragment debug logs cost nothing in release builds, whatever the runtime
+ * filtering of libARSAL. The arguments are still type checked.
+ */
+#define ARSTREAM_PRINT(level, tag, ...)                                                        \
+    do                                                                                         \
+    {                                                                                          \
+        if ((level) <= ARSTREAM_MAX_LOG_LEVEL)                                                 \
+        {                                                                                      \
+            ARSAL_PRINT ((level), (tag), __VA_ARGS__);                                         \
+        }                                                                                      \
+    } while (0)
+
+#endif /* _ARSTREAM_PRINT_PRIVATE_H_ */
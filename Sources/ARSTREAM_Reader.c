@@ -52,6 +52,11 @@
 
 #include "ARSTREAM_Buffers.h"
 #include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_Histogram.h"
+#include "ARSTREAM_Time.h"
+#include "ARSTREAM_EventLog.h"
+#include "ARSTREAM_Thread.h"
+#include "ARSTREAM_Print.h"
 
 /*
  * ARSDK Headers
@@ -61,6 +66,7 @@
 #include <libARSAL/ARSAL_Print.h>
 #include <libARSAL/ARSAL_Mutex.h>
 #include <libARSAL/ARSAL_Endianness.h>
+#include <libARSAL/ARSAL_Time.h>
 
 /*
  * Macros
@@ -71,6 +77,16 @@
 
 #define ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES (15)
 
+/**
+ * Number of frames in each window of the clock offset estimation
+ */
+#define ARSTREAM_READER_CLOCK_OFFSET_WINDOW_NB_FRAMES (256)
+
+/**
+ * How far behind the current frame a fragment can be to be considered late (reordered) rather than part of a restarted stream
+ */
+#define ARSTREAM_READER_MAX_LATE_FRAMES (16)
+
 /**
  * Sets *PTR to VAL if PTR is not null
  */
@@ -89,9 +105,8 @@
 
 struct ARSTREAM_Reader_t {
     /* Configuration on New */
-    ARNETWORK_Manager_t *manager;
-    int dataBufferID;
-    int ackBufferID;
+    ARSTREAM_Transport_t *transport;
+    int ownsTransport;
     uint32_t maxFragmentSize;
     int32_t maxAckInterval;
     ARSTREAM_Reader_FrameCompleteCallback_t callback;
@@ -101,6 +116,39 @@ struct ARSTREAM_Reader_t {
     uint32_t currentFrameBufferSize; // Usable length of the buffer
     uint32_t currentFrameSize;       // Actual data length
     uint8_t *currentFrameBuffer;
+    uint8_t currentFrameFlags;
+    uint8_t currentFrameNbFragments;
+    uint64_t currentFrameStartTimeUs; // Reception time of the first fragment
+    uint16_t previousFrameNumber;     // Last frame given to the application
+    int previousFrameIsValid;         // Whether a frame was already given to the application
+
+    /* Incomplete frames delivery */
+    int incompleteFramesMinPercent;
+    int incompleteFramesMaxWaitTimeMs;
+
+    /* Skipping of the frames which depend on a lost frame */
+    int skipFramesUntilFlush;
+    int referenceIsLost;
+
+    /* Flush frame requests */
+    int flushFrameRequestIntervalMs;
+    int flushFrameRequestIsPending;
+    struct timespec lastFlushFrameRequestTime;
+
+    /* One-way latency estimation */
+    int currentFrameHasTimestamps;
+    uint64_t currentFrameSendTimeUs; // Sender time of the first transmission
+    uint32_t currentFrameQueueDurationUs;
+    int64_t clockOffsetWindowMinUs [2]; // Minimum (reception - send) time, over two consecutive windows
+    int clockOffsetWindowIndex;
+    int clockOffsetWindowNbFrames;
+    int64_t clockOffsetUs;
+    ARSTREAM_Histogram_t histograms [ARSTREAM_READER_HISTOGRAM_MAX];
+    uint64_t counters [ARSTREAM_READER_COUNTER_MAX];
+
+    /* Description of the frame given to the application */
+    int frameInfoIsValid;
+    ARSTREAM_Reader_FrameInfo_t frameInfo;
 
     /* Acknowledge storage */
     ARSAL_Mutex_t ackPacketMutex;
@@ -112,6 +160,7 @@ struct ARSTREAM_Reader_t {
     int threadsShouldStop;
     int dataThreadStarted;
     int ackThreadStarted;
+    ARSTREAM_Thread_t *threads [ARSTREAM_THREAD_ROLE_MAX]; // Threads started by ARSTREAM_Reader_StartThreads
 
     /* Efficiency calculations */
     int efficiency_nbUseful [ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES];
@@ -124,30 +173,303 @@ struct ARSTREAM_Reader_t {
  */
 
 /**
- * @brief ARNETWORK_Manager_Callback_t for ARNETWORK_... calls
- * @param IoBufferId Unused as we always send on one unique buffer
- * @param dataPtr Unused as we don't need to free the memory
- * @param customData Unused
- * @param status Unused
- * @return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT
+ * @brief Computes the number of frames skipped since the last frame given to the application
+ * @param reader The reader
+ * @param frameNumber The frame which will be given to the application
+ * @return The number of skipped frames
+ */
+static int ARSTREAM_Reader_UpdateSkippedFrames (ARSTREAM_Reader_t *reader, uint16_t frameNumber);
+
+/**
+ * @brief Checks if a fragment belongs to a frame older than the current one
+ * Only done when incomplete frames are delivered : the current frame may then already be given to the application,
+ * and must not be started again by a late fragment of an older frame
+ * @param reader The reader
+ * @param frameNumber The frame number of the fragment
+ * @return 1 if the fragment is late and must be dropped, 0 otherwise
+ */
+static int ARSTREAM_Reader_FragmentIsLate (ARSTREAM_Reader_t *reader, uint16_t frameNumber);
+
+/**
+ * @brief Fills the frameInfo of the reader for the current frame
+ * @param reader The reader
+ * @param ackPacket The acknowledge packet of the current frame
+ */
+static void ARSTREAM_Reader_FillFrameInfo (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_AckPacket_t *ackPacket);
+
+/**
+ * @brief Checks if the current frame should be delivered as an incomplete frame
+ * @param reader The reader
+ * @param ackPacket The acknowledge packet of the current frame
+ * @return 1 if the frame should be delivered, 0 otherwise
+ */
+static int ARSTREAM_Reader_IncompleteFrameIsDeliverable (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_AckPacket_t *ackPacket);
+
+/**
+ * @brief Gives the current frame to the application as an incomplete frame
+ * @param reader The reader
+ * @param ackPacket The acknowledge packet of the current frame
+ */
+static void ARSTREAM_Reader_DeliverIncompleteFrame (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_AckPacket_t *ackPacket);
+
+/**
+ * @brief Marks a flush frame request as pending, and wakes up the ack thread to send it
+ * @param reader The reader
+ */
+static void ARSTREAM_Reader_QueueFlushFrameRequest (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Queues a flush frame request if the reference is lost, and if the last request is old enough
+ * @param reader The reader
+ */
+static void ARSTREAM_Reader_CheckFlushFrameRequest (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Gets the size of the headers of a data fragment
+ * @param header The data header of the fragment
+ * @return The size of the header and of its extensions, in bytes
+ */
+static int ARSTREAM_Reader_GetDataHeaderSize (ARSTREAM_NetworkHeaders_DataHeader_t *header);
+
+/**
+ * @brief Updates the clock offset estimation with a new frame
+ * @param reader The reader
+ * @param deltaUs Reception time of the first fragment (reader clock) minus the send time of the frame (sender clock)
  */
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Reader_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status);
+static void ARSTREAM_Reader_UpdateClockOffset (ARSTREAM_Reader_t *reader, int64_t deltaUs);
+
+/**
+ * @brief Converts a (reader time - sender time) delta into a latency
+ * @param reader The reader
+ * @param deltaUs The time delta
+ * @return The latency, clamped to the uint32_t range
+ */
+static uint32_t ARSTREAM_Reader_DeltaToLatencyUs (ARSTREAM_Reader_t *reader, int64_t deltaUs);
+
+/**
+ * @brief Gets the time since the first fragment of the current frame was received
+ * @param reader The reader
+ * @return The age of the current frame, in ms
+ */
+static int ARSTREAM_Reader_GetCurrentFrameAgeMs (ARSTREAM_Reader_t *reader);
+
+/**
+ * @brief Adds a value to a cumulative counter of the reader
+ * @param reader The reader
+ * @param counter Which counter to increment
+ * @param value Value to add
+ */
+static inline void ARSTREAM_Reader_AddCounter (ARSTREAM_Reader_t *reader, eARSTREAM_READER_COUNTER counter, uint64_t value);
 
 /*
  * Internal functions implementation
  */
 
-//TODO: Network, NULL callback should be ok ?
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Reader_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status)
+static inline void ARSTREAM_Reader_AddCounter (ARSTREAM_Reader_t *reader, eARSTREAM_READER_COUNTER counter, uint64_t value)
+{
+    __sync_fetch_and_add (&(reader->counters [counter]), value);
+}
+
+static int ARSTREAM_Reader_UpdateSkippedFrames (ARSTREAM_Reader_t *reader, uint16_t frameNumber)
+{
+    int nbMissedFrame = 0;
+    /* No gap to report before the first frame : the stream may have been joined at any frame */
+    if ((reader->previousFrameIsValid == 1) &&
+        (frameNumber != (uint16_t)(reader->previousFrameNumber + 1)))
+    {
+        /* Frame numbers wrap : compute the gap modulo 2^16 */
+        nbMissedFrame = (int16_t)(uint16_t)(frameNumber - reader->previousFrameNumber - 1);
+        ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Missed %d frames !", nbMissedFrame);
+        ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FRAMES_MISSED, frameNumber, nbMissedFrame, 0);
+        /* A restarted sender goes back : only count plausible gaps, and never give a negative number to the application */
+        if (nbMissedFrame > 0)
+        {
+            ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FRAMES_MISSED, nbMissedFrame);
+        }
+        else
+        {
+            nbMissedFrame = 0;
+        }
+    }
+    reader->previousFrameNumber = frameNumber;
+    reader->previousFrameIsValid = 1;
+    return nbMissedFrame;
+}
+
+static int ARSTREAM_Reader_FragmentIsLate (ARSTREAM_Reader_t *reader, uint16_t frameNumber)
+{
+    int retVal = 0;
+    if (reader->incompleteFramesMinPercent != ARSTREAM_READER_INCOMPLETE_FRAMES_DISABLED)
+    {
+        /* Serial number order : the ackPacket frame number is only written by the data thread, which calls this function */
+        int16_t age = (int16_t)(uint16_t)(reader->ackPacket.frameNumber - frameNumber);
+        if ((age > 0) &&
+            (age <= ARSTREAM_READER_MAX_LATE_FRAMES))
+        {
+            retVal = 1;
+        }
+    }
+    return retVal;
+}
+
+static void ARSTREAM_Reader_FillFrameInfo (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_AckPacket_t *ackPacket)
+{
+    ARSTREAM_Reader_FrameInfo_t *info = &(reader->frameInfo);
+    int inMissingRange = 0;
+    uint32_t i;
+
+    memset (info, 0, sizeof (ARSTREAM_Reader_FrameInfo_t));
+    if (reader->currentFrameHasTimestamps == 1)
+    {
+        uint64_t nowUs = ARSTREAM_Time_GetMonotonicUs ();
+        info->hasTimestamps = 1;
+        info->senderQueueDurationUs = reader->currentFrameQueueDurationUs;
+        info->firstFragmentLatencyUs = ARSTREAM_Reader_DeltaToLatencyUs (reader, (int64_t)(reader->currentFrameStartTimeUs - reader->currentFrameSendTimeUs));
+        info->completionLatencyUs = ARSTREAM_Reader_DeltaToLatencyUs (reader, (int64_t)(nowUs - reader->currentFrameSendTimeUs));
+        info->clockOffsetUs = reader->clockOffsetUs;
+        ARSTREAM_Histogram_Record (&(reader->histograms [ARSTREAM_READER_HISTOGRAM_SENDER_QUEUE_DURATION]), info->senderQueueDurationUs);
+        ARSTREAM_Histogram_Record (&(reader->histograms [ARSTREAM_READER_HISTOGRAM_FIRST_FRAGMENT_LATENCY]), info->firstFragmentLatencyUs);
+        ARSTREAM_Histogram_Record (&(reader->histograms [ARSTREAM_READER_HISTOGRAM_COMPLETION_LATENCY]), info->completionLatencyUs);
+    }
+    info->frameNumber = ackPacket->frameNumber;
+    info->nbFragments = reader->currentFrameNbFragments;
+    info->fragmentSize = reader->maxFragmentSize;
+    for (i = 0; i < info->nbFragments; i++)
+    {
+        if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (ackPacket, i) != 0)
+        {
+            info->receivedFragments [i / 8] |= (1 << (i % 8));
+            info->nbReceivedFragments++;
+            inMissingRange = 0;
+        }
+        else if (inMissingRange == 1)
+        {
+            info->missingRanges [info->nbMissingRanges - 1].size += reader->maxFragmentSize;
+        }
+        else
+        {
+            info->missingRanges [info->nbMissingRanges].offset = i * reader->maxFragmentSize;
+            info->missingRanges [info->nbMissingRanges].size = reader->maxFragmentSize;
+            info->nbMissingRanges++;
+            inMissingRange = 1;
+        }
+    }
+}
+
+static int ARSTREAM_Reader_IncompleteFrameIsDeliverable (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_AckPacket_t *ackPacket)
+{
+    int retVal = 0;
+    if ((reader->incompleteFramesMinPercent != ARSTREAM_READER_INCOMPLETE_FRAMES_DISABLED) &&
+        (reader->currentFrameSize > 0))
+    {
+        uint32_t nbReceived = ARSTREAM_NetworkHeaders_AckPacketCountSet (ackPacket, reader->currentFrameNbFragments);
+        if ((100 * nbReceived) >= (uint32_t)(reader->incompleteFramesMinPercent * reader->currentFrameNbFragments))
+        {
+            retVal = 1;
+        }
+    }
+    return retVal;
+}
+
+static void ARSTREAM_Reader_DeliverIncompleteFrame (ARSTREAM_Reader_t *reader, ARSTREAM_NetworkHeaders_AckPacket_t *ackPacket)
+{
+    int isFlushFrame = ((reader->currentFrameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0) ? 1 : 0;
+    int nbMissedFrame = ARSTREAM_Reader_UpdateSkippedFrames (reader, ackPacket->frameNumber);
+    ARSTREAM_Reader_FillFrameInfo (reader, ackPacket);
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Incomplete frame %d (%d/%d fragments, isFlush : %d)", ackPacket->frameNumber, reader->frameInfo.nbReceivedFragments, reader->frameInfo.nbFragments, isFlushFrame);
+    ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FRAME_INCOMPLETE, ackPacket->frameNumber, reader->frameInfo.nbReceivedFragments, reader->frameInfo.nbFragments);
+    ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FRAMES_INCOMPLETE, 1);
+    reader->frameInfoIsValid = 1;
+    ARSTREAM_EVENT (ARSTREAM_EVENT_READER_CALLBACK_BEGIN, ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE, ackPacket->frameNumber, 0);
+    reader->currentFrameBuffer = reader->callback (ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE, reader->currentFrameBuffer, reader->currentFrameSize, nbMissedFrame, isFlushFrame, &(reader->currentFrameBufferSize), reader->custom);
+    ARSTREAM_EVENT (ARSTREAM_EVENT_READER_CALLBACK_END, ARSTREAM_READER_CAUSE_FRAME_INCOMPLETE, ackPacket->frameNumber, 0);
+    reader->frameInfoIsValid = 0;
+}
+
+static void ARSTREAM_Reader_QueueFlushFrameRequest (ARSTREAM_Reader_t *reader)
+{
+    ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackSendMutex), ARSTREAM_EVENT_LOCK_READER_ACK_SEND);
+    reader->flushFrameRequestIsPending = 1;
+    ARSAL_Cond_Signal (&(reader->ackSendCond));
+    ARSAL_Mutex_Unlock (&(reader->ackSendMutex));
+}
+
+static void ARSTREAM_Reader_CheckFlushFrameRequest (ARSTREAM_Reader_t *reader)
+{
+    if ((reader->flushFrameRequestIntervalMs > 0) &&
+        (reader->referenceIsLost == 1))
+    {
+        struct timespec now;
+        ARSAL_Time_GetTime (&now);
+        if (ARSAL_Time_ComputeTimespecMsTimeDiff (&(reader->lastFlushFrameRequestTime), &now) >= reader->flushFrameRequestIntervalMs)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Reference lost, requesting a flush frame");
+            ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FLUSH_REQUESTED, 0, 0, 0);
+            ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FLUSH_FRAMES_REQUESTED, 1);
+            reader->lastFlushFrameRequestTime = now;
+            ARSTREAM_Reader_QueueFlushFrameRequest (reader);
+        }
+    }
+}
+
+static int ARSTREAM_Reader_GetDataHeaderSize (ARSTREAM_NetworkHeaders_DataHeader_t *header)
+{
+    int retVal = sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+    if ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_TIMESTAMP) != 0)
+    {
+        retVal += sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t);
+    }
+    return retVal;
+}
+
+static void ARSTREAM_Reader_UpdateClockOffset (ARSTREAM_Reader_t *reader, int64_t deltaUs)
+{
+    int64_t minDeltaUs;
+    int rttMs;
+    if (reader->clockOffsetWindowNbFrames >= ARSTREAM_READER_CLOCK_OFFSET_WINDOW_NB_FRAMES)
+    {
+        /* Start a new window, but keep the previous one so the estimation does not jump */
+        reader->clockOffsetWindowIndex = 1 - reader->clockOffsetWindowIndex;
+        reader->clockOffsetWindowMinUs [reader->clockOffsetWindowIndex] = INT64_MAX;
+        reader->clockOffsetWindowNbFrames = 0;
+    }
+    reader->clockOffsetWindowNbFrames++;
+    if (deltaUs < reader->clockOffsetWindowMinUs [reader->clockOffsetWindowIndex])
+    {
+        reader->clockOffsetWindowMinUs [reader->clockOffsetWindowIndex] = deltaUs;
+    }
+
+    minDeltaUs = reader->clockOffsetWindowMinUs [0];
+    if (reader->clockOffsetWindowMinUs [1] < minDeltaUs)
+    {
+        minDeltaUs = reader->clockOffsetWindowMinUs [1];
+    }
+    /* The fastest fragments are assumed to take half of the round trip time */
+    rttMs = reader->transport->ops->getEstimatedLatency (reader->transport->context);
+    if (rttMs < 0)
+    {
+        rttMs = 0;
+    }
+    reader->clockOffsetUs = minDeltaUs - ((int64_t)rttMs * 500);
+}
+
+static uint32_t ARSTREAM_Reader_DeltaToLatencyUs (ARSTREAM_Reader_t *reader, int64_t deltaUs)
 {
-    /* Avoid "unused parameters" warnings */
-    (void)IoBufferId;
-    (void)dataPtr;
-    (void)customData;
-    (void)status;
-
-    /* Dummy return value */
-    return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT;
+    int64_t latencyUs = deltaUs - reader->clockOffsetUs;
+    if (latencyUs < 0)
+    {
+        latencyUs = 0;
+    }
+    else if (latencyUs > UINT32_MAX)
+    {
+        latencyUs = UINT32_MAX;
+    }
+    return (uint32_t)latencyUs;
+}
+
+static int ARSTREAM_Reader_GetCurrentFrameAgeMs (ARSTREAM_Reader_t *reader)
+{
+    return (int)((ARSTREAM_Time_GetMonotonicUs () - reader->currentFrameStartTimeUs) / 1000);
 }
 
 /*
@@ -165,6 +487,31 @@ void ARSTREAM_Reader_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
 }
 
 ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Reader_t *retReader = NULL;
+    ARSTREAM_Transport_t *transport = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+
+    transport = ARSTREAM_Transport_NewNetwork (manager, dataBufferID, ackBufferID, &internalError);
+    if (internalError == ARSTREAM_OK)
+    {
+        retReader = ARSTREAM_Reader_NewWithTransport (transport, callback, frameBuffer, frameBufferSize, maxFragmentSize, maxAckInterval, custom, &internalError);
+    }
+
+    if (retReader != NULL)
+    {
+        retReader->ownsTransport = 1;
+    }
+    else if (transport != NULL)
+    {
+        ARSTREAM_Transport_Delete (&transport);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retReader;
+}
+
+ARSTREAM_Reader_t* ARSTREAM_Reader_NewWithTransport (ARSTREAM_Transport_t *transport, ARSTREAM_Reader_FrameCompleteCallback_t callback, uint8_t *frameBuffer, uint32_t frameBufferSize, uint32_t maxFragmentSize, int32_t maxAckInterval, void *custom, eARSTREAM_ERROR *error)
 {
     ARSTREAM_Reader_t *retReader = NULL;
     int ackPacketMutexWasInit = 0;
@@ -172,7 +519,7 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
     int ackSendCondWasInit = 0;
     eARSTREAM_ERROR internalError = ARSTREAM_OK;
     /* ARGS Check */
-    if ((manager == NULL) ||
+    if ((transport == NULL) ||
         (callback == NULL) ||
         (frameBuffer == NULL) ||
         (frameBufferSize == 0) ||
@@ -193,9 +540,8 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
     /* Copy parameters */
     if (internalError == ARSTREAM_OK)
     {
-        retReader->manager = manager;
-        retReader->dataBufferID = dataBufferID;
-        retReader->ackBufferID = ackBufferID;
+        retReader->transport = transport;
+        retReader->ownsTransport = 0;
         retReader->maxFragmentSize = maxFragmentSize;
         retReader->maxAckInterval = maxAckInterval;
         retReader->callback = callback;
@@ -247,9 +593,42 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
     {
         int i;
         retReader->currentFrameSize = 0;
+        retReader->currentFrameFlags = 0;
+        retReader->currentFrameNbFragments = 0;
+        retReader->previousFrameNumber = UINT16_MAX;
+        retReader->previousFrameIsValid = 0;
+        retReader->incompleteFramesMinPercent = ARSTREAM_READER_INCOMPLETE_FRAMES_DISABLED;
+        retReader->incompleteFramesMaxWaitTimeMs = 0;
+        retReader->skipFramesUntilFlush = 0;
+        retReader->referenceIsLost = 1;
+        retReader->flushFrameRequestIntervalMs = 0;
+        retReader->flushFrameRequestIsPending = 0;
+        ARSAL_Time_GetTime (&(retReader->lastFlushFrameRequestTime));
+        retReader->currentFrameStartTimeUs = 0;
+        retReader->currentFrameHasTimestamps = 0;
+        retReader->currentFrameSendTimeUs = 0;
+        retReader->currentFrameQueueDurationUs = 0;
+        retReader->clockOffsetWindowMinUs [0] = INT64_MAX;
+        retReader->clockOffsetWindowMinUs [1] = INT64_MAX;
+        retReader->clockOffsetWindowIndex = 0;
+        retReader->clockOffsetWindowNbFrames = 0;
+        retReader->clockOffsetUs = 0;
+        for (i = 0; i < ARSTREAM_READER_HISTOGRAM_MAX; i++)
+        {
+            ARSTREAM_Histogram_Reset (&(retReader->histograms [i]));
+        }
+        for (i = 0; i < ARSTREAM_READER_COUNTER_MAX; i++)
+        {
+            retReader->counters [i] = 0;
+        }
+        retReader->frameInfoIsValid = 0;
+        retReader->ackPacket.frameNumber = 0;
+        ARSTREAM_NetworkHeaders_AckPacketReset (&(retReader->ackPacket));
         retReader->threadsShouldStop = 0;
         retReader->dataThreadStarted = 0;
         retReader->ackThreadStarted = 0;
+        retReader->threads [ARSTREAM_THREAD_ROLE_DATA] = NULL;
+        retReader->threads [ARSTREAM_THREAD_ROLE_ACK] = NULL;
         retReader->efficiency_index = 0;
         for (i = 0; i < ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES; i++)
         {
@@ -281,6 +660,87 @@ ARSTREAM_Reader_t* ARSTREAM_Reader_New (ARNETWORK_Manager_t *manager, int dataBu
     return retReader;
 }
 
+eARSTREAM_ERROR ARSTREAM_Reader_SetIncompleteFramesDelivery (ARSTREAM_Reader_t *reader, int minPercentOfFragments, int maxWaitTimeMs)
+{
+    if ((reader == NULL) ||
+        (minPercentOfFragments < ARSTREAM_READER_INCOMPLETE_FRAMES_DISABLED) ||
+        (minPercentOfFragments > 100) ||
+        (maxWaitTimeMs < 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    reader->incompleteFramesMaxWaitTimeMs = maxWaitTimeMs;
+    reader->incompleteFramesMinPercent = minPercentOfFragments;
+    return ARSTREAM_OK;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetSkipFramesUntilFlush (ARSTREAM_Reader_t *reader, int enable)
+{
+    if (reader == NULL)
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    reader->skipFramesUntilFlush = (enable != 0) ? 1 : 0;
+    return ARSTREAM_OK;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_SetAutomaticFlushFrameRequests (ARSTREAM_Reader_t *reader, int requestIntervalMs)
+{
+    if ((reader == NULL) ||
+        (requestIntervalMs < 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    reader->flushFrameRequestIntervalMs = requestIntervalMs;
+    return ARSTREAM_OK;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_RequestFlushFrame (ARSTREAM_Reader_t *reader)
+{
+    if (reader == NULL)
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    ARSTREAM_Reader_QueueFlushFrameRequest (reader);
+    return ARSTREAM_OK;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_GetFrameInfo (ARSTREAM_Reader_t *reader, ARSTREAM_Reader_FrameInfo_t *info)
+{
+    if ((reader == NULL) ||
+        (info == NULL) ||
+        (reader->frameInfoIsValid == 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    memcpy (info, &(reader->frameInfo), sizeof (ARSTREAM_Reader_FrameInfo_t));
+    return ARSTREAM_OK;
+}
+
+eARSTREAM_ERROR ARSTREAM_Reader_GetHistogram (ARSTREAM_Reader_t *reader, eARSTREAM_READER_HISTOGRAM histogram, ARSTREAM_Histogram_t *snapshot)
+{
+    if ((reader == NULL) ||
+        (histogram < 0) ||
+        (histogram >= ARSTREAM_READER_HISTOGRAM_MAX) ||
+        (snapshot == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    ARSTREAM_Histogram_Snapshot (&(reader->histograms [histogram]), snapshot);
+    return ARSTREAM_OK;
+}
+
+uint64_t ARSTREAM_Reader_GetCounter (ARSTREAM_Reader_t *reader, eARSTREAM_READER_COUNTER counter)
+{
+    if ((reader == NULL) ||
+        (counter < 0) ||
+        (counter >= ARSTREAM_READER_COUNTER_MAX))
+    {
+        return 0;
+    }
+    return __sync_fetch_and_add (&(reader->counters [counter]), 0);
+}
+
 void ARSTREAM_Reader_StopReader (ARSTREAM_Reader_t *reader)
 {
     if (reader != NULL)
@@ -291,7 +751,7 @@ void ARSTREAM_Reader_StopReader (ARSTREAM_Reader_t *reader)
          * If maxAckInterval >= 0, an ACK packet will be sent as a side-effect. */
         if (reader->ackThreadStarted == 1)
         {
-            ARSAL_Mutex_Lock (&(reader->ackSendMutex));
+            ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackSendMutex), ARSTREAM_EVENT_LOCK_READER_ACK_SEND);
             ARSAL_Cond_Signal (&(reader->ackSendCond));
             ARSAL_Mutex_Unlock (&(reader->ackSendMutex));
         }
@@ -313,37 +773,86 @@ eARSTREAM_ERROR ARSTREAM_Reader_Delete (ARSTREAM_Reader_t **reader)
 
         if (canDelete == 1)
         {
+            /* The threads started by the library have left their loops : join them */
+            ARSTREAM_Thread_Delete (&((*reader)->threads [ARSTREAM_THREAD_ROLE_DATA]));
+            ARSTREAM_Thread_Delete (&((*reader)->threads [ARSTREAM_THREAD_ROLE_ACK]));
             ARSAL_Mutex_Destroy (&((*reader)->ackPacketMutex));
             ARSAL_Mutex_Destroy (&((*reader)->ackSendMutex));
             ARSAL_Cond_Destroy (&((*reader)->ackSendCond));
+            if ((*reader)->ownsTransport == 1)
+            {
+                ARSTREAM_Transport_Delete (&((*reader)->transport));
+            }
             free (*reader);
             *reader = NULL;
             retVal = ARSTREAM_OK;
         }
         else
         {
-            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Call ARSTREAM_Reader_StopReader before calling this function");
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Call ARSTREAM_Reader_StopReader before calling this function");
             retVal = ARSTREAM_ERROR_BUSY;
         }
     }
     return retVal;
 }
 
+eARSTREAM_ERROR ARSTREAM_Reader_StartThreads (ARSTREAM_Reader_t *reader, const ARSTREAM_Thread_Config_t *dataConfig, const ARSTREAM_Thread_Config_t *ackConfig)
+{
+    ARSTREAM_Thread_t *dataThread = NULL;
+    ARSTREAM_Thread_t *ackThread = NULL;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+
+    if (reader == NULL)
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    if ((reader->threads [ARSTREAM_THREAD_ROLE_DATA] != NULL) ||
+        (reader->threads [ARSTREAM_THREAD_ROLE_ACK] != NULL) ||
+        (reader->dataThreadStarted == 1) ||
+        (reader->ackThreadStarted == 1))
+    {
+        return ARSTREAM_ERROR_BUSY;
+    }
+
+    /* Both threads apply their settings, and wait : none runs if any setting fails */
+    dataThread = ARSTREAM_Thread_New (dataConfig, ARSTREAM_Reader_RunDataThread, reader, &err);
+    if (dataThread != NULL)
+    {
+        ackThread = ARSTREAM_Thread_New (ackConfig, ARSTREAM_Reader_RunAckThread, reader, &err);
+    }
+    if (err != ARSTREAM_OK)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Unable to start the reader threads : %s", ARSTREAM_Error_ToString (err));
+        ARSTREAM_Thread_Delete (&dataThread);
+        return err;
+    }
+
+    /* Marked as started at once, so that ARSTREAM_Reader_Delete waits for ARSTREAM_Reader_StopReader */
+    reader->dataThreadStarted = 1;
+    reader->ackThreadStarted = 1;
+    reader->threads [ARSTREAM_THREAD_ROLE_DATA] = dataThread;
+    reader->threads [ARSTREAM_THREAD_ROLE_ACK] = ackThread;
+    ARSTREAM_Thread_Start (dataThread);
+    ARSTREAM_Thread_Start (ackThread);
+    return ARSTREAM_OK;
+}
+
 void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
 {
     uint8_t *recvData = NULL;
-    int recvSize;
-    uint16_t previousFNum = UINT16_MAX;
+    uint32_t recvSize = 0;
     int skipCurrentFrame = 0;
+    int currentFrameIsDiscarded = 0;
     int packetWasAlreadyAck = 0;
     ARSTREAM_Reader_t *reader = (ARSTREAM_Reader_t *)ARSTREAM_Reader_t_Param;
     ARSTREAM_NetworkHeaders_DataHeader_t *header = NULL;
-    int recvDataLen = reader->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+    ARSTREAM_NetworkHeaders_AckPacket_t previousFrameAck;
+    int recvDataLen = reader->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t);
 
     /* Parameters check */
     if (reader == NULL)
     {
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while starting %s, bad parameters", __FUNCTION__);
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while starting %s, bad parameters", __FUNCTION__);
         return (void *)0;
     }
 
@@ -351,64 +860,183 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
     recvData = malloc (recvDataLen);
     if (recvData == NULL)
     {
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while starting %s, can not alloc memory", __FUNCTION__);
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while starting %s, can not alloc memory", __FUNCTION__);
         return (void *)0;
     }
-    header = (ARSTREAM_NetworkHeaders_DataHeader_t *)recvData;
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Stream reader thread running");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Stream reader thread running");
     reader->dataThreadStarted = 1;
 
     while (reader->threadsShouldStop == 0)
     {
-        eARNETWORK_ERROR err = ARNETWORK_Manager_ReadDataWithTimeout (reader->manager, reader->dataBufferID, recvData, recvDataLen, &recvSize, ARSTREAM_READER_DATAREAD_TIMEOUT_MS);
-        if (ARNETWORK_OK != err)
+        int readTimeoutMs = ARSTREAM_READER_DATAREAD_TIMEOUT_MS;
+        int currentFrameIsPending = ((skipCurrentFrame == 0) && (reader->currentFrameSize > 0)) ? 1 : 0;
+        uint8_t *packet = recvData;
+        int packetIsBorrowed = 0;
+        eARSTREAM_ERROR err;
+
+        /* Do not wait for the network past the incomplete frame timeout */
+        if ((currentFrameIsPending == 1) &&
+            (reader->incompleteFramesMaxWaitTimeMs > 0))
         {
-            if (ARNETWORK_ERROR_BUFFER_EMPTY != err)
+            int remainingTimeMs = reader->incompleteFramesMaxWaitTimeMs - ARSTREAM_Reader_GetCurrentFrameAgeMs (reader);
+            if ((remainingTimeMs > 0) &&
+                (remainingTimeMs < readTimeoutMs))
             {
-                ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while reading stream data: %s", ARNETWORK_Error_ToString (err));
+                readTimeoutMs = remainingTimeMs;
             }
         }
+
+        /* Use the packet in place if the transport allows it */
+        if (reader->transport->ops->receiveBegin != NULL)
+        {
+            err = reader->transport->ops->receiveBegin (reader->transport->context, ARSTREAM_TRANSPORT_CHANNEL_DATA, &packet, &recvSize, readTimeoutMs);
+            packetIsBorrowed = (err == ARSTREAM_OK) ? 1 : 0;
+        }
         else
         {
+            err = reader->transport->ops->receive (reader->transport->context, ARSTREAM_TRANSPORT_CHANNEL_DATA, recvData, recvDataLen, &recvSize, readTimeoutMs);
+        }
+        header = (ARSTREAM_NetworkHeaders_DataHeader_t *)packet;
+
+        if (ARSTREAM_OK != err)
+        {
+            if (ARSTREAM_ERROR_BUFFER_EMPTY != err)
+            {
+                ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Error while reading stream data: %s", ARSTREAM_Error_ToString (err));
+            }
+        }
+        else if ((recvSize < (uint32_t)ARSTREAM_Reader_GetDataHeaderSize (header)) ||
+                 (recvSize > (uint32_t)recvDataLen))
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Read %d octets, which is not a valid fragment size", recvSize);
+        }
+        else if (ARSTREAM_Reader_FragmentIsLate (reader, header->frameNumber) == 1)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Dropping late fragment %d of frame %d (current frame is %d)", header->fragmentNumber, header->frameNumber, reader->ackPacket.frameNumber);
+            ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FRAGMENTS_RECEIVED, 1);
+            ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_LATE_FRAGMENTS, 1);
+        }
+        else
+        {
+            uint64_t recvTimeUs = ARSTREAM_Time_GetMonotonicUs ();
+            int headerSize = ARSTREAM_Reader_GetDataHeaderSize (header);
             int cpIndex, cpSize, endIndex;
-            ARSAL_Mutex_Lock (&(reader->ackPacketMutex));
+            int isNewFrame = 0;
+            int previousFrameIsDeliverable = 0;
+            ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackPacketMutex), ARSTREAM_EVENT_LOCK_READER_ACK_PACKET);
             if (header->frameNumber != reader->ackPacket.frameNumber)
             {
+                isNewFrame = 1;
                 reader->efficiency_index ++;
                 reader->efficiency_index %= ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES;
                 reader->efficiency_nbTotal [reader->efficiency_index] = 0;
                 reader->efficiency_nbUseful [reader->efficiency_index] = 0;
-                skipCurrentFrame = 0;
-                reader->currentFrameSize = 0;
-                reader->ackPacket.frameNumber = header->frameNumber;
-#ifdef DEBUG
-                uint32_t nackPackets = ARSTREAM_NetworkHeaders_AckPacketCountNotSet (&(reader->ackPacket), header->fragmentsPerFrame);
-                if (nackPackets != 0)
+                if ((currentFrameIsPending == 1) &&
+                    (ARSTREAM_Reader_IncompleteFrameIsDeliverable (reader, &(reader->ackPacket)) == 1))
+                {
+                    memcpy (&previousFrameAck, &(reader->ackPacket), sizeof (ARSTREAM_NetworkHeaders_AckPacket_t));
+                    previousFrameIsDeliverable = 1;
+                }
+                if (previousFrameIsDeliverable == 0)
                 {
-                    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Dropping a frame (missing %d fragments)", nackPackets);
+                    uint32_t nackPackets = ARSTREAM_NetworkHeaders_AckPacketCountNotSet (&(reader->ackPacket), reader->currentFrameNbFragments);
+                    if (nackPackets != 0)
+                    {
+                        ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Dropping a frame (missing %d fragments)", nackPackets);
+                        ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FRAME_DROPPED, reader->ackPacket.frameNumber, nackPackets, 0);
+                        ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FRAMES_DROPPED, 1);
+                    }
                 }
-#endif
+                reader->ackPacket.frameNumber = header->frameNumber;
                 ARSTREAM_NetworkHeaders_AckPacketResetUpTo (&(reader->ackPacket), header->fragmentsPerFrame);
             }
             packetWasAlreadyAck = ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(reader->ackPacket), header->fragmentNumber);
             ARSTREAM_NetworkHeaders_AckPacketSetFlag (&(reader->ackPacket), header->fragmentNumber);
+            ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FRAGMENT_RECEIVED, header->frameNumber, header->fragmentNumber, packetWasAlreadyAck);
+            ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FRAGMENTS_RECEIVED, 1);
 
-            reader->efficiency_nbTotal [reader->efficiency_index] ++;
-            if (packetWasAlreadyAck == 0)
+            if ((isNewFrame == 0) &&
+                (currentFrameIsDiscarded == 1))
             {
-                reader->efficiency_nbUseful [reader->efficiency_index] ++;
+                /* The discarded frame was acked at once : its in-flight fragments are not duplicates */
+                ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_DISCARDED_FRAGMENTS, 1);
+            }
+            else
+            {
+                reader->efficiency_nbTotal [reader->efficiency_index] ++;
+                if (packetWasAlreadyAck == 0)
+                {
+                    reader->efficiency_nbUseful [reader->efficiency_index] ++;
+                }
+                else
+                {
+                    ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_DUPLICATE_FRAGMENTS, 1);
+                }
             }
 
             ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
 
-            ARSAL_Mutex_Lock (&(reader->ackSendMutex));
+            if (previousFrameIsDeliverable == 1)
+            {
+                ARSTREAM_Reader_DeliverIncompleteFrame (reader, &previousFrameAck);
+            }
+
+            if (isNewFrame == 1)
+            {
+                ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FRAME_STARTED, header->frameNumber, header->fragmentsPerFrame, ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0) ? 1 : 0);
+                skipCurrentFrame = 0;
+                currentFrameIsDiscarded = 0;
+                reader->currentFrameSize = 0;
+                reader->currentFrameFlags = header->frameFlags;
+                reader->currentFrameNbFragments = header->fragmentsPerFrame;
+                reader->currentFrameStartTimeUs = recvTimeUs;
+                reader->currentFrameHasTimestamps = 0;
+                if ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_TIMESTAMP) != 0)
+                {
+                    ARSTREAM_NetworkHeaders_TimestampExtension_t *timestampExtension = (ARSTREAM_NetworkHeaders_TimestampExtension_t *)&packet[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)];
+                    reader->currentFrameHasTimestamps = 1;
+                    reader->currentFrameSendTimeUs = dtohll (timestampExtension->sendTimestampUs);
+                    reader->currentFrameQueueDurationUs = dtohl (timestampExtension->queueDurationUs);
+                    ARSTREAM_Reader_UpdateClockOffset (reader, (int64_t)(recvTimeUs - reader->currentFrameSendTimeUs));
+                }
+
+                /* The reference is lost as soon as a frame was not given to the application,
+                 * and is only recovered by a flush frame */
+                if (header->frameNumber != (uint16_t)(reader->previousFrameNumber + 1))
+                {
+                    reader->referenceIsLost = 1;
+                }
+                if ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0)
+                {
+                    reader->referenceIsLost = 0;
+                }
+
+                /* Discard the frame, and ack it at once so the sender stops sending it */
+                if ((reader->skipFramesUntilFlush == 1) &&
+                    (reader->referenceIsLost == 1))
+                {
+                    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Discarding frame %d (waiting for a flush frame)", header->frameNumber);
+                    ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FRAME_DISCARDED, header->frameNumber, 0, 0);
+                    ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FRAMES_DISCARDED, 1);
+                    skipCurrentFrame = 1;
+                    currentFrameIsDiscarded = 1;
+                    ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_DISCARDED_FRAGMENTS, 1);
+                    ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackPacketMutex), ARSTREAM_EVENT_LOCK_READER_ACK_PACKET);
+                    ARSTREAM_NetworkHeaders_AckPacketResetUpTo (&(reader->ackPacket), 0);
+                    /* Move the first fragment out of the efficiency window, like the following ones */
+                    reader->efficiency_nbTotal [reader->efficiency_index] = 0;
+                    reader->efficiency_nbUseful [reader->efficiency_index] = 0;
+                    ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
+                }
+            }
+
+            ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackSendMutex), ARSTREAM_EVENT_LOCK_READER_ACK_SEND);
             ARSAL_Cond_Signal (&(reader->ackSendCond));
             ARSAL_Mutex_Unlock (&(reader->ackSendMutex));
 
-
             cpIndex = reader->maxFragmentSize * header->fragmentNumber;
-            cpSize = recvSize - sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+            cpSize = recvSize - headerSize;
             endIndex = cpIndex + cpSize;
             while ((endIndex > reader->currentFrameBufferSize) &&
                    (skipCurrentFrame == 0) &&
@@ -435,7 +1063,7 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
             {
                 if (packetWasAlreadyAck == 0)
                 {
-                    memcpy (&(reader->currentFrameBuffer)[cpIndex], &recvData[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], recvSize - sizeof (ARSTREAM_NetworkHeaders_DataHeader_t));
+                    memcpy (&(reader->currentFrameBuffer)[cpIndex], &packet[headerSize], cpSize);
                 }
 
                 if (endIndex > reader->currentFrameSize)
@@ -443,34 +1071,63 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
                     reader->currentFrameSize = endIndex;
                 }
 
-                ARSAL_Mutex_Lock (&(reader->ackPacketMutex));
+                ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackPacketMutex), ARSTREAM_EVENT_LOCK_READER_ACK_PACKET);
                 if (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&(reader->ackPacket), header->fragmentsPerFrame))
                 {
-                    if (header->frameNumber != previousFNum)
+                    if (header->frameNumber != reader->previousFrameNumber)
                     {
-                        int nbMissedFrame = 0;
                         int isFlushFrame = ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME) != 0) ? 1 : 0;
-                        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack all in frame %d (isFlush : %d)", header->frameNumber, isFlushFrame);
-                        if (header->frameNumber != previousFNum + 1)
-                        {
-                            nbMissedFrame = header->frameNumber - previousFNum - 1;
-                            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Missed %d frames !", nbMissedFrame);
-                        }
-                        previousFNum = header->frameNumber;
+                        int nbMissedFrame = ARSTREAM_Reader_UpdateSkippedFrames (reader, header->frameNumber);
+                        ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack all in frame %d (isFlush : %d)", header->frameNumber, isFlushFrame);
+                        ARSTREAM_EVENT (ARSTREAM_EVENT_READER_FRAME_COMPLETE, header->frameNumber, reader->currentFrameSize, isFlushFrame);
+                        ARSTREAM_Reader_AddCounter (reader, ARSTREAM_READER_COUNTER_FRAMES_COMPLETE, 1);
                         skipCurrentFrame = 1;
+                        ARSTREAM_Reader_FillFrameInfo (reader, &(reader->ackPacket));
+                        reader->frameInfoIsValid = 1;
+                        ARSTREAM_EVENT (ARSTREAM_EVENT_READER_CALLBACK_BEGIN, ARSTREAM_READER_CAUSE_FRAME_COMPLETE, header->frameNumber, 0);
                         reader->currentFrameBuffer = reader->callback (ARSTREAM_READER_CAUSE_FRAME_COMPLETE, reader->currentFrameBuffer, reader->currentFrameSize, nbMissedFrame, isFlushFrame, &(reader->currentFrameBufferSize), reader->custom);
+                        ARSTREAM_EVENT (ARSTREAM_EVENT_READER_CALLBACK_END, ARSTREAM_READER_CAUSE_FRAME_COMPLETE, header->frameNumber, 0);
+                        reader->frameInfoIsValid = 0;
                     }
                 }
                 ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
             }
         }
+
+        if (packetIsBorrowed == 1)
+        {
+            reader->transport->ops->receiveEnd (reader->transport->context, ARSTREAM_TRANSPORT_CHANNEL_DATA);
+        }
+
+        /* Deliver the current frame if its missing fragments did not arrive in time */
+        if ((skipCurrentFrame == 0) &&
+            (reader->currentFrameSize > 0) &&
+            (reader->incompleteFramesMaxWaitTimeMs > 0) &&
+            (ARSTREAM_Reader_GetCurrentFrameAgeMs (reader) >= reader->incompleteFramesMaxWaitTimeMs))
+        {
+            int currentFrameIsDeliverable = 0;
+            ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackPacketMutex), ARSTREAM_EVENT_LOCK_READER_ACK_PACKET);
+            if (ARSTREAM_Reader_IncompleteFrameIsDeliverable (reader, &(reader->ackPacket)) == 1)
+            {
+                memcpy (&previousFrameAck, &(reader->ackPacket), sizeof (ARSTREAM_NetworkHeaders_AckPacket_t));
+                currentFrameIsDeliverable = 1;
+            }
+            ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
+            if (currentFrameIsDeliverable == 1)
+            {
+                skipCurrentFrame = 1;
+                ARSTREAM_Reader_DeliverIncompleteFrame (reader, &previousFrameAck);
+            }
+        }
+
+        ARSTREAM_Reader_CheckFlushFrameRequest (reader);
     }
 
     free (recvData);
 
     reader->callback (ARSTREAM_READER_CAUSE_CANCEL, reader->currentFrameBuffer, reader->currentFrameSize, 0, 0, &(reader->currentFrameBufferSize), reader->custom);
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Stream reader thread ended");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Stream reader thread ended");
     reader->dataThreadStarted = 0;
     return (void *)0;
 }
@@ -478,16 +1135,19 @@ void* ARSTREAM_Reader_RunDataThread (void *ARSTREAM_Reader_t_Param)
 void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param)
 {
     ARSTREAM_NetworkHeaders_AckPacket_t sendPacket = {0};
+    ARSTREAM_NetworkHeaders_ControlPacket_t controlPacket;
     ARSTREAM_Reader_t *reader = (ARSTREAM_Reader_t *)ARSTREAM_Reader_t_Param;
     memset(&sendPacket, 0, sizeof(sendPacket));
+    memset(&controlPacket, 0, sizeof(controlPacket));
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack sender thread running");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack sender thread running");
     reader->ackThreadStarted = 1;
 
     while (reader->threadsShouldStop == 0)
     {
         int isPeriodicAck = 0;
-        ARSAL_Mutex_Lock (&(reader->ackSendMutex));
+        int sendFlushFrameRequest = 0;
+        ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackSendMutex), ARSTREAM_EVENT_LOCK_READER_ACK_SEND);
         if (reader->maxAckInterval <= 0)
         {
             ARSAL_Cond_Wait (&(reader->ackSendCond), &(reader->ackSendMutex));
@@ -500,22 +1160,33 @@ void* ARSTREAM_Reader_RunAckThread (void *ARSTREAM_Reader_t_Param)
                 isPeriodicAck = 1;
             }
         }
+        sendFlushFrameRequest = reader->flushFrameRequestIsPending;
+        reader->flushFrameRequestIsPending = 0;
         ARSAL_Mutex_Unlock (&(reader->ackSendMutex));
 
+        if (sendFlushFrameRequest == 1)
+        {
+            ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackPacketMutex), ARSTREAM_EVENT_LOCK_READER_ACK_PACKET);
+            controlPacket.frameNumber = htods (reader->ackPacket.frameNumber);
+            ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
+            controlPacket.controlType = ARSTREAM_NETWORK_HEADERS_CONTROL_FLUSH_FRAME_REQUEST;
+            reader->transport->ops->send (reader->transport->context, ARSTREAM_TRANSPORT_CHANNEL_ACK, (uint8_t *)&controlPacket, sizeof (controlPacket), NULL, NULL);
+        }
+
         /* Only send an ACK if the maxAckInterval value allows it. */
         if ((reader->maxAckInterval > 0) ||
             ((reader->maxAckInterval == 0) && (isPeriodicAck == 0)))
         {
-            ARSAL_Mutex_Lock (&(reader->ackPacketMutex));
+            ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackPacketMutex), ARSTREAM_EVENT_LOCK_READER_ACK_PACKET);
             sendPacket.frameNumber = htods  (reader->ackPacket.frameNumber);
             sendPacket.highPacketsAck = htodll (reader->ackPacket.highPacketsAck);
             sendPacket.lowPacketsAck  = htodll (reader->ackPacket.lowPacketsAck);
             ARSAL_Mutex_Unlock (&(reader->ackPacketMutex));
-            ARNETWORK_Manager_SendData (reader->manager, reader->ackBufferID, (uint8_t *)&sendPacket, sizeof (sendPacket), NULL, ARSTREAM_Reader_NetworkCallback, 1);
+            reader->transport->ops->send (reader->transport->context, ARSTREAM_TRANSPORT_CHANNEL_ACK, (uint8_t *)&sendPacket, sizeof (sendPacket), NULL, NULL);
         }
     }
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack sender thread ended");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_READER_TAG, "Ack sender thread ended");
     reader->ackThreadStarted = 0;
     return (void *)0;
 }
@@ -530,7 +1201,7 @@ float ARSTREAM_Reader_GetEstimatedEfficiency (ARSTREAM_Reader_t *reader)
     uint32_t totalPackets = 0;
     uint32_t usefulPackets = 0;
     int i;
-    ARSAL_Mutex_Lock (&(reader->ackPacketMutex));
+    ARSTREAM_EVENT_MUTEX_LOCK (&(reader->ackPacketMutex), ARSTREAM_EVENT_LOCK_READER_ACK_PACKET);
     for (i = 0; i < ARSTREAM_READER_EFFICIENCY_AVERAGE_NB_FRAMES; i++)
     {
         totalPackets += reader->efficiency_nbTotal [i];
@@ -544,7 +1215,7 @@ float ARSTREAM_Reader_GetEstimatedEfficiency (ARSTREAM_Reader_t *reader)
     else if (usefulPackets > totalPackets)
     {
         retVal = 1.0f; // If this happens, it means that we have a big problem
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Computed efficiency is greater that 1.0 ...");
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_READER_TAG, "Computed efficiency is greater that 1.0 ...");
     }
     else
     {
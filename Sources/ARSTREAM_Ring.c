@@ -0,0 +1,322 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Ring.c
+ * @brief Lock-free single producer / single consumer ring of packet slots
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+/*
+ * Private Headers
+ */
+
+#include "ARSTREAM_Ring.h"
+#include "ARSTREAM_Time.h"
+
+/*
+ * Macros
+ */
+
+/**
+ * Magic number of an initialized ring ("ARRG")
+ */
+#define ARSTREAM_RING_MAGIC (0x41525247)
+
+/**
+ * Alignment of the indexes and slots, to avoid false sharing between the reader and the writer
+ */
+#define ARSTREAM_RING_CACHE_LINE (64)
+
+/**
+ * Size of the header of a slot (packet size, padded)
+ */
+#define ARSTREAM_RING_SLOT_HEADER_SIZE (8)
+
+/**
+ * Polling period when futexes are not available, in us
+ */
+#define ARSTREAM_RING_POLL_PERIOD_US (1000)
+
+/*
+ * Types
+ */
+
+struct ARSTREAM_Ring_Shared_t {
+    /* Constant after init. Only read by ARSTREAM_Ring_Attach(), which keeps a checked copy */
+    uint32_t magic;
+    uint32_t nbSlots;
+    uint32_t slotSize;
+    uint32_t slotStride;
+    uint32_t futexOp; /* Private futexes are cheaper, but do not work across processes */
+    uint8_t padding0 [ARSTREAM_RING_CACHE_LINE - (5 * sizeof (uint32_t))];
+
+    /* Written by the writer. writeIndex is also the futex word the reader sleeps on */
+    volatile uint32_t writeIndex;
+    volatile uint32_t readerWaiting;
+    uint8_t padding1 [ARSTREAM_RING_CACHE_LINE - (2 * sizeof (uint32_t))];
+
+    /* Written by the reader */
+    volatile uint32_t readIndex;
+    uint8_t padding2 [ARSTREAM_RING_CACHE_LINE - sizeof (uint32_t)];
+
+    /* Followed by nbSlots slots of slotStride bytes */
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Gets the stride of the slots of a ring
+ * @param slotSize Maximum size of a packet, in bytes
+ * @return The size of a slot with its header, rounded up to a cache line
+ */
+static uint32_t ARSTREAM_Ring_GetSlotStride (uint32_t slotSize);
+
+/**
+ * @brief Gets a slot of a ring
+ * @param ring The ring
+ * @param index Index of the packet (read or write index)
+ * @return A pointer to the slot header
+ */
+static uint8_t* ARSTREAM_Ring_GetSlot (ARSTREAM_Ring_t *ring, uint32_t index);
+
+/*
+ * Internal functions implementation
+ */
+
+static uint32_t ARSTREAM_Ring_GetSlotStride (uint32_t slotSize)
+{
+    uint32_t stride = slotSize + ARSTREAM_RING_SLOT_HEADER_SIZE;
+    return (stride + ARSTREAM_RING_CACHE_LINE - 1) & ~(ARSTREAM_RING_CACHE_LINE - 1);
+}
+
+static uint8_t* ARSTREAM_Ring_GetSlot (ARSTREAM_Ring_t *ring, uint32_t index)
+{
+    /* nbSlots is a power of two, so the indexes can wrap around 2^32 */
+    return ring->slots + ((size_t)(index & (ring->nbSlots - 1)) * ring->slotStride);
+}
+
+/*
+ * Implementation
+ */
+
+size_t ARSTREAM_Ring_GetMemorySize (uint32_t nbSlots, uint32_t slotSize)
+{
+    if ((nbSlots == 0) ||
+        ((nbSlots & (nbSlots - 1)) != 0) ||
+        (slotSize == 0) ||
+        (slotSize > (UINT32_MAX / 2)))
+    {
+        return 0;
+    }
+    return sizeof (ARSTREAM_Ring_Shared_t) + ((size_t)nbSlots * ARSTREAM_Ring_GetSlotStride (slotSize));
+}
+
+int ARSTREAM_Ring_Init (ARSTREAM_Ring_t *ring, void *memory, uint32_t nbSlots, uint32_t slotSize, int processShared)
+{
+    ARSTREAM_Ring_Shared_t *shared = (ARSTREAM_Ring_Shared_t *)memory;
+
+    if ((ring == NULL) ||
+        (memory == NULL) ||
+        (ARSTREAM_Ring_GetMemorySize (nbSlots, slotSize) == 0))
+    {
+        return -1;
+    }
+
+    ring->shared = shared;
+    ring->slots = (uint8_t *)memory + sizeof (ARSTREAM_Ring_Shared_t);
+    ring->nbSlots = nbSlots;
+    ring->slotSize = slotSize;
+    ring->slotStride = ARSTREAM_Ring_GetSlotStride (slotSize);
+#ifdef __linux__
+    ring->futexOp = (processShared != 0) ? 0 : FUTEX_PRIVATE_FLAG;
+#else
+    (void)processShared;
+    ring->futexOp = 0;
+#endif
+
+    memset (shared, 0, sizeof (ARSTREAM_Ring_Shared_t));
+    shared->nbSlots = ring->nbSlots;
+    shared->slotSize = ring->slotSize;
+    shared->slotStride = ring->slotStride;
+    shared->futexOp = ring->futexOp;
+    /* Publish the ring only when it is fully initialized */
+    __atomic_store_n (&(shared->magic), ARSTREAM_RING_MAGIC, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int ARSTREAM_Ring_Attach (ARSTREAM_Ring_t *ring, void *memory, size_t memorySize)
+{
+    ARSTREAM_Ring_Shared_t *shared = (ARSTREAM_Ring_Shared_t *)memory;
+    uint32_t nbSlots, slotSize, slotStride, futexOp;
+
+    if ((ring == NULL) ||
+        (memory == NULL) ||
+        (memorySize < sizeof (ARSTREAM_Ring_Shared_t)) ||
+        (__atomic_load_n (&(shared->magic), __ATOMIC_ACQUIRE) != ARSTREAM_RING_MAGIC))
+    {
+        return -1;
+    }
+
+    /* The memory may come from another process, which can still write to it :
+     * read the geometry once, check this copy, and never read it from the memory again */
+    nbSlots = __atomic_load_n (&(shared->nbSlots), __ATOMIC_RELAXED);
+    slotSize = __atomic_load_n (&(shared->slotSize), __ATOMIC_RELAXED);
+    slotStride = __atomic_load_n (&(shared->slotStride), __ATOMIC_RELAXED);
+    futexOp = __atomic_load_n (&(shared->futexOp), __ATOMIC_RELAXED);
+    if ((ARSTREAM_Ring_GetMemorySize (nbSlots, slotSize) == 0) ||
+        (ARSTREAM_Ring_GetMemorySize (nbSlots, slotSize) > memorySize) ||
+        (slotStride != ARSTREAM_Ring_GetSlotStride (slotSize)) ||
+        (futexOp != 0))
+    {
+        return -1;
+    }
+
+    ring->shared = shared;
+    ring->slots = (uint8_t *)memory + sizeof (ARSTREAM_Ring_Shared_t);
+    ring->nbSlots = nbSlots;
+    ring->slotSize = slotSize;
+    ring->slotStride = slotStride;
+    ring->futexOp = futexOp;
+    return 0;
+}
+
+uint32_t ARSTREAM_Ring_GetSlotSize (ARSTREAM_Ring_t *ring)
+{
+    return ring->slotSize;
+}
+
+uint8_t* ARSTREAM_Ring_WriteBegin (ARSTREAM_Ring_t *ring)
+{
+    uint32_t writeIndex = __atomic_load_n (&(ring->shared->writeIndex), __ATOMIC_RELAXED);
+    uint32_t readIndex = __atomic_load_n (&(ring->shared->readIndex), __ATOMIC_ACQUIRE);
+
+    if ((writeIndex - readIndex) >= ring->nbSlots)
+    {
+        return NULL;
+    }
+    return ARSTREAM_Ring_GetSlot (ring, writeIndex) + ARSTREAM_RING_SLOT_HEADER_SIZE;
+}
+
+void ARSTREAM_Ring_WriteEnd (ARSTREAM_Ring_t *ring, uint32_t size)
+{
+    uint32_t writeIndex = __atomic_load_n (&(ring->shared->writeIndex), __ATOMIC_RELAXED);
+    uint32_t *slotSize = (uint32_t *)ARSTREAM_Ring_GetSlot (ring, writeIndex);
+
+    *slotSize = (size <= ring->slotSize) ? size : ring->slotSize;
+    __atomic_store_n (&(ring->shared->writeIndex), writeIndex + 1, __ATOMIC_RELEASE);
+
+    /* Pairs with the fence of ARSTREAM_Ring_Wait : either the reader sees the new index, or we see its flag */
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    if (__atomic_load_n (&(ring->shared->readerWaiting), __ATOMIC_RELAXED) != 0)
+    {
+#ifdef __linux__
+        syscall (SYS_futex, &(ring->shared->writeIndex), FUTEX_WAKE | ring->futexOp, 1, NULL, NULL, 0);
+#endif
+    }
+}
+
+uint8_t* ARSTREAM_Ring_ReadBegin (ARSTREAM_Ring_t *ring, uint32_t *size)
+{
+    uint32_t readIndex = __atomic_load_n (&(ring->shared->readIndex), __ATOMIC_RELAXED);
+    uint32_t writeIndex = __atomic_load_n (&(ring->shared->writeIndex), __ATOMIC_ACQUIRE);
+    uint8_t *slot;
+    uint32_t slotSize;
+
+    if (readIndex == writeIndex)
+    {
+        return NULL;
+    }
+    slot = ARSTREAM_Ring_GetSlot (ring, readIndex);
+    memcpy (&slotSize, slot, sizeof (slotSize));
+    /* Never trust a size written by another process */
+    *size = (slotSize <= ring->slotSize) ? slotSize : ring->slotSize;
+    return slot + ARSTREAM_RING_SLOT_HEADER_SIZE;
+}
+
+void ARSTREAM_Ring_ReadEnd (ARSTREAM_Ring_t *ring)
+{
+    uint32_t readIndex = __atomic_load_n (&(ring->shared->readIndex), __ATOMIC_RELAXED);
+    __atomic_store_n (&(ring->shared->readIndex), readIndex + 1, __ATOMIC_RELEASE);
+}
+
+int ARSTREAM_Ring_Wait (ARSTREAM_Ring_t *ring, int timeoutMs)
+{
+    uint32_t readIndex = __atomic_load_n (&(ring->shared->readIndex), __ATOMIC_RELAXED);
+    uint32_t writeIndex;
+#ifdef __linux__
+    struct timespec timeout;
+
+    __atomic_store_n (&(ring->shared->readerWaiting), 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    writeIndex = __atomic_load_n (&(ring->shared->writeIndex), __ATOMIC_ACQUIRE);
+    if ((writeIndex == readIndex) &&
+        (timeoutMs > 0))
+    {
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (timeoutMs % 1000) * 1000000;
+        /* Returns at once if the writer published a packet after our check */
+        syscall (SYS_futex, &(ring->shared->writeIndex), FUTEX_WAIT | ring->futexOp, writeIndex, &timeout, NULL, 0);
+        writeIndex = __atomic_load_n (&(ring->shared->writeIndex), __ATOMIC_ACQUIRE);
+    }
+    __atomic_store_n (&(ring->shared->readerWaiting), 0, __ATOMIC_RELAXED);
+#else
+    uint64_t endUs = ARSTREAM_Time_GetMonotonicUs () + ((uint64_t)timeoutMs * 1000);
+    writeIndex = __atomic_load_n (&(ring->shared->writeIndex), __ATOMIC_ACQUIRE);
+    while ((writeIndex == readIndex) &&
+           (ARSTREAM_Time_GetMonotonicUs () < endUs))
+    {
+        usleep (ARSTREAM_RING_POLL_PERIOD_US);
+        writeIndex = __atomic_load_n (&(ring->shared->writeIndex), __ATOMIC_ACQUIRE);
+    }
+#endif
+    return (writeIndex != readIndex) ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Ring.h
+ * @brief Lock-free single producer / single consumer ring of packet slots
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_RING_PRIVATE_H_
+#define _ARSTREAM_RING_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <stddef.h>
+#include <inttypes.h>
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Layout of a ring in its memory block (private)
+ */
+typedef struct ARSTREAM_Ring_Shared_t ARSTREAM_Ring_Shared_t;
+
+/**
+ * @brief A ring of fixed size slots, with one writer thread and one reader thread
+ *
+ * The ring is entirely stored in the memory block given to ARSTREAM_Ring_Init(), and only uses
+ * offsets internally. The block can thus be mapped by two processes at different addresses.
+ * Readers and writers never take a lock. Only a reader waiting on an empty ring sleeps, on a futex
+ * when available.
+ *
+ * This structure is the process-local handle of the ring. It keeps its own copy of the geometry,
+ * checked once by ARSTREAM_Ring_Init() or ARSTREAM_Ring_Attach(): the other process can still
+ * write to the memory block, so only the indexes are read from it afterwards.
+ */
+typedef struct {
+    ARSTREAM_Ring_Shared_t *shared; /**< Header of the ring in the memory block */
+    uint8_t *slots; /**< First slot of the ring in the memory block */
+    uint32_t nbSlots; /**< Number of slots (power of two) */
+    uint32_t slotSize; /**< Maximum size of a packet, in bytes */
+    uint32_t slotStride; /**< Distance between two slots, in bytes */
+    uint32_t futexOp; /**< Flags of the futex calls */
+} ARSTREAM_Ring_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Gets the size of the memory block needed by a ring
+ * @param nbSlots Number of slots (must be a power of two)
+ * @param slotSize Maximum size of a packet, in bytes
+ * @return The size of the memory block, in bytes, or 0 if the parameters are invalid
+ */
+size_t ARSTREAM_Ring_GetMemorySize (uint32_t nbSlots, uint32_t slotSize);
+
+/**
+ * @brief Initializes an empty ring in a memory block
+ * @param[out] ring The handle of the ring
+ * @param memory The memory block, of at least ARSTREAM_Ring_GetMemorySize() bytes, aligned on 64 bytes
+ * @param nbSlots Number of slots (must be a power of two)
+ * @param slotSize Maximum size of a packet, in bytes
+ * @param processShared 1 if the memory block is shared with another process, 0 if the ring is only used by one process
+ * @return 0 on success, -1 if the parameters are invalid
+ */
+int ARSTREAM_Ring_Init (ARSTREAM_Ring_t *ring, void *memory, uint32_t nbSlots, uint32_t slotSize, int processShared);
+
+/**
+ * @brief Attaches to a ring already initialized in a shared memory block (e.g. by another process)
+ * @param[out] ring The handle of the ring
+ * @param memory The memory block
+ * @param memorySize The size of the memory block, in bytes
+ * @return 0 on success, -1 if the memory block does not hold a valid process shared ring
+ */
+int ARSTREAM_Ring_Attach (ARSTREAM_Ring_t *ring, void *memory, size_t memorySize);
+
+/**
+ * @brief Gets the maximum size of a packet in a ring
+ * @param ring The ring
+ * @return The slot size, in bytes
+ */
+uint32_t ARSTREAM_Ring_GetSlotSize (ARSTREAM_Ring_t *ring);
+
+/**
+ * @brief Gets the next free slot of a ring (writer side)
+ * @param ring The ring
+ * @return A pointer to the slot data, or NULL if the ring is full
+ * @note The packet is only visible to the reader after ARSTREAM_Ring_WriteEnd()
+ */
+uint8_t* ARSTREAM_Ring_WriteBegin (ARSTREAM_Ring_t *ring);
+
+/**
+ * @brief Publishes the slot returned by ARSTREAM_Ring_WriteBegin() (writer side)
+ * Wakes the reader up if it is waiting
+ * @param ring The ring
+ * @param size The size of the packet written in the slot, in bytes
+ */
+void ARSTREAM_Ring_WriteEnd (ARSTREAM_Ring_t *ring, uint32_t size);
+
+/**
+ * @brief Gets the oldest packet of a ring, without removing it (reader side)
+ * @param ring The ring
+ * @param[out] size The size of the packet, in bytes
+ * @return A pointer to the packet data, or NULL if the ring is empty
+ */
+uint8_t* ARSTREAM_Ring_ReadBegin (ARSTREAM_Ring_t *ring, uint32_t *size);
+
+/**
+ * @brief Frees the slot returned by ARSTREAM_Ring_ReadBegin() (reader side)
+ * @param ring The ring
+ */
+void ARSTREAM_Ring_ReadEnd (ARSTREAM_Ring_t *ring);
+
+/**
+ * @brief Waits until the ring is not empty (reader side)
+ * @param ring The ring
+ * @param timeoutMs Maximum time to wait, in ms
+ * @return 1 if a packet is available, 0 on timeout
+ * @note The wait may return early (e.g. on signals). Callers must check the ring again
+ */
+int ARSTREAM_Ring_Wait (ARSTREAM_Ring_t *ring, int timeoutMs);
+
+#endif /* _ARSTREAM_RING_PRIVATE_H_ */
@@ -52,6 +52,11 @@
 
 #include "ARSTREAM_Buffers.h"
 #include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_Histogram.h"
+#include "ARSTREAM_Time.h"
+#include "ARSTREAM_EventLog.h"
+#include "ARSTREAM_Thread.h"
+#include "ARSTREAM_Print.h"
 
 /*
  * ARSDK Headers
@@ -110,6 +115,11 @@
  */
 #define ARSTREAM_SENDER_PREVIOUS_FRAME_NB_SAVE (10)
 
+/**
+ * Maximum size of the headers of a fragment (data header and all its extensions)
+ */
+#define ARSTREAM_SENDER_MAX_HEADER_SIZE (sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t))
+
 /**
  * Sets *PTR to VAL if PTR is not null
  */
@@ -132,13 +142,13 @@ typedef struct {
     uint32_t frameSize;
     uint8_t *frameBuffer;
     int isHighPriority;
+    uint64_t queueTimeUs;
 } ARSTREAM_Sender_Frame_t;
 
 struct ARSTREAM_Sender_t {
     /* Configuration on New */
-    ARNETWORK_Manager_t *manager;
-    int dataBufferID;
-    int ackBufferID;
+    ARSTREAM_Transport_t *transport;
+    int ownsTransport;
     ARSTREAM_Sender_FrameUpdateCallback_t callback;
     uint32_t maxNumberOfNextFrames;
     uint32_t maxFragmentSize;
@@ -148,11 +158,15 @@ struct ARSTREAM_Sender_t {
     /* Other configuration */
     int minRetryTimeMs;
     int maxRetryTimeMs;
+    int frameTimestampsEnabled;
 
     /* Current frame storage */
     ARSTREAM_Sender_Frame_t currentFrame;
     int currentFrameNbFragments;
     int currentFrameCbWasCalled;
+    uint64_t currentFrameStartTimeUs;
+    uint64_t currentFrameFirstSendTimeUs;
+    uint64_t currentFrameAllSentTimeUs;
     ARSAL_Mutex_t packetsToSendMutex;
     ARSTREAM_NetworkHeaders_AckPacket_t packetsToSend;
 
@@ -168,6 +182,7 @@ struct ARSTREAM_Sender_t {
     uint32_t indexGetNextFrame;
     uint32_t numberOfWaitingFrames;
     ARSTREAM_Sender_Frame_t *nextFrames;
+    uint32_t lastFlushFrameNumber;
 
     /* Previous frame storage (for LATE_ACKs) */
     int *previousFramesStatus;
@@ -177,18 +192,23 @@ struct ARSTREAM_Sender_t {
     int threadsShouldStop;
     int dataThreadStarted;
     int ackThreadStarted;
+    ARSTREAM_Thread_t *threads [ARSTREAM_THREAD_ROLE_MAX]; // Threads started by ARSTREAM_Sender_StartThreads
 
     /* Efficiency calculations */
     int efficiency_nbFragments [ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES];
     int efficiency_nbSent [ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES];
     int efficiency_index;
+
+    /* Frame lifecycle statistics */
+    ARSTREAM_Histogram_t histograms [ARSTREAM_SENDER_HISTOGRAM_MAX];
+    uint64_t counters [ARSTREAM_SENDER_COUNTER_MAX];
 };
 
 typedef struct {
     ARSTREAM_Sender_t *sender;
     uint32_t frameNumber;
     int fragmentIndex;
-} ARSTREAM_Sender_NetworkCallbackParam_t;
+} ARSTREAM_Sender_TransportCallbackParam_t;
 
 /*
  * Internal functions declarations
@@ -221,16 +241,13 @@ static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size,
 static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *newFrame);
 
 /**
- * @brief ARNETWORK_Manager_Callback_t for ARNETWORK_... calls
- * @param IoBufferId Unused as we always send on one unique buffer
- * @param dataPtr Unused as we don't need to free the memory
- * @param customData (ARSTREAM_Sender_NetworkCallbackParam_t *) Sender + fragment index
- * @param status Network information
- * @return ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT
+ * @brief ARSTREAM_Transport_SendCallback_t for the data fragments
+ * @param callbackData (ARSTREAM_Sender_TransportCallbackParam_t *) Sender + fragment index
+ * @param status Transport information
  *
- * @warning customData is a malloc'd pointer, and must be freed within this callback, during last call
+ * @warning callbackData is a malloc'd pointer, and must be freed within this callback
  */
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status);
+static void ARSTREAM_Sender_TransportCallback (void *callbackData, eARSTREAM_TRANSPORT_SEND_STATUS status);
 
 /**
  * @brief Signals that the current frame of the sender was acknowledged
@@ -238,6 +255,30 @@ eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBuffer
  */
 static void ARSTREAM_Sender_FrameWasAck (ARSTREAM_Sender_t *sender);
 
+/**
+ * @brief Cancels a frame and calls the callback with FRAME_CANCEL status
+ * @param sender The sender
+ * @param frame The frame to cancel
+ */
+static void ARSTREAM_Sender_CancelFrame (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame);
+
+/**
+ * @brief Records a duration in a lifecycle histogram
+ * @param sender The sender
+ * @param histogram The histogram to update
+ * @param startTimeUs The start time of the duration
+ * @param endTimeUs The end time of the duration
+ */
+static void ARSTREAM_Sender_RecordDuration (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_HISTOGRAM histogram, uint64_t startTimeUs, uint64_t endTimeUs);
+
+/**
+ * @brief Adds a value to a cumulative counter of the sender
+ * @param sender The sender
+ * @param counter Which counter to increment
+ * @param value Value to add
+ */
+static inline void ARSTREAM_Sender_AddCounter (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_COUNTER counter, uint64_t value);
+
 /**
  * @brief Calls LATE_ACK callback if required
  * @param sender The sender
@@ -247,6 +288,13 @@ static void ARSTREAM_Sender_FrameWasAck (ARSTREAM_Sender_t *sender);
  */
 static int ARSTREAM_Sender_SendLateAck (ARSTREAM_Sender_t *sender, uint16_t frameId);
 
+/**
+ * @brief Handles a control packet received from the reader
+ * @param sender The sender
+ * @param controlPacket The control packet, in network endianness
+ */
+static void ARSTREAM_Sender_ProcessControlPacket (ARSTREAM_Sender_t *sender, ARSTREAM_NetworkHeaders_ControlPacket_t *controlPacket);
+
 /**
  * @brief Internal wrapper around the callback calls
  * This wrapper includes checks for framePointer value, and avoids calling
@@ -267,7 +315,7 @@ static void ARSTREAM_Sender_FlushQueue (ARSTREAM_Sender_t *sender)
     while (sender->numberOfWaitingFrames > 0)
     {
         ARSTREAM_Sender_Frame_t *nextFrame = &(sender->nextFrames [sender->indexGetNextFrame]);
-        ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, nextFrame->frameBuffer, nextFrame->frameSize);
+        ARSTREAM_Sender_CancelFrame (sender, nextFrame);
         sender->indexGetNextFrame++;
         sender->indexGetNextFrame %= sender->maxNumberOfNextFrames;
         sender->numberOfWaitingFrames--;
@@ -277,7 +325,7 @@ static void ARSTREAM_Sender_FlushQueue (ARSTREAM_Sender_t *sender)
 static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size, uint8_t *buffer, int wasFlushFrame)
 {
     int retVal;
-    ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+    ARSTREAM_EVENT_MUTEX_LOCK (&(sender->nextFrameMutex), ARSTREAM_EVENT_LOCK_SENDER_NEXT_FRAME);
     retVal = sender->numberOfWaitingFrames;
     if (sender->currentFrameCbWasCalled == 0)
     {
@@ -295,6 +343,17 @@ static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size,
         nextFrame->frameBuffer = buffer;
         nextFrame->frameSize   = size;
         nextFrame->isHighPriority = wasFlushFrame;
+        nextFrame->queueTimeUs = ARSTREAM_Time_GetMonotonicUs ();
+        ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FRAME_QUEUED, nextFrame->frameNumber, size, wasFlushFrame);
+        if (buffer != NULL)
+        {
+            /* Do not count the dummy frame of ARSTREAM_Sender_StopSender */
+            ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_FRAMES_QUEUED, 1);
+        }
+        if (wasFlushFrame == 1)
+        {
+            sender->lastFlushFrameNumber = sender->nextFrameNumber;
+        }
 
         sender->indexAddNextFrame++;
         sender->indexAddNextFrame %= sender->maxNumberOfNextFrames;
@@ -305,6 +364,8 @@ static int ARSTREAM_Sender_AddToQueue (ARSTREAM_Sender_t *sender, uint32_t size,
     }
     else
     {
+        ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FRAME_REJECTED, size, 0, 0);
+        ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_FRAMES_REJECTED, 1);
         retVal = -1;
     }
     ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
@@ -315,7 +376,7 @@ static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sen
 {
     int retVal = 0;
     int hadTimeout = 0;
-    ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+    ARSTREAM_EVENT_MUTEX_LOCK (&(sender->nextFrameMutex), ARSTREAM_EVENT_LOCK_SENDER_NEXT_FRAME);
     // Check if a frame is ready and of good priority
     if (sender->numberOfWaitingFrames > 0)
     {
@@ -337,7 +398,7 @@ static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sen
     {
         struct timespec start, end;
         int timewaited = 0;
-        int waitTime = ARNETWORK_Manager_GetEstimatedLatency (sender->manager);
+        int waitTime = sender->transport->ops->getEstimatedLatency (sender->transport->context);
         if (waitTime < 0) // Unable to get latency
         {
             waitTime = ARSTREAM_SENDER_DEFAULT_ESTIMATED_LATENCY_MS;
@@ -390,17 +451,17 @@ static int ARSTREAM_Sender_PopFromQueue (ARSTREAM_Sender_t *sender, ARSTREAM_Sen
         newFrame->frameBuffer = frame->frameBuffer;
         newFrame->frameSize   = frame->frameSize;
         newFrame->isHighPriority = frame->isHighPriority;
+        newFrame->queueTimeUs = frame->queueTimeUs;
+        ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FRAME_POPPED, frame->frameNumber, sender->numberOfWaitingFrames, 0);
     }
     ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
     return retVal;
 }
 
-eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBufferId, uint8_t *dataPtr, void *customData, eARNETWORK_MANAGER_CALLBACK_STATUS status)
+static void ARSTREAM_Sender_TransportCallback (void *callbackData, eARSTREAM_TRANSPORT_SEND_STATUS status)
 {
-    eARNETWORK_MANAGER_CALLBACK_RETURN retVal = ARNETWORK_MANAGER_CALLBACK_RETURN_DEFAULT;
-
     /* Get params */
-    ARSTREAM_Sender_NetworkCallbackParam_t *cbParams = (ARSTREAM_Sender_NetworkCallbackParam_t *)customData;
+    ARSTREAM_Sender_TransportCallbackParam_t *cbParams = (ARSTREAM_Sender_TransportCallbackParam_t *)callbackData;
 
     /* Get Sender */
     ARSTREAM_Sender_t *sender = cbParams->sender;
@@ -411,51 +472,88 @@ eARNETWORK_MANAGER_CALLBACK_RETURN ARSTREAM_Sender_NetworkCallback (int IoBuffer
     /* Get frameNumber */
     uint32_t frameNumber = cbParams->frameNumber;
 
-    /* Remove "unused parameter" warnings */
-    (void)IoBufferId;
-    (void)dataPtr;
-
     switch (status)
     {
-    case ARNETWORK_MANAGER_CALLBACK_STATUS_SENT:
-        ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
+    case ARSTREAM_TRANSPORT_SEND_STATUS_SENT:
+        ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_FRAGMENTS_SENT, 1);
+        ARSTREAM_EVENT_MUTEX_LOCK (&(sender->packetsToSendMutex), ARSTREAM_EVENT_LOCK_SENDER_PACKETS_TO_SEND);
         // Modify packetsToSend only if it refers to the frame we're sending
         if (frameNumber == sender->packetsToSend.frameNumber)
         {
-            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Sent packet %d", packetIndex);
+            ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FRAGMENT_SENT, frameNumber, packetIndex, 0);
             if (1 == ARSTREAM_NetworkHeaders_AckPacketUnsetFlag (&(sender->packetsToSend), packetIndex))
             {
-                ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "All packets were sent");
+                ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "All packets were sent");
+                if (sender->currentFrameAllSentTimeUs == 0)
+                {
+                    sender->currentFrameAllSentTimeUs = ARSTREAM_Time_GetMonotonicUs ();
+                    ARSTREAM_Sender_RecordDuration (sender, ARSTREAM_SENDER_HISTOGRAM_SENT, sender->currentFrameFirstSendTimeUs, sender->currentFrameAllSentTimeUs);
+                }
             }
         }
         else
         {
-            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Sent a packet for an old frame [packet %d, current frame %d]", frameNumber,sender->packetsToSend.frameNumber);
+            ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_LATE_FRAGMENT_SENT, frameNumber, sender->packetsToSend.frameNumber, 0);
+            ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_LATE_FRAGMENTS_SENT, 1);
         }
         ARSAL_Mutex_Unlock (&(sender->packetsToSendMutex));
         /* Free cbParams */
         free (cbParams);
         break;
-    case ARNETWORK_MANAGER_CALLBACK_STATUS_CANCEL:
+    case ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL:
         /* Free cbParams */
         free (cbParams);
         break;
     default:
         break;
     }
-    return retVal;
 }
 
 
 static void ARSTREAM_Sender_FrameWasAck (ARSTREAM_Sender_t *sender)
 {
+    uint64_t nowUs = ARSTREAM_Time_GetMonotonicUs ();
+    ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FRAME_ACKNOWLEDGED, sender->currentFrame.frameNumber, nowUs - sender->currentFrame.queueTimeUs, 0);
+    ARSTREAM_Sender_RecordDuration (sender, ARSTREAM_SENDER_HISTOGRAM_ACKNOWLEDGED, sender->currentFrameFirstSendTimeUs, nowUs);
+    ARSTREAM_Sender_RecordDuration (sender, ARSTREAM_SENDER_HISTOGRAM_TOTAL, sender->currentFrame.queueTimeUs, nowUs);
+    ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_FRAMES_ACKNOWLEDGED, 1);
     ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_SENT, sender->currentFrame.frameBuffer, sender->currentFrame.frameSize);
     sender->currentFrameCbWasCalled = 1;
-    ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+    ARSTREAM_EVENT_MUTEX_LOCK (&(sender->nextFrameMutex), ARSTREAM_EVENT_LOCK_SENDER_NEXT_FRAME);
     ARSAL_Cond_Signal (&(sender->nextFrameCond));
     ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
 }
 
+static void ARSTREAM_Sender_CancelFrame (ARSTREAM_Sender_t *sender, ARSTREAM_Sender_Frame_t *frame)
+{
+    if (frame->frameBuffer != NULL)
+    {
+        /* Only the current frame has acknowledged fragments, queued frames were never sent */
+        int isCurrentFrame = (frame == &(sender->currentFrame)) ? 1 : 0;
+        ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FRAME_CANCELLED, frame->frameNumber,
+                        (isCurrentFrame == 1) ? ARSTREAM_NetworkHeaders_AckPacketCountSet (&(sender->ackPacket), sender->currentFrameNbFragments) : 0,
+                        (isCurrentFrame == 1) ? sender->currentFrameNbFragments : 0);
+        ARSTREAM_Sender_RecordDuration (sender, ARSTREAM_SENDER_HISTOGRAM_CANCELLED, frame->queueTimeUs, ARSTREAM_Time_GetMonotonicUs ());
+        ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_FRAMES_CANCELLED, 1);
+    }
+    ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, frame->frameBuffer, frame->frameSize);
+}
+
+static void ARSTREAM_Sender_RecordDuration (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_HISTOGRAM histogram, uint64_t startTimeUs, uint64_t endTimeUs)
+{
+    uint64_t durationUs = 0;
+    if (endTimeUs > startTimeUs)
+    {
+        durationUs = endTimeUs - startTimeUs;
+    }
+    ARSTREAM_Histogram_Record (&(sender->histograms [histogram]), (durationUs > UINT32_MAX) ? UINT32_MAX : (uint32_t)durationUs);
+}
+
+static inline void ARSTREAM_Sender_AddCounter (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_COUNTER counter, uint64_t value)
+{
+    __sync_fetch_and_add (&(sender->counters [counter]), value);
+}
+
 static int ARSTREAM_Sender_SendLateAck (ARSTREAM_Sender_t *sender, uint16_t frameId)
 {
     int retVal = 0;
@@ -470,18 +568,49 @@ static int ARSTREAM_Sender_SendLateAck (ARSTREAM_Sender_t *sender, uint16_t fram
     return retVal;
 }
 
+static void ARSTREAM_Sender_ProcessControlPacket (ARSTREAM_Sender_t *sender, ARSTREAM_NetworkHeaders_ControlPacket_t *controlPacket)
+{
+    uint16_t frameNumber = dtohs (controlPacket->frameNumber);
+    switch (controlPacket->controlType)
+    {
+    case ARSTREAM_NETWORK_HEADERS_CONTROL_FLUSH_FRAME_REQUEST:
+    {
+        int16_t flushFrameAge;
+        ARSTREAM_EVENT_MUTEX_LOCK (&(sender->nextFrameMutex), ARSTREAM_EVENT_LOCK_SENDER_NEXT_FRAME);
+        flushFrameAge = (int16_t)((uint16_t)sender->lastFlushFrameNumber - frameNumber);
+        ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
+        // Only report the request if no flush frame was queued after the last frame seen by the reader
+        if (flushFrameAge <= 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Reader requested a flush frame (last frame seen : %d)", frameNumber);
+            ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FLUSH_REQUESTED, frameNumber, 0, 0);
+            ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_FLUSH_FRAMES_REQUESTED, 1);
+            ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FLUSH_FRAME_REQUESTED, NULL, 0);
+        }
+        break;
+    }
+    default:
+        ARSTREAM_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_SENDER_TAG, "Unknown control packet type %d", controlPacket->controlType);
+        break;
+    }
+}
+
 static void ARSTREAM_Sender_CallCallback (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize)
 {
     int needToCall = 1;
-    // Dont call if the frame is null, except for LATE_ACKs
-    if (framePointer == NULL && status != ARSTREAM_SENDER_STATUS_FRAME_LATE_ACK)
+    // Dont call if the frame is null, except for LATE_ACKs and flush frame requests
+    if ((framePointer == NULL) &&
+        (status != ARSTREAM_SENDER_STATUS_FRAME_LATE_ACK) &&
+        (status != ARSTREAM_SENDER_STATUS_FLUSH_FRAME_REQUESTED))
     {
         needToCall = 0;
     }
 
     if (needToCall == 1)
     {
+        ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_CALLBACK_BEGIN, status, 0, 0);
         sender->callback(status, framePointer, frameSize, sender->custom);
+        ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_CALLBACK_END, status, 0, 0);
     }
 }
 
@@ -500,6 +629,31 @@ void ARSTREAM_Sender_InitStreamAckBuffer (ARNETWORK_IOBufferParam_t *bufferParam
 }
 
 ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBufferID, int ackBufferID, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment,  void *custom, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Sender_t *retSender = NULL;
+    ARSTREAM_Transport_t *transport = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+
+    transport = ARSTREAM_Transport_NewNetwork (manager, dataBufferID, ackBufferID, &internalError);
+    if (internalError == ARSTREAM_OK)
+    {
+        retSender = ARSTREAM_Sender_NewWithTransport (transport, callback, framesBufferSize, maxFragmentSize, maxNumberOfFragment, custom, &internalError);
+    }
+
+    if (retSender != NULL)
+    {
+        retSender->ownsTransport = 1;
+    }
+    else if (transport != NULL)
+    {
+        ARSTREAM_Transport_Delete (&transport);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retSender;
+}
+
+ARSTREAM_Sender_t* ARSTREAM_Sender_NewWithTransport (ARSTREAM_Transport_t *transport, ARSTREAM_Sender_FrameUpdateCallback_t callback, uint32_t framesBufferSize, uint32_t maxFragmentSize, uint32_t maxNumberOfFragment,  void *custom, eARSTREAM_ERROR *error)
 {
     ARSTREAM_Sender_t *retSender = NULL;
     int packetsToSendMutexWasInit = 0;
@@ -510,7 +664,7 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
     int previousFramesArrayWasCreated = 0;
     eARSTREAM_ERROR internalError = ARSTREAM_OK;
     /* ARGS Check */
-    if ((manager == NULL) ||
+    if ((transport == NULL) ||
         (callback == NULL) ||
         (maxFragmentSize == 0) ||
         (maxNumberOfFragment > ARSTREAM_NETWORK_HEADERS_MAX_FRAGMENTS_PER_FRAME))
@@ -529,9 +683,8 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
     /* Copy parameters */
     if (internalError == ARSTREAM_OK)
     {
-        retSender->manager = manager;
-        retSender->dataBufferID = dataBufferID;
-        retSender->ackBufferID = ackBufferID;
+        retSender->transport = transport;
+        retSender->ownsTransport = 0;
         retSender->callback = callback;
         retSender->custom = custom;
         retSender->maxNumberOfFragment = maxNumberOfFragment;
@@ -544,6 +697,7 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
     {
         retSender->minRetryTimeMs = ARSTREAM_SENDER_DEFAULT_MINIMUM_TIME_BETWEEN_RETRIES_MS;
         retSender->maxRetryTimeMs = ARSTREAM_SENDER_DEFAULT_MAXIMUM_TIME_BETWEEN_RETRIES_MS;
+        retSender->frameTimestampsEnabled = 0;
     }
 
     /* Setup internal mutexes/sems */
@@ -632,22 +786,37 @@ ARSTREAM_Sender_t* ARSTREAM_Sender_New (ARNETWORK_Manager_t *manager, int dataBu
         retSender->currentFrame.frameBuffer = NULL;
         retSender->currentFrame.frameSize   = 0;
         retSender->currentFrame.isHighPriority = 0;
+        retSender->currentFrame.queueTimeUs = 0;
         retSender->currentFrameNbFragments = 0;
         retSender->currentFrameCbWasCalled = 0;
+        retSender->currentFrameStartTimeUs = 0;
+        retSender->currentFrameFirstSendTimeUs = 0;
+        retSender->currentFrameAllSentTimeUs = 0;
         retSender->nextFrameNumber = 0;
         retSender->indexAddNextFrame = 0;
         retSender->indexGetNextFrame = 0;
         retSender->numberOfWaitingFrames = 0;
+        retSender->lastFlushFrameNumber = 0;
         retSender->previousFrameIndex = 0;
         retSender->threadsShouldStop = 0;
         retSender->dataThreadStarted = 0;
         retSender->ackThreadStarted = 0;
+        retSender->threads [ARSTREAM_THREAD_ROLE_DATA] = NULL;
+        retSender->threads [ARSTREAM_THREAD_ROLE_ACK] = NULL;
         retSender->efficiency_index = 0;
         for (i = 0; i < ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES; i++)
         {
             retSender->efficiency_nbFragments [i] = 0;
             retSender->efficiency_nbSent [i] = 0;
         }
+        for (i = 0; i < ARSTREAM_SENDER_HISTOGRAM_MAX; i++)
+        {
+            ARSTREAM_Histogram_Reset (&(retSender->histograms [i]));
+        }
+        for (i = 0; i < ARSTREAM_SENDER_COUNTER_MAX; i++)
+        {
+            retSender->counters [i] = 0;
+        }
     }
 
     if ((internalError != ARSTREAM_OK) &&
@@ -704,6 +873,23 @@ eARSTREAM_ERROR ARSTREAM_Sender_SetTimeBetweenRetries (ARSTREAM_Sender_t *sender
     return err;
 }
 
+eARSTREAM_ERROR ARSTREAM_Sender_SetFrameTimestamps (ARSTREAM_Sender_t *sender, int enable)
+{
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    if ((sender == NULL) ||
+        ((enable != 0) &&
+         (enable != 1)))
+    {
+        err = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (err == ARSTREAM_OK)
+    {
+        sender->frameTimestampsEnabled = enable;
+    }
+    return err;
+}
+
 void ARSTREAM_Sender_StopSender (ARSTREAM_Sender_t *sender)
 {
     if (sender != NULL)
@@ -733,6 +919,9 @@ eARSTREAM_ERROR ARSTREAM_Sender_Delete (ARSTREAM_Sender_t **sender)
 
         if (canDelete == 1)
         {
+            /* The threads started by the library have left their loops : join them */
+            ARSTREAM_Thread_Delete (&((*sender)->threads [ARSTREAM_THREAD_ROLE_DATA]));
+            ARSTREAM_Thread_Delete (&((*sender)->threads [ARSTREAM_THREAD_ROLE_ACK]));
             ARSTREAM_Sender_FlushQueue (*sender);
             ARSAL_Mutex_Destroy (&((*sender)->packetsToSendMutex));
             ARSAL_Mutex_Destroy (&((*sender)->ackMutex));
@@ -740,13 +929,17 @@ eARSTREAM_ERROR ARSTREAM_Sender_Delete (ARSTREAM_Sender_t **sender)
             ARSAL_Cond_Destroy (&((*sender)->nextFrameCond));
             free ((*sender)->nextFrames);
             free ((*sender)->previousFramesStatus);
+            if ((*sender)->ownsTransport == 1)
+            {
+                ARSTREAM_Transport_Delete (&((*sender)->transport));
+            }
             free (*sender);
             *sender = NULL;
             retVal = ARSTREAM_OK;
         }
         else
         {
-            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Call ARSTREAM_Sender_StopSender before calling this function");
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Call ARSTREAM_Sender_StopSender before calling this function");
             retVal = ARSTREAM_ERROR_BUSY;
         }
     }
@@ -796,44 +989,106 @@ eARSTREAM_ERROR ARSTREAM_Sender_FlushFramesQueue (ARSTREAM_Sender_t *sender)
     }
     if (retVal == ARSTREAM_OK)
     {
-        ARSAL_Mutex_Lock (&(sender->nextFrameMutex));
+        ARSTREAM_EVENT_MUTEX_LOCK (&(sender->nextFrameMutex), ARSTREAM_EVENT_LOCK_SENDER_NEXT_FRAME);
         ARSTREAM_Sender_FlushQueue (sender);
         ARSAL_Mutex_Unlock (&(sender->nextFrameMutex));
     }
     return retVal;
 }
 
+eARSTREAM_ERROR ARSTREAM_Sender_StartThreads (ARSTREAM_Sender_t *sender, const ARSTREAM_Thread_Config_t *dataConfig, const ARSTREAM_Thread_Config_t *ackConfig)
+{
+    ARSTREAM_Thread_t *dataThread = NULL;
+    ARSTREAM_Thread_t *ackThread = NULL;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+
+    if (sender == NULL)
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    if ((sender->threads [ARSTREAM_THREAD_ROLE_DATA] != NULL) ||
+        (sender->threads [ARSTREAM_THREAD_ROLE_ACK] != NULL) ||
+        (sender->dataThreadStarted == 1) ||
+        (sender->ackThreadStarted == 1))
+    {
+        return ARSTREAM_ERROR_BUSY;
+    }
+
+    /* Both threads apply their settings, and wait : none runs if any setting fails */
+    dataThread = ARSTREAM_Thread_New (dataConfig, ARSTREAM_Sender_RunDataThread, sender, &err);
+    if (dataThread != NULL)
+    {
+        ackThread = ARSTREAM_Thread_New (ackConfig, ARSTREAM_Sender_RunAckThread, sender, &err);
+    }
+    if (err != ARSTREAM_OK)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Unable to start the sender threads : %s", ARSTREAM_Error_ToString (err));
+        ARSTREAM_Thread_Delete (&dataThread);
+        return err;
+    }
+
+    /* Marked as started at once, so that ARSTREAM_Sender_Delete waits for ARSTREAM_Sender_StopSender */
+    sender->dataThreadStarted = 1;
+    sender->ackThreadStarted = 1;
+    sender->threads [ARSTREAM_THREAD_ROLE_DATA] = dataThread;
+    sender->threads [ARSTREAM_THREAD_ROLE_ACK] = ackThread;
+    ARSTREAM_Thread_Start (dataThread);
+    ARSTREAM_Thread_Start (ackThread);
+    return ARSTREAM_OK;
+}
+
 void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
 {
     /* Local declarations */
     ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)ARSTREAM_Sender_t_Param;
     uint8_t *sendFragment = NULL;
+    uint8_t *batchHeaders = NULL;
+    ARSTREAM_Transport_Packet_t *batchPackets = NULL;
     uint32_t sendSize = 0;
     uint16_t nbPackets = 0;
     int cnt;
     int numbersOfFragmentsSentForCurrentFrame = 0;
+    uint32_t nbFragmentsToSend = 0;
+    uint32_t sendRound = 0;
     int lastFragmentSize = 0;
+    uint32_t headerSize = sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
     ARSTREAM_NetworkHeaders_DataHeader_t *header = NULL;
+    ARSTREAM_NetworkHeaders_TimestampExtension_t *timestampExtension = NULL;
     ARSTREAM_Sender_Frame_t nextFrame = {0};
     int firstFrame = 1;
 
     /* Parameters check */
     if (sender == NULL)
     {
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while starting %s, bad parameters", __FUNCTION__);
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while starting %s, bad parameters", __FUNCTION__);
         return (void *)0;
     }
 
     /* Alloc and check */
-    sendFragment = malloc (sender->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t));
+    sendFragment = malloc (sender->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t));
     if (sendFragment == NULL)
     {
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while starting %s, can not alloc memory", __FUNCTION__);
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while starting %s, can not alloc memory", __FUNCTION__);
         return (void *)0;
     }
+    if (sender->transport->ops->sendPackets != NULL)
+    {
+        batchHeaders = malloc (sender->maxNumberOfFragment * ARSTREAM_SENDER_MAX_HEADER_SIZE);
+        batchPackets = malloc (sender->maxNumberOfFragment * sizeof (ARSTREAM_Transport_Packet_t));
+        if ((batchHeaders == NULL) ||
+            (batchPackets == NULL))
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while starting %s, can not alloc memory", __FUNCTION__);
+            free (sendFragment);
+            free (batchHeaders);
+            free (batchPackets);
+            return (void *)0;
+        }
+    }
     header = (ARSTREAM_NetworkHeaders_DataHeader_t *)sendFragment;
+    timestampExtension = (ARSTREAM_NetworkHeaders_TimestampExtension_t *)&sendFragment[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)];
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Sender thread running");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Sender thread running");
     sender->dataThreadStarted = 1;
 
     while (sender->threadsShouldStop == 0)
@@ -847,16 +1102,17 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
         {
             break;
         }
-        ARSAL_Mutex_Lock (&(sender->ackMutex));
+        ARSTREAM_EVENT_MUTEX_LOCK (&(sender->ackMutex), ARSTREAM_EVENT_LOCK_SENDER_ACK);
         if (waitRes == 1)
         {
             int previousWasAck = 1;
-            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Previous frame was sent in %d packets. Frame size was %d packets", numbersOfFragmentsSentForCurrentFrame, nbPackets);
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Previous frame was sent in %d packets. Frame size was %d packets", numbersOfFragmentsSentForCurrentFrame, nbPackets);
             sender->efficiency_nbFragments [sender->efficiency_index ] = nbPackets;
             sender->efficiency_nbSent [sender->efficiency_index] = numbersOfFragmentsSentForCurrentFrame;
             numbersOfFragmentsSentForCurrentFrame = 0;
+            sendRound = 0;
             /* We have a new frame to send */
-            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "New frame needs to be sent");
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "New frame needs to be sent");
             sender->efficiency_index ++;
             sender->efficiency_index %= ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES;
             sender->efficiency_nbSent [sender->efficiency_index] = 0;
@@ -869,13 +1125,13 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             {
 #ifdef DEBUG
                 ARSTREAM_NetworkHeaders_AckPacketDump ("Cancel frame:", &(sender->ackPacket));
-                ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Receiver acknowledged %d of %d packets", ARSTREAM_NetworkHeaders_AckPacketCountSet (&(sender->ackPacket), nbPackets), nbPackets);
+                ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Receiver acknowledged %d of %d packets", ARSTREAM_NetworkHeaders_AckPacketCountSet (&(sender->ackPacket), nbPackets), nbPackets);
 #endif
 
                 previousWasAck = 0;
-                ARNETWORK_Manager_FlushInputBuffer (sender->manager, sender->dataBufferID);
+                sender->transport->ops->flush (sender->transport->context, ARSTREAM_TRANSPORT_CHANNEL_DATA);
 
-                ARSTREAM_Sender_CallCallback(sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, sender->currentFrame.frameBuffer, sender->currentFrame.frameSize);
+                ARSTREAM_Sender_CancelFrame (sender, &(sender->currentFrame));
             }
             sender->currentFrameCbWasCalled = 0; // New frame
             firstFrame = 0;
@@ -885,6 +1141,9 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             sender->currentFrame.frameBuffer = nextFrame.frameBuffer;
             sender->currentFrame.frameSize   = nextFrame.frameSize;
             sender->currentFrame.isHighPriority = nextFrame.isHighPriority;
+            sender->currentFrame.queueTimeUs = nextFrame.queueTimeUs;
+            sender->currentFrameStartTimeUs = ARSTREAM_Time_GetMonotonicUs ();
+            ARSTREAM_Sender_RecordDuration (sender, ARSTREAM_SENDER_HISTOGRAM_QUEUED, sender->currentFrame.queueTimeUs, sender->currentFrameStartTimeUs);
             sendSize = nextFrame.frameSize;
 
             sender->previousFramesStatus[sender->previousFrameIndex] = previousWasAck;
@@ -896,15 +1155,23 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             ARSTREAM_NetworkHeaders_AckPacketReset (&(sender->ackPacket));
 
             /* Reset packetsToSend - update frame number */
-            ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
+            ARSTREAM_EVENT_MUTEX_LOCK (&(sender->packetsToSendMutex), ARSTREAM_EVENT_LOCK_SENDER_PACKETS_TO_SEND);
             sender->packetsToSend.frameNumber = sender->currentFrame.frameNumber;
             ARSTREAM_NetworkHeaders_AckPacketReset (&(sender->packetsToSend));
+            sender->currentFrameFirstSendTimeUs = 0;
+            sender->currentFrameAllSentTimeUs = 0;
             ARSAL_Mutex_Unlock (&(sender->packetsToSendMutex));
 
             /* Update stream data header with the new frame number */
             header->frameNumber = sender->currentFrame.frameNumber;
             header->frameFlags = 0;
             header->frameFlags |= (sender->currentFrame.isHighPriority != 0) ? ARSTREAM_NETWORK_HEADERS_FLAG_FLUSH_FRAME : 0;
+            header->frameFlags |= (sender->frameTimestampsEnabled != 0) ? ARSTREAM_NETWORK_HEADERS_FLAG_TIMESTAMP : 0;
+            headerSize = sizeof (ARSTREAM_NetworkHeaders_DataHeader_t);
+            if ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_TIMESTAMP) != 0)
+            {
+                headerSize += sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t);
+            }
 
             /* Compute number of fragments / size of the last fragment */
             if (0 < sendSize)
@@ -920,14 +1187,15 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             }
             sender->currentFrameNbFragments = nbPackets;
 
-            ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "New frame has size %d (=%d packets)", sendSize, nbPackets);
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "New frame has size %d (=%d packets)", sendSize, nbPackets);
+            ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_FRAME_STARTED, sender->currentFrame.frameNumber, sendSize, nbPackets);
         }
         ARSAL_Mutex_Unlock (&(sender->ackMutex));
         /* END OF NEW FRAME BLOCK */
 
         /* Flag all non-ack packets as "packet to send" */
-        ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
-        ARSAL_Mutex_Lock (&(sender->ackMutex));
+        ARSTREAM_EVENT_MUTEX_LOCK (&(sender->packetsToSendMutex), ARSTREAM_EVENT_LOCK_SENDER_PACKETS_TO_SEND);
+        ARSTREAM_EVENT_MUTEX_LOCK (&(sender->ackMutex), ARSTREAM_EVENT_LOCK_SENDER_ACK);
         ARSTREAM_NetworkHeaders_AckPacketReset (&(sender->packetsToSend));
         for (cnt = 0; cnt < nbPackets; cnt++)
         {
@@ -937,30 +1205,107 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
             }
         }
 
-        /* Send all "packets to send" */
-        for (cnt = 0; cnt < nbPackets; cnt++)
+        /* Timestamp the first transmission of the frame */
+        nbFragmentsToSend = ARSTREAM_NetworkHeaders_AckPacketCountSet (&(sender->packetsToSend), nbPackets);
+        if ((sender->currentFrameFirstSendTimeUs == 0) &&
+            (nbFragmentsToSend > 0))
         {
-            if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->packetsToSend), cnt))
+            sender->currentFrameFirstSendTimeUs = ARSTREAM_Time_GetMonotonicUs ();
+            ARSTREAM_Sender_RecordDuration (sender, ARSTREAM_SENDER_HISTOGRAM_FIRST_FRAGMENT, sender->currentFrameStartTimeUs, sender->currentFrameFirstSendTimeUs);
+            if ((header->frameFlags & ARSTREAM_NETWORK_HEADERS_FLAG_TIMESTAMP) != 0)
             {
-                eARNETWORK_ERROR netError = ARNETWORK_OK;
-                uint32_t maxFragSize = sender->maxFragmentSize;
-                numbersOfFragmentsSentForCurrentFrame ++;
-                int currFragmentSize = (cnt == nbPackets-1) ? lastFragmentSize : maxFragSize;
-                header->fragmentNumber = cnt;
-                header->fragmentsPerFrame = nbPackets;
-                memcpy (&sendFragment[sizeof (ARSTREAM_NetworkHeaders_DataHeader_t)], &(sender->currentFrame.frameBuffer)[maxFragSize*cnt], currFragmentSize);
-                ARSTREAM_Sender_NetworkCallbackParam_t *cbParams = malloc (sizeof (ARSTREAM_Sender_NetworkCallbackParam_t));
-                cbParams->sender = sender;
-                cbParams->fragmentIndex = cnt;
-                cbParams->frameNumber = sender->packetsToSend.frameNumber;
+                uint64_t queueDurationUs = sender->currentFrameFirstSendTimeUs - sender->currentFrame.queueTimeUs;
+                timestampExtension->sendTimestampUs = htodll (sender->currentFrameFirstSendTimeUs);
+                timestampExtension->queueDurationUs = htodl ((queueDurationUs > UINT32_MAX) ? UINT32_MAX : (uint32_t)queueDurationUs);
+            }
+        }
+        if (nbFragmentsToSend > 0)
+        {
+            ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_SEND_ROUND, sender->packetsToSend.frameNumber, nbFragmentsToSend, sendRound);
+            if (sendRound > 0)
+            {
+                ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_FRAGMENTS_RETRANSMITTED, nbFragmentsToSend);
+            }
+            sendRound++;
+        }
+
+        /* Send all "packets to send" in one batch if the transport allows it.
+         * Each packet gets its own copy of the header, and points directly to the frame buffer */
+        if (batchPackets != NULL)
+        {
+            int nbBatchPackets = 0;
+            uint32_t maxFragSize = sender->maxFragmentSize;
+            header->fragmentsPerFrame = nbPackets;
+            for (cnt = 0; cnt < nbPackets; cnt++)
+            {
+                if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->packetsToSend), cnt))
+                {
+                    ARSTREAM_Transport_Packet_t *packet = &(batchPackets [nbBatchPackets]);
+                    ARSTREAM_Sender_TransportCallbackParam_t *cbParams = malloc (sizeof (ARSTREAM_Sender_TransportCallbackParam_t));
+                    if (cbParams == NULL)
+                    {
+                        break;
+                    }
+                    cbParams->sender = sender;
+                    cbParams->fragmentIndex = cnt;
+                    cbParams->frameNumber = sender->packetsToSend.frameNumber;
+                    header->fragmentNumber = cnt;
+                    packet->header = &batchHeaders [cnt * ARSTREAM_SENDER_MAX_HEADER_SIZE];
+                    packet->headerSize = headerSize;
+                    memcpy (packet->header, sendFragment, headerSize);
+                    packet->payload = &(sender->currentFrame.frameBuffer)[maxFragSize*cnt];
+                    packet->payloadSize = (cnt == nbPackets-1) ? lastFragmentSize : maxFragSize;
+                    packet->callback = ARSTREAM_Sender_TransportCallback;
+                    packet->callbackData = (void *)cbParams;
+                    nbBatchPackets++;
+                }
+            }
+            numbersOfFragmentsSentForCurrentFrame += nbBatchPackets;
+            if (nbBatchPackets > 0)
+            {
+                eARSTREAM_ERROR sendError;
                 ARSAL_Mutex_Unlock (&(sender->packetsToSendMutex));
-                netError = ARNETWORK_Manager_SendData (sender->manager, sender->dataBufferID, sendFragment, currFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t), (void *)cbParams, ARSTREAM_Sender_NetworkCallback, 1);
-                if (netError != ARNETWORK_OK)
+                sendError = sender->transport->ops->sendPackets (sender->transport->context, ARSTREAM_TRANSPORT_CHANNEL_DATA, batchPackets, nbBatchPackets);
+                if (sendError != ARSTREAM_OK)
                 {
-                    ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the fragment ; error: %d : %s", netError, ARNETWORK_Error_ToString(netError));
+                    ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the fragments ; error: %d : %s", sendError, ARSTREAM_Error_ToString (sendError));
+                }
+                ARSTREAM_EVENT_MUTEX_LOCK (&(sender->packetsToSendMutex), ARSTREAM_EVENT_LOCK_SENDER_PACKETS_TO_SEND);
+            }
+        }
+        /* Else, send all "packets to send" one by one */
+        else
+        {
+            for (cnt = 0; cnt < nbPackets; cnt++)
+            {
+                if (ARSTREAM_NetworkHeaders_AckPacketFlagIsSet (&(sender->packetsToSend), cnt))
+                {
+                    eARSTREAM_ERROR sendError = ARSTREAM_OK;
+                    uint32_t maxFragSize = sender->maxFragmentSize;
+                    int currFragmentSize = (cnt == nbPackets-1) ? lastFragmentSize : maxFragSize;
+                    ARSTREAM_Sender_TransportCallbackParam_t *cbParams = malloc (sizeof (ARSTREAM_Sender_TransportCallbackParam_t));
+                    if (cbParams == NULL)
+                    {
+                        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Unable to alloc the fragment callback parameters");
+                        break;
+                    }
+                    numbersOfFragmentsSentForCurrentFrame ++;
+                    header->fragmentNumber = cnt;
+                    header->fragmentsPerFrame = nbPackets;
+                    memcpy (&sendFragment[headerSize], &(sender->currentFrame.frameBuffer)[maxFragSize*cnt], currFragmentSize);
+                    cbParams->sender = sender;
+                    cbParams->fragmentIndex = cnt;
+                    cbParams->frameNumber = sender->packetsToSend.frameNumber;
+                    ARSAL_Mutex_Unlock (&(sender->packetsToSendMutex));
+                    sendError = sender->transport->ops->send (sender->transport->context, ARSTREAM_TRANSPORT_CHANNEL_DATA, sendFragment, currFragmentSize + headerSize, ARSTREAM_Sender_TransportCallback, (void *)cbParams);
+                    if (sendError != ARSTREAM_OK)
+                    {
+                        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error occurred during sending of the fragment ; error: %d : %s", sendError, ARSTREAM_Error_ToString (sendError));
+                        free (cbParams);
+                    }
+
+                    ARSTREAM_EVENT_MUTEX_LOCK (&(sender->packetsToSendMutex), ARSTREAM_EVENT_LOCK_SENDER_PACKETS_TO_SEND);
                 }
-
-                ARSAL_Mutex_Lock (&(sender->packetsToSendMutex));
             }
         }
         ARSAL_Mutex_Unlock (&(sender->ackMutex));
@@ -972,12 +1317,12 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
     {
 #ifdef DEBUG
         ARSTREAM_NetworkHeaders_AckPacketDump ("Cancel frame:", &(sender->ackPacket));
-        ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Receiver acknowledged %d of %d packets", ARSTREAM_NetworkHeaders_AckPacketCountSet (&(sender->ackPacket), nbPackets), nbPackets);
+        ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Receiver acknowledged %d of %d packets", ARSTREAM_NetworkHeaders_AckPacketCountSet (&(sender->ackPacket), nbPackets), nbPackets);
 #endif
-        ARSTREAM_Sender_CallCallback (sender, ARSTREAM_SENDER_STATUS_FRAME_CANCEL, sender->currentFrame.frameBuffer, sender->currentFrame.frameSize);
+        ARSTREAM_Sender_CancelFrame (sender, &(sender->currentFrame));
     }
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Sender thread ended");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Sender thread ended");
     sender->dataThreadStarted = 0;
 
     if(sendFragment)
@@ -985,6 +1330,8 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
         free(sendFragment);
         sendFragment = NULL;
     }
+    free (batchHeaders);
+    free (batchPackets);
 
     return (void *)0;
 }
@@ -993,27 +1340,31 @@ void* ARSTREAM_Sender_RunDataThread (void *ARSTREAM_Sender_t_Param)
 void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param)
 {
     ARSTREAM_NetworkHeaders_AckPacket_t recvPacket;
-    int recvSize;
+    uint32_t recvSize = 0;
     ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)ARSTREAM_Sender_t_Param;
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Ack thread running");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Ack thread running");
     sender->ackThreadStarted = 1;
 
     ARSTREAM_NetworkHeaders_AckPacketReset (&recvPacket);
 
     while (sender->threadsShouldStop == 0)
     {
-        eARNETWORK_ERROR err = ARNETWORK_Manager_ReadDataWithTimeout (sender->manager, sender->ackBufferID, (uint8_t *)&recvPacket, sizeof (recvPacket), &recvSize, 1000);
-        if (ARNETWORK_OK != err)
+        eARSTREAM_ERROR err = sender->transport->ops->receive (sender->transport->context, ARSTREAM_TRANSPORT_CHANNEL_ACK, (uint8_t *)&recvPacket, sizeof (recvPacket), &recvSize, 1000);
+        if (ARSTREAM_OK != err)
         {
-            if (ARNETWORK_ERROR_BUFFER_EMPTY != err)
+            if (ARSTREAM_ERROR_BUFFER_EMPTY != err)
             {
-                ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while reading ACK data: %s", ARNETWORK_Error_ToString (err));
+                ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Error while reading ACK data: %s", ARSTREAM_Error_ToString (err));
             }
         }
+        else if (recvSize == sizeof (ARSTREAM_NetworkHeaders_ControlPacket_t))
+        {
+            ARSTREAM_Sender_ProcessControlPacket (sender, (ARSTREAM_NetworkHeaders_ControlPacket_t *)&recvPacket);
+        }
         else if (recvSize != sizeof (recvPacket))
         {
-            ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Read %d octets, expected %d", recvSize, sizeof (recvPacket));
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Read %d octets, expected %d", recvSize, sizeof (recvPacket));
         }
         else
         {
@@ -1021,12 +1372,14 @@ void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param)
             recvPacket.frameNumber = dtohs (recvPacket.frameNumber);
             recvPacket.highPacketsAck = dtohll (recvPacket.highPacketsAck);
             recvPacket.lowPacketsAck = dtohll (recvPacket.lowPacketsAck);
+            ARSTREAM_Sender_AddCounter (sender, ARSTREAM_SENDER_COUNTER_ACKS_RECEIVED, 1);
 
             /* Apply recvPacket to sender->ackPacket if frame numbers are the same */
-            ARSAL_Mutex_Lock (&(sender->ackMutex));
+            ARSTREAM_EVENT_MUTEX_LOCK (&(sender->ackMutex), ARSTREAM_EVENT_LOCK_SENDER_ACK);
             if (sender->ackPacket.frameNumber == recvPacket.frameNumber)
             {
                 ARSTREAM_NetworkHeaders_AckPacketSetFlags (&(sender->ackPacket), &recvPacket);
+                ARSTREAM_EVENT (ARSTREAM_EVENT_SENDER_ACK_RECEIVED, recvPacket.frameNumber, ARSTREAM_NetworkHeaders_AckPacketCountSet (&(sender->ackPacket), sender->currentFrameNbFragments), sender->currentFrameNbFragments);
                 if ((sender->currentFrameCbWasCalled == 0) &&
                     (ARSTREAM_NetworkHeaders_AckPacketAllFlagsSet (&(sender->ackPacket), sender->currentFrameNbFragments) == 1))
                 {
@@ -1041,7 +1394,7 @@ void* ARSTREAM_Sender_RunAckThread (void *ARSTREAM_Sender_t_Param)
         }
     }
 
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Ack thread ended");
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SENDER_TAG, "Ack thread ended");
     sender->ackThreadStarted = 0;
     return (void *)0;
 }
@@ -1056,7 +1409,7 @@ float ARSTREAM_Sender_GetEstimatedEfficiency (ARSTREAM_Sender_t *sender)
     uint32_t totalPackets = 0;
     uint32_t sentPackets = 0;
     int i;
-    ARSAL_Mutex_Lock (&(sender->ackMutex));
+    ARSTREAM_EVENT_MUTEX_LOCK (&(sender->ackMutex), ARSTREAM_EVENT_LOCK_SENDER_ACK);
     for (i = 0; i < ARSTREAM_SENDER_EFFICIENCY_AVERAGE_NB_FRAMES; i++)
     {
         totalPackets += sender->efficiency_nbFragments [i];
@@ -1070,7 +1423,7 @@ float ARSTREAM_Sender_GetEstimatedEfficiency (ARSTREAM_Sender_t *sender)
     else if (totalPackets > sentPackets)
     {
         retVal = 1.0f; // If this happens, it means that we have a big problem
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Computed efficiency is greater that 1.0 ...");
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SENDER_TAG, "Computed efficiency is greater that 1.0 ...");
     }
     else
     {
@@ -1079,6 +1432,30 @@ float ARSTREAM_Sender_GetEstimatedEfficiency (ARSTREAM_Sender_t *sender)
     return retVal;
 }
 
+eARSTREAM_ERROR ARSTREAM_Sender_GetHistogram (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_HISTOGRAM histogram, ARSTREAM_Histogram_t *snapshot)
+{
+    if ((sender == NULL) ||
+        (histogram < 0) ||
+        (histogram >= ARSTREAM_SENDER_HISTOGRAM_MAX) ||
+        (snapshot == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    ARSTREAM_Histogram_Snapshot (&(sender->histograms [histogram]), snapshot);
+    return ARSTREAM_OK;
+}
+
+uint64_t ARSTREAM_Sender_GetCounter (ARSTREAM_Sender_t *sender, eARSTREAM_SENDER_COUNTER counter)
+{
+    if ((sender == NULL) ||
+        (counter < 0) ||
+        (counter >= ARSTREAM_SENDER_COUNTER_MAX))
+    {
+        return 0;
+    }
+    return __sync_fetch_and_add (&(sender->counters [counter]), 0);
+}
+
 void* ARSTREAM_Sender_GetCustom (ARSTREAM_Sender_t *sender)
 {
     void *ret = NULL;
@@ -0,0 +1,696 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_SharedMemoryTransport.c
+ * @brief Stream transport over a shared memory area, for same-host or in-process sender/reader pairs
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Private Headers
+ */
+
+#include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_Ring.h"
+#include "ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_SHM_TRANSPORT_TAG "ARSTREAM_SharedMemoryTransport"
+
+/**
+ * Magic number and version of a shared memory area ("ARSM")
+ */
+#define ARSTREAM_SHM_TRANSPORT_MAGIC (0x4152534D)
+#define ARSTREAM_SHM_TRANSPORT_VERSION (1)
+
+/**
+ * Number and size of the ack slots
+ */
+#define ARSTREAM_SHM_TRANSPORT_NB_ACK_SLOTS (64)
+#define ARSTREAM_SHM_TRANSPORT_ACK_SLOT_SIZE (sizeof (ARSTREAM_NetworkHeaders_AckPacket_t))
+
+/**
+ * Alignment of the rings in the area
+ */
+#define ARSTREAM_SHM_TRANSPORT_ALIGN (4096)
+
+/**
+ * memfd_create() is only in recent C libraries, but the system call exists since Linux 3.17
+ */
+#if defined (HAVE_MEMFD_CREATE) || (defined (__linux__) && defined (SYS_memfd_create))
+#define ARSTREAM_SHM_TRANSPORT_HAS_MEMFD
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC (0x0001U)
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING (0x0002U)
+#endif
+#endif
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+/*
+ * Types
+ */
+
+/**
+ * Header of a shared memory area, followed by the data ring and the ack ring
+ * Only fixed size types : the area can be mapped by processes of different word sizes
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t maxFragmentSize;
+    uint32_t refCount; /* Number of endpoints using an in-process area (unused by memfd areas) */
+    uint64_t dataRingOffset;
+    uint64_t dataRingSize;
+    uint64_t ackRingOffset;
+    uint64_t ackRingSize;
+    uint64_t totalSize;
+} ARSTREAM_SharedMemoryTransport_Header_t;
+
+typedef struct {
+    uint8_t *area;
+    size_t areaSize;
+    int isMapped; /* 1 for a memfd mapping, 0 for an in-process area */
+    eARSTREAM_TRANSPORT_ROLE role;
+    ARSTREAM_Ring_t sendRing; /* Data ring for the sender, ack ring for the reader */
+    ARSTREAM_Ring_t receiveRing; /* Ack ring for the sender, data ring for the reader */
+} ARSTREAM_SharedMemoryTransport_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Computes the layout of a shared memory area
+ * @param header The header to fill
+ * @param maxFragmentSize Maximum fragment size of the sender
+ * @param nbSlots Number of frame slots
+ * @return 1 if the layout is valid, 0 otherwise
+ */
+static int ARSTREAM_SharedMemoryTransport_ComputeLayout (ARSTREAM_SharedMemoryTransport_Header_t *header, uint32_t maxFragmentSize, uint32_t nbSlots);
+
+/**
+ * @brief Writes the header and initializes the rings of a new area
+ * @param area The area, of header->totalSize bytes
+ * @param header The layout of the area
+ * @param nbSlots Number of frame slots
+ * @param processShared 1 if the area is shared with another process
+ * @param[out] dataRing The data ring
+ * @param[out] ackRing The ack ring
+ */
+static void ARSTREAM_SharedMemoryTransport_InitArea (uint8_t *area, ARSTREAM_SharedMemoryTransport_Header_t *header, uint32_t nbSlots, int processShared, ARSTREAM_Ring_t *dataRing, ARSTREAM_Ring_t *ackRing);
+
+/**
+ * @brief Creates an endpoint on rings which are already mapped
+ * @param area The area holding the rings
+ * @param areaSize The size of the area
+ * @param isMapped 1 if the area is a memfd mapping, 0 for an in-process area
+ * @param role Role of the endpoint
+ * @param dataRing The data ring, copied in the endpoint
+ * @param ackRing The ack ring, copied in the endpoint
+ * @param[out] error The error, if NULL is returned
+ * @return The new transport, or NULL if an error occured. On error, the area is released as if the endpoint was destroyed
+ */
+static ARSTREAM_Transport_t* ARSTREAM_SharedMemoryTransport_NewEndpoint (uint8_t *area, size_t areaSize, int isMapped, eARSTREAM_TRANSPORT_ROLE role, const ARSTREAM_Ring_t *dataRing, const ARSTREAM_Ring_t *ackRing, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Releases an area
+ * Unmaps a memfd area. An in-process area is freed with its last endpoint
+ * @param area The area
+ * @param areaSize The size of the area
+ * @param isMapped 1 if the area is a memfd mapping, 0 for an in-process area
+ */
+static void ARSTREAM_SharedMemoryTransport_ReleaseArea (uint8_t *area, size_t areaSize, int isMapped);
+
+/**
+ * @brief Gets the ring of a channel, if this endpoint can use it in the given direction
+ * @param transport The shared memory transport
+ * @param channel The channel
+ * @param sending 1 to send on the channel, 0 to receive from it
+ * @return The ring, or NULL if the channel does not go in this direction for this endpoint
+ */
+static ARSTREAM_Ring_t* ARSTREAM_SharedMemoryTransport_GetRing (ARSTREAM_SharedMemoryTransport_t *transport, eARSTREAM_TRANSPORT_CHANNEL channel, int sending);
+
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData);
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs);
+static void ARSTREAM_SharedMemoryTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static int ARSTREAM_SharedMemoryTransport_GetEstimatedLatency (void *context);
+static void ARSTREAM_SharedMemoryTransport_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static const ARSTREAM_Transport_Ops_t ARSTREAM_SharedMemoryTransport_Ops = {
+    .send = ARSTREAM_SharedMemoryTransport_Send,
+    .receive = ARSTREAM_SharedMemoryTransport_Receive,
+    .sendPackets = ARSTREAM_SharedMemoryTransport_SendPackets,
+    .receiveBegin = ARSTREAM_SharedMemoryTransport_ReceiveBegin,
+    .receiveEnd = ARSTREAM_SharedMemoryTransport_ReceiveEnd,
+    .flush = ARSTREAM_SharedMemoryTransport_Flush,
+    .getEstimatedLatency = ARSTREAM_SharedMemoryTransport_GetEstimatedLatency,
+    .destroy = ARSTREAM_SharedMemoryTransport_Destroy,
+};
+
+static int ARSTREAM_SharedMemoryTransport_ComputeLayout (ARSTREAM_SharedMemoryTransport_Header_t *header, uint32_t maxFragmentSize, uint32_t nbSlots)
+{
+    uint64_t dataSlotSize = (uint64_t)maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t);
+    uint64_t align = ARSTREAM_SHM_TRANSPORT_ALIGN;
+
+    memset (header, 0, sizeof (ARSTREAM_SharedMemoryTransport_Header_t));
+    if ((maxFragmentSize == 0) ||
+        (dataSlotSize > (UINT32_MAX / 2)))
+    {
+        return 0;
+    }
+
+    header->magic = ARSTREAM_SHM_TRANSPORT_MAGIC;
+    header->version = ARSTREAM_SHM_TRANSPORT_VERSION;
+    header->maxFragmentSize = maxFragmentSize;
+    header->dataRingOffset = align;
+    header->dataRingSize = ARSTREAM_Ring_GetMemorySize (nbSlots, (uint32_t)dataSlotSize);
+    header->ackRingOffset = (header->dataRingOffset + header->dataRingSize + align - 1) & ~(align - 1);
+    header->ackRingSize = ARSTREAM_Ring_GetMemorySize (ARSTREAM_SHM_TRANSPORT_NB_ACK_SLOTS, ARSTREAM_SHM_TRANSPORT_ACK_SLOT_SIZE);
+    header->totalSize = header->ackRingOffset + header->ackRingSize;
+
+    return ((header->dataRingSize != 0) &&
+            (header->totalSize <= (uint64_t)SIZE_MAX) &&
+            (header->totalSize <= (uint64_t)INT64_MAX)) ? 1 : 0;
+}
+
+static void ARSTREAM_SharedMemoryTransport_InitArea (uint8_t *area, ARSTREAM_SharedMemoryTransport_Header_t *header, uint32_t nbSlots, int processShared, ARSTREAM_Ring_t *dataRing, ARSTREAM_Ring_t *ackRing)
+{
+    uint32_t dataSlotSize = header->maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t);
+
+    /* The layout was checked by ARSTREAM_SharedMemoryTransport_ComputeLayout : the init can not fail */
+    ARSTREAM_Ring_Init (dataRing, &area [header->dataRingOffset], nbSlots, dataSlotSize, processShared);
+    ARSTREAM_Ring_Init (ackRing, &area [header->ackRingOffset], ARSTREAM_SHM_TRANSPORT_NB_ACK_SLOTS, ARSTREAM_SHM_TRANSPORT_ACK_SLOT_SIZE, processShared);
+    memcpy (area, header, sizeof (ARSTREAM_SharedMemoryTransport_Header_t));
+}
+
+static ARSTREAM_Transport_t* ARSTREAM_SharedMemoryTransport_NewEndpoint (uint8_t *area, size_t areaSize, int isMapped, eARSTREAM_TRANSPORT_ROLE role, const ARSTREAM_Ring_t *dataRing, const ARSTREAM_Ring_t *ackRing, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Transport_t *retTransport = NULL;
+    ARSTREAM_SharedMemoryTransport_t *transport = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+
+    /* Alloc new context */
+    transport = calloc (1, sizeof (ARSTREAM_SharedMemoryTransport_t));
+    if (transport == NULL)
+    {
+        ARSTREAM_SharedMemoryTransport_ReleaseArea (area, areaSize, isMapped);
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_ALLOC);
+        return retTransport;
+    }
+
+    transport->area = area;
+    transport->areaSize = areaSize;
+    transport->isMapped = isMapped;
+    transport->role = role;
+    if (role == ARSTREAM_TRANSPORT_ROLE_SENDER)
+    {
+        transport->sendRing = *dataRing;
+        transport->receiveRing = *ackRing;
+    }
+    else
+    {
+        transport->sendRing = *ackRing;
+        transport->receiveRing = *dataRing;
+    }
+
+    retTransport = ARSTREAM_Transport_New (&ARSTREAM_SharedMemoryTransport_Ops, transport, &internalError);
+    if (internalError != ARSTREAM_OK)
+    {
+        ARSTREAM_SharedMemoryTransport_Destroy (transport);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retTransport;
+}
+
+static void ARSTREAM_SharedMemoryTransport_ReleaseArea (uint8_t *area, size_t areaSize, int isMapped)
+{
+    ARSTREAM_SharedMemoryTransport_Header_t *header = (ARSTREAM_SharedMemoryTransport_Header_t *)area;
+    if (isMapped != 0)
+    {
+        munmap (area, areaSize);
+    }
+    else if (__sync_sub_and_fetch (&(header->refCount), 1) == 0)
+    {
+        free (area);
+    }
+}
+
+static ARSTREAM_Ring_t* ARSTREAM_SharedMemoryTransport_GetRing (ARSTREAM_SharedMemoryTransport_t *transport, eARSTREAM_TRANSPORT_CHANNEL channel, int sending)
+{
+    eARSTREAM_TRANSPORT_CHANNEL sendChannel = (transport->role == ARSTREAM_TRANSPORT_ROLE_SENDER) ? ARSTREAM_TRANSPORT_CHANNEL_DATA : ARSTREAM_TRANSPORT_CHANNEL_ACK;
+    if (sending != 0)
+    {
+        return (channel == sendChannel) ? &(transport->sendRing) : NULL;
+    }
+    return (channel != sendChannel) ? &(transport->receiveRing) : NULL;
+}
+
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData)
+{
+    ARSTREAM_Transport_Packet_t packet;
+
+    packet.header = data;
+    packet.headerSize = size;
+    packet.payload = NULL;
+    packet.payloadSize = 0;
+    packet.callback = NULL;
+    packet.callbackData = NULL;
+
+    if (ARSTREAM_SharedMemoryTransport_SendPackets (context, channel, &packet, 1) != ARSTREAM_OK)
+    {
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    if (callback != NULL)
+    {
+        callback (callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs)
+{
+    eARSTREAM_ERROR retVal;
+    uint8_t *data = NULL;
+    uint32_t dataSize = 0;
+
+    retVal = ARSTREAM_SharedMemoryTransport_ReceiveBegin (context, channel, &data, &dataSize, timeoutMs);
+    if (retVal == ARSTREAM_OK)
+    {
+        if (dataSize <= bufferSize)
+        {
+            memcpy (buffer, data, dataSize);
+            *receivedSize = dataSize;
+        }
+        else
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Received %d bytes, which does not fit in a %d bytes buffer", dataSize, bufferSize);
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+        }
+        ARSTREAM_SharedMemoryTransport_ReceiveEnd (context, channel);
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets)
+{
+    ARSTREAM_SharedMemoryTransport_t *transport = (ARSTREAM_SharedMemoryTransport_t *)context;
+    ARSTREAM_Ring_t *ring = ARSTREAM_SharedMemoryTransport_GetRing (transport, channel, 1);
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    int nbSent = 0;
+    int i;
+
+    if (ring == NULL)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Channel %d can not be sent by this endpoint", channel);
+        retVal = ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    /* One copy per fragment, straight into the slot the reader will read in place */
+    while ((retVal == ARSTREAM_OK) &&
+           (nbSent < nbPackets))
+    {
+        ARSTREAM_Transport_Packet_t *packet = &packets [nbSent];
+        uint8_t *slot;
+
+        if ((packet->headerSize + packet->payloadSize) > ARSTREAM_Ring_GetSlotSize (ring))
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Packet of %d bytes is larger than the %d bytes slots", packet->headerSize + packet->payloadSize, ARSTREAM_Ring_GetSlotSize (ring));
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+            break;
+        }
+
+        slot = ARSTREAM_Ring_WriteBegin (ring);
+        if (slot == NULL)
+        {
+            /* The other endpoint is late : drop, the stream acks will trigger a retry */
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_SHM_TRANSPORT_TAG, "Ring full, dropping %d packets", nbPackets - nbSent);
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+            break;
+        }
+
+        memcpy (slot, packet->header, packet->headerSize);
+        if (packet->payloadSize > 0)
+        {
+            memcpy (&slot [packet->headerSize], packet->payload, packet->payloadSize);
+        }
+        ARSTREAM_Ring_WriteEnd (ring, packet->headerSize + packet->payloadSize);
+        nbSent++;
+    }
+
+    for (i = 0; i < nbPackets; i++)
+    {
+        if (packets [i].callback != NULL)
+        {
+            packets [i].callback (packets [i].callbackData, (i < nbSent) ? ARSTREAM_TRANSPORT_SEND_STATUS_SENT : ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+        }
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs)
+{
+    ARSTREAM_SharedMemoryTransport_t *transport = (ARSTREAM_SharedMemoryTransport_t *)context;
+    ARSTREAM_Ring_t *ring = ARSTREAM_SharedMemoryTransport_GetRing (transport, channel, 0);
+    uint8_t *packet;
+
+    if (ring == NULL)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Channel %d can not be received by this endpoint", channel);
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    packet = ARSTREAM_Ring_ReadBegin (ring, receivedSize);
+    if ((packet == NULL) &&
+        (ARSTREAM_Ring_Wait (ring, timeoutMs) != 0))
+    {
+        packet = ARSTREAM_Ring_ReadBegin (ring, receivedSize);
+    }
+
+    if (packet == NULL)
+    {
+        return ARSTREAM_ERROR_BUFFER_EMPTY;
+    }
+    *data = packet;
+    return ARSTREAM_OK;
+}
+
+static void ARSTREAM_SharedMemoryTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    ARSTREAM_SharedMemoryTransport_t *transport = (ARSTREAM_SharedMemoryTransport_t *)context;
+    ARSTREAM_Ring_t *ring = ARSTREAM_SharedMemoryTransport_GetRing (transport, channel, 0);
+    if (ring != NULL)
+    {
+        ARSTREAM_Ring_ReadEnd (ring);
+    }
+}
+
+static eARSTREAM_ERROR ARSTREAM_SharedMemoryTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    /* Packets are published in the ring at once, so there is never anything to flush */
+    (void)context;
+    (void)channel;
+    return ARSTREAM_OK;
+}
+
+static int ARSTREAM_SharedMemoryTransport_GetEstimatedLatency (void *context)
+{
+    /* Same host : the round trip time is far below one ms */
+    (void)context;
+    return 0;
+}
+
+static void ARSTREAM_SharedMemoryTransport_Destroy (void *context)
+{
+    ARSTREAM_SharedMemoryTransport_t *transport = (ARSTREAM_SharedMemoryTransport_t *)context;
+    if (transport != NULL)
+    {
+        ARSTREAM_SharedMemoryTransport_ReleaseArea (transport->area, transport->areaSize, transport->isMapped);
+        free (transport);
+    }
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_Transport_CreateSharedMemory (uint32_t maxFragmentSize, uint32_t nbSlots, eARSTREAM_ERROR *error)
+{
+#ifdef ARSTREAM_SHM_TRANSPORT_HAS_MEMFD
+    ARSTREAM_SharedMemoryTransport_Header_t header;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    ARSTREAM_Ring_t dataRing;
+    ARSTREAM_Ring_t ackRing;
+    uint8_t *area = NULL;
+    int fd = -1;
+
+    /* ARGS Check */
+    if (ARSTREAM_SharedMemoryTransport_ComputeLayout (&header, maxFragmentSize, nbSlots) == 0)
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return -1;
+    }
+
+#ifdef HAVE_MEMFD_CREATE
+    fd = memfd_create ("arstream", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+    fd = syscall (SYS_memfd_create, "arstream", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#endif
+    if (fd < 0)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Unable to create the memory file : %s", strerror (errno));
+        internalError = (errno == ENOSYS) ? ARSTREAM_ERROR_NOT_SUPPORTED : ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ftruncate (fd, (off_t)header.totalSize) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Unable to size the memory file to %llu bytes : %s", (unsigned long long)header.totalSize, strerror (errno));
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        area = mmap (NULL, (size_t)header.totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (area == MAP_FAILED)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Unable to map the memory file : %s", strerror (errno));
+            area = NULL;
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+    }
+
+    /* The pages are fresh zeroes : only the ring headers need to be written */
+    if (internalError == ARSTREAM_OK)
+    {
+        ARSTREAM_SharedMemoryTransport_InitArea (area, &header, nbSlots, 1, &dataRing, &ackRing);
+        munmap (area, (size_t)header.totalSize);
+
+#ifdef F_ADD_SEALS
+        /* Neither endpoint can resize the area under the feet of the other one (SIGBUS) */
+        if (fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_SHM_TRANSPORT_TAG, "Unable to seal the memory file : %s", strerror (errno));
+        }
+#endif
+    }
+
+    if ((internalError != ARSTREAM_OK) &&
+        (fd >= 0))
+    {
+        close (fd);
+        fd = -1;
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return fd;
+#else
+    (void)maxFragmentSize;
+    (void)nbSlots;
+    SET_WITH_CHECK (error, ARSTREAM_ERROR_NOT_SUPPORTED);
+    return -1;
+#endif
+}
+
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewSharedMemory (int fd, eARSTREAM_TRANSPORT_ROLE role, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Transport_t *retTransport = NULL;
+    ARSTREAM_SharedMemoryTransport_Header_t header;
+    ARSTREAM_Ring_t dataRing;
+    ARSTREAM_Ring_t ackRing;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    struct stat fdStat;
+    uint8_t *area = NULL;
+    size_t areaSize = 0;
+
+    /* ARGS Check */
+    if ((fd < 0) ||
+        (role < ARSTREAM_TRANSPORT_ROLE_SENDER) ||
+        (role >= ARSTREAM_TRANSPORT_ROLE_MAX))
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    if ((fstat (fd, &fdStat) != 0) ||
+        ((uint64_t)fdStat.st_size < sizeof (ARSTREAM_SharedMemoryTransport_Header_t)) ||
+        ((uint64_t)fdStat.st_size > (uint64_t)SIZE_MAX))
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    areaSize = (size_t)fdStat.st_size;
+    area = mmap (NULL, areaSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (area == MAP_FAILED)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "Unable to map the memory file : %s", strerror (errno));
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_TRANSPORT);
+        return retTransport;
+    }
+
+    /* Check the area against the layout it should have : it may come from another process */
+    memcpy (&header, area, sizeof (header));
+    if ((header.magic != ARSTREAM_SHM_TRANSPORT_MAGIC) ||
+        (header.version != ARSTREAM_SHM_TRANSPORT_VERSION) ||
+        (header.totalSize > areaSize) ||
+        (header.dataRingOffset < sizeof (header)) ||
+        (header.dataRingOffset > header.totalSize) ||
+        (header.dataRingSize > (header.totalSize - header.dataRingOffset)) ||
+        (header.ackRingOffset < (header.dataRingOffset + header.dataRingSize)) ||
+        (header.ackRingOffset > header.totalSize) ||
+        (header.ackRingSize > (header.totalSize - header.ackRingOffset)))
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "The memory file is not a stream shared memory area");
+        internalError = ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if ((ARSTREAM_Ring_Attach (&dataRing, &area [header.dataRingOffset], (size_t)header.dataRingSize) != 0) ||
+            (ARSTREAM_Ring_Attach (&ackRing, &area [header.ackRingOffset], (size_t)header.ackRingSize) != 0) ||
+            (ARSTREAM_Ring_GetSlotSize (&ackRing) < ARSTREAM_SHM_TRANSPORT_ACK_SLOT_SIZE))
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_SHM_TRANSPORT_TAG, "The rings of the memory file are corrupted");
+            internalError = ARSTREAM_ERROR_BAD_PARAMETERS;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        retTransport = ARSTREAM_SharedMemoryTransport_NewEndpoint (area, areaSize, 1, role, &dataRing, &ackRing, &internalError);
+    }
+    else
+    {
+        munmap (area, areaSize);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retTransport;
+}
+
+eARSTREAM_ERROR ARSTREAM_Transport_NewLoopback (uint32_t maxFragmentSize, uint32_t nbSlots, ARSTREAM_Transport_t **senderTransport, ARSTREAM_Transport_t **readerTransport)
+{
+    ARSTREAM_SharedMemoryTransport_Header_t header;
+    ARSTREAM_Ring_t dataRing;
+    ARSTREAM_Ring_t ackRing;
+    eARSTREAM_ERROR error = ARSTREAM_OK;
+    void *area = NULL;
+
+    /* ARGS Check */
+    if ((senderTransport == NULL) ||
+        (readerTransport == NULL) ||
+        (ARSTREAM_SharedMemoryTransport_ComputeLayout (&header, maxFragmentSize, nbSlots) == 0))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+    *senderTransport = NULL;
+    *readerTransport = NULL;
+
+    /* Same layout as a memfd area, in private memory. Each endpoint holds a reference */
+    if (posix_memalign (&area, ARSTREAM_SHM_TRANSPORT_ALIGN, (size_t)header.totalSize) != 0)
+    {
+        return ARSTREAM_ERROR_ALLOC;
+    }
+    header.refCount = 2;
+    ARSTREAM_SharedMemoryTransport_InitArea (area, &header, nbSlots, 0, &dataRing, &ackRing);
+
+    *senderTransport = ARSTREAM_SharedMemoryTransport_NewEndpoint (area, (size_t)header.totalSize, 0, ARSTREAM_TRANSPORT_ROLE_SENDER, &dataRing, &ackRing, &error);
+    if (error != ARSTREAM_OK)
+    {
+        /* Drop the reference of the reader too */
+        ARSTREAM_SharedMemoryTransport_ReleaseArea (area, (size_t)header.totalSize, 0);
+        return error;
+    }
+
+    *readerTransport = ARSTREAM_SharedMemoryTransport_NewEndpoint (area, (size_t)header.totalSize, 0, ARSTREAM_TRANSPORT_ROLE_READER, &dataRing, &ackRing, &error);
+    if (error != ARSTREAM_OK)
+    {
+        ARSTREAM_Transport_Delete (senderTransport);
+    }
+    return error;
+}
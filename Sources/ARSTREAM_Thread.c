@@ -0,0 +1,507 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Thread.c
+ * @brief Threads started by the library, with CPU affinity and scheduling settings
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Private Headers
+ */
+
+#include "ARSTREAM_Thread.h"
+#include "ARSTREAM_Histogram.h"
+#include "ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_THREAD_TAG "ARSTREAM_Thread"
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief States of a thread, from its creation to its routine
+ */
+typedef enum {
+    ARSTREAM_THREAD_STATE_CONFIGURING = 0, /**< The thread is applying its settings */
+    ARSTREAM_THREAD_STATE_READY, /**< The settings are applied, the thread waits for ARSTREAM_Thread_Start */
+    ARSTREAM_THREAD_STATE_FAILED, /**< The settings could not be applied, the thread returned */
+    ARSTREAM_THREAD_STATE_STARTED, /**< The thread runs its routine */
+    ARSTREAM_THREAD_STATE_ABORTED, /**< The thread was deleted before being started, and returns */
+} eARSTREAM_THREAD_STATE;
+
+struct ARSTREAM_Thread_t {
+    ARSAL_Thread_t thread;
+    ARSTREAM_Thread_Config_t config;
+    void* (*routine)(void *);
+    void *arg;
+
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t cond;
+    eARSTREAM_THREAD_STATE state;
+    eARSTREAM_ERROR configError;
+};
+
+/**
+ * @brief Parameters of the scheduling latency probe
+ */
+typedef struct {
+    uint32_t periodUs;
+    uint32_t nbSamples;
+    ARSTREAM_Histogram_t *latencies;
+} ARSTREAM_Thread_Probe_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Checks the ranges of a thread configuration
+ * @param config The configuration
+ * @return 1 if the configuration is valid, 0 otherwise
+ */
+static int ARSTREAM_Thread_CheckConfig (const ARSTREAM_Thread_Config_t *config);
+
+/**
+ * @brief Converts the errno of a failed scheduling call
+ * @param err The errno value
+ * @return The matching eARSTREAM_ERROR
+ */
+static eARSTREAM_ERROR ARSTREAM_Thread_ErrnoToError (int err);
+
+/**
+ * @brief Applies a configuration to the calling thread
+ * @param config The configuration
+ * @return ARSTREAM_OK, or the error of the first setting which could not be applied
+ */
+static eARSTREAM_ERROR ARSTREAM_Thread_ApplyConfig (const ARSTREAM_Thread_Config_t *config);
+
+/**
+ * @brief Entry point of the threads : applies the settings, waits to be started, then runs the routine
+ * @param param The ARSTREAM_Thread_t
+ * @return The return value of the routine, or NULL if it was not called
+ */
+static void* ARSTREAM_Thread_Run (void *param);
+
+/**
+ * @brief Routine of the scheduling latency probe
+ * @param param The ARSTREAM_Thread_Probe_t
+ * @return NULL
+ */
+static void* ARSTREAM_Thread_RunProbe (void *param);
+
+/*
+ * Internal functions implementation
+ */
+
+static int ARSTREAM_Thread_CheckConfig (const ARSTREAM_Thread_Config_t *config)
+{
+    if (config->fifoPriority != 0)
+    {
+        if ((config->fifoPriority < sched_get_priority_min (SCHED_FIFO)) ||
+            (config->fifoPriority > sched_get_priority_max (SCHED_FIFO)))
+        {
+            return 0;
+        }
+    }
+    if ((config->niceValue < -20) ||
+        (config->niceValue > 19))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+static eARSTREAM_ERROR ARSTREAM_Thread_ErrnoToError (int err)
+{
+    eARSTREAM_ERROR retVal;
+    switch (err)
+    {
+    case EPERM:
+    case EACCES:
+        retVal = ARSTREAM_ERROR_PERMISSION;
+        break;
+    case ENOSYS:
+    case ENOTSUP:
+        retVal = ARSTREAM_ERROR_NOT_SUPPORTED;
+        break;
+    default:
+        retVal = ARSTREAM_ERROR_BAD_PARAMETERS;
+        break;
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_Thread_ApplyConfig (const ARSTREAM_Thread_Config_t *config)
+{
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+
+    if (config->cpuMask != 0)
+    {
+#ifdef __linux__
+        cpu_set_t cpus;
+        int cpu;
+        CPU_ZERO (&cpus);
+        for (cpu = 0; (cpu < 64) && (cpu < CPU_SETSIZE); cpu++)
+        {
+            if ((config->cpuMask & (1ULL << cpu)) != 0)
+            {
+                CPU_SET (cpu, &cpus);
+            }
+        }
+        /* pid 0 : the calling thread only */
+        if (sched_setaffinity (0, sizeof (cpus), &cpus) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_THREAD_TAG, "Unable to set the CPU affinity 0x%llx : %s", (unsigned long long)config->cpuMask, strerror (errno));
+            retVal = ARSTREAM_Thread_ErrnoToError (errno);
+        }
+#else
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_THREAD_TAG, "CPU affinity is not supported on this system");
+        retVal = ARSTREAM_ERROR_NOT_SUPPORTED;
+#endif
+    }
+
+    if ((retVal == ARSTREAM_OK) &&
+        (config->fifoPriority != 0))
+    {
+        struct sched_param param;
+        int ret;
+        memset (&param, 0, sizeof (param));
+        param.sched_priority = config->fifoPriority;
+        ret = pthread_setschedparam (pthread_self (), SCHED_FIFO, &param);
+        if (ret != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_THREAD_TAG, "Unable to set the SCHED_FIFO priority %d : %s", config->fifoPriority, strerror (ret));
+            retVal = ARSTREAM_Thread_ErrnoToError (ret);
+        }
+    }
+    else if ((retVal == ARSTREAM_OK) &&
+             (config->niceValue != 0))
+    {
+#ifdef __linux__
+        /* On Linux, the nice value belongs to the thread, not to the process */
+        if (setpriority (PRIO_PROCESS, (id_t)syscall (SYS_gettid), config->niceValue) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_THREAD_TAG, "Unable to set the nice value %d : %s", config->niceValue, strerror (errno));
+            retVal = ARSTREAM_Thread_ErrnoToError (errno);
+        }
+#else
+        /* Elsewhere, it would apply to the whole process */
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_THREAD_TAG, "Per thread nice values are not supported on this system");
+        retVal = ARSTREAM_ERROR_NOT_SUPPORTED;
+#endif
+    }
+
+    return retVal;
+}
+
+static void* ARSTREAM_Thread_Run (void *param)
+{
+    ARSTREAM_Thread_t *thread = (ARSTREAM_Thread_t *)param;
+    eARSTREAM_ERROR err = ARSTREAM_Thread_ApplyConfig (&(thread->config));
+    int mustRun;
+
+    ARSAL_Mutex_Lock (&(thread->mutex));
+    thread->configError = err;
+    thread->state = (err == ARSTREAM_OK) ? ARSTREAM_THREAD_STATE_READY : ARSTREAM_THREAD_STATE_FAILED;
+    ARSAL_Cond_Broadcast (&(thread->cond));
+    while (thread->state == ARSTREAM_THREAD_STATE_READY)
+    {
+        ARSAL_Cond_Wait (&(thread->cond), &(thread->mutex));
+    }
+    mustRun = (thread->state == ARSTREAM_THREAD_STATE_STARTED) ? 1 : 0;
+    ARSAL_Mutex_Unlock (&(thread->mutex));
+
+    if (mustRun == 1)
+    {
+        return thread->routine (thread->arg);
+    }
+    return NULL;
+}
+
+static void* ARSTREAM_Thread_RunProbe (void *param)
+{
+    ARSTREAM_Thread_Probe_t *probe = (ARSTREAM_Thread_Probe_t *)param;
+    struct timespec deadline;
+    struct timespec now;
+    uint32_t i;
+
+    clock_gettime (CLOCK_MONOTONIC, &deadline);
+    for (i = 0; i < probe->nbSamples; i++)
+    {
+        int64_t lateNs;
+        deadline.tv_sec += probe->periodUs / 1000000;
+        deadline.tv_nsec += (long)(probe->periodUs % 1000000) * 1000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+#ifdef __linux__
+        while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+        {
+            /* Interrupted : sleep again until the deadline */
+        }
+        clock_gettime (CLOCK_MONOTONIC, &now);
+#else
+        clock_gettime (CLOCK_MONOTONIC, &now);
+        lateNs = ((int64_t)(deadline.tv_sec - now.tv_sec) * 1000000000) + (deadline.tv_nsec - now.tv_nsec);
+        if (lateNs > 0)
+        {
+            struct timespec sleepTime;
+            sleepTime.tv_sec = lateNs / 1000000000;
+            sleepTime.tv_nsec = lateNs % 1000000000;
+            nanosleep (&sleepTime, NULL);
+            clock_gettime (CLOCK_MONOTONIC, &now);
+        }
+#endif
+        lateNs = ((int64_t)(now.tv_sec - deadline.tv_sec) * 1000000000) + (now.tv_nsec - deadline.tv_nsec);
+        if (lateNs < 0)
+        {
+            lateNs = 0;
+        }
+        ARSTREAM_Histogram_Record (probe->latencies, ((lateNs / 1000) > UINT32_MAX) ? UINT32_MAX : (uint32_t)(lateNs / 1000));
+    }
+    return NULL;
+}
+
+/*
+ * Implementation
+ */
+
+ARSTREAM_Thread_t* ARSTREAM_Thread_New (const ARSTREAM_Thread_Config_t *config, void* (*routine)(void *), void *arg, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Thread_t *retThread = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    int mutexWasInit = 0;
+    int condWasInit = 0;
+
+    /* ARGS Check */
+    if ((routine == NULL) ||
+        ((config != NULL) &&
+         (ARSTREAM_Thread_CheckConfig (config) == 0)))
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retThread;
+    }
+
+    /* Alloc new thread */
+    retThread = calloc (1, sizeof (ARSTREAM_Thread_t));
+    if (retThread == NULL)
+    {
+        internalError = ARSTREAM_ERROR_ALLOC;
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (config != NULL)
+        {
+            retThread->config = *config;
+        }
+        retThread->routine = routine;
+        retThread->arg = arg;
+        retThread->state = ARSTREAM_THREAD_STATE_CONFIGURING;
+        retThread->configError = ARSTREAM_OK;
+        if (ARSAL_Mutex_Init (&(retThread->mutex)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            mutexWasInit = 1;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Cond_Init (&(retThread->cond)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            condWasInit = 1;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Thread_Create (&(retThread->thread), ARSTREAM_Thread_Run, retThread) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_THREAD_TAG, "Unable to create the thread");
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            /* Wait for the settings to be applied */
+            ARSAL_Mutex_Lock (&(retThread->mutex));
+            while (retThread->state == ARSTREAM_THREAD_STATE_CONFIGURING)
+            {
+                ARSAL_Cond_Wait (&(retThread->cond), &(retThread->mutex));
+            }
+            internalError = retThread->configError;
+            ARSAL_Mutex_Unlock (&(retThread->mutex));
+            if (internalError != ARSTREAM_OK)
+            {
+                ARSAL_Thread_Join (retThread->thread, NULL);
+                ARSAL_Thread_Destroy (&(retThread->thread));
+            }
+        }
+    }
+
+    if ((internalError != ARSTREAM_OK) &&
+        (retThread != NULL))
+    {
+        if (condWasInit == 1)
+        {
+            ARSAL_Cond_Destroy (&(retThread->cond));
+        }
+        if (mutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy (&(retThread->mutex));
+        }
+        free (retThread);
+        retThread = NULL;
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retThread;
+}
+
+void ARSTREAM_Thread_Start (ARSTREAM_Thread_t *thread)
+{
+    if (thread != NULL)
+    {
+        ARSAL_Mutex_Lock (&(thread->mutex));
+        if (thread->state == ARSTREAM_THREAD_STATE_READY)
+        {
+            thread->state = ARSTREAM_THREAD_STATE_STARTED;
+            ARSAL_Cond_Broadcast (&(thread->cond));
+        }
+        ARSAL_Mutex_Unlock (&(thread->mutex));
+    }
+}
+
+void ARSTREAM_Thread_Delete (ARSTREAM_Thread_t **thread)
+{
+    if ((thread != NULL) &&
+        (*thread != NULL))
+    {
+        ARSAL_Mutex_Lock (&((*thread)->mutex));
+        if ((*thread)->state == ARSTREAM_THREAD_STATE_READY)
+        {
+            (*thread)->state = ARSTREAM_THREAD_STATE_ABORTED;
+            ARSAL_Cond_Broadcast (&((*thread)->cond));
+        }
+        ARSAL_Mutex_Unlock (&((*thread)->mutex));
+
+        ARSAL_Thread_Join ((*thread)->thread, NULL);
+        ARSAL_Thread_Destroy (&((*thread)->thread));
+        ARSAL_Cond_Destroy (&((*thread)->cond));
+        ARSAL_Mutex_Destroy (&((*thread)->mutex));
+        free (*thread);
+        *thread = NULL;
+    }
+}
+
+eARSTREAM_ERROR ARSTREAM_Thread_MeasureSchedulingLatency (const ARSTREAM_Thread_Config_t *config, uint32_t periodUs, uint32_t nbSamples, ARSTREAM_Histogram_t *latencies)
+{
+    ARSTREAM_Thread_Probe_t probe;
+    ARSTREAM_Thread_t *thread = NULL;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+
+    if ((periodUs == 0) ||
+        (nbSamples == 0) ||
+        (latencies == NULL))
+    {
+        return ARSTREAM_ERROR_BAD_PARAMETERS;
+    }
+
+    ARSTREAM_Histogram_Reset (latencies);
+    probe.periodUs = periodUs;
+    probe.nbSamples = nbSamples;
+    probe.latencies = latencies;
+    thread = ARSTREAM_Thread_New (config, ARSTREAM_Thread_RunProbe, &probe, &err);
+    if (thread != NULL)
+    {
+        ARSTREAM_Thread_Start (thread);
+        ARSTREAM_Thread_Delete (&thread);
+    }
+    return err;
+}
@@ -0,0 +1,93 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Thread.h
+ * @brief Threads started by the library, with CPU affinity and scheduling settings
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_THREAD_PRIVATE_H_
+#define _ARSTREAM_THREAD_PRIVATE_H_
+
+/*
+ * System Headers
+ */
+#include <inttypes.h>
+
+/*
+ * ARSDK Headers
+ */
+#include <libARStream/ARSTREAM_Error.h>
+#include <libARStream/ARSTREAM_Thread.h>
+
+/*
+ * Types
+ */
+
+/**
+ * @brief A thread started by the library
+ */
+typedef struct ARSTREAM_Thread_t ARSTREAM_Thread_t;
+
+/*
+ * Functions declarations
+ */
+
+/**
+ * @brief Creates a thread, and applies its settings
+ * The thread applies the settings to itself, then waits for ARSTREAM_Thread_Start before
+ * calling the routine. A caller which creates several threads can thus check all their
+ * settings before letting any of them run.
+ *
+ * @param config The settings of the thread. NULL keeps the inherited settings
+ * @param routine The routine to run
+ * @param arg The argument of the routine
+ * @param[out] error Optional pointer to an eARSTREAM_ERROR to hold any error information
+ * @return The thread, or NULL if it could not be created, or if its settings could not be applied
+ */
+ARSTREAM_Thread_t* ARSTREAM_Thread_New (const ARSTREAM_Thread_Config_t *config, void* (*routine)(void *), void *arg, eARSTREAM_ERROR *error);
+
+/**
+ * @brief Lets a thread call its routine
+ * @param thread The thread
+ */
+void ARSTREAM_Thread_Start (ARSTREAM_Thread_t *thread);
+
+/**
+ * @brief Waits for the end of a thread, and deletes it
+ * A thread which was never started returns without calling its routine
+ * @param thread Pointer to the thread to delete. Set to NULL
+ * @warning The routine of a started thread must be stopped before this call
+ */
+void ARSTREAM_Thread_Delete (ARSTREAM_Thread_t **thread);
+
+#endif /* _ARSTREAM_THREAD_PRIVATE_H_ */
@@ -0,0 +1,853 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_UDPTransport.c
+ * @brief Stream transport over a raw UDP socket
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
+
+/*
+ * Private Headers
+ */
+
+#include "ARSTREAM_NetworkHeaders.h"
+#include "ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_UDP_TRANSPORT_TAG "ARSTREAM_UDPTransport"
+
+/**
+ * Number of preallocated receive slots (maximum number of datagrams read by one recvmmsg call)
+ */
+#define ARSTREAM_UDP_TRANSPORT_NB_SLOTS (256)
+
+/**
+ * Maximum number of datagrams given to one sendmmsg call
+ */
+#define ARSTREAM_UDP_TRANSPORT_MAX_BATCH (64)
+
+/**
+ * Requested size of the socket buffers
+ * A full frame burst (up to 128 fragments) must fit without drops
+ */
+#define ARSTREAM_UDP_TRANSPORT_SOCKET_BUFFER_SIZE (1024 * 1024)
+
+/**
+ * Segmentation offload (GSO/GRO) is only available on Linux (kernel 4.18 and 5.0).
+ * The socket options are defined here as older C libraries do not know them, and their
+ * availability is probed at runtime.
+ */
+#ifdef __linux__
+#define ARSTREAM_UDP_TRANSPORT_HAS_OFFLOAD
+#ifndef SOL_UDP
+#define SOL_UDP (17)
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT (103)
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO (104)
+#endif
+#endif
+
+/**
+ * Maximum number of segments in a GSO send (UDP_MAX_SEGMENTS of the kernel)
+ */
+#define ARSTREAM_UDP_TRANSPORT_GSO_MAX_SEGMENTS (64)
+
+/**
+ * Maximum size of a GSO send, or of a GRO coalesced datagram (maximum UDP payload over IPv4)
+ */
+#define ARSTREAM_UDP_TRANSPORT_GSO_MAX_SIZE (65507)
+
+/**
+ * Number of receive buffers when GRO is enabled (each one can hold up to 64 coalesced fragments)
+ */
+#define ARSTREAM_UDP_TRANSPORT_NB_GRO_BUFFERS (ARSTREAM_UDP_TRANSPORT_NB_SLOTS / ARSTREAM_UDP_TRANSPORT_GSO_MAX_SEGMENTS)
+
+/**
+ * Size of the ancillary data buffer of a received message (GRO segment size)
+ */
+#define ARSTREAM_UDP_TRANSPORT_CONTROL_SIZE (CMSG_SPACE (sizeof (int)))
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+/*
+ * Types
+ */
+
+typedef struct {
+    int socket;
+    uint32_t flags; /* Flags actually enabled, after probing the kernel */
+
+    /* Receive buffers : one per datagram, or one per coalesced burst with GRO */
+    uint8_t *buffers;
+    uint32_t bufferSize;
+    int nbBuffers;
+    uint8_t control [ARSTREAM_UDP_TRANSPORT_NB_GRO_BUFFERS][ARSTREAM_UDP_TRANSPORT_CONTROL_SIZE];
+#ifdef HAVE_RECVMMSG
+    struct mmsghdr recvMsgs [ARSTREAM_UDP_TRANSPORT_NB_SLOTS];
+    struct iovec recvIovecs [ARSTREAM_UDP_TRANSPORT_NB_SLOTS];
+#endif
+
+    /* Received packets, pointing into the receive buffers */
+    uint8_t *packets [ARSTREAM_UDP_TRANSPORT_NB_SLOTS];
+    uint32_t packetsSize [ARSTREAM_UDP_TRANSPORT_NB_SLOTS];
+    int nbPackets;
+    int readPacket;
+} ARSTREAM_UDPTransport_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Adds the datagrams of a received message to the packets list
+ * With GRO, a message may hold several datagrams of the same size (the last one can be shorter)
+ * @param transport The UDP transport
+ * @param data The message data
+ * @param size The message size, in bytes
+ * @param msg The message header, with its ancillary data
+ */
+static void ARSTREAM_UDPTransport_AddDatagrams (ARSTREAM_UDPTransport_t *transport, uint8_t *data, uint32_t size, struct msghdr *msg);
+
+/**
+ * @brief Fills the packets list with the datagrams available on the socket
+ * Waits up to timeoutMs for the first datagram, then reads all the datagrams already queued without blocking
+ * @param transport The UDP transport
+ * @param timeoutMs Maximum time to wait for the first datagram, in ms
+ * @return ARSTREAM_OK if at least one datagram was read
+ * @return ARSTREAM_ERROR_BUFFER_EMPTY on timeout
+ * @return ARSTREAM_ERROR_TRANSPORT on socket errors
+ */
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_FillPackets (ARSTREAM_UDPTransport_t *transport, int timeoutMs);
+
+/**
+ * @brief Sends one packet with sendmsg
+ * @param transport The UDP transport
+ * @param packets The packets to send
+ * @param nbPackets Number of packets in the array
+ * @return The number of packets sent (1), or -1 on error (see errno)
+ */
+static int ARSTREAM_UDPTransport_SendOne (ARSTREAM_UDPTransport_t *transport, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+
+#ifdef HAVE_SENDMMSG
+/**
+ * @brief Sends packets with one sendmmsg call
+ * @param transport The UDP transport
+ * @param packets The packets to send
+ * @param nbPackets Number of packets in the array
+ * @return The number of packets sent, 0 if none was sent, or -1 on error (see errno)
+ */
+static int ARSTREAM_UDPTransport_SendBatch (ARSTREAM_UDPTransport_t *transport, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+#endif
+
+#ifdef ARSTREAM_UDP_TRANSPORT_HAS_OFFLOAD
+/**
+ * @brief Sends packets as one GSO super-datagram, segmented by the kernel
+ * The first packet gives the segment size. The following packets are added while they have the same size,
+ * a shorter packet ends the segment list.
+ * @param transport The UDP transport
+ * @param packets The packets to send
+ * @param nbPackets Number of packets in the array
+ * @return The number of packets sent, 0 if the first packet does not fit in a GSO send, or -1 on error (see errno)
+ */
+static int ARSTREAM_UDPTransport_SendSegments (ARSTREAM_UDPTransport_t *transport, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+#endif
+
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData);
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs);
+static void ARSTREAM_UDPTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static int ARSTREAM_UDPTransport_GetEstimatedLatency (void *context);
+static void ARSTREAM_UDPTransport_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static const ARSTREAM_Transport_Ops_t ARSTREAM_UDPTransport_Ops = {
+    .send = ARSTREAM_UDPTransport_Send,
+    .receive = ARSTREAM_UDPTransport_Receive,
+    .sendPackets = ARSTREAM_UDPTransport_SendPackets,
+    .receiveBegin = ARSTREAM_UDPTransport_ReceiveBegin,
+    .receiveEnd = ARSTREAM_UDPTransport_ReceiveEnd,
+    .flush = ARSTREAM_UDPTransport_Flush,
+    .getEstimatedLatency = ARSTREAM_UDPTransport_GetEstimatedLatency,
+    .destroy = ARSTREAM_UDPTransport_Destroy,
+};
+
+static void ARSTREAM_UDPTransport_AddDatagrams (ARSTREAM_UDPTransport_t *transport, uint8_t *data, uint32_t size, struct msghdr *msg)
+{
+    uint32_t segmentSize = size;
+    uint32_t offset = 0;
+
+    if ((msg->msg_flags & MSG_TRUNC) != 0)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_UDP_TRANSPORT_TAG, "Dropped a truncated datagram");
+        return;
+    }
+
+#ifdef ARSTREAM_UDP_TRANSPORT_HAS_OFFLOAD
+    if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_GRO) != 0)
+    {
+        struct cmsghdr *cmsg;
+        for (cmsg = CMSG_FIRSTHDR (msg); cmsg != NULL; cmsg = CMSG_NXTHDR (msg, cmsg))
+        {
+            if ((cmsg->cmsg_level == SOL_UDP) &&
+                (cmsg->cmsg_type == UDP_GRO))
+            {
+                int groSize;
+                memcpy (&groSize, CMSG_DATA (cmsg), sizeof (int));
+                if (groSize > 0)
+                {
+                    segmentSize = groSize;
+                }
+            }
+        }
+    }
+#endif
+
+    while ((offset < size) &&
+           (transport->nbPackets < ARSTREAM_UDP_TRANSPORT_NB_SLOTS))
+    {
+        uint32_t packetSize = size - offset;
+        if (packetSize > segmentSize)
+        {
+            packetSize = segmentSize;
+        }
+        transport->packets [transport->nbPackets] = &data [offset];
+        transport->packetsSize [transport->nbPackets] = packetSize;
+        transport->nbPackets++;
+        offset += packetSize;
+    }
+}
+
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_FillPackets (ARSTREAM_UDPTransport_t *transport, int timeoutMs)
+{
+    struct pollfd pfd;
+    int pollRes;
+    int nbRead = 0;
+
+    transport->nbPackets = 0;
+    transport->readPacket = 0;
+
+    pfd.fd = transport->socket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    pollRes = poll (&pfd, 1, timeoutMs);
+    if (pollRes == 0)
+    {
+        return ARSTREAM_ERROR_BUFFER_EMPTY;
+    }
+    else if (pollRes < 0)
+    {
+        if (errno == EINTR)
+        {
+            return ARSTREAM_ERROR_BUFFER_EMPTY;
+        }
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Error while polling socket : %s", strerror (errno));
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+#ifdef HAVE_RECVMMSG
+    {
+        int i;
+        /* The kernel overwrites the control lengths */
+        for (i = 0; i < transport->nbBuffers; i++)
+        {
+            transport->recvMsgs [i].msg_hdr.msg_controllen = (transport->recvMsgs [i].msg_hdr.msg_control != NULL) ? ARSTREAM_UDP_TRANSPORT_CONTROL_SIZE : 0;
+        }
+        nbRead = recvmmsg (transport->socket, transport->recvMsgs, transport->nbBuffers, MSG_DONTWAIT, NULL);
+        for (i = 0; i < nbRead; i++)
+        {
+            ARSTREAM_UDPTransport_AddDatagrams (transport, transport->recvIovecs [i].iov_base, transport->recvMsgs [i].msg_len, &transport->recvMsgs [i].msg_hdr);
+        }
+    }
+#else
+    {
+        struct msghdr msg;
+        struct iovec iov;
+        ssize_t recvSize;
+        memset (&msg, 0, sizeof (msg));
+        iov.iov_base = transport->buffers;
+        iov.iov_len = transport->bufferSize;
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_GRO) != 0)
+        {
+            msg.msg_control = transport->control [0];
+            msg.msg_controllen = ARSTREAM_UDP_TRANSPORT_CONTROL_SIZE;
+        }
+        recvSize = recvmsg (transport->socket, &msg, MSG_DONTWAIT);
+        if (recvSize >= 0)
+        {
+            nbRead = 1;
+            ARSTREAM_UDPTransport_AddDatagrams (transport, transport->buffers, (uint32_t)recvSize, &msg);
+        }
+        else
+        {
+            nbRead = -1;
+        }
+    }
+#endif
+
+    if (nbRead < 0)
+    {
+        if ((errno == EAGAIN) ||
+            (errno == EWOULDBLOCK) ||
+            (errno == EINTR))
+        {
+            return ARSTREAM_ERROR_BUFFER_EMPTY;
+        }
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Error while reading socket : %s", strerror (errno));
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    return (transport->nbPackets > 0) ? ARSTREAM_OK : ARSTREAM_ERROR_BUFFER_EMPTY;
+}
+
+static int ARSTREAM_UDPTransport_SendOne (ARSTREAM_UDPTransport_t *transport, ARSTREAM_Transport_Packet_t *packets, int nbPackets)
+{
+    struct msghdr msg;
+    struct iovec iov [2];
+
+    (void)nbPackets;
+
+    memset (&msg, 0, sizeof (msg));
+    iov [0].iov_base = packets [0].header;
+    iov [0].iov_len = packets [0].headerSize;
+    iov [1].iov_base = packets [0].payload;
+    iov [1].iov_len = packets [0].payloadSize;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    return (sendmsg (transport->socket, &msg, 0) < 0) ? -1 : 1;
+}
+
+#ifdef HAVE_SENDMMSG
+static int ARSTREAM_UDPTransport_SendBatch (ARSTREAM_UDPTransport_t *transport, ARSTREAM_Transport_Packet_t *packets, int nbPackets)
+{
+    struct mmsghdr msgs [ARSTREAM_UDP_TRANSPORT_MAX_BATCH];
+    struct iovec iovecs [2 * ARSTREAM_UDP_TRANSPORT_MAX_BATCH];
+    int i;
+
+    if (nbPackets > ARSTREAM_UDP_TRANSPORT_MAX_BATCH)
+    {
+        nbPackets = ARSTREAM_UDP_TRANSPORT_MAX_BATCH;
+    }
+
+    memset (msgs, 0, nbPackets * sizeof (struct mmsghdr));
+    for (i = 0; i < nbPackets; i++)
+    {
+        iovecs [2*i].iov_base = packets [i].header;
+        iovecs [2*i].iov_len = packets [i].headerSize;
+        iovecs [2*i + 1].iov_base = packets [i].payload;
+        iovecs [2*i + 1].iov_len = packets [i].payloadSize;
+        msgs [i].msg_hdr.msg_iov = &iovecs [2*i];
+        msgs [i].msg_hdr.msg_iovlen = 2;
+    }
+
+    return sendmmsg (transport->socket, msgs, nbPackets, 0);
+}
+#endif
+
+#ifdef ARSTREAM_UDP_TRANSPORT_HAS_OFFLOAD
+static int ARSTREAM_UDPTransport_SendSegments (ARSTREAM_UDPTransport_t *transport, ARSTREAM_Transport_Packet_t *packets, int nbPackets)
+{
+    struct msghdr msg;
+    struct iovec iovecs [2 * ARSTREAM_UDP_TRANSPORT_GSO_MAX_SEGMENTS];
+    union {
+        uint8_t buffer [CMSG_SPACE (sizeof (uint16_t))];
+        struct cmsghdr align;
+    } control;
+    uint32_t segmentSize = packets [0].headerSize + packets [0].payloadSize;
+    uint32_t totalSize = 0;
+    int nbSegments = 0;
+
+    /* As all segments but the last have the same size, the kernel splits the
+     * gathered buffers exactly on the packet boundaries : no copy is needed */
+    while ((nbSegments < nbPackets) &&
+           (nbSegments < ARSTREAM_UDP_TRANSPORT_GSO_MAX_SEGMENTS))
+    {
+        uint32_t packetSize = packets [nbSegments].headerSize + packets [nbSegments].payloadSize;
+        if ((packetSize > segmentSize) ||
+            (totalSize + packetSize > ARSTREAM_UDP_TRANSPORT_GSO_MAX_SIZE))
+        {
+            break;
+        }
+        iovecs [2*nbSegments].iov_base = packets [nbSegments].header;
+        iovecs [2*nbSegments].iov_len = packets [nbSegments].headerSize;
+        iovecs [2*nbSegments + 1].iov_base = packets [nbSegments].payload;
+        iovecs [2*nbSegments + 1].iov_len = packets [nbSegments].payloadSize;
+        totalSize += packetSize;
+        nbSegments++;
+        if (packetSize < segmentSize)
+        {
+            break;
+        }
+    }
+
+    if (nbSegments == 0)
+    {
+        /* The first packet is larger than a GSO send : an empty sendmsg would send an empty datagram */
+        return 0;
+    }
+
+    memset (&msg, 0, sizeof (msg));
+    msg.msg_iov = iovecs;
+    msg.msg_iovlen = 2 * nbSegments;
+    if (nbSegments > 1)
+    {
+        struct cmsghdr *cmsg;
+        uint16_t gsoSize = (uint16_t)segmentSize;
+        memset (&control, 0, sizeof (control));
+        msg.msg_control = control.buffer;
+        msg.msg_controllen = sizeof (control.buffer);
+        cmsg = CMSG_FIRSTHDR (&msg);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN (sizeof (uint16_t));
+        memcpy (CMSG_DATA (cmsg), &gsoSize, sizeof (uint16_t));
+    }
+
+    return (sendmsg (transport->socket, &msg, 0) < 0) ? -1 : nbSegments;
+}
+#endif
+
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData)
+{
+    ARSTREAM_UDPTransport_t *transport = (ARSTREAM_UDPTransport_t *)context;
+    ssize_t sentSize;
+
+    /* The channel is implied by the role of the endpoint */
+    (void)channel;
+
+    do
+    {
+        sentSize = send (transport->socket, data, size, 0);
+    } while ((sentSize < 0) && (errno == EINTR));
+
+    if (sentSize < 0)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Error while sending data : %s", strerror (errno));
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    if (callback != NULL)
+    {
+        callback (callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_SENT);
+    }
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs)
+{
+    eARSTREAM_ERROR retVal;
+    uint8_t *data = NULL;
+    uint32_t dataSize = 0;
+
+    retVal = ARSTREAM_UDPTransport_ReceiveBegin (context, channel, &data, &dataSize, timeoutMs);
+    if (retVal == ARSTREAM_OK)
+    {
+        if (dataSize <= bufferSize)
+        {
+            memcpy (buffer, data, dataSize);
+            *receivedSize = dataSize;
+        }
+        else
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Received %d bytes, which does not fit in a %d bytes buffer", dataSize, bufferSize);
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+        }
+        ARSTREAM_UDPTransport_ReceiveEnd (context, channel);
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets)
+{
+    ARSTREAM_UDPTransport_t *transport = (ARSTREAM_UDPTransport_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    int nbSent = 0;
+    int i;
+
+    (void)channel;
+
+    while ((nbSent < nbPackets) &&
+           (retVal == ARSTREAM_OK))
+    {
+        int res;
+        int usedGso = 0;
+#ifdef ARSTREAM_UDP_TRANSPORT_HAS_OFFLOAD
+        if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_GSO) != 0)
+        {
+            usedGso = 1;
+            res = ARSTREAM_UDPTransport_SendSegments (transport, &packets [nbSent], nbPackets - nbSent);
+        }
+        else
+#endif
+#ifdef HAVE_SENDMMSG
+        if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_BATCH) != 0)
+        {
+            res = ARSTREAM_UDPTransport_SendBatch (transport, &packets [nbSent], nbPackets - nbSent);
+        }
+        else
+#endif
+        {
+            res = ARSTREAM_UDPTransport_SendOne (transport, &packets [nbSent], nbPackets - nbSent);
+        }
+
+        if (res > 0)
+        {
+            /* Partial sends are retried from the first unsent packet */
+            nbSent += res;
+        }
+        else if (res == 0)
+        {
+            /* Nothing was sent and errno is not set : retrying would loop on the same packets */
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Error while sending %d packets : no packet was sent", nbPackets - nbSent);
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+        }
+        else if (errno == EINTR)
+        {
+            /* Retry */
+        }
+        else if ((usedGso == 1) &&
+                 ((errno == EIO) || (errno == ENOPROTOOPT) || (errno == EOPNOTSUPP)))
+        {
+            /* The output device can not segment (e.g. no checksum offload) : fall back to the regular path.
+             * Other errors (EINVAL for a bad segment size, ...) are reported, and GSO stays enabled */
+            ARSTREAM_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_UDP_TRANSPORT_TAG, "GSO send failed (%s), disabling GSO", strerror (errno));
+            transport->flags &= ~ARSTREAM_TRANSPORT_UDP_FLAG_GSO;
+        }
+        else
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Error while sending %d packets : %s", nbPackets - nbSent, strerror (errno));
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    for (i = 0; i < nbPackets; i++)
+    {
+        if (packets [i].callback != NULL)
+        {
+            packets [i].callback (packets [i].callbackData, (i < nbSent) ? ARSTREAM_TRANSPORT_SEND_STATUS_SENT : ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+        }
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs)
+{
+    ARSTREAM_UDPTransport_t *transport = (ARSTREAM_UDPTransport_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+
+    (void)channel;
+
+    if (transport->readPacket >= transport->nbPackets)
+    {
+        retVal = ARSTREAM_UDPTransport_FillPackets (transport, timeoutMs);
+    }
+
+    if (retVal == ARSTREAM_OK)
+    {
+        *data = transport->packets [transport->readPacket];
+        *receivedSize = transport->packetsSize [transport->readPacket];
+    }
+    return retVal;
+}
+
+static void ARSTREAM_UDPTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    ARSTREAM_UDPTransport_t *transport = (ARSTREAM_UDPTransport_t *)context;
+    (void)channel;
+    transport->readPacket++;
+}
+static eARSTREAM_ERROR ARSTREAM_UDPTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    /* Packets are given to the kernel at once, so there is never anything to flush */
+    (void)context;
+    (void)channel;
+    return ARSTREAM_OK;
+}
+
+static int ARSTREAM_UDPTransport_GetEstimatedLatency (void *context)
+{
+    /* Raw UDP has no RTT estimation */
+    (void)context;
+    return -1;
+}
+
+static void ARSTREAM_UDPTransport_Destroy (void *context)
+{
+    ARSTREAM_UDPTransport_t *transport = (ARSTREAM_UDPTransport_t *)context;
+    if (transport != NULL)
+    {
+        if (transport->socket >= 0)
+        {
+            close (transport->socket);
+        }
+        free (transport->buffers);
+        free (transport);
+    }
+}
+
+/*
+ * Implementation
+ */
+
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewUDP (const char *remoteAddress, int localPort, int remotePort, uint32_t maxFragmentSize, uint32_t flags, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Transport_t *retTransport = NULL;
+    ARSTREAM_UDPTransport_t *transport = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    struct sockaddr_in localAddr;
+    struct sockaddr_in remoteAddr;
+    /* ARGS Check */
+    if ((remoteAddress == NULL) ||
+        (localPort <= 0) ||
+        (remotePort <= 0) ||
+        (maxFragmentSize == 0))
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    memset (&remoteAddr, 0, sizeof (remoteAddr));
+    remoteAddr.sin_family = AF_INET;
+    remoteAddr.sin_port = htons (remotePort);
+    if (inet_pton (AF_INET, remoteAddress, &remoteAddr.sin_addr) != 1)
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    /* Alloc new context */
+    transport = calloc (1, sizeof (ARSTREAM_UDPTransport_t));
+    if (transport == NULL)
+    {
+        internalError = ARSTREAM_ERROR_ALLOC;
+    }
+    else
+    {
+        transport->socket = -1;
+    }
+
+    /* Open the socket */
+    if (internalError == ARSTREAM_OK)
+    {
+        int bufSize = ARSTREAM_UDP_TRANSPORT_SOCKET_BUFFER_SIZE;
+        transport->socket = socket (AF_INET, SOCK_DGRAM, 0);
+        if (transport->socket < 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Unable to create socket : %s", strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+        else
+        {
+            /* Not fatal : the default sizes only make bursts more likely to be dropped */
+            if (setsockopt (transport->socket, SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof (bufSize)) != 0)
+            {
+                ARSTREAM_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_UDP_TRANSPORT_TAG, "Unable to set the socket receive buffer size : %s", strerror (errno));
+            }
+            if (setsockopt (transport->socket, SOL_SOCKET, SO_SNDBUF, &bufSize, sizeof (bufSize)) != 0)
+            {
+                ARSTREAM_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_UDP_TRANSPORT_TAG, "Unable to set the socket send buffer size : %s", strerror (errno));
+            }
+        }
+    }
+
+    /* Keep only the features supported by the system */
+    if (internalError == ARSTREAM_OK)
+    {
+        transport->flags = flags;
+#if !defined (HAVE_SENDMMSG) && !defined (HAVE_RECVMMSG)
+        transport->flags &= ~ARSTREAM_TRANSPORT_UDP_FLAG_BATCH;
+#endif
+#ifdef ARSTREAM_UDP_TRANSPORT_HAS_OFFLOAD
+        if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_GSO) != 0)
+        {
+            int gsoSize = 0;
+            socklen_t gsoSizeLen = sizeof (gsoSize);
+            if (getsockopt (transport->socket, SOL_UDP, UDP_SEGMENT, &gsoSize, &gsoSizeLen) != 0)
+            {
+                ARSTREAM_PRINT (ARSAL_PRINT_INFO, ARSTREAM_UDP_TRANSPORT_TAG, "GSO is not supported : %s", strerror (errno));
+                transport->flags &= ~ARSTREAM_TRANSPORT_UDP_FLAG_GSO;
+            }
+        }
+        if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_GRO) != 0)
+        {
+            int enable = 1;
+            if (setsockopt (transport->socket, SOL_UDP, UDP_GRO, &enable, sizeof (enable)) != 0)
+            {
+                ARSTREAM_PRINT (ARSAL_PRINT_INFO, ARSTREAM_UDP_TRANSPORT_TAG, "GRO is not supported : %s", strerror (errno));
+                transport->flags &= ~ARSTREAM_TRANSPORT_UDP_FLAG_GRO;
+            }
+        }
+#else
+        transport->flags &= ~(ARSTREAM_TRANSPORT_UDP_FLAG_GSO | ARSTREAM_TRANSPORT_UDP_FLAG_GRO);
+#endif
+    }
+
+    /* Alloc the receive buffers, large enough for data fragments and ack packets, or for coalesced bursts */
+    if (internalError == ARSTREAM_OK)
+    {
+        if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_GRO) != 0)
+        {
+            transport->bufferSize = ARSTREAM_UDP_TRANSPORT_GSO_MAX_SIZE;
+            transport->nbBuffers = ARSTREAM_UDP_TRANSPORT_NB_GRO_BUFFERS;
+        }
+        else
+        {
+            transport->bufferSize = maxFragmentSize + sizeof (ARSTREAM_NetworkHeaders_DataHeader_t) + sizeof (ARSTREAM_NetworkHeaders_TimestampExtension_t);
+            if (transport->bufferSize < sizeof (ARSTREAM_NetworkHeaders_AckPacket_t))
+            {
+                transport->bufferSize = sizeof (ARSTREAM_NetworkHeaders_AckPacket_t);
+            }
+            transport->nbBuffers = ARSTREAM_UDP_TRANSPORT_NB_SLOTS;
+        }
+#ifdef HAVE_RECVMMSG
+        if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_BATCH) == 0)
+        {
+            transport->nbBuffers = 1;
+        }
+#else
+        transport->nbBuffers = 1;
+#endif
+        transport->buffers = malloc (transport->nbBuffers * transport->bufferSize);
+        if (transport->buffers == NULL)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+    }
+
+#ifdef HAVE_RECVMMSG
+    if (internalError == ARSTREAM_OK)
+    {
+        int i;
+        for (i = 0; i < transport->nbBuffers; i++)
+        {
+            transport->recvIovecs [i].iov_base = &transport->buffers [i * transport->bufferSize];
+            transport->recvIovecs [i].iov_len = transport->bufferSize;
+            transport->recvMsgs [i].msg_hdr.msg_iov = &transport->recvIovecs [i];
+            transport->recvMsgs [i].msg_hdr.msg_iovlen = 1;
+            if ((transport->flags & ARSTREAM_TRANSPORT_UDP_FLAG_GRO) != 0)
+            {
+                transport->recvMsgs [i].msg_hdr.msg_control = transport->control [i];
+            }
+        }
+    }
+#endif
+
+    /* Bind and connect the socket */
+    if (internalError == ARSTREAM_OK)
+    {
+        memset (&localAddr, 0, sizeof (localAddr));
+        localAddr.sin_family = AF_INET;
+        localAddr.sin_port = htons (localPort);
+        localAddr.sin_addr.s_addr = htonl (INADDR_ANY);
+        if (bind (transport->socket, (struct sockaddr *)&localAddr, sizeof (localAddr)) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Unable to bind socket to port %d : %s", localPort, strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (connect (transport->socket, (struct sockaddr *)&remoteAddr, sizeof (remoteAddr)) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_UDP_TRANSPORT_TAG, "Unable to connect socket to %s:%d : %s", remoteAddress, remotePort, strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        retTransport = ARSTREAM_Transport_New (&ARSTREAM_UDPTransport_Ops, transport, &internalError);
+    }
+
+    if (internalError != ARSTREAM_OK)
+    {
+        ARSTREAM_UDPTransport_Destroy (transport);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retTransport;
+}
@@ -0,0 +1,1045 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_URing.c
+ * @brief io_uring event loop shared by many stream transports
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#include <config.h>
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifdef HAVE_LIBURING
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <liburing.h>
+#endif
+
+/*
+ * Private Headers
+ */
+
+#include "ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARStream/ARSTREAM_URing.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Mutex.h>
+
+/*
+ * Macros
+ */
+
+#define ARSTREAM_URING_TAG "ARSTREAM_URing"
+
+/**
+ * Number of receive requests kept in flight by each transport
+ */
+#define ARSTREAM_URING_NB_RECEIVE_SLOTS (32)
+
+/**
+ * Extra byte at the end of each buffer : a read on a UDP socket gives no MSG_TRUNC, so the receives
+ * ask for one more byte than the buffer size, and a datagram which fills it is known to be too large
+ */
+#define ARSTREAM_URING_SPARE_SIZE (1)
+
+/**
+ * Maximum number of completions reaped at once
+ */
+#define ARSTREAM_URING_CQE_BATCH (64)
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+#ifdef HAVE_LIBURING
+
+/*
+ * Types
+ */
+
+typedef struct ARSTREAM_URingTransport_t ARSTREAM_URingTransport_t;
+
+typedef enum {
+    ARSTREAM_URING_OP_NONE = 0,
+    ARSTREAM_URING_OP_SEND,
+    ARSTREAM_URING_OP_RECEIVE,
+} eARSTREAM_URING_OP;
+
+/**
+ * @brief A registered buffer, and the request which uses it
+ */
+typedef struct ARSTREAM_URing_Slot_t {
+    ARSTREAM_URingTransport_t *transport;
+    eARSTREAM_URING_OP op;
+    uint8_t *data;
+    uint32_t size;
+    ARSTREAM_Transport_SendCallback_t callback;
+    void *callbackData;
+    struct ARSTREAM_URing_Slot_t *next; /**< Next slot of a batch being filled by ARSTREAM_URingTransport_SendPackets */
+} ARSTREAM_URing_Slot_t;
+
+struct ARSTREAM_URing_t {
+    struct io_uring ring;
+    int ringWasInit;
+    int eventFd;
+    uint64_t eventValue;
+
+    /* Registered buffers */
+    uint8_t *buffers;
+    uint32_t bufferSize;
+    uint32_t bufferStride; /* bufferSize plus the spare byte */
+    uint32_t nbBuffers;
+    ARSTREAM_URing_Slot_t *slots;
+
+    /* Free slots, and slots waiting to be submitted by the event loop. Protected by the mutex */
+    ARSAL_Mutex_t mutex;
+    ARSTREAM_URing_Slot_t **freeSlots;
+    uint32_t nbFreeSlots;
+    ARSTREAM_URing_Slot_t **pendingSlots;
+    uint32_t nbPendingSlots;
+    int nbTransports;
+
+    int threadStarted;
+    int threadShouldStop;
+};
+
+struct ARSTREAM_URingTransport_t {
+    ARSTREAM_URing_t *ring;
+    int socket;
+
+    /* Received slots, waiting to be read by the stream thread. Protected by the mutex */
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t cond;
+    ARSTREAM_URing_Slot_t *readySlots [ARSTREAM_URING_NB_RECEIVE_SLOTS];
+    uint32_t readyIndex;
+    uint32_t nbReadySlots;
+    ARSTREAM_URing_Slot_t *borrowedSlot;
+    int nbOwnedSlots;
+    int closing;
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Takes a free registered buffer
+ * @param ring The ring
+ * @param transport The transport which will use the slot
+ * @param op The request which will use the slot
+ * @return A slot, or NULL if all the buffers are in use
+ */
+static ARSTREAM_URing_Slot_t* ARSTREAM_URing_AllocSlot (ARSTREAM_URing_t *ring, ARSTREAM_URingTransport_t *transport, eARSTREAM_URING_OP op);
+
+/**
+ * @brief Gives a slot back to the free list, and wakes up a closing transport when its last slot is released
+ * @param ring The ring
+ * @param slot The slot to release
+ */
+static void ARSTREAM_URing_FreeSlot (ARSTREAM_URing_t *ring, ARSTREAM_URing_Slot_t *slot);
+
+/**
+ * @brief Queues a slot for submission by the event loop
+ * The event loop is only woken up when the pending list was empty, so a burst of requests costs one wake up
+ * @param ring The ring
+ * @param slot The slot to submit
+ */
+static void ARSTREAM_URing_Submit (ARSTREAM_URing_t *ring, ARSTREAM_URing_Slot_t *slot);
+
+/**
+ * @brief Wakes up the event loop
+ * @param ring The ring
+ */
+static void ARSTREAM_URing_Wakeup (ARSTREAM_URing_t *ring);
+
+/**
+ * @brief Prepares the SQEs of all the pending slots (event loop thread only)
+ * @param ring The ring
+ */
+static void ARSTREAM_URing_PrepPending (ARSTREAM_URing_t *ring);
+
+/**
+ * @brief Handles a completion (event loop thread only)
+ * @param ring The ring
+ * @param slot The completed slot
+ * @param res The result of the request
+ */
+static void ARSTREAM_URing_Complete (ARSTREAM_URing_t *ring, ARSTREAM_URing_Slot_t *slot, int res);
+
+static eARSTREAM_ERROR ARSTREAM_URingTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData);
+static eARSTREAM_ERROR ARSTREAM_URingTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs);
+static eARSTREAM_ERROR ARSTREAM_URingTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets);
+static eARSTREAM_ERROR ARSTREAM_URingTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs);
+static void ARSTREAM_URingTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static eARSTREAM_ERROR ARSTREAM_URingTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel);
+static int ARSTREAM_URingTransport_GetEstimatedLatency (void *context);
+static void ARSTREAM_URingTransport_Destroy (void *context);
+
+/*
+ * Internal functions implementation
+ */
+
+static const ARSTREAM_Transport_Ops_t ARSTREAM_URingTransport_Ops = {
+    .send = ARSTREAM_URingTransport_Send,
+    .receive = ARSTREAM_URingTransport_Receive,
+    .sendPackets = ARSTREAM_URingTransport_SendPackets,
+    .receiveBegin = ARSTREAM_URingTransport_ReceiveBegin,
+    .receiveEnd = ARSTREAM_URingTransport_ReceiveEnd,
+    .flush = ARSTREAM_URingTransport_Flush,
+    .getEstimatedLatency = ARSTREAM_URingTransport_GetEstimatedLatency,
+    .destroy = ARSTREAM_URingTransport_Destroy,
+};
+
+static ARSTREAM_URing_Slot_t* ARSTREAM_URing_AllocSlot (ARSTREAM_URing_t *ring, ARSTREAM_URingTransport_t *transport, eARSTREAM_URING_OP op)
+{
+    ARSTREAM_URing_Slot_t *slot = NULL;
+    ARSAL_Mutex_Lock (&(ring->mutex));
+    if (ring->nbFreeSlots > 0)
+    {
+        ring->nbFreeSlots--;
+        slot = ring->freeSlots [ring->nbFreeSlots];
+    }
+    ARSAL_Mutex_Unlock (&(ring->mutex));
+
+    if (slot != NULL)
+    {
+        slot->transport = transport;
+        slot->op = op;
+        slot->size = 0;
+        slot->callback = NULL;
+        slot->callbackData = NULL;
+        ARSAL_Mutex_Lock (&(transport->mutex));
+        transport->nbOwnedSlots++;
+        ARSAL_Mutex_Unlock (&(transport->mutex));
+    }
+    return slot;
+}
+
+static void ARSTREAM_URing_FreeSlot (ARSTREAM_URing_t *ring, ARSTREAM_URing_Slot_t *slot)
+{
+    ARSTREAM_URingTransport_t *transport = slot->transport;
+
+    slot->transport = NULL;
+    slot->op = ARSTREAM_URING_OP_NONE;
+    ARSAL_Mutex_Lock (&(ring->mutex));
+    ring->freeSlots [ring->nbFreeSlots] = slot;
+    ring->nbFreeSlots++;
+    ARSAL_Mutex_Unlock (&(ring->mutex));
+
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    transport->nbOwnedSlots--;
+    if ((transport->closing == 1) &&
+        (transport->nbOwnedSlots == 0))
+    {
+        ARSAL_Cond_Signal (&(transport->cond));
+    }
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+}
+
+static void ARSTREAM_URing_Submit (ARSTREAM_URing_t *ring, ARSTREAM_URing_Slot_t *slot)
+{
+    int wasEmpty;
+    ARSAL_Mutex_Lock (&(ring->mutex));
+    wasEmpty = (ring->nbPendingSlots == 0) ? 1 : 0;
+    ring->pendingSlots [ring->nbPendingSlots] = slot;
+    ring->nbPendingSlots++;
+    ARSAL_Mutex_Unlock (&(ring->mutex));
+
+    if (wasEmpty == 1)
+    {
+        ARSTREAM_URing_Wakeup (ring);
+    }
+}
+
+static void ARSTREAM_URing_Wakeup (ARSTREAM_URing_t *ring)
+{
+    uint64_t value = 1;
+    if (write (ring->eventFd, &value, sizeof (value)) < 0)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Unable to wake up the event loop : %s", strerror (errno));
+    }
+}
+
+static void ARSTREAM_URing_PrepPending (ARSTREAM_URing_t *ring)
+{
+    uint32_t i;
+    ARSAL_Mutex_Lock (&(ring->mutex));
+    for (i = 0; i < ring->nbPendingSlots; i++)
+    {
+        ARSTREAM_URing_Slot_t *slot = ring->pendingSlots [i];
+        struct io_uring_sqe *sqe = io_uring_get_sqe (&(ring->ring));
+        if (sqe == NULL)
+        {
+            /* Submission queue full : push what we have, then retry */
+            io_uring_submit (&(ring->ring));
+            sqe = io_uring_get_sqe (&(ring->ring));
+        }
+        if (sqe == NULL)
+        {
+            /* Keep the remaining slots for the next loop */
+            memmove (ring->pendingSlots, &(ring->pendingSlots [i]), (ring->nbPendingSlots - i) * sizeof (ARSTREAM_URing_Slot_t *));
+            ring->nbPendingSlots -= i;
+            ARSAL_Mutex_Unlock (&(ring->mutex));
+            return;
+        }
+
+        if (slot->op == ARSTREAM_URING_OP_SEND)
+        {
+            io_uring_prep_write_fixed (sqe, slot->transport->socket, slot->data, slot->size, 0, 0);
+        }
+        else
+        {
+            io_uring_prep_read_fixed (sqe, slot->transport->socket, slot->data, ring->bufferSize + ARSTREAM_URING_SPARE_SIZE, 0, 0);
+        }
+        io_uring_sqe_set_data (sqe, slot);
+    }
+    ring->nbPendingSlots = 0;
+    ARSAL_Mutex_Unlock (&(ring->mutex));
+}
+
+static void ARSTREAM_URing_Complete (ARSTREAM_URing_t *ring, ARSTREAM_URing_Slot_t *slot, int res)
+{
+    ARSTREAM_URingTransport_t *transport = slot->transport;
+    int closing;
+
+    if (slot->op == ARSTREAM_URING_OP_SEND)
+    {
+        if (slot->callback != NULL)
+        {
+            slot->callback (slot->callbackData, (res >= 0) ? ARSTREAM_TRANSPORT_SEND_STATUS_SENT : ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+        }
+        ARSTREAM_URing_FreeSlot (ring, slot);
+        return;
+    }
+
+    if (res > (int)ring->bufferSize)
+    {
+        /* The datagram was truncated : delivering it would corrupt the frame */
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Dropping a packet larger than the %d bytes buffers", ring->bufferSize);
+        res = 0;
+    }
+
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    closing = transport->closing;
+    if ((closing == 0) &&
+        (res > 0))
+    {
+        uint32_t index = (transport->readyIndex + transport->nbReadySlots) % ARSTREAM_URING_NB_RECEIVE_SLOTS;
+        slot->size = res;
+        transport->readySlots [index] = slot;
+        transport->nbReadySlots++;
+        ARSAL_Cond_Signal (&(transport->cond));
+    }
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+
+    if (closing == 1)
+    {
+        ARSTREAM_URing_FreeSlot (ring, slot);
+    }
+    else if (res <= 0)
+    {
+        /* Empty or truncated datagram, or transient error (e.g. ICMP port unreachable on the connected socket) : read again */
+        ARSTREAM_URing_Submit (ring, slot);
+    }
+}
+
+static eARSTREAM_ERROR ARSTREAM_URingTransport_Send (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *data, uint32_t size, ARSTREAM_Transport_SendCallback_t callback, void *callbackData)
+{
+    ARSTREAM_URingTransport_t *transport = (ARSTREAM_URingTransport_t *)context;
+    ARSTREAM_URing_Slot_t *slot;
+
+    (void)channel;
+
+    if (size > transport->ring->bufferSize)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Packet of %d bytes is larger than the %d bytes buffers", size, transport->ring->bufferSize);
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+    slot = ARSTREAM_URing_AllocSlot (transport->ring, transport, ARSTREAM_URING_OP_SEND);
+    if (slot == NULL)
+    {
+        return ARSTREAM_ERROR_TRANSPORT;
+    }
+
+    memcpy (slot->data, data, size);
+    slot->size = size;
+    slot->callback = callback;
+    slot->callbackData = callbackData;
+    ARSTREAM_URing_Submit (transport->ring, slot);
+    return ARSTREAM_OK;
+}
+
+static eARSTREAM_ERROR ARSTREAM_URingTransport_Receive (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t *buffer, uint32_t bufferSize, uint32_t *receivedSize, int timeoutMs)
+{
+    eARSTREAM_ERROR retVal;
+    uint8_t *data = NULL;
+    uint32_t dataSize = 0;
+
+    retVal = ARSTREAM_URingTransport_ReceiveBegin (context, channel, &data, &dataSize, timeoutMs);
+    if (retVal == ARSTREAM_OK)
+    {
+        if (dataSize <= bufferSize)
+        {
+            memcpy (buffer, data, dataSize);
+            *receivedSize = dataSize;
+        }
+        else
+        {
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+        }
+        ARSTREAM_URingTransport_ReceiveEnd (context, channel);
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_URingTransport_SendPackets (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, ARSTREAM_Transport_Packet_t *packets, int nbPackets)
+{
+    ARSTREAM_URingTransport_t *transport = (ARSTREAM_URingTransport_t *)context;
+    ARSTREAM_URing_t *ring = transport->ring;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+    ARSTREAM_URing_Slot_t *first = NULL;
+    ARSTREAM_URing_Slot_t **last = &first;
+    int wasEmpty;
+    int i;
+
+    (void)channel;
+
+    /* Copy all the packets into registered buffers, then queue them with a single wake up */
+    for (i = 0; i < nbPackets; i++)
+    {
+        ARSTREAM_Transport_Packet_t *packet = &packets [i];
+        ARSTREAM_URing_Slot_t *slot = NULL;
+        if (packet->headerSize + packet->payloadSize <= ring->bufferSize)
+        {
+            slot = ARSTREAM_URing_AllocSlot (ring, transport, ARSTREAM_URING_OP_SEND);
+        }
+        else
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Packet of %d bytes is larger than the %d bytes buffers", packet->headerSize + packet->payloadSize, ring->bufferSize);
+        }
+        if (slot == NULL)
+        {
+            if (packet->callback != NULL)
+            {
+                packet->callback (packet->callbackData, ARSTREAM_TRANSPORT_SEND_STATUS_CANCEL);
+            }
+            retVal = ARSTREAM_ERROR_TRANSPORT;
+            continue;
+        }
+
+        memcpy (slot->data, packet->header, packet->headerSize);
+        memcpy (&(slot->data [packet->headerSize]), packet->payload, packet->payloadSize);
+        slot->size = packet->headerSize + packet->payloadSize;
+        slot->callback = packet->callback;
+        slot->callbackData = packet->callbackData;
+        slot->next = NULL;
+        *last = slot;
+        last = &(slot->next);
+    }
+
+    if (first == NULL)
+    {
+        return retVal;
+    }
+
+    /* The whole batch is appended in the same critical section that checks for an empty list,
+     * so that the event loop can not go back to sleep between the check and the append */
+    ARSAL_Mutex_Lock (&(ring->mutex));
+    wasEmpty = (ring->nbPendingSlots == 0) ? 1 : 0;
+    while (first != NULL)
+    {
+        ring->pendingSlots [ring->nbPendingSlots] = first;
+        ring->nbPendingSlots++;
+        first = first->next;
+    }
+    ARSAL_Mutex_Unlock (&(ring->mutex));
+
+    if (wasEmpty == 1)
+    {
+        ARSTREAM_URing_Wakeup (ring);
+    }
+    return retVal;
+}
+
+static eARSTREAM_ERROR ARSTREAM_URingTransport_ReceiveBegin (void *context, eARSTREAM_TRANSPORT_CHANNEL channel, uint8_t **data, uint32_t *receivedSize, int timeoutMs)
+{
+    ARSTREAM_URingTransport_t *transport = (ARSTREAM_URingTransport_t *)context;
+    eARSTREAM_ERROR retVal = ARSTREAM_OK;
+
+    (void)channel;
+
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    if (transport->nbReadySlots == 0)
+    {
+        ARSAL_Cond_Timedwait (&(transport->cond), &(transport->mutex), timeoutMs);
+    }
+    if (transport->nbReadySlots > 0)
+    {
+        transport->borrowedSlot = transport->readySlots [transport->readyIndex];
+        transport->readyIndex = (transport->readyIndex + 1) % ARSTREAM_URING_NB_RECEIVE_SLOTS;
+        transport->nbReadySlots--;
+        *data = transport->borrowedSlot->data;
+        *receivedSize = transport->borrowedSlot->size;
+    }
+    else
+    {
+        retVal = ARSTREAM_ERROR_BUFFER_EMPTY;
+    }
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+    return retVal;
+}
+
+static void ARSTREAM_URingTransport_ReceiveEnd (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    ARSTREAM_URingTransport_t *transport = (ARSTREAM_URingTransport_t *)context;
+    ARSTREAM_URing_Slot_t *slot = transport->borrowedSlot;
+
+    (void)channel;
+
+    transport->borrowedSlot = NULL;
+    if (slot != NULL)
+    {
+        /* Give the buffer back to the kernel for the next fragment */
+        ARSTREAM_URing_Submit (transport->ring, slot);
+    }
+}
+
+static eARSTREAM_ERROR ARSTREAM_URingTransport_Flush (void *context, eARSTREAM_TRANSPORT_CHANNEL channel)
+{
+    /* Submitted requests can not be recalled */
+    (void)context;
+    (void)channel;
+    return ARSTREAM_OK;
+}
+
+static int ARSTREAM_URingTransport_GetEstimatedLatency (void *context)
+{
+    (void)context;
+    return -1;
+}
+
+static void ARSTREAM_URingTransport_Destroy (void *context)
+{
+    ARSTREAM_URingTransport_t *transport = (ARSTREAM_URingTransport_t *)context;
+    ARSTREAM_URing_t *ring;
+    if (transport == NULL)
+    {
+        return;
+    }
+    ring = transport->ring;
+
+    /* Release the received slots, then wake the in-flight reads up, so that the event loop releases their slots */
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    transport->closing = 1;
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+    while (transport->nbReadySlots > 0)
+    {
+        ARSTREAM_URing_FreeSlot (ring, transport->readySlots [transport->readyIndex]);
+        transport->readyIndex = (transport->readyIndex + 1) % ARSTREAM_URING_NB_RECEIVE_SLOTS;
+        transport->nbReadySlots--;
+    }
+    if (transport->borrowedSlot != NULL)
+    {
+        ARSTREAM_URing_FreeSlot (ring, transport->borrowedSlot);
+        transport->borrowedSlot = NULL;
+    }
+    if (transport->socket >= 0)
+    {
+        shutdown (transport->socket, SHUT_RDWR);
+    }
+
+    ARSAL_Mutex_Lock (&(transport->mutex));
+    while (transport->nbOwnedSlots > 0)
+    {
+        ARSAL_Cond_Wait (&(transport->cond), &(transport->mutex));
+    }
+    ARSAL_Mutex_Unlock (&(transport->mutex));
+
+    if (transport->socket >= 0)
+    {
+        close (transport->socket);
+    }
+    ARSAL_Cond_Destroy (&(transport->cond));
+    ARSAL_Mutex_Destroy (&(transport->mutex));
+
+    ARSAL_Mutex_Lock (&(ring->mutex));
+    ring->nbTransports--;
+    ARSAL_Mutex_Unlock (&(ring->mutex));
+    free (transport);
+}
+
+#endif /* HAVE_LIBURING */
+
+/*
+ * Implementation
+ */
+
+#ifdef HAVE_LIBURING
+
+ARSTREAM_URing_t* ARSTREAM_URing_New (uint32_t nbBuffers, uint32_t bufferSize, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_URing_t *retRing = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    int mutexWasInit = 0;
+    /* ARGS Check */
+    if ((nbBuffers == 0) ||
+        (bufferSize == 0) ||
+        (bufferSize >= (uint32_t)INT32_MAX))
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retRing;
+    }
+
+    /* Alloc new ring */
+    retRing = calloc (1, sizeof (ARSTREAM_URing_t));
+    if (retRing == NULL)
+    {
+        internalError = ARSTREAM_ERROR_ALLOC;
+    }
+    else
+    {
+        retRing->eventFd = -1;
+        retRing->bufferSize = bufferSize;
+        retRing->bufferStride = bufferSize + ARSTREAM_URING_SPARE_SIZE;
+        retRing->nbBuffers = nbBuffers;
+    }
+
+    /* Alloc the buffers and the slot lists */
+    if (internalError == ARSTREAM_OK)
+    {
+        retRing->buffers = malloc ((size_t)nbBuffers * retRing->bufferStride);
+        retRing->slots = calloc (nbBuffers, sizeof (ARSTREAM_URing_Slot_t));
+        retRing->freeSlots = malloc (nbBuffers * sizeof (ARSTREAM_URing_Slot_t *));
+        retRing->pendingSlots = malloc (nbBuffers * sizeof (ARSTREAM_URing_Slot_t *));
+        if ((retRing->buffers == NULL) ||
+            (retRing->slots == NULL) ||
+            (retRing->freeSlots == NULL) ||
+            (retRing->pendingSlots == NULL))
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            uint32_t i;
+            for (i = 0; i < nbBuffers; i++)
+            {
+                retRing->slots [i].data = &(retRing->buffers [(size_t)i * retRing->bufferStride]);
+                retRing->freeSlots [i] = &(retRing->slots [i]);
+            }
+            retRing->nbFreeSlots = nbBuffers;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Mutex_Init (&(retRing->mutex)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            mutexWasInit = 1;
+        }
+    }
+
+    /* Create the ring, with room for all the buffers in flight, and register the buffers */
+    if (internalError == ARSTREAM_OK)
+    {
+        int ret = io_uring_queue_init (nbBuffers + 1, &(retRing->ring), 0);
+        if (ret < 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Unable to create the io_uring : %s", strerror (-ret));
+            internalError = (ret == -ENOSYS) ? ARSTREAM_ERROR_NOT_SUPPORTED : ARSTREAM_ERROR_TRANSPORT;
+        }
+        else
+        {
+            retRing->ringWasInit = 1;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        struct iovec iov;
+        int ret;
+        iov.iov_base = retRing->buffers;
+        iov.iov_len = (size_t)nbBuffers * retRing->bufferStride;
+        ret = io_uring_register_buffers (&(retRing->ring), &iov, 1);
+        if (ret < 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Unable to register the buffers : %s", strerror (-ret));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        retRing->eventFd = eventfd (0, EFD_CLOEXEC);
+        if (retRing->eventFd < 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Unable to create the wake up event : %s", strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    if ((internalError != ARSTREAM_OK) &&
+        (retRing != NULL))
+    {
+        if (retRing->eventFd >= 0)
+        {
+            close (retRing->eventFd);
+        }
+        if (retRing->ringWasInit == 1)
+        {
+            io_uring_queue_exit (&(retRing->ring));
+        }
+        if (mutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy (&(retRing->mutex));
+        }
+        free (retRing->buffers);
+        free (retRing->slots);
+        free (retRing->freeSlots);
+        free (retRing->pendingSlots);
+        free (retRing);
+        retRing = NULL;
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retRing;
+}
+
+void* ARSTREAM_URing_RunThread (void *ARSTREAM_URing_t_Param)
+{
+    ARSTREAM_URing_t *ring = (ARSTREAM_URing_t *)ARSTREAM_URing_t_Param;
+    struct io_uring_cqe *cqes [ARSTREAM_URING_CQE_BATCH];
+    int eventArmed = 0;
+
+    if (ring == NULL)
+    {
+        ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Error while starting %s, bad parameters", __FUNCTION__);
+        return (void *)0;
+    }
+
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_URING_TAG, "Event loop running");
+    ring->threadStarted = 1;
+
+    while (ring->threadShouldStop == 0)
+    {
+        unsigned nbCqes;
+        unsigned i;
+        int ret;
+
+        /* The wake up event completes as a read on the eventfd, re-arm it after each wake up */
+        if (eventArmed == 0)
+        {
+            struct io_uring_sqe *sqe = io_uring_get_sqe (&(ring->ring));
+            if (sqe != NULL)
+            {
+                io_uring_prep_read (sqe, ring->eventFd, &(ring->eventValue), sizeof (ring->eventValue), 0);
+                io_uring_sqe_set_data (sqe, ring);
+                eventArmed = 1;
+            }
+        }
+
+        ARSTREAM_URing_PrepPending (ring);
+
+        /* Submit all the new requests and wait for completions in a single system call */
+        ret = io_uring_submit_and_wait (&(ring->ring), 1);
+        if ((ret < 0) &&
+            (ret != -EINTR))
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Error while waiting for completions : %s", strerror (-ret));
+        }
+
+        nbCqes = io_uring_peek_batch_cqe (&(ring->ring), cqes, ARSTREAM_URING_CQE_BATCH);
+        for (i = 0; i < nbCqes; i++)
+        {
+            void *data = io_uring_cqe_get_data (cqes [i]);
+            if (data == ring)
+            {
+                eventArmed = 0;
+            }
+            else if (data != NULL)
+            {
+                ARSTREAM_URing_Complete (ring, (ARSTREAM_URing_Slot_t *)data, cqes [i]->res);
+            }
+        }
+        io_uring_cq_advance (&(ring->ring), nbCqes);
+    }
+
+    ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, ARSTREAM_URING_TAG, "Event loop ended");
+    ring->threadStarted = 0;
+    return (void *)0;
+}
+
+void ARSTREAM_URing_Stop (ARSTREAM_URing_t *ring)
+{
+    if (ring != NULL)
+    {
+        ring->threadShouldStop = 1;
+        ARSTREAM_URing_Wakeup (ring);
+    }
+}
+
+eARSTREAM_ERROR ARSTREAM_URing_Delete (ARSTREAM_URing_t **ring)
+{
+    eARSTREAM_ERROR retVal = ARSTREAM_ERROR_BAD_PARAMETERS;
+    if ((ring != NULL) &&
+        (*ring != NULL))
+    {
+        if (((*ring)->threadStarted == 0) &&
+            ((*ring)->nbTransports == 0))
+        {
+            close ((*ring)->eventFd);
+            io_uring_queue_exit (&((*ring)->ring));
+            ARSAL_Mutex_Destroy (&((*ring)->mutex));
+            free ((*ring)->buffers);
+            free ((*ring)->slots);
+            free ((*ring)->freeSlots);
+            free ((*ring)->pendingSlots);
+            free (*ring);
+            *ring = NULL;
+            retVal = ARSTREAM_OK;
+        }
+        else
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Delete all the transports and call ARSTREAM_URing_Stop before calling this function");
+            retVal = ARSTREAM_ERROR_BUSY;
+        }
+    }
+    return retVal;
+}
+
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewURing (ARSTREAM_URing_t *ring, const char *remoteAddress, int localPort, int remotePort, eARSTREAM_ERROR *error)
+{
+    ARSTREAM_Transport_t *retTransport = NULL;
+    ARSTREAM_URingTransport_t *transport = NULL;
+    eARSTREAM_ERROR internalError = ARSTREAM_OK;
+    struct sockaddr_in localAddr;
+    struct sockaddr_in remoteAddr;
+    int mutexWasInit = 0;
+    int condWasInit = 0;
+    int i;
+    /* ARGS Check */
+    if ((ring == NULL) ||
+        (remoteAddress == NULL) ||
+        (localPort <= 0) ||
+        (remotePort <= 0))
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    memset (&remoteAddr, 0, sizeof (remoteAddr));
+    remoteAddr.sin_family = AF_INET;
+    remoteAddr.sin_port = htons (remotePort);
+    if (inet_pton (AF_INET, remoteAddress, &remoteAddr.sin_addr) != 1)
+    {
+        SET_WITH_CHECK (error, ARSTREAM_ERROR_BAD_PARAMETERS);
+        return retTransport;
+    }
+
+    /* Alloc new context */
+    transport = calloc (1, sizeof (ARSTREAM_URingTransport_t));
+    if (transport == NULL)
+    {
+        internalError = ARSTREAM_ERROR_ALLOC;
+    }
+    else
+    {
+        transport->ring = ring;
+        transport->socket = -1;
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Mutex_Init (&(transport->mutex)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            mutexWasInit = 1;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (ARSAL_Cond_Init (&(transport->cond)) != 0)
+        {
+            internalError = ARSTREAM_ERROR_ALLOC;
+        }
+        else
+        {
+            condWasInit = 1;
+        }
+    }
+
+    /* Open, bind and connect the socket */
+    if (internalError == ARSTREAM_OK)
+    {
+        transport->socket = socket (AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (transport->socket < 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Unable to create socket : %s", strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        memset (&localAddr, 0, sizeof (localAddr));
+        localAddr.sin_family = AF_INET;
+        localAddr.sin_port = htons (localPort);
+        localAddr.sin_addr.s_addr = htonl (INADDR_ANY);
+        if (bind (transport->socket, (struct sockaddr *)&localAddr, sizeof (localAddr)) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Unable to bind socket to port %d : %s", localPort, strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        if (connect (transport->socket, (struct sockaddr *)&remoteAddr, sizeof (remoteAddr)) != 0)
+        {
+            ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "Unable to connect socket to %s:%d : %s", remoteAddress, remotePort, strerror (errno));
+            internalError = ARSTREAM_ERROR_TRANSPORT;
+        }
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        retTransport = ARSTREAM_Transport_New (&ARSTREAM_URingTransport_Ops, transport, &internalError);
+    }
+
+    if (internalError == ARSTREAM_OK)
+    {
+        ARSAL_Mutex_Lock (&(ring->mutex));
+        ring->nbTransports++;
+        ARSAL_Mutex_Unlock (&(ring->mutex));
+
+        /* Keep receive requests in flight on the socket */
+        for (i = 0; i < ARSTREAM_URING_NB_RECEIVE_SLOTS; i++)
+        {
+            ARSTREAM_URing_Slot_t *slot = ARSTREAM_URing_AllocSlot (ring, transport, ARSTREAM_URING_OP_RECEIVE);
+            if (slot == NULL)
+            {
+                ARSTREAM_PRINT (ARSAL_PRINT_WARNING, ARSTREAM_URING_TAG, "Only %d receive buffers available", i);
+                break;
+            }
+            ARSTREAM_URing_Submit (ring, slot);
+        }
+    }
+    else if (transport != NULL)
+    {
+        if (transport->socket >= 0)
+        {
+            close (transport->socket);
+        }
+        if (condWasInit == 1)
+        {
+            ARSAL_Cond_Destroy (&(transport->cond));
+        }
+        if (mutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy (&(transport->mutex));
+        }
+        free (transport);
+    }
+
+    SET_WITH_CHECK (error, internalError);
+    return retTransport;
+}
+
+#else /* HAVE_LIBURING */
+
+ARSTREAM_URing_t* ARSTREAM_URing_New (uint32_t nbBuffers, uint32_t bufferSize, eARSTREAM_ERROR *error)
+{
+    (void)nbBuffers;
+    (void)bufferSize;
+    ARSTREAM_PRINT (ARSAL_PRINT_ERROR, ARSTREAM_URING_TAG, "libARStream was built without io_uring support");
+    SET_WITH_CHECK (error, ARSTREAM_ERROR_NOT_SUPPORTED);
+    return NULL;
+}
+
+void* ARSTREAM_URing_RunThread (void *ARSTREAM_URing_t_Param)
+{
+    (void)ARSTREAM_URing_t_Param;
+    return (void *)0;
+}
+
+void ARSTREAM_URing_Stop (ARSTREAM_URing_t *ring)
+{
+    (void)ring;
+}
+
+eARSTREAM_ERROR ARSTREAM_URing_Delete (ARSTREAM_URing_t **ring)
+{
+    (void)ring;
+    return ARSTREAM_ERROR_BAD_PARAMETERS;
+}
+
+ARSTREAM_Transport_t* ARSTREAM_Transport_NewURing (ARSTREAM_URing_t *ring, const char *remoteAddress, int localPort, int remotePort, eARSTREAM_ERROR *error)
+{
+    (void)ring;
+    (void)remoteAddress;
+    (void)localPort;
+    (void)remotePort;
+    SET_WITH_CHECK (error, ARSTREAM_ERROR_NOT_SUPPORTED);
+    return NULL;
+}
+
+#endif /* HAVE_LIBURING */
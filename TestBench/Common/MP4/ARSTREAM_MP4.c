@@ -0,0 +1,812 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_MP4.c
+ * @brief Minimal mp4 file reader for the testbenches
+ * The file is memory mapped : frames are handed out as pointers into the mapping, without any copy
+ * The atom tree is indexed in one pass when the file is opened. Sample data (mdat) is never walked
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "ARSTREAM_MP4.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_MP4"
+
+#define ARSTREAM_MP4_ATOM_HEADER_SIZE (8)
+#define ARSTREAM_MP4_WIDE_ATOM_HEADER_SIZE (16)
+
+#define ARSTREAM_MP4_MAX_ATOM_DEPTH (8)
+#define ARSTREAM_MP4_NO_ATOM (-1)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief An atom of the index tree
+ */
+typedef struct {
+    uint32_t type; /**< 4CC of the atom */
+    uint64_t offset; /**< Offset of the atom payload (after its header) in the file */
+    uint64_t size; /**< Size of the atom payload */
+    int firstChild; /**< Index of the first child atom, or ARSTREAM_MP4_NO_ATOM */
+    int nextSibling; /**< Index of the next atom of the same parent, or ARSTREAM_MP4_NO_ATOM */
+} ARSTREAM_MP4_AtomNode_t;
+
+/**
+ * @brief A track of the file, as atoms of the index tree
+ */
+typedef struct {
+    int mdia; /**< Media atom (holds mdhd and hdlr) */
+    int stbl; /**< Sample table atom */
+    uint32_t handler; /**< Handler type of the track (ARSTREAM_MP4_HANDLER_VIDEO ...) */
+} ARSTREAM_MP4_Track_t;
+
+struct ARSTREAM_MP4 {
+    uint8_t *map;
+    size_t mapSize;
+
+    /* Atom index : atoms [0] is the first top level atom */
+    ARSTREAM_MP4_AtomNode_t *atoms;
+    int nbAtoms;
+    int atomsCapacity;
+    ARSTREAM_MP4_Track_t *tracks;
+    int nbTracks;
+    int selectedTrack;
+
+    /* Sample tables of the selected track */
+    int nbFrames;
+    uint32_t maxFrameSize;
+    uint32_t timescale;
+    uint64_t durationUs;
+    uint64_t *framesOffsetArray;
+    uint32_t *framesSizeArray;
+    uint64_t *framesTimeUsArray;
+    uint8_t *framesIsSyncArray;
+};
+
+/**
+ * @brief Location of an atom payload in the mapping
+ */
+typedef struct {
+    const uint8_t *data; /**< First byte after the atom header, NULL if the atom was not found */
+    uint64_t size; /**< Size of the payload (atom size, minus its header) */
+} ARSTREAM_MP4_Payload_t;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Reads a big endian 32 bits value
+ */
+static uint32_t ARSTREAM_MP4_Read32 (const uint8_t *data);
+
+/**
+ * @brief Reads a big endian 64 bits value
+ */
+static uint64_t ARSTREAM_MP4_Read64 (const uint8_t *data);
+
+/**
+ * @brief Tells if the children of an atom must be indexed
+ * @param type 4CC of the atom
+ * @return 1 for the container atoms leading to the sample tables, 0 otherwise
+ */
+static int ARSTREAM_MP4_IsContainer (uint32_t type);
+
+/**
+ * @brief Indexes the atoms of a range of the file, and their children
+ * @param mp4 The file
+ * @param start Offset of the first atom of the range
+ * @param end End of the range (parent payload end, or file size)
+ * @param depth Depth of the range in the atom tree
+ * @return Index of the first atom of the range, ARSTREAM_MP4_NO_ATOM if the range is empty, or -2 on allocation error
+ */
+static int ARSTREAM_MP4_IndexAtoms (ARSTREAM_MP4_t *mp4, uint64_t start, uint64_t end, int depth);
+
+/**
+ * @brief Finds an atom among the children of an indexed atom
+ * @param mp4 The file
+ * @param parent Index of the parent atom, or ARSTREAM_MP4_NO_ATOM for top level atoms
+ * @param atomName 4CC of the atom to find
+ * @return Index of the atom, or ARSTREAM_MP4_NO_ATOM if not found
+ */
+static int ARSTREAM_MP4_FindChild (ARSTREAM_MP4_t *mp4, int parent, const char *atomName);
+
+/**
+ * @brief Gets the payload of an indexed atom
+ * @param mp4 The file
+ * @param atom Index of the atom, or ARSTREAM_MP4_NO_ATOM
+ * @return The atom payload. Its data is NULL for ARSTREAM_MP4_NO_ATOM
+ */
+static ARSTREAM_MP4_Payload_t ARSTREAM_MP4_GetPayload (ARSTREAM_MP4_t *mp4, int atom);
+
+/**
+ * @brief Lists the tracks of the file (moov/trak with a mdia/minf/stbl), with their handler type (mdia/hdlr)
+ * @return 0 on success, -1 on error
+ */
+static int ARSTREAM_MP4_IndexTracks (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Finds an atom of the selected track (mdia/[minf/stbl/]atomName)
+ * @param mp4 The file
+ * @param atomName 4CC of the atom to find
+ * @param inSampleTable 1 to look into the sample table (stbl), 0 to look into the media atom (mdia)
+ * @return The atom payload. Its data is NULL if the atom was not found
+ */
+static ARSTREAM_MP4_Payload_t ARSTREAM_MP4_FindTrackAtom (ARSTREAM_MP4_t *mp4, const char *atomName, int inSampleTable);
+
+/**
+ * @brief Frees the sample tables of the selected track
+ */
+static void ARSTREAM_MP4_FreeSampleTables (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Reads the frame sizes (stsz)
+ * @return 0 on success, -1 on error
+ */
+static int ARSTREAM_MP4_ReadSizes (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Reads the frame offsets (stsc + stco or co64)
+ * @return 0 on success, -1 on error
+ */
+static int ARSTREAM_MP4_ReadOffsets (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Reads the frame times (mdhd + stts)
+ * @return 0 on success, -1 on error
+ */
+static int ARSTREAM_MP4_ReadTimes (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Reads the key frames flags (stss)
+ * @return 0 on success, -1 on error
+ */
+static int ARSTREAM_MP4_ReadSyncSamples (ARSTREAM_MP4_t *mp4);
+
+/*
+ * Internal functions implementation
+ */
+
+static uint32_t ARSTREAM_MP4_Read32 (const uint8_t *data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+static uint64_t ARSTREAM_MP4_Read64 (const uint8_t *data)
+{
+    return ((uint64_t)ARSTREAM_MP4_Read32 (data) << 32) | ARSTREAM_MP4_Read32 (&data[4]);
+}
+
+static int ARSTREAM_MP4_IsContainer (uint32_t type)
+{
+    static const char *containers[] = { "moov", "trak", "mdia", "minf", "stbl", "edts", "dinf", "mvex" };
+    unsigned int i;
+
+    for (i = 0; i < sizeof (containers) / sizeof (containers[0]); i++)
+    {
+        if (type == ARSTREAM_MP4_Read32 ((const uint8_t *)containers[i]))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int ARSTREAM_MP4_IndexAtoms (ARSTREAM_MP4_t *mp4, uint64_t start, uint64_t end, int depth)
+{
+    int first = ARSTREAM_MP4_NO_ATOM;
+    int previous = ARSTREAM_MP4_NO_ATOM;
+    uint64_t offset = start;
+
+    while (offset + ARSTREAM_MP4_ATOM_HEADER_SIZE <= end)
+    {
+        const uint8_t *header = &mp4->map[offset];
+        uint64_t atomSize = ARSTREAM_MP4_Read32 (header);
+        uint64_t headerSize = ARSTREAM_MP4_ATOM_HEADER_SIZE;
+        ARSTREAM_MP4_AtomNode_t *node;
+        int index;
+        if (atomSize == 1)
+        {
+            if (offset + ARSTREAM_MP4_WIDE_ATOM_HEADER_SIZE > end)
+            {
+                break;
+            }
+            atomSize = ARSTREAM_MP4_Read64 (&header[ARSTREAM_MP4_ATOM_HEADER_SIZE]);
+            headerSize = ARSTREAM_MP4_WIDE_ATOM_HEADER_SIZE;
+        }
+        else if (atomSize == 0)
+        {
+            /* Last atom, up to the end of its parent */
+            atomSize = end - offset;
+        }
+        if ((atomSize < headerSize) ||
+            (atomSize > end - offset))
+        {
+            /* Keep what was indexed : a file still being recorded has a truncated last atom */
+            ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Truncated atom %.4s", (const char *)&header[4]);
+            break;
+        }
+
+        if (mp4->nbAtoms == mp4->atomsCapacity)
+        {
+            int newCapacity = (mp4->atomsCapacity == 0) ? 64 : 2 * mp4->atomsCapacity;
+            ARSTREAM_MP4_AtomNode_t *newAtoms = realloc (mp4->atoms, newCapacity * sizeof (ARSTREAM_MP4_AtomNode_t));
+            if (newAtoms == NULL)
+            {
+                return -2;
+            }
+            mp4->atoms = newAtoms;
+            mp4->atomsCapacity = newCapacity;
+        }
+        index = mp4->nbAtoms++;
+        node = &mp4->atoms[index];
+        node->type = ARSTREAM_MP4_Read32 (&header[4]);
+        node->offset = offset + headerSize;
+        node->size = atomSize - headerSize;
+        node->firstChild = ARSTREAM_MP4_NO_ATOM;
+        node->nextSibling = ARSTREAM_MP4_NO_ATOM;
+        if (previous != ARSTREAM_MP4_NO_ATOM)
+        {
+            mp4->atoms[previous].nextSibling = index;
+        }
+        else
+        {
+            first = index;
+        }
+        previous = index;
+
+        if ((depth < ARSTREAM_MP4_MAX_ATOM_DEPTH) &&
+            (ARSTREAM_MP4_IsContainer (node->type) != 0))
+        {
+            /* The index array may move : do not use node past this call */
+            int child = ARSTREAM_MP4_IndexAtoms (mp4, offset + headerSize, offset + atomSize, depth + 1);
+            if (child == -2)
+            {
+                return -2;
+            }
+            mp4->atoms[index].firstChild = child;
+        }
+        offset += atomSize;
+    }
+    return first;
+}
+
+static int ARSTREAM_MP4_FindChild (ARSTREAM_MP4_t *mp4, int parent, const char *atomName)
+{
+    uint32_t type = ARSTREAM_MP4_Read32 ((const uint8_t *)atomName);
+    int atom;
+
+    if (parent == ARSTREAM_MP4_NO_ATOM)
+    {
+        atom = (mp4->nbAtoms > 0) ? 0 : ARSTREAM_MP4_NO_ATOM;
+    }
+    else
+    {
+        atom = mp4->atoms[parent].firstChild;
+    }
+    while ((atom != ARSTREAM_MP4_NO_ATOM) &&
+           (mp4->atoms[atom].type != type))
+    {
+        atom = mp4->atoms[atom].nextSibling;
+    }
+    return atom;
+}
+
+static ARSTREAM_MP4_Payload_t ARSTREAM_MP4_GetPayload (ARSTREAM_MP4_t *mp4, int atom)
+{
+    ARSTREAM_MP4_Payload_t payload = { NULL, 0 };
+    if (atom != ARSTREAM_MP4_NO_ATOM)
+    {
+        payload.data = &mp4->map[mp4->atoms[atom].offset];
+        payload.size = mp4->atoms[atom].size;
+    }
+    return payload;
+}
+
+static int ARSTREAM_MP4_IndexTracks (ARSTREAM_MP4_t *mp4)
+{
+    int moov = ARSTREAM_MP4_FindChild (mp4, ARSTREAM_MP4_NO_ATOM, "moov");
+    uint32_t trakType = ARSTREAM_MP4_Read32 ((const uint8_t *)"trak");
+    int trak;
+
+    for (trak = (moov != ARSTREAM_MP4_NO_ATOM) ? mp4->atoms[moov].firstChild : ARSTREAM_MP4_NO_ATOM;
+         trak != ARSTREAM_MP4_NO_ATOM;
+         trak = mp4->atoms[trak].nextSibling)
+    {
+        ARSTREAM_MP4_Track_t *newTracks;
+        ARSTREAM_MP4_Payload_t hdlr;
+        int mdia, stbl;
+        if (mp4->atoms[trak].type != trakType)
+        {
+            continue;
+        }
+        mdia = ARSTREAM_MP4_FindChild (mp4, trak, "mdia");
+        stbl = (mdia != ARSTREAM_MP4_NO_ATOM) ? ARSTREAM_MP4_FindChild (mp4, ARSTREAM_MP4_FindChild (mp4, mdia, "minf"), "stbl") : ARSTREAM_MP4_NO_ATOM;
+        if (stbl == ARSTREAM_MP4_NO_ATOM)
+        {
+            continue;
+        }
+        newTracks = realloc (mp4->tracks, (mp4->nbTracks + 1) * sizeof (ARSTREAM_MP4_Track_t));
+        if (newTracks == NULL)
+        {
+            return -1;
+        }
+        mp4->tracks = newTracks;
+        mp4->tracks[mp4->nbTracks].mdia = mdia;
+        mp4->tracks[mp4->nbTracks].stbl = stbl;
+        /* hdlr : version/flags, pre defined, handler type, ... */
+        hdlr = ARSTREAM_MP4_GetPayload (mp4, ARSTREAM_MP4_FindChild (mp4, mdia, "hdlr"));
+        mp4->tracks[mp4->nbTracks].handler = ((hdlr.data != NULL) && (hdlr.size >= 12)) ? ARSTREAM_MP4_Read32 (&hdlr.data[8]) : 0;
+        mp4->nbTracks++;
+    }
+    return 0;
+}
+
+static ARSTREAM_MP4_Payload_t ARSTREAM_MP4_FindTrackAtom (ARSTREAM_MP4_t *mp4, const char *atomName, int inSampleTable)
+{
+    ARSTREAM_MP4_Track_t *track = &mp4->tracks[mp4->selectedTrack];
+    return ARSTREAM_MP4_GetPayload (mp4, ARSTREAM_MP4_FindChild (mp4, (inSampleTable != 0) ? track->stbl : track->mdia, atomName));
+}
+
+static void ARSTREAM_MP4_FreeSampleTables (ARSTREAM_MP4_t *mp4)
+{
+    free (mp4->framesOffsetArray);
+    free (mp4->framesSizeArray);
+    free (mp4->framesTimeUsArray);
+    free (mp4->framesIsSyncArray);
+    mp4->framesOffsetArray = NULL;
+    mp4->framesSizeArray = NULL;
+    mp4->framesTimeUsArray = NULL;
+    mp4->framesIsSyncArray = NULL;
+    mp4->nbFrames = 0;
+    mp4->maxFrameSize = 0;
+    mp4->timescale = 0;
+    mp4->durationUs = 0;
+}
+
+static int ARSTREAM_MP4_ReadSizes (ARSTREAM_MP4_t *mp4)
+{
+    /* stsz : version/flags, sample size, sample count, [sizes] */
+    ARSTREAM_MP4_Payload_t stsz = ARSTREAM_MP4_FindTrackAtom (mp4, "stsz", 1);
+    uint32_t sampleSize;
+    uint32_t nbSamples;
+    uint32_t i;
+
+    if ((stsz.data == NULL) ||
+        (stsz.size < 12))
+    {
+        return -1;
+    }
+    sampleSize = ARSTREAM_MP4_Read32 (&stsz.data[4]);
+    nbSamples = ARSTREAM_MP4_Read32 (&stsz.data[8]);
+    if ((nbSamples == 0) ||
+        (nbSamples > INT32_MAX / sizeof (uint64_t)) ||
+        ((sampleSize == 0) && (nbSamples > (stsz.size - 12) / sizeof (uint32_t))))
+    {
+        return -1;
+    }
+    mp4->framesSizeArray = malloc (nbSamples * sizeof (uint32_t));
+    if (mp4->framesSizeArray == NULL)
+    {
+        return -1;
+    }
+    mp4->nbFrames = (int)nbSamples;
+    for (i = 0; i < nbSamples; i++)
+    {
+        /* A non-zero sample size means that all the samples have the same size */
+        mp4->framesSizeArray [i] = (sampleSize != 0) ? sampleSize : ARSTREAM_MP4_Read32 (&stsz.data[12 + 4 * i]);
+        if (mp4->framesSizeArray [i] > mp4->maxFrameSize)
+        {
+            mp4->maxFrameSize = mp4->framesSizeArray [i];
+        }
+    }
+    return 0;
+}
+
+static int ARSTREAM_MP4_ReadOffsets (ARSTREAM_MP4_t *mp4)
+{
+    /* stsc : version/flags, entry count, [first chunk, samples per chunk, sample description index] */
+    ARSTREAM_MP4_Payload_t stsc = ARSTREAM_MP4_FindTrackAtom (mp4, "stsc", 1);
+    /* stco / co64 : version/flags, entry count, [32 / 64 bits chunk offset] */
+    ARSTREAM_MP4_Payload_t stco = ARSTREAM_MP4_FindTrackAtom (mp4, "stco", 1);
+    uint32_t offsetSize = sizeof (uint32_t);
+    uint32_t nbStscEntries;
+    uint32_t nbChunks;
+    uint32_t entry = 0;
+    uint32_t chunk;
+    uint32_t sample = 0;
+
+    if (stco.data == NULL)
+    {
+        stco = ARSTREAM_MP4_FindTrackAtom (mp4, "co64", 1);
+        offsetSize = sizeof (uint64_t);
+    }
+    if ((stsc.data == NULL) ||
+        (stsc.size < 8) ||
+        (stco.data == NULL) ||
+        (stco.size < 8))
+    {
+        return -1;
+    }
+    nbStscEntries = ARSTREAM_MP4_Read32 (&stsc.data[4]);
+    nbChunks = ARSTREAM_MP4_Read32 (&stco.data[4]);
+    if ((nbStscEntries == 0) ||
+        (nbStscEntries > (stsc.size - 8) / 12) ||
+        (nbChunks > (stco.size - 8) / offsetSize))
+    {
+        return -1;
+    }
+    mp4->framesOffsetArray = malloc (mp4->nbFrames * sizeof (uint64_t));
+    if (mp4->framesOffsetArray == NULL)
+    {
+        return -1;
+    }
+
+    /* Chunks are numbered from 1. Each stsc entry applies up to the first chunk of the next entry */
+    for (chunk = 1; (chunk <= nbChunks) && (sample < (uint32_t)mp4->nbFrames); chunk++)
+    {
+        uint64_t offset;
+        uint32_t samplesPerChunk;
+        uint32_t i;
+        while ((entry + 1 < nbStscEntries) &&
+               (chunk >= ARSTREAM_MP4_Read32 (&stsc.data[8 + 12 * (entry + 1)])))
+        {
+            entry++;
+        }
+        samplesPerChunk = ARSTREAM_MP4_Read32 (&stsc.data[8 + 12 * entry + 4]);
+        offset = (offsetSize == sizeof (uint64_t)) ?
+            ARSTREAM_MP4_Read64 (&stco.data[8 + 8 * (chunk - 1)]) :
+            ARSTREAM_MP4_Read32 (&stco.data[8 + 4 * (chunk - 1)]);
+        for (i = 0; (i < samplesPerChunk) && (sample < (uint32_t)mp4->nbFrames); i++, sample++)
+        {
+            if ((offset > mp4->mapSize) ||
+                (mp4->framesSizeArray [sample] > mp4->mapSize - offset))
+            {
+                ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Frame %u is out of the file", sample);
+                return -1;
+            }
+            mp4->framesOffsetArray [sample] = offset;
+            offset += mp4->framesSizeArray [sample];
+        }
+    }
+    if (sample < (uint32_t)mp4->nbFrames)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Chunk tables only describe %u of the %d frames", sample, mp4->nbFrames);
+        return -1;
+    }
+    return 0;
+}
+
+static int ARSTREAM_MP4_ReadTimes (ARSTREAM_MP4_t *mp4)
+{
+    /* mdhd : version/flags, creation time, modification time, timescale, duration (times are 64 bits in version 1) */
+    ARSTREAM_MP4_Payload_t mdhd = ARSTREAM_MP4_FindTrackAtom (mp4, "mdhd", 0);
+    /* stts : version/flags, entry count, [sample count, sample delta] */
+    ARSTREAM_MP4_Payload_t stts = ARSTREAM_MP4_FindTrackAtom (mp4, "stts", 1);
+    uint32_t timescaleOffset;
+    uint32_t nbEntries;
+    uint32_t entry;
+    uint32_t delta = 0;
+    uint64_t decodeTime = 0;
+    int sample = 0;
+
+    if ((mdhd.data == NULL) ||
+        (mdhd.size < 1))
+    {
+        return -1;
+    }
+    timescaleOffset = (mdhd.data[0] == 1) ? 20 : 12;
+    if (mdhd.size < timescaleOffset + 4)
+    {
+        return -1;
+    }
+    mp4->timescale = ARSTREAM_MP4_Read32 (&mdhd.data[timescaleOffset]);
+    if ((mp4->timescale == 0) ||
+        (stts.data == NULL) ||
+        (stts.size < 8))
+    {
+        return -1;
+    }
+    nbEntries = ARSTREAM_MP4_Read32 (&stts.data[4]);
+    if (nbEntries > (stts.size - 8) / 8)
+    {
+        return -1;
+    }
+    mp4->framesTimeUsArray = malloc (mp4->nbFrames * sizeof (uint64_t));
+    if (mp4->framesTimeUsArray == NULL)
+    {
+        return -1;
+    }
+
+    for (entry = 0; (entry < nbEntries) && (sample < mp4->nbFrames); entry++)
+    {
+        uint32_t count = ARSTREAM_MP4_Read32 (&stts.data[8 + 8 * entry]);
+        uint32_t i;
+        delta = ARSTREAM_MP4_Read32 (&stts.data[8 + 8 * entry + 4]);
+        for (i = 0; (i < count) && (sample < mp4->nbFrames); i++, sample++)
+        {
+            mp4->framesTimeUsArray [sample] = decodeTime * 1000000 / mp4->timescale;
+            decodeTime += delta;
+        }
+    }
+    /* Frames not described by the table keep the last delta */
+    for (; sample < mp4->nbFrames; sample++)
+    {
+        mp4->framesTimeUsArray [sample] = decodeTime * 1000000 / mp4->timescale;
+        decodeTime += delta;
+    }
+    mp4->durationUs = decodeTime * 1000000 / mp4->timescale;
+    return 0;
+}
+
+static int ARSTREAM_MP4_ReadSyncSamples (ARSTREAM_MP4_t *mp4)
+{
+    /* stss : version/flags, entry count, [sample number] */
+    ARSTREAM_MP4_Payload_t stss = ARSTREAM_MP4_FindTrackAtom (mp4, "stss", 1);
+    uint32_t nbEntries;
+    uint32_t entry;
+
+    mp4->framesIsSyncArray = malloc (mp4->nbFrames);
+    if (mp4->framesIsSyncArray == NULL)
+    {
+        return -1;
+    }
+    if (stss.data == NULL)
+    {
+        /* No sync sample table : every frame is a key frame */
+        memset (mp4->framesIsSyncArray, 1, mp4->nbFrames);
+        return 0;
+    }
+    if (stss.size < 8)
+    {
+        return -1;
+    }
+    nbEntries = ARSTREAM_MP4_Read32 (&stss.data[4]);
+    if (nbEntries > (stss.size - 8) / 4)
+    {
+        return -1;
+    }
+    memset (mp4->framesIsSyncArray, 0, mp4->nbFrames);
+    for (entry = 0; entry < nbEntries; entry++)
+    {
+        /* Sample numbers start at 1 */
+        uint32_t sample = ARSTREAM_MP4_Read32 (&stss.data[8 + 4 * entry]);
+        if ((sample >= 1) &&
+            (sample <= (uint32_t)mp4->nbFrames))
+        {
+            mp4->framesIsSyncArray [sample - 1] = 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Implementation
+ */
+
+ARSTREAM_MP4_t* ARSTREAM_MP4_Open (const char *path)
+{
+    ARSTREAM_MP4_t *mp4 = NULL;
+    struct stat fileStat;
+    int track;
+    int fd;
+
+    mp4 = calloc (1, sizeof (ARSTREAM_MP4_t));
+    if (mp4 == NULL)
+    {
+        return NULL;
+    }
+    fd = open (path, O_RDONLY);
+    if (fd < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to open %s : %s", path, strerror (errno));
+        ARSTREAM_MP4_Close (&mp4);
+        return NULL;
+    }
+    if ((fstat (fd, &fileStat) != 0) ||
+        (fileStat.st_size <= 0) ||
+        ((uint64_t)fileStat.st_size > SIZE_MAX))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to get the size of %s", path);
+        close (fd);
+        ARSTREAM_MP4_Close (&mp4);
+        return NULL;
+    }
+    mp4->mapSize = (size_t)fileStat.st_size;
+    mp4->map = mmap (NULL, mp4->mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    /* The mapping keeps its own reference on the file */
+    close (fd);
+    if (mp4->map == MAP_FAILED)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to map %s : %s", path, strerror (errno));
+        mp4->map = NULL;
+        ARSTREAM_MP4_Close (&mp4);
+        return NULL;
+    }
+    /* Frames are read in order : let the kernel read ahead (best effort) */
+    madvise (mp4->map, mp4->mapSize, MADV_SEQUENTIAL);
+
+    if ((ARSTREAM_MP4_IndexAtoms (mp4, 0, mp4->mapSize, 0) == -2) ||
+        (ARSTREAM_MP4_IndexTracks (mp4) != 0))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to index the atoms of %s", path);
+        ARSTREAM_MP4_Close (&mp4);
+        return NULL;
+    }
+    if (mp4->nbTracks == 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "No track in %s", path);
+        ARSTREAM_MP4_Close (&mp4);
+        return NULL;
+    }
+    track = ARSTREAM_MP4_FindTrack (mp4, ARSTREAM_MP4_HANDLER_VIDEO);
+    if (track < 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "No video track in %s, reading its first track", path);
+        track = 0;
+    }
+    if (ARSTREAM_MP4_SelectTrack (mp4, track) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to read the sample tables of %s", path);
+        ARSTREAM_MP4_Close (&mp4);
+    }
+    return mp4;
+}
+
+void ARSTREAM_MP4_Close (ARSTREAM_MP4_t **mp4)
+{
+    if ((mp4 != NULL) &&
+        (*mp4 != NULL))
+    {
+        if ((*mp4)->map != NULL)
+        {
+            munmap ((*mp4)->map, (*mp4)->mapSize);
+        }
+        ARSTREAM_MP4_FreeSampleTables (*mp4);
+        free ((*mp4)->atoms);
+        free ((*mp4)->tracks);
+        free (*mp4);
+        *mp4 = NULL;
+    }
+}
+
+int ARSTREAM_MP4_GetNbTracks (ARSTREAM_MP4_t *mp4)
+{
+    return mp4->nbTracks;
+}
+
+uint32_t ARSTREAM_MP4_GetTrackHandler (ARSTREAM_MP4_t *mp4, int track)
+{
+    return mp4->tracks [track].handler;
+}
+
+int ARSTREAM_MP4_FindTrack (ARSTREAM_MP4_t *mp4, uint32_t handler)
+{
+    int track;
+    for (track = 0; track < mp4->nbTracks; track++)
+    {
+        if (mp4->tracks [track].handler == handler)
+        {
+            return track;
+        }
+    }
+    return -1;
+}
+
+int ARSTREAM_MP4_SelectTrack (ARSTREAM_MP4_t *mp4, int track)
+{
+    if ((track < 0) ||
+        (track >= mp4->nbTracks))
+    {
+        return -1;
+    }
+    ARSTREAM_MP4_FreeSampleTables (mp4);
+    mp4->selectedTrack = track;
+    if ((ARSTREAM_MP4_ReadSizes (mp4) != 0) ||
+        (ARSTREAM_MP4_ReadOffsets (mp4) != 0) ||
+        (ARSTREAM_MP4_ReadTimes (mp4) != 0) ||
+        (ARSTREAM_MP4_ReadSyncSamples (mp4) != 0))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to read the sample tables of track %d", track);
+        ARSTREAM_MP4_FreeSampleTables (mp4);
+        return -1;
+    }
+    return 0;
+}
+
+int ARSTREAM_MP4_GetSelectedTrack (ARSTREAM_MP4_t *mp4)
+{
+    return mp4->selectedTrack;
+}
+
+int ARSTREAM_MP4_GetNbFrames (ARSTREAM_MP4_t *mp4)
+{
+    return mp4->nbFrames;
+}
+
+uint32_t ARSTREAM_MP4_GetMaxFrameSize (ARSTREAM_MP4_t *mp4)
+{
+    return mp4->maxFrameSize;
+}
+
+uint64_t ARSTREAM_MP4_GetDurationUs (ARSTREAM_MP4_t *mp4)
+{
+    return mp4->durationUs;
+}
+
+uint32_t ARSTREAM_MP4_GetFrameSize (ARSTREAM_MP4_t *mp4, int index)
+{
+    return mp4->framesSizeArray [index];
+}
+
+int ARSTREAM_MP4_IsIFrame (ARSTREAM_MP4_t *mp4, int index)
+{
+    return mp4->framesIsSyncArray [index];
+}
+
+uint64_t ARSTREAM_MP4_GetFrameTimeUs (ARSTREAM_MP4_t *mp4, int index)
+{
+    return mp4->framesTimeUsArray [index];
+}
+
+const uint8_t* ARSTREAM_MP4_GetFrame (ARSTREAM_MP4_t *mp4, int index, uint32_t *size)
+{
+    if (size != NULL)
+    {
+        *size = mp4->framesSizeArray [index];
+    }
+    return &mp4->map [mp4->framesOffsetArray [index]];
+}
@@ -0,0 +1,151 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_MP4.h
+ * @brief Minimal mp4 file reader for the testbenches
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_MP4_H_
+#define _ARSTREAM_MP4_H_
+
+#include <inttypes.h>
+
+/**
+ * @brief Builds a track handler type from its 4CC
+ */
+#define ARSTREAM_MP4_HANDLER(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+#define ARSTREAM_MP4_HANDLER_VIDEO ARSTREAM_MP4_HANDLER ('v', 'i', 'd', 'e') /**< Handler type of video tracks */
+#define ARSTREAM_MP4_HANDLER_SOUND ARSTREAM_MP4_HANDLER ('s', 'o', 'u', 'n') /**< Handler type of audio tracks */
+
+/**
+ * @brief An mp4 file mapped for frame reading
+ * The frames are the samples of one track of the file : the selected track
+ */
+typedef struct ARSTREAM_MP4 ARSTREAM_MP4_t;
+
+/**
+ * @brief Maps an mp4 file, indexes its atoms, and reads the sample tables of its first video track
+ * If the file has no video track, its first track is selected
+ * Chunk offsets can be 32 (stco) or 64 bits (co64), with any number of samples per chunk (stsc)
+ * @param path Path of the mp4 file
+ * @return The opened file, or NULL if the file can not be read
+ */
+ARSTREAM_MP4_t* ARSTREAM_MP4_Open (const char *path);
+
+/**
+ * @brief Closes an mp4 file, and unmaps it
+ * @param mp4 Pointer to the ARSTREAM_MP4_t * to close. Set to NULL
+ */
+void ARSTREAM_MP4_Close (ARSTREAM_MP4_t **mp4);
+
+/**
+ * @brief Gets the number of tracks of the file
+ */
+int ARSTREAM_MP4_GetNbTracks (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Gets the handler type of a track (ARSTREAM_MP4_HANDLER_VIDEO, ARSTREAM_MP4_HANDLER_SOUND ...)
+ * @param mp4 The file
+ * @param track Index of the track, in [0, ARSTREAM_MP4_GetNbTracks()[
+ */
+uint32_t ARSTREAM_MP4_GetTrackHandler (ARSTREAM_MP4_t *mp4, int track);
+
+/**
+ * @brief Finds the first track with a given handler type
+ * @param mp4 The file
+ * @param handler The handler type
+ * @return Index of the track, or -1 if there is no such track
+ */
+int ARSTREAM_MP4_FindTrack (ARSTREAM_MP4_t *mp4, uint32_t handler);
+
+/**
+ * @brief Selects the track to read the frames from, and reads its sample tables
+ * @param mp4 The file
+ * @param track Index of the track
+ * @return 0 on success, -1 if the track does not exist or its tables can not be read (the file then has no frame)
+ */
+int ARSTREAM_MP4_SelectTrack (ARSTREAM_MP4_t *mp4, int track);
+
+/**
+ * @brief Gets the index of the selected track
+ */
+int ARSTREAM_MP4_GetSelectedTrack (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Gets the number of frames of the selected track
+ */
+int ARSTREAM_MP4_GetNbFrames (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Gets the size of the largest frame of the selected track, in bytes
+ */
+uint32_t ARSTREAM_MP4_GetMaxFrameSize (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Gets the size of a frame, in bytes
+ * @param mp4 The file
+ * @param index Index of the frame, in [0, ARSTREAM_MP4_GetNbFrames()[
+ */
+uint32_t ARSTREAM_MP4_GetFrameSize (ARSTREAM_MP4_t *mp4, int index);
+
+/**
+ * @brief Tells if a frame is a key frame (I-Frame)
+ * Key frames are read from the sync sample table (stss). If the file has none, all frames are key frames
+ * @param mp4 The file
+ * @param index Index of the frame
+ */
+int ARSTREAM_MP4_IsIFrame (ARSTREAM_MP4_t *mp4, int index);
+
+/**
+ * @brief Gets the decoding time of a frame, from the start of the file, in us
+ * Times are read from the time-to-sample table (stts)
+ * @param mp4 The file
+ * @param index Index of the frame
+ */
+uint64_t ARSTREAM_MP4_GetFrameTimeUs (ARSTREAM_MP4_t *mp4, int index);
+
+/**
+ * @brief Gets the duration of the selected track (time of the last frame, plus its duration), in us
+ */
+uint64_t ARSTREAM_MP4_GetDurationUs (ARSTREAM_MP4_t *mp4);
+
+/**
+ * @brief Gets a frame, without any copy
+ * @param mp4 The file
+ * @param index Index of the frame
+ * @param[out] size Size of the frame, in bytes. May be NULL
+ * @return Pointer to the frame in the file mapping. Read only, valid until ARSTREAM_MP4_Close() is called
+ */
+const uint8_t* ARSTREAM_MP4_GetFrame (ARSTREAM_MP4_t *mp4, int index, uint32_t *size);
+
+#endif /* _ARSTREAM_MP4_H_ */
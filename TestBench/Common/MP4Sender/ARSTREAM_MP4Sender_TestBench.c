@@ -45,17 +45,18 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdio.h>
-#include <arpa/inet.h>
-#include <errno.h>
+#include <time.h>
 
 /*
  * ARSDK Headers
  */
 
 #include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Time.h>
 #include <libARStream/ARSTREAM_Sender.h>
 
 #include "../ARSTREAM_TB_Config.h"
+#include "../MP4/ARSTREAM_MP4.h"
 
 /*
  * Macros
@@ -67,15 +68,14 @@
 #define SENDING_PORT (54321)
 #define READING_PORT (43210)
 
-#define NB_BUFFERS (40)
-#define I_FRAME_EVERY_N (30)
+#define SENDER_QUEUE_SIZE (40)
 
 #define TEST_MODE (0)
 
 #if TEST_MODE
-# define TIME_BETWEEN_FRAMES_MS (1000)
+# define TIME_SCALE (30) /* Play the file 30 times slower than recorded */
 #else
-# define TIME_BETWEEN_FRAMES_MS (33)
+# define TIME_SCALE (1)
 #endif
 
 #define __TAG__ "ARSTREAM_MP4Sender_TB"
@@ -100,18 +100,11 @@ float ARSTREAM_MP4Sender_PercentOk = 0.0;
 static int nbSent = 0;
 static int nbOk = 0;
 
-static int currentBufferIndex = 0;
-static uint8_t *multiBuffer[NB_BUFFERS];
-static uint32_t multiBufferSize[NB_BUFFERS];
-static int multiBufferIsFree[NB_BUFFERS];
-
 static char *appName;
 
-static FILE *mp4File;
-static int mp4NbFrames;
+static ARSTREAM_MP4_t *mp4File;
 static int mp4CurrentFrame;
-static uint32_t *framesOffsetArray;
-static uint32_t *framesSizeArray;
+static uint64_t mp4LoopOffsetUs;
 
 /*
  * Internal functions declarations
@@ -122,33 +115,15 @@ static uint32_t *framesSizeArray;
  */
 void ARSTREAM_MP4SenderTb_printUsage ();
 
-/**
- * @brief Initializes the multi buffers of the testbench
- * @param maxsize Maximum size of a frame in the current mp4 file
- */
-void ARSTREAM_MP4SenderTb_initMultiBuffers (int maxsize);
-
 /**
  * @see ARSTREAM_Sender.h
  */
 void ARSTREAM_MP4SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
 
-/**
- * @brief Gets a free buffer pointer
- * @param[in] buffer the buffer to mark as free
- */
-void ARSTREAM_MP4SenderTb_SetBufferFree (uint8_t *buffer);
-
-/**
- * @brief Gets a free buffer pointer
- * @param[out] retSize Pointer where to store the size of the next free buffer (or 0 if there is no free buffer)
- * @return Pointer to the next free buffer, or NULL if there is no free buffer
- */
-uint8_t* ARSTREAM_MP4SenderTb_GetNextFreeBuffer (uint32_t *retSize);
-
 /**
  * @brief File reader thread function
- * This function reads frames periodically from the given mp4 file, and sends them through the ARSTREAM_Sender_t
+ * This function sends the frames of the mp4 file through the ARSTREAM_Sender_t, at the times of the file
+ * Frames are not copied : the sender gets pointers into the file mapping
  * @param ARSTREAM_Sender_t_Param A valid ARSTREAM_Sender_t, casted as a (void *), which will be used by the thread
  * @return No meaningful value : (void *)0
  *
@@ -165,29 +140,21 @@ void* fileReaderThread (void *ARSTREAM_Sender_t_Param);
 int ARSTREAM_MP4SenderTb_StartStreamTest (const char *fpath, ARNETWORK_Manager_t *manager);
 
 /**
- * @brief Opens the file for reading + get the largest frame size
+ * @brief Opens the file for reading
  * @param path Path of the mp4 file
- * @return the size of the largest frame in the file
  */
-int ARSTREAM_MP4SenderTb_OpenStreamFile (const char *path);
+void ARSTREAM_MP4SenderTb_OpenStreamFile (const char *path);
 
 /**
  * @brief Get the "next" frame from file
- * @param nextFrame buffer in which to store nextFrame
- * @param nextFrameSize size of the nextFrame buffer
- * @param isIFrame pointer to an int which will hold this boolean-like flag
- * @return actual data size of the nextFrame
+ * @param[out] nextFrameSize size of the frame
+ * @param[out] isIFrame pointer to an int which will hold this boolean-like flag
+ * @param[out] timeUs time of the frame, from the start of the stream, in us
+ * @return pointer to the frame, in the file mapping
  *
  * @note After reading the last frame from the file, this function goes back to the beginning
  */
-uint32_t ARSTREAM_MP4SenderTb_GetNextFrame (uint8_t *nextFrame, int nextFrameSize, int *isIFrame);
-
-/**
- * @brief seeks the global mp4File to the given atom
- * @param atomName 4CC of the atom to seek
- * @return size of the atom (-1 means failure)
- */
-int ARSTREAM_MP4SenderTb_JumpToAtom (const char *atomName);
+const uint8_t* ARSTREAM_MP4SenderTb_GetNextFrame (uint32_t *nextFrameSize, int *isIFrame, uint64_t *timeUs);
 
 /*
  * Internal functions implementation
@@ -200,31 +167,19 @@ void ARSTREAM_MP4SenderTb_printUsage ()
     ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        ip -> optionnal, ip of the stream reader");
 }
 
-void ARSTREAM_MP4SenderTb_initMultiBuffers (int maxsize)
-{
-    int buffIndex;
-    for (buffIndex = 0; buffIndex < NB_BUFFERS; buffIndex++)
-    {
-        multiBuffer[buffIndex] = malloc (maxsize);
-        multiBufferSize[buffIndex] = maxsize;
-        multiBufferIsFree[buffIndex] = 1;
-    }
-}
-
 void ARSTREAM_MP4SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
 {
+    framePointer = framePointer; /* Frames live in the file mapping : nothing to free */
     custom = custom;
     switch (status)
     {
     case ARSTREAM_SENDER_STATUS_FRAME_SENT:
-        ARSTREAM_MP4SenderTb_SetBufferFree (framePointer);
         ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Successfully sent a frame of size %u", frameSize);
         nbSent++;
         nbOk++;
         ARSTREAM_MP4Sender_PercentOk = (100.f * nbOk) / (1.f * nbSent);
         break;
     case ARSTREAM_SENDER_STATUS_FRAME_CANCEL:
-        ARSTREAM_MP4SenderTb_SetBufferFree (framePointer);
         ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Cancelled a frame of size %u", frameSize);
         nbSent++;
         ARSTREAM_MP4Sender_PercentOk = (100.f * nbOk) / (1.f * nbSent);
@@ -235,60 +190,35 @@ void ARSTREAM_MP4SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, u
     }
 }
 
-void ARSTREAM_MP4SenderTb_SetBufferFree (uint8_t *buffer)
-{
-    int i;
-    for (i = 0; i < NB_BUFFERS; i++)
-    {
-        if (multiBuffer[i] == buffer)
-        {
-            multiBufferIsFree[i] = 1;
-        }
-    }
-}
-
-uint8_t* ARSTREAM_MP4SenderTb_GetNextFreeBuffer (uint32_t *retSize)
-{
-    uint8_t *retBuffer = NULL;
-    int nbtest = 0;
-    if (retSize == NULL)
-    {
-        return NULL;
-    }
-    do
-    {
-        if (multiBufferIsFree[currentBufferIndex] == 1)
-        {
-            retBuffer = multiBuffer[currentBufferIndex];
-            *retSize = multiBufferSize[currentBufferIndex];
-        }
-        currentBufferIndex = (currentBufferIndex + 1) % NB_BUFFERS;
-        nbtest++;
-    } while (retBuffer == NULL && nbtest < NB_BUFFERS);
-    return retBuffer;
-}
-
 void* fileReaderThread (void *ARSTREAM_Sender_t_Param)
 {
 
-    uint8_t cnt = 0;
     uint32_t frameSize = 0;
-    uint32_t frameCapacity = 0;
-    uint8_t *nextFrameAddr;
+    uint64_t frameTimeUs = 0;
+    const uint8_t *nextFrameAddr;
+    struct timespec start, now;
     ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)ARSTREAM_Sender_t_Param;
-    srand (time (NULL));
     ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Encoder thread running");
+    ARSAL_Time_GetTime (&start);
     while (stillRunning)
     {
         int flush;
-        nextFrameAddr = ARSTREAM_MP4SenderTb_GetNextFreeBuffer (&frameCapacity);
-        frameSize = ARSTREAM_MP4SenderTb_GetNextFrame (nextFrameAddr, frameCapacity, &flush);
-        cnt++;
+        int64_t waitMs;
+        nextFrameAddr = ARSTREAM_MP4SenderTb_GetNextFrame (&frameSize, &flush, &frameTimeUs);
+
+        /* Wait for the time of the frame in the file */
+        ARSAL_Time_GetTime (&now);
+        waitMs = (int64_t)(frameTimeUs * TIME_SCALE / 1000) - ARSAL_Time_ComputeTimespecMsTimeDiff (&start, &now);
+        if (waitMs > 0)
+        {
+            usleep (1000 * waitMs);
+        }
 
         if (frameSize != 0)
         {
             int nbPrevious = 0;
-            eARSTREAM_ERROR res = ARSTREAM_Sender_SendNewFrame (sender, nextFrameAddr, frameSize, flush, &nbPrevious);
+            /* The sender only reads the frames : handing it the read-only mapping is safe */
+            eARSTREAM_ERROR res = ARSTREAM_Sender_SendNewFrame (sender, (uint8_t *)nextFrameAddr, frameSize, flush, &nbPrevious);
             switch (res)
             {
             case ARSTREAM_OK:
@@ -308,8 +238,6 @@ void* fileReaderThread (void *ARSTREAM_Sender_t_Param)
         {
             ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Could not get a new encoded frame");
         }
-
-        usleep (1000 * TIME_BETWEEN_FRAMES_MS);
     }
     ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Encoder thread ended");
     return (void *)0;
@@ -320,8 +248,8 @@ int ARSTREAM_MP4SenderTb_StartStreamTest (const char *fpath, ARNETWORK_Manager_t
     int retVal = 0;
     eARSTREAM_ERROR err;
     ARSTREAM_Sender_t *sender;
-    ARSTREAM_MP4SenderTb_initMultiBuffers (ARSTREAM_MP4SenderTb_OpenStreamFile (fpath));
-    sender = ARSTREAM_Sender_New (manager, DATA_BUFFER_ID, ACK_BUFFER_ID, ARSTREAM_MP4SenderTb_FrameUpdateCallback, NB_BUFFERS, ARSTREAM_TB_FRAG_SIZE, ARSTREAM_TB_MAX_NB_FRAG, NULL, &err);
+    ARSTREAM_MP4SenderTb_OpenStreamFile (fpath);
+    sender = ARSTREAM_Sender_New (manager, DATA_BUFFER_ID, ACK_BUFFER_ID, ARSTREAM_MP4SenderTb_FrameUpdateCallback, SENDER_QUEUE_SIZE, ARSTREAM_TB_FRAG_SIZE, ARSTREAM_TB_MAX_NB_FRAG, NULL, &err);
     if (sender == NULL)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Error during ARSTREAM_Sender_New call : %s", ARSTREAM_Error_ToString(err));
@@ -346,235 +274,37 @@ int ARSTREAM_MP4SenderTb_StartStreamTest (const char *fpath, ARNETWORK_Manager_t
     pthread_join (streamsend, NULL);
 
     ARSTREAM_Sender_Delete (&sender);
+    ARSTREAM_MP4_Close (&mp4File);
 
     return retVal;
 }
 
-int ARSTREAM_MP4SenderTb_OpenStreamFile (const char *path)
+void ARSTREAM_MP4SenderTb_OpenStreamFile (const char *path)
 {
-    int res = 1;
-    int greatest = 0;
-    mp4File = fopen (path, "rb");
+    mp4File = ARSTREAM_MP4_Open (path);
     if (NULL == mp4File)
     {
-        perror ("Open error");
         exit (1);
     }
-
-    /* Jump to stsz atom */
-    res = ARSTREAM_MP4SenderTb_JumpToAtom ("moov");
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("trak");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("mdia");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("minf");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("stbl");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("stsz");
-    }
-
-    /* Read nbFrames + all frames sizes */
-    if (res != -1)
-    {
-        uint8_t *data = malloc (res);
-        res = fread (data, 1, res, mp4File);
-        uint32_t neNbFrames = *(uint32_t *)&data[8];
-        mp4NbFrames = ntohl (neNbFrames);
-        framesSizeArray = malloc (mp4NbFrames * sizeof (uint32_t));
-        memcpy (framesSizeArray, &data[12], mp4NbFrames * sizeof (uint32_t));
-        int i;
-        for (i = 0; i < mp4NbFrames; i++)
-        {
-            framesSizeArray [i] = ntohl (framesSizeArray [i]);
-            if (framesSizeArray [i] > greatest)
-            {
-                greatest = framesSizeArray [i];
-            }
-        }
-        free (data);
-    }
-
-    /* Rewind file */
-    rewind (mp4File);
-
-    /* Jump to stco atom */
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("moov");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("trak");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("mdia");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("minf");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("stbl");
-    }
-    if (res != -1)
-    {
-        res = ARSTREAM_MP4SenderTb_JumpToAtom ("stco");
-    }
-
-    /* Read nbFrames + all frames sizes */
-    if (res != -1)
-    {
-        uint8_t *data = malloc (res);
-        res = fread (data, 1, res, mp4File);
-        framesOffsetArray = malloc (mp4NbFrames * sizeof (uint32_t));
-        memcpy (framesOffsetArray, &data[8], mp4NbFrames * sizeof (uint32_t));
-        int i;
-        for (i = 0; i < mp4NbFrames; i++)
-        {
-            framesOffsetArray [i] = ntohl (framesOffsetArray [i]);
-        }
-        free (data);
-    }
-
     mp4CurrentFrame = 0;
-    return greatest;
+    mp4LoopOffsetUs = 0;
 }
 
-uint32_t ARSTREAM_MP4SenderTb_GetNextFrame (uint8_t *nextFrame, int nextFrameSize, int *isIFrame)
+const uint8_t* ARSTREAM_MP4SenderTb_GetNextFrame (uint32_t *nextFrameSize, int *isIFrame, uint64_t *timeUs)
 {
-    uint32_t nextSize = framesSizeArray [mp4CurrentFrame];
-    uint32_t nextOffset = framesOffsetArray [mp4CurrentFrame];
-
-    *isIFrame = 0;
+    const uint8_t *nextFrame = ARSTREAM_MP4_GetFrame (mp4File, mp4CurrentFrame, nextFrameSize);
 
-    if (nextSize <= nextFrameSize)
-    {
-        fseek (mp4File, nextOffset, SEEK_SET);
-        int readRes = fread (nextFrame, 1, nextSize, mp4File);
-        if (readRes != nextSize)
-        {
-            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Fread error: %s", strerror(errno));
-        }
-    }
-    else
-    {
-        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "GetNextFrame error ... this is pretty bad !");
-        return 0;
-    }
+    *isIFrame = ARSTREAM_MP4_IsIFrame (mp4File, mp4CurrentFrame);
+    *timeUs = mp4LoopOffsetUs + ARSTREAM_MP4_GetFrameTimeUs (mp4File, mp4CurrentFrame);
 
     mp4CurrentFrame++;
-    if (mp4CurrentFrame >= mp4NbFrames)
+    if (mp4CurrentFrame >= ARSTREAM_MP4_GetNbFrames (mp4File))
     {
         mp4CurrentFrame = 0;
+        mp4LoopOffsetUs += ARSTREAM_MP4_GetDurationUs (mp4File);
     }
 
-    *isIFrame = ((mp4CurrentFrame % I_FRAME_EVERY_N) == 1) ? 1 : 0;
-
-    return nextSize;
-}
-
-
-/**
- * Read from a file functions
- * Note : fptr MUST be a valid file pointer
- */
-static void read_uint32 (FILE *fptr, uint32_t *dest)
-{
-    uint32_t locValue = 0;
-    if (1 != fread (&locValue, sizeof (locValue), 1, fptr))
-    {
-        fprintf (stderr, "Error reading a uint32_t\n");
-    }
-    *dest = ntohl (locValue);
-}
-
-static void read_uint64 (FILE *fptr, uint64_t *dest)
-{
-    uint64_t retValue = 0;
-    uint32_t locValue = 0;
-    if (1 != fread (&locValue, sizeof (locValue), 1, fptr))
-    {
-        fprintf (stderr, "Error reading low value of a uint64_t\n");
-        return;
-    }
-    retValue = (uint64_t)(ntohl (locValue));
-    if (1 != fread (&locValue, sizeof (locValue), 1, fptr))
-    {
-        fprintf (stderr, "Error reading a high value of a uint64_t\n");
-    }
-    retValue += ((uint64_t)(ntohl (locValue))) << 32;
-    *dest = retValue;
-}
-
-void read_4cc (FILE *fptr, char dest[5])
-{
-    if (1 != fread (dest, 4, 1, fptr))
-    {
-        fprintf (stderr, "Error reading a 4cc\n");
-    }
-}
-
-int ARSTREAM_MP4SenderTb_JumpToAtom (const char *atomName)
-{
-    uint32_t atomSize = 0;
-    char fourCCTag [5] = {0};
-    uint64_t wideAtomSize = 0;
-    int found = 0;
-    FILE *streamFile = mp4File;
-    if (NULL == streamFile)
-    {
-        return 0;
-    }
-
-    read_uint32 (streamFile, &atomSize);
-    read_4cc (streamFile, fourCCTag);
-    if (0 == atomSize)
-    {
-        read_uint64 (streamFile, &wideAtomSize);
-    }
-    else
-    {
-        wideAtomSize = atomSize;
-    }
-    if (0 == strncmp (fourCCTag, atomName, 4))
-    {
-        found = 1;
-    }
-
-    while (0 == found &&
-           !feof (streamFile))
-    {
-        fseek (streamFile, wideAtomSize - 8, SEEK_CUR);
-
-        read_uint32 (streamFile, &atomSize);
-        read_4cc (streamFile, fourCCTag);
-        if (0 == atomSize)
-        {
-            read_uint64 (streamFile, &wideAtomSize);
-        }
-        else
-        {
-            wideAtomSize = atomSize;
-        }
-        if (0 == strncmp (fourCCTag, atomName, 4))
-        {
-            found = 1;
-        }
-    }
-    return wideAtomSize;
+    return nextFrame;
 }
 
 /*
@@ -72,6 +72,8 @@
 
 #define READER_PING_DELAY (0) // Use default value
 
+#define FLUSH_FRAME_REQUEST_INTERVAL_MS (100)
+
 #ifndef __IP
 #define __IP "127.0.0.1"
 #endif
@@ -299,12 +301,13 @@ int ARSTREAM_ReaderTb_StartStreamTest (ARNETWORK_Manager_t *manager, const char
     ARSTREAM_ReaderTb_initMultiBuffers (FRAME_MAX_SIZE);
     ARSAL_Sem_Init (&closeSem, 0, 0);
     firstFrame = ARSTREAM_ReaderTb_GetNextFreeBuffer (&firstFrameSize, 0);
-    g_Reader = ARSTREAM_Reader_New (manager, DATA_BUFFER_ID, ACK_BUFFER_ID, ARSTREAM_ReaderTb_FrameCompleteCallback, firstFrame, firstFrameSize, ARSTREAM_TB_FRAG_SIZE, NULL, &err);
+    g_Reader = ARSTREAM_Reader_New (manager, DATA_BUFFER_ID, ACK_BUFFER_ID, ARSTREAM_ReaderTb_FrameCompleteCallback, firstFrame, firstFrameSize, ARSTREAM_TB_FRAG_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT, NULL, &err);
     if (g_Reader == NULL)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Error during ARSTREAM_Reader_New call : %s", ARSTREAM_Error_ToString(err));
         return 1;
     }
+    ARSTREAM_Reader_SetAutomaticFlushFrameRequests (g_Reader, FLUSH_FRAME_REQUEST_INTERVAL_MS);
 
     pthread_t streamsend, streamread;
     pthread_create (&streamsend, NULL, ARSTREAM_Reader_RunDataThread, g_Reader);
@@ -445,6 +448,18 @@ int ARSTREAM_ReaderTb_GetLatency ()
     }
 }
 
+int ARSTREAM_ReaderTb_GetFrameLatency (float percentile)
+{
+    ARSTREAM_Histogram_t histogram;
+    if ((g_Reader == NULL) ||
+        (ARSTREAM_Reader_GetHistogram (g_Reader, ARSTREAM_READER_HISTOGRAM_COMPLETION_LATENCY, &histogram) != ARSTREAM_OK) ||
+        (histogram.count == 0))
+    {
+        return -1;
+    }
+    return ARSTREAM_Histogram_GetPercentile (&histogram, percentile) / 1000;
+}
+
 int ARSTREAM_ReaderTb_GetMissedFrames ()
 {
     int retval = nbSkippedSinceLast;
@@ -67,6 +67,13 @@ int ARSTREAM_ReaderTb_GetMeanTimeBetweenFrames ();
  */
 int ARSTREAM_ReaderTb_GetLatency ();
 
+/**
+ * Gets a percentile of the frames one-way latency (requires sender timestamps)
+ * @param percentile The percentile to get (0.0 - 100.0)
+ * @return latency of the frames in ms, or -1 if unknown
+ */
+int ARSTREAM_ReaderTb_GetFrameLatency (float percentile);
+
 /**
  * @brief Gets the number of missed frames since last call
  * @return Number of frames missed since last call
@@ -43,6 +43,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
 
 /*
  * ARSDK Headers
@@ -52,6 +53,7 @@
 #include <libARStream/ARSTREAM_Sender.h>
 
 #include "../ARSTREAM_TB_Config.h"
+#include "../Workload/ARSTREAM_Workload.h"
 
 /*
  * Macros
@@ -66,16 +68,11 @@
 #define BITRATE_KBPS (1200)
 #define FPS          (30)
 
-#define FRAME_SIZE   (1000 * BITRATE_KBPS / FPS / 8)
-
-#define FRAME_MIN_SIZE (FRAME_SIZE)
-#define FRAME_MAX_SIZE (FRAME_SIZE)
-
 #define I_FRAME_EVERY_N (15)
+#define I_TO_P_RATIO (6.f)
+#define FRAME_SIZE_VARIATION (0.2f)
 #define NB_BUFFERS (2 * I_FRAME_EVERY_N)
 
-#define TIME_BETWEEN_FRAMES_MS (1000 / FPS)
-
 #define __TAG__ "ARSTREAM_Sender_TB"
 
 #define SENDER_PING_DELAY (0) // Use default value
@@ -103,6 +100,7 @@ static int currentIndexInDt = 0;
 static int nbSkippedSinceLast = 0;
 
 static int stillRunning = 1;
+static int flushFrameRequested = 0;
 
 float ARSTREAM_Sender_PercentOk = 0.0;
 static int nbSent = 0;
@@ -115,6 +113,8 @@ static int multiBufferIsFree[NB_BUFFERS];
 
 static char *appName;
 
+static ARSTREAM_Workload_t *g_Workload;
+
 /*
  * Internal functions declarations
  */
@@ -127,7 +127,7 @@ void ARSTREAM_SenderTb_printUsage ();
 /**
  * @brief Initializes the multi buffers of the testbench
  */
-void ARSTREAM_SenderTb_initMultiBuffers ();
+void ARSTREAM_SenderTb_initMultiBuffers (uint32_t maxsize);
 
 /**
  * @see ARSTREAM_Sender.h
@@ -148,12 +148,12 @@ void ARSTREAM_SenderTb_SetBufferFree (uint8_t *buffer);
 uint8_t* ARSTREAM_SenderTb_GetNextFreeBuffer (uint32_t *retSize);
 
 /**
- * @brief Fake encoder thread function
- * This function generates dummy frames periodically, and sends them through the ARSTREAM_Sender_t
+ * @brief Encoder thread function
+ * This function generates the frames of the workload at their times, and sends them through the ARSTREAM_Sender_t
  * @param ARSTREAM_Sender_t_Param A valid ARSTREAM_Sender_t, casted as a (void *), which will be used by the thread
  * @return No meaningful value : (void *)0
  */
-void* fakeEncoderThread (void *ARSTREAM_Sender_t_Param);
+void* workloadEncoderThread (void *ARSTREAM_Sender_t_Param);
 
 /**
  * @brief Stream entry point
@@ -168,17 +168,21 @@ int ARSTREAM_SenderTb_StartStreamTest (ARNETWORK_Manager_t *manager);
 
 void ARSTREAM_SenderTb_printUsage ()
 {
-    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Usage : %s [ip]", appName);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Usage : %s [ip [workload]]", appName);
     ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        ip -> optionnal, ip of the stream reader");
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "        workload -> optionnal, frames to send :");
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "                    gop:bitrateKbps[:fps[:gopLength[:iToPRatio[:sizeVariation]]]] (default gop:%d:%d:%d:%.0f:%.1f)", BITRATE_KBPS, FPS, I_FRAME_EVERY_N, I_TO_P_RATIO, FRAME_SIZE_VARIATION);
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "                    csv:path (lines of timeUs,size,type)");
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "                    mp4:path (frame sizes, types and times of an mp4 file)");
 }
 
-void ARSTREAM_SenderTb_initMultiBuffers ()
+void ARSTREAM_SenderTb_initMultiBuffers (uint32_t maxsize)
 {
     int buffIndex;
     for (buffIndex = 0; buffIndex < NB_BUFFERS; buffIndex++)
     {
-        multiBuffer[buffIndex] = malloc (FRAME_MAX_SIZE);
-        multiBufferSize[buffIndex] = FRAME_MAX_SIZE;
+        multiBuffer[buffIndex] = malloc (maxsize);
+        multiBufferSize[buffIndex] = maxsize;
         multiBufferIsFree[buffIndex] = 1;
     }
 }
@@ -217,6 +221,10 @@ void ARSTREAM_SenderTb_FrameUpdateCallback (eARSTREAM_SENDER_STATUS status, uint
         nbOk++;
         ARSTREAM_Sender_PercentOk = (100.f * nbOk) / (1.f * nbSent);
         break;
+    case ARSTREAM_SENDER_STATUS_FLUSH_FRAME_REQUESTED:
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Reader requested a flush frame");
+        flushFrameRequested = 1;
+        break;
     default:
         // All cases handled
         break;
@@ -256,40 +264,48 @@ uint8_t* ARSTREAM_SenderTb_GetNextFreeBuffer (uint32_t *retSize)
     return retBuffer;
 }
 
-void* fakeEncoderThread (void *ARSTREAM_Sender_t_Param)
+void* workloadEncoderThread (void *ARSTREAM_Sender_t_Param)
 {
 
     uint32_t cnt = 0;
-    uint32_t frameSize = 0;
     uint32_t frameCapacity = 0;
     uint8_t *nextFrameAddr;
+    ARSTREAM_Workload_Frame_t frame;
+    struct timespec start, now;
+    int64_t waitMs;
     ARSTREAM_Sender_t *sender = (ARSTREAM_Sender_t *)ARSTREAM_Sender_t_Param;
-    srand (time (NULL));
     ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Encoder thread running");
+    ARSAL_Time_GetTime (&start);
     while (stillRunning)
     {
         cnt++;
-        frameSize = rand () % FRAME_MAX_SIZE;
-        if (frameSize < FRAME_MIN_SIZE)
+        ARSTREAM_Workload_GetNextFrame (g_Workload, &frame);
+
+        /* Wait for the time of the frame in the workload */
+        ARSAL_Time_GetTime (&now);
+        waitMs = (int64_t)(frame.timeUs / 1000) - ARSAL_Time_ComputeTimespecMsTimeDiff (&start, &now);
+        if (waitMs > 0)
         {
-            frameSize = FRAME_MIN_SIZE;
+            usleep (1000 * waitMs);
         }
-        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Generating a frame of size %d with number %u", frameSize, cnt);
+
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Generating a %c-frame of size %u with number %u", (frame.isIFrame == 1) ? 'I' : 'P', frame.size, cnt);
 
         nextFrameAddr = ARSTREAM_SenderTb_GetNextFreeBuffer (&frameCapacity);
         if (nextFrameAddr != NULL)
         {
-            if (frameCapacity >= frameSize)
+            if (frameCapacity >= frame.size)
             {
                 eARSTREAM_ERROR res;
                 int nbPrevious;
-                int flush = ((cnt % I_FRAME_EVERY_N) == 1) ? 1 : 0;
-                memset (nextFrameAddr, cnt, frameSize);
-                res = ARSTREAM_Sender_SendNewFrame (sender, nextFrameAddr, frameSize, flush, &nbPrevious);
+                int flush = ((frame.isIFrame == 1) || (flushFrameRequested == 1)) ? 1 : 0;
+                flushFrameRequested = 0;
+                memset (nextFrameAddr, cnt, frame.size);
+                res = ARSTREAM_Sender_SendNewFrame (sender, nextFrameAddr, frame.size, flush, &nbPrevious);
                 switch (res)
                 {
                 case ARSTREAM_OK:
-                    ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Added a frame of size %u to the Sender (already %d in queue)", frameSize, nbPrevious);
+                    ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Added a frame of size %u to the Sender (already %d in queue)", frame.size, nbPrevious);
                     break;
                 case ARSTREAM_ERROR_BAD_PARAMETERS:
                 case ARSTREAM_ERROR_FRAME_TOO_LARGE:
@@ -310,8 +326,6 @@ void* fakeEncoderThread (void *ARSTREAM_Sender_t_Param)
         {
             ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Could not encode a new frame : no free buffer !");
         }
-
-        usleep (1000 * TIME_BETWEEN_FRAMES_MS);
     }
     ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Encoder thread ended");
     return (void *)0;
@@ -321,13 +335,14 @@ int ARSTREAM_SenderTb_StartStreamTest (ARNETWORK_Manager_t *manager)
 {
     int retVal = 0;
     eARSTREAM_ERROR err;
-    ARSTREAM_SenderTb_initMultiBuffers ();
+    ARSTREAM_SenderTb_initMultiBuffers (ARSTREAM_Workload_GetMaxFrameSize (g_Workload));
     g_Sender = ARSTREAM_Sender_New (manager, DATA_BUFFER_ID, ACK_BUFFER_ID, ARSTREAM_SenderTb_FrameUpdateCallback, NB_BUFFERS, ARSTREAM_TB_FRAG_SIZE, ARSTREAM_TB_MAX_NB_FRAG, NULL, &err);
     if (g_Sender == NULL)
     {
         ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Error during ARSTREAM_Sender_New call : %s", ARSTREAM_Error_ToString(err));
         return 1;
     }
+    ARSTREAM_Sender_SetFrameTimestamps (g_Sender, 1);
 
     pthread_t streamsend, streamread;
     pthread_create (&streamsend, NULL, ARSTREAM_Sender_RunDataThread, g_Sender);
@@ -336,7 +351,7 @@ int ARSTREAM_SenderTb_StartStreamTest (ARNETWORK_Manager_t *manager)
     /* USER CODE */
 
     pthread_t sourceThread;
-    pthread_create (&sourceThread, NULL, fakeEncoderThread, g_Sender);
+    pthread_create (&sourceThread, NULL, workloadEncoderThread, g_Sender);
     pthread_join (sourceThread, NULL);
 
     /* END OF USER CODE */
@@ -359,7 +374,7 @@ int ARSTREAM_Sender_TestBenchMain (int argc, char *argv[])
 {
     int retVal = 0;
     appName = argv[0];
-    if (3 <=  argc)
+    if (4 <=  argc)
     {
         ARSTREAM_SenderTb_printUsage ();
         return 1;
@@ -367,11 +382,26 @@ int ARSTREAM_Sender_TestBenchMain (int argc, char *argv[])
 
     char *ip = __IP;
 
-    if (2 == argc)
+    if (2 <= argc)
     {
         ip = argv[1];
     }
 
+    if (3 == argc)
+    {
+        g_Workload = ARSTREAM_Workload_NewFromSpec (argv[2], (uint32_t)time (NULL));
+    }
+    else
+    {
+        ARSTREAM_Workload_GopConfig_t gop = { BITRATE_KBPS, FPS, I_FRAME_EVERY_N, I_TO_P_RATIO, FRAME_SIZE_VARIATION, (uint32_t)time (NULL) };
+        g_Workload = ARSTREAM_Workload_NewGop (&gop);
+    }
+    if (g_Workload == NULL)
+    {
+        ARSTREAM_SenderTb_printUsage ();
+        return 1;
+    }
+
     int nbInBuff = 1;
     ARNETWORK_IOBufferParam_t inParams;
     ARSTREAM_Sender_InitStreamDataBuffer (&inParams, DATA_BUFFER_ID, ARSTREAM_TB_FRAG_SIZE, ARSTREAM_TB_MAX_NB_FRAG);
@@ -418,6 +448,7 @@ int ARSTREAM_Sender_TestBenchMain (int argc, char *argv[])
     pthread_join (netsend, NULL);
 
     ARNETWORK_Manager_Delete (&g_Manager);
+    ARSTREAM_Workload_Delete (&g_Workload);
 
     return retVal;
 }
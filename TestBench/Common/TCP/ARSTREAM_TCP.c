@@ -0,0 +1,337 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_TCP.c
+ * @brief TCP baseline for the testbenches : length prefixed frames over a TCP stream
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "ARSTREAM_TCP.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_TCP"
+
+#define ARSTREAM_TCP_RING_SIZE_MIN (4096)
+
+/*
+ * Types
+ */
+
+struct ARSTREAM_TCP_Receiver {
+    int socket;
+    uint8_t *ring;
+    uint32_t ringSize; /* Power of two */
+    uint32_t readIndex; /* Free running : the ring holds writeIndex - readIndex bytes */
+    uint32_t writeIndex;
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Receives as much data as the contiguous free space of the ring can hold
+ * @param receiver The receiver
+ * @return The number of bytes received, or -1 if the connection is closed or broken
+ */
+static int ARSTREAM_TCP_Receiver_Fill (ARSTREAM_TCP_Receiver_t *receiver);
+
+/**
+ * @brief Takes bytes out of the ring
+ * @param receiver The receiver
+ * @param dest Where to copy the bytes, or NULL to drop them
+ * @param size Number of bytes, at most the number of bytes in the ring
+ */
+static void ARSTREAM_TCP_Receiver_Consume (ARSTREAM_TCP_Receiver_t *receiver, uint8_t *dest, uint32_t size);
+
+/*
+ * Internal functions implementation
+ */
+
+static int ARSTREAM_TCP_Receiver_Fill (ARSTREAM_TCP_Receiver_t *receiver)
+{
+    uint32_t used = receiver->writeIndex - receiver->readIndex;
+    uint32_t offset = receiver->writeIndex & (receiver->ringSize - 1);
+    uint32_t contiguous = receiver->ringSize - offset;
+    ssize_t nbRead;
+
+    if (contiguous > receiver->ringSize - used)
+    {
+        contiguous = receiver->ringSize - used;
+    }
+    do
+    {
+        nbRead = recv (receiver->socket, &receiver->ring [offset], contiguous, 0);
+    } while ((nbRead < 0) && (errno == EINTR));
+
+    if (nbRead <= 0)
+    {
+        if (nbRead < 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Read error %s", strerror (errno));
+        }
+        return -1;
+    }
+    receiver->writeIndex += (uint32_t)nbRead;
+    return (int)nbRead;
+}
+
+static void ARSTREAM_TCP_Receiver_Consume (ARSTREAM_TCP_Receiver_t *receiver, uint8_t *dest, uint32_t size)
+{
+    uint32_t offset = receiver->readIndex & (receiver->ringSize - 1);
+    uint32_t first = receiver->ringSize - offset;
+
+    if (dest != NULL)
+    {
+        if (first >= size)
+        {
+            memcpy (dest, &receiver->ring [offset], size);
+        }
+        else
+        {
+            /* Wraps around the end of the ring */
+            memcpy (dest, &receiver->ring [offset], first);
+            memcpy (&dest [first], receiver->ring, size - first);
+        }
+    }
+    receiver->readIndex += size;
+}
+
+/*
+ * Implementation
+ */
+
+int ARSTREAM_TCP_SetOptions (int socket, const ARSTREAM_TCP_Options_t *options)
+{
+    int retVal = 0;
+    int noDelay = (options->noDelay != 0) ? 1 : 0;
+
+    if (setsockopt (socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof (noDelay)) != 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to set TCP_NODELAY : %s", strerror (errno));
+        retVal = -1;
+    }
+    if (options->notSentLowat != 0)
+    {
+#ifdef TCP_NOTSENT_LOWAT
+        int lowat = (int)options->notSentLowat;
+        if (setsockopt (socket, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &lowat, sizeof (lowat)) != 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to set TCP_NOTSENT_LOWAT : %s", strerror (errno));
+            retVal = -1;
+        }
+#else
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "TCP_NOTSENT_LOWAT is not supported");
+        retVal = -1;
+#endif
+    }
+    return retVal;
+}
+
+int ARSTREAM_TCP_IsWritable (int socket)
+{
+    struct pollfd fd;
+    fd.fd = socket;
+    fd.events = POLLOUT;
+    fd.revents = 0;
+    return ((poll (&fd, 1, 0) == 1) && ((fd.revents & POLLOUT) != 0)) ? 1 : 0;
+}
+
+int ARSTREAM_TCP_SendFrame (int socket, uint32_t number, const uint8_t *frame, uint32_t size)
+{
+    uint8_t header [ARSTREAM_TCP_FRAME_HEADER_SIZE];
+    struct iovec iov [2];
+    struct msghdr msg;
+    int iovIndex = 0;
+    uint32_t total = ARSTREAM_TCP_FRAME_HEADER_SIZE + size;
+    uint32_t written = 0;
+
+    header [0] = (uint8_t)(size >> 24);
+    header [1] = (uint8_t)(size >> 16);
+    header [2] = (uint8_t)(size >> 8);
+    header [3] = (uint8_t)size;
+    header [4] = (uint8_t)(number >> 24);
+    header [5] = (uint8_t)(number >> 16);
+    header [6] = (uint8_t)(number >> 8);
+    header [7] = (uint8_t)number;
+    iov [0].iov_base = header;
+    iov [0].iov_len = ARSTREAM_TCP_FRAME_HEADER_SIZE;
+    iov [1].iov_base = (void *)frame;
+    iov [1].iov_len = size;
+
+    /* One syscall for the header and the data, unless the socket buffer is full */
+    while (written < total)
+    {
+        ssize_t nbWritten;
+        memset (&msg, 0, sizeof (msg));
+        msg.msg_iov = &iov [iovIndex];
+        msg.msg_iovlen = 2 - iovIndex;
+        /* A closed peer is reported as an error, not as SIGPIPE */
+        nbWritten = sendmsg (socket, &msg, MSG_NOSIGNAL);
+        if (nbWritten < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Write error %s", strerror (errno));
+            return -1;
+        }
+        written += (uint32_t)nbWritten;
+        while ((iovIndex < 2) &&
+               ((size_t)nbWritten >= iov [iovIndex].iov_len))
+        {
+            nbWritten -= iov [iovIndex].iov_len;
+            iovIndex++;
+        }
+        if (iovIndex < 2)
+        {
+            iov [iovIndex].iov_base = (uint8_t *)iov [iovIndex].iov_base + nbWritten;
+            iov [iovIndex].iov_len -= nbWritten;
+        }
+    }
+    return (int)total;
+}
+
+ARSTREAM_TCP_Receiver_t* ARSTREAM_TCP_Receiver_New (int socket, uint32_t ringSize)
+{
+    ARSTREAM_TCP_Receiver_t *receiver = calloc (1, sizeof (ARSTREAM_TCP_Receiver_t));
+    if (receiver == NULL)
+    {
+        return NULL;
+    }
+    receiver->socket = socket;
+    receiver->ringSize = ARSTREAM_TCP_RING_SIZE_MIN;
+    while ((receiver->ringSize < ringSize) &&
+           (receiver->ringSize < 0x80000000u))
+    {
+        receiver->ringSize <<= 1;
+    }
+    receiver->ring = malloc (receiver->ringSize);
+    if (receiver->ring == NULL)
+    {
+        ARSTREAM_TCP_Receiver_Delete (&receiver);
+    }
+    return receiver;
+}
+
+void ARSTREAM_TCP_Receiver_Delete (ARSTREAM_TCP_Receiver_t **receiver)
+{
+    if ((receiver != NULL) &&
+        (*receiver != NULL))
+    {
+        free ((*receiver)->ring);
+        free (*receiver);
+        *receiver = NULL;
+    }
+}
+
+int ARSTREAM_TCP_Receiver_ReadFrame (ARSTREAM_TCP_Receiver_t *receiver, uint8_t *frame, uint32_t capacity, uint32_t *number)
+{
+    uint8_t header [ARSTREAM_TCP_FRAME_HEADER_SIZE];
+    uint32_t size, remaining;
+    int fits;
+
+    if (receiver == NULL)
+    {
+        return -1;
+    }
+
+    while (receiver->writeIndex - receiver->readIndex < ARSTREAM_TCP_FRAME_HEADER_SIZE)
+    {
+        if (ARSTREAM_TCP_Receiver_Fill (receiver) < 0)
+        {
+            return -1;
+        }
+    }
+    ARSTREAM_TCP_Receiver_Consume (receiver, header, ARSTREAM_TCP_FRAME_HEADER_SIZE);
+    size = ((uint32_t)header [0] << 24) | ((uint32_t)header [1] << 16) | ((uint32_t)header [2] << 8) | header [3];
+    if (number != NULL)
+    {
+        *number = ((uint32_t)header [4] << 24) | ((uint32_t)header [5] << 16) | ((uint32_t)header [6] << 8) | header [7];
+    }
+    if (size > INT32_MAX)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Invalid frame size %u", size);
+        return -1;
+    }
+    fits = ((frame != NULL) && (size <= capacity)) ? 1 : 0;
+    if (fits == 0)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Frame too big for buffer (%u / %u) : skipped", size, capacity);
+    }
+
+    /* The frame goes through the ring in chunks : it may be larger than the ring */
+    remaining = size;
+    while (remaining > 0)
+    {
+        uint32_t available = receiver->writeIndex - receiver->readIndex;
+        if (available == 0)
+        {
+            if (ARSTREAM_TCP_Receiver_Fill (receiver) < 0)
+            {
+                return -1;
+            }
+            continue;
+        }
+        if (available > remaining)
+        {
+            available = remaining;
+        }
+        ARSTREAM_TCP_Receiver_Consume (receiver, (fits != 0) ? &frame [size - remaining] : NULL, available);
+        remaining -= available;
+    }
+    return (fits != 0) ? (int)size : 0;
+}
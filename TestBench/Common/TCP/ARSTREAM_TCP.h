@@ -0,0 +1,121 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_TCP.h
+ * @brief TCP baseline for the testbenches : length prefixed frames over a TCP stream
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ *
+ * Each frame is sent as an 8 bytes header (frame size, frame number, both big endian) followed by
+ * the frame data. The receiver reads the stream through a ring buffer with large recv calls, and
+ * never has to search for frame boundaries.
+ */
+
+#ifndef _ARSTREAM_TCP_H_
+#define _ARSTREAM_TCP_H_
+
+#include <inttypes.h>
+
+/**
+ * @brief Size of the header sent before each frame, in bytes
+ */
+#define ARSTREAM_TCP_FRAME_HEADER_SIZE (8)
+
+/**
+ * @brief Default size of the receiver ring buffer, in bytes
+ */
+#define ARSTREAM_TCP_RING_SIZE_DEFAULT (64 * 1024)
+
+/**
+ * @brief Socket options of the TCP baseline
+ */
+typedef struct {
+    int noDelay; /**< 1 to disable Nagle's algorithm (TCP_NODELAY) */
+    uint32_t notSentLowat; /**< Limit of not yet sent bytes for the socket to be writable (TCP_NOTSENT_LOWAT), 0 to keep the system default */
+} ARSTREAM_TCP_Options_t;
+
+/**
+ * @brief Receiving side of a TCP baseline stream
+ */
+typedef struct ARSTREAM_TCP_Receiver ARSTREAM_TCP_Receiver_t;
+
+/**
+ * @brief Sets the baseline options of a TCP socket
+ * @param socket The socket
+ * @param options The options
+ * @return 0 on success, -1 if an option can not be set
+ */
+int ARSTREAM_TCP_SetOptions (int socket, const ARSTREAM_TCP_Options_t *options);
+
+/**
+ * @brief Tells if a frame can be written without waiting
+ * With TCP_NOTSENT_LOWAT, this is false as long as more than notSentLowat bytes are waiting to be sent
+ * @param socket The socket
+ * @return 1 if the socket is writable, 0 otherwise
+ */
+int ARSTREAM_TCP_IsWritable (int socket);
+
+/**
+ * @brief Sends a frame (header and data)
+ * @param socket The socket
+ * @param number Number of the frame
+ * @param frame The frame data
+ * @param size Size of the frame, in bytes
+ * @return The number of bytes written (header included), or -1 on error
+ * @note This call blocks until the whole frame is in the socket buffer
+ */
+int ARSTREAM_TCP_SendFrame (int socket, uint32_t number, const uint8_t *frame, uint32_t size);
+
+/**
+ * @brief Creates a receiver on a connected socket
+ * @param socket The socket. Not closed by ARSTREAM_TCP_Receiver_Delete()
+ * @param ringSize Size of the ring buffer, in bytes (rounded up to a power of two). Frames may be larger
+ * @return The receiver, or NULL on allocation error
+ */
+ARSTREAM_TCP_Receiver_t* ARSTREAM_TCP_Receiver_New (int socket, uint32_t ringSize);
+
+/**
+ * @brief Deletes a receiver
+ * @param receiver Pointer to the ARSTREAM_TCP_Receiver_t * to delete. Set to NULL
+ */
+void ARSTREAM_TCP_Receiver_Delete (ARSTREAM_TCP_Receiver_t **receiver);
+
+/**
+ * @brief Reads the next frame of the stream
+ * @param receiver The receiver
+ * @param frame The buffer to fill
+ * @param capacity Capacity of the buffer, in bytes
+ * @param[out] number Number of the frame. May be NULL
+ * @return The frame size, 0 if the frame is empty or larger than capacity (its data is then skipped, the stream stays in sync), or -1 if the connection is closed or broken
+ */
+int ARSTREAM_TCP_Receiver_ReadFrame (ARSTREAM_TCP_Receiver_t *receiver, uint8_t *frame, uint32_t capacity, uint32_t *number);
+
+#endif /* _ARSTREAM_TCP_H_ */
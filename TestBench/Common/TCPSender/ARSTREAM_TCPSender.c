@@ -50,6 +50,8 @@
 #include <libARSAL/ARSAL_Print.h>
 #include <libARSAL/ARSAL_Socket.h>
 
+#include "../TCP/ARSTREAM_TCP.h"
+
 /*
  * Macros
  */
@@ -73,7 +75,8 @@
 
 #define NB_FRAMES_FOR_AVERAGE (15)
 
-#define HEADER_MAGIC (0x37333331)
+/* Keep at most about one frame waiting in the socket : like the ARSTREAM_Sender queue, late frames are dropped */
+#define NOT_SENT_LOWAT (FRAME_MAX_SIZE)
 
 /*
  * Types
@@ -84,12 +87,6 @@ typedef struct {
     int csocket;
 } ARSTREAM_TCPSender_t;
 
-typedef struct {
-    uint32_t header;
-    uint32_t size;
-    uint32_t num;
-} ARSTREAM_TCPSender_FrameHeader_t;
-
 /*
  * Globals
  */
@@ -116,8 +113,9 @@ ARSTREAM_TCPSender_t *ARSTREAM_TCPSender_Create (int port);
 
 /**
  * Send a frame through an ARSTREAM_TCPSender_t
+ * @return 1 if the frame was sent, 0 if it was dropped because the socket still holds the previous frames, -1 on error
  */
-void ARSTREAM_TCPSender_SendFrame (ARSTREAM_TCPSender_t *sender, ARSTREAM_TCPSender_FrameHeader_t *header, uint8_t *frame);
+int ARSTREAM_TCPSender_SendFrame (ARSTREAM_TCPSender_t *sender, uint32_t num, uint8_t *frame, uint32_t size);
 
 /**
  * Delete an ARSTREAM_TCPSender_t
@@ -131,7 +129,7 @@ void ARSTREAM_TCPSender_Delete (ARSTREAM_TCPSender_t **sender);
 void* TCP_fakeEncoderThread (void *param)
 {
     uint8_t *buffer;
-    ARSTREAM_TCPSender_FrameHeader_t header = { HEADER_MAGIC, 0, 0 };
+    uint32_t num = 0;
     ARSTREAM_TCPSender_t *sender = (ARSTREAM_TCPSender_t *)param;
     srand (time (NULL));
     ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Encoder thread running");
@@ -143,17 +141,19 @@ void* TCP_fakeEncoderThread (void *param)
     }
     while (stillRunning)
     {
-        header.num ++;
+        num ++;
         int frameSize = rand () % FRAME_MAX_SIZE;
         if (frameSize < FRAME_MIN_SIZE)
         {
             frameSize = FRAME_MIN_SIZE;
         }
-        header.size = frameSize;
-        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Generating a frame of size %d with number %u", header.size, header.num);
+        ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Generating a frame of size %d with number %u", frameSize, num);
 
-        memset (buffer, header.num, header.size);
-        ARSTREAM_TCPSender_SendFrame (sender, &header, buffer);
+        memset (buffer, num, frameSize);
+        if (ARSTREAM_TCPSender_SendFrame (sender, num, buffer, frameSize) == 0)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Socket still busy : dropped frame %u", num);
+        }
         usleep (1000 * TIME_BETWEEN_FRAMES_MS);
     }
     ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Encoder thread ended");
@@ -209,20 +209,25 @@ ARSTREAM_TCPSender_t *ARSTREAM_TCPSender_Create (int port)
 
     ARSAL_PRINT (ARSAL_PRINT_WARNING, __TAG__, "Connected !");
 
+    ARSTREAM_TCP_Options_t options = { 1, NOT_SENT_LOWAT };
+    ARSTREAM_TCP_SetOptions (sender->csocket, &options);
+
     return sender;
 }
 
-void ARSTREAM_TCPSender_SendFrame (ARSTREAM_TCPSender_t *sender, ARSTREAM_TCPSender_FrameHeader_t *header, uint8_t *frame)
+int ARSTREAM_TCPSender_SendFrame (ARSTREAM_TCPSender_t *sender, uint32_t num, uint8_t *frame, uint32_t size)
 {
     if ((sender == NULL) ||
-        (header == NULL) ||
         (frame  == NULL))
     {
-        return;
+        return -1;
     }
 
-    ARSAL_Socket_Send (sender->csocket, header, sizeof (ARSTREAM_TCPSender_FrameHeader_t), 0);
-    ARSAL_Socket_Send (sender->csocket, frame, header->size, 0);
+    if (ARSTREAM_TCP_IsWritable (sender->csocket) == 0)
+    {
+        return 0;
+    }
+    return (ARSTREAM_TCP_SendFrame (sender->csocket, num, frame, size) < 0) ? -1 : 1;
 }
 
 void ARSTREAM_TCPSender_Delete (ARSTREAM_TCPSender_t **sender)
@@ -0,0 +1,381 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Workload.c
+ * @brief Frame workloads for the testbenches : synthetic GOP streams, or replayed traces
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <errno.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "ARSTREAM_Workload.h"
+#include "../MP4/ARSTREAM_MP4.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "ARSTREAM_Workload"
+
+#define ARSTREAM_WORKLOAD_LINE_SIZE (256)
+#define ARSTREAM_WORKLOAD_DEFAULT_FPS (30)
+#define ARSTREAM_WORKLOAD_DEFAULT_GOP_LENGTH (30)
+#define ARSTREAM_WORKLOAD_DEFAULT_I_TO_P_RATIO (6.f)
+#define ARSTREAM_WORKLOAD_DEFAULT_SIZE_VARIATION (0.2f)
+
+/*
+ * Types
+ */
+
+struct ARSTREAM_Workload {
+    /* Synthetic GOP */
+    ARSTREAM_Workload_GopConfig_t gop;
+    uint32_t iFrameSize;
+    uint32_t pFrameSize;
+    uint32_t random;
+
+    /* Replayed trace (nbFrames > 0) */
+    ARSTREAM_Workload_Frame_t *frames;
+    int nbFrames;
+    uint64_t loopDurationUs;
+
+    uint32_t maxFrameSize;
+    uint64_t frameIndex;
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Creates an empty workload
+ */
+static ARSTREAM_Workload_t* ARSTREAM_Workload_New (void);
+
+/**
+ * @brief Appends a frame to the trace of a workload
+ * @return 0 on success, -1 on allocation error
+ */
+static int ARSTREAM_Workload_AddTraceFrame (ARSTREAM_Workload_t *workload, uint64_t timeUs, uint32_t size, int isIFrame);
+
+/**
+ * @brief Computes the loop duration and the largest frame of a trace, once all its frames are added
+ * @return 0 if the trace holds frames, -1 otherwise
+ */
+static int ARSTREAM_Workload_EndTrace (ARSTREAM_Workload_t *workload);
+
+/**
+ * @brief Gets a random number in [0, 1[ (xorshift32)
+ */
+static float ARSTREAM_Workload_Random (ARSTREAM_Workload_t *workload);
+
+/*
+ * Internal functions implementation
+ */
+
+static ARSTREAM_Workload_t* ARSTREAM_Workload_New (void)
+{
+    return calloc (1, sizeof (ARSTREAM_Workload_t));
+}
+
+static int ARSTREAM_Workload_AddTraceFrame (ARSTREAM_Workload_t *workload, uint64_t timeUs, uint32_t size, int isIFrame)
+{
+    /* Grow by powers of two */
+    if ((workload->nbFrames & (workload->nbFrames - 1)) == 0)
+    {
+        int capacity = (workload->nbFrames == 0) ? 256 : 2 * workload->nbFrames;
+        ARSTREAM_Workload_Frame_t *frames = realloc (workload->frames, capacity * sizeof (ARSTREAM_Workload_Frame_t));
+        if (frames == NULL)
+        {
+            return -1;
+        }
+        workload->frames = frames;
+    }
+    workload->frames [workload->nbFrames].timeUs = timeUs;
+    workload->frames [workload->nbFrames].size = size;
+    workload->frames [workload->nbFrames].isIFrame = isIFrame;
+    workload->nbFrames++;
+    if (size > workload->maxFrameSize)
+    {
+        workload->maxFrameSize = size;
+    }
+    return 0;
+}
+
+static int ARSTREAM_Workload_EndTrace (ARSTREAM_Workload_t *workload)
+{
+    uint64_t firstUs, lastUs;
+    if (workload->nbFrames == 0)
+    {
+        return -1;
+    }
+    firstUs = workload->frames [0].timeUs;
+    lastUs = workload->frames [workload->nbFrames - 1].timeUs;
+    if ((workload->nbFrames == 1) ||
+        (lastUs <= firstUs))
+    {
+        workload->loopDurationUs = (uint64_t)workload->nbFrames * 1000000 / ARSTREAM_WORKLOAD_DEFAULT_FPS;
+    }
+    else
+    {
+        /* The next loop starts one mean frame interval after the last frame */
+        workload->loopDurationUs = (lastUs - firstUs) + (lastUs - firstUs) / (workload->nbFrames - 1);
+    }
+    return 0;
+}
+
+static float ARSTREAM_Workload_Random (ARSTREAM_Workload_t *workload)
+{
+    uint32_t x = workload->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    workload->random = x;
+    return (x >> 8) / 16777216.f;
+}
+
+/*
+ * Implementation
+ */
+
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewGop (const ARSTREAM_Workload_GopConfig_t *config)
+{
+    ARSTREAM_Workload_t *workload = NULL;
+    uint32_t meanFrameSize;
+
+    if ((config == NULL) ||
+        (config->bitrateKbps == 0) ||
+        (config->fps == 0) ||
+        (config->gopLength == 0) ||
+        (config->iToPRatio < 1.f) ||
+        (config->sizeVariation < 0.f) ||
+        (config->sizeVariation >= 1.f))
+    {
+        return NULL;
+    }
+    workload = ARSTREAM_Workload_New ();
+    if (workload == NULL)
+    {
+        return NULL;
+    }
+    workload->gop = *config;
+
+    /* gopLength * mean = I + (gopLength - 1) * P, with I = ratio * P */
+    meanFrameSize = config->bitrateKbps * 1000 / 8 / config->fps;
+    workload->pFrameSize = (uint32_t)(config->gopLength * (float)meanFrameSize / (config->iToPRatio + config->gopLength - 1));
+    workload->iFrameSize = (config->gopLength == 1) ? meanFrameSize : (uint32_t)(config->iToPRatio * workload->pFrameSize);
+    workload->maxFrameSize = (uint32_t)(workload->iFrameSize * (1.f + config->sizeVariation)) + 1;
+    workload->random = (config->seed != 0) ? config->seed : 1;
+    return workload;
+}
+
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewFromCsv (const char *path)
+{
+    ARSTREAM_Workload_t *workload = NULL;
+    char line [ARSTREAM_WORKLOAD_LINE_SIZE];
+    unsigned long long timeUs;
+    unsigned long size;
+    char type;
+    int lineNumber = 0;
+    int error = 0;
+    FILE *file;
+
+    file = fopen (path, "r");
+    if (file == NULL)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to open %s : %s", path, strerror (errno));
+        return NULL;
+    }
+    workload = ARSTREAM_Workload_New ();
+    error = (workload == NULL) ? 1 : 0;
+
+    while ((error == 0) &&
+           (fgets (line, sizeof (line), file) != NULL))
+    {
+        lineNumber++;
+        if ((line[0] == '#') ||
+            (line[0] == '\n') ||
+            (line[0] == '\r') ||
+            (isalpha ((unsigned char)line[0])))
+        {
+            continue;
+        }
+        if (sscanf (line, "%llu , %lu , %c", &timeUs, &size, &type) != 3)
+        {
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "%s:%d : expected \"timeUs,size,type\"", path, lineNumber);
+            error = 1;
+        }
+        else if ((workload->nbFrames > 0) &&
+                 (timeUs < workload->frames [workload->nbFrames - 1].timeUs))
+        {
+            /* The frames are replayed in file order : a time going back would underflow the inter-frame delay */
+            ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "%s:%d : time %llu is before the time of the previous frame (%llu)", path, lineNumber, timeUs, (unsigned long long)workload->frames [workload->nbFrames - 1].timeUs);
+            error = 1;
+        }
+        else if (ARSTREAM_Workload_AddTraceFrame (workload, timeUs, (uint32_t)size, ((type == 'I') || (type == 'i') || (type == '1')) ? 1 : 0) != 0)
+        {
+            error = 1;
+        }
+    }
+    fclose (file);
+
+    if ((error == 0) &&
+        (ARSTREAM_Workload_EndTrace (workload) != 0))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "%s holds no frame", path);
+        error = 1;
+    }
+    if (error != 0)
+    {
+        ARSTREAM_Workload_Delete (&workload);
+    }
+    return workload;
+}
+
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewFromMP4 (const char *path)
+{
+    ARSTREAM_Workload_t *workload = NULL;
+    ARSTREAM_MP4_t *mp4 = NULL;
+    int error = 0;
+    int i;
+
+    mp4 = ARSTREAM_MP4_Open (path);
+    if (mp4 == NULL)
+    {
+        return NULL;
+    }
+    workload = ARSTREAM_Workload_New ();
+    error = (workload == NULL) ? 1 : 0;
+    for (i = 0; (error == 0) && (i < ARSTREAM_MP4_GetNbFrames (mp4)); i++)
+    {
+        error = ARSTREAM_Workload_AddTraceFrame (workload, ARSTREAM_MP4_GetFrameTimeUs (mp4, i), ARSTREAM_MP4_GetFrameSize (mp4, i), ARSTREAM_MP4_IsIFrame (mp4, i));
+    }
+
+    if ((error != 0) ||
+        (ARSTREAM_Workload_EndTrace (workload) != 0))
+    {
+        ARSTREAM_Workload_Delete (&workload);
+    }
+    else if (ARSTREAM_MP4_GetDurationUs (mp4) > workload->frames [workload->nbFrames - 1].timeUs - workload->frames [0].timeUs)
+    {
+        /* The file knows the duration of its last frame */
+        workload->loopDurationUs = ARSTREAM_MP4_GetDurationUs (mp4) - workload->frames [0].timeUs;
+    }
+    ARSTREAM_MP4_Close (&mp4);
+    return workload;
+}
+
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewFromSpec (const char *spec, uint32_t seed)
+{
+    ARSTREAM_Workload_GopConfig_t config;
+
+    if (spec == NULL)
+    {
+        return NULL;
+    }
+    if (strncmp (spec, "csv:", 4) == 0)
+    {
+        return ARSTREAM_Workload_NewFromCsv (&spec[4]);
+    }
+    if (strncmp (spec, "mp4:", 4) == 0)
+    {
+        return ARSTREAM_Workload_NewFromMP4 (&spec[4]);
+    }
+    if (strncmp (spec, "gop:", 4) == 0)
+    {
+        config.bitrateKbps = 0;
+        config.fps = ARSTREAM_WORKLOAD_DEFAULT_FPS;
+        config.gopLength = ARSTREAM_WORKLOAD_DEFAULT_GOP_LENGTH;
+        config.iToPRatio = ARSTREAM_WORKLOAD_DEFAULT_I_TO_P_RATIO;
+        config.sizeVariation = ARSTREAM_WORKLOAD_DEFAULT_SIZE_VARIATION;
+        config.seed = seed;
+        if (sscanf (&spec[4], "%u:%u:%u:%f:%f", &config.bitrateKbps, &config.fps, &config.gopLength, &config.iToPRatio, &config.sizeVariation) >= 1)
+        {
+            return ARSTREAM_Workload_NewGop (&config);
+        }
+    }
+    ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Invalid workload \"%s\"", spec);
+    return NULL;
+}
+
+void ARSTREAM_Workload_Delete (ARSTREAM_Workload_t **workload)
+{
+    if ((workload != NULL) &&
+        (*workload != NULL))
+    {
+        free ((*workload)->frames);
+        free (*workload);
+        *workload = NULL;
+    }
+}
+
+void ARSTREAM_Workload_GetNextFrame (ARSTREAM_Workload_t *workload, ARSTREAM_Workload_Frame_t *frame)
+{
+    if (workload->nbFrames > 0)
+    {
+        uint64_t loop = workload->frameIndex / workload->nbFrames;
+        const ARSTREAM_Workload_Frame_t *traceFrame = &workload->frames [workload->frameIndex % workload->nbFrames];
+        *frame = *traceFrame;
+        frame->timeUs = (traceFrame->timeUs - workload->frames [0].timeUs) + loop * workload->loopDurationUs;
+    }
+    else
+    {
+        float variation = workload->gop.sizeVariation * (2.f * ARSTREAM_Workload_Random (workload) - 1.f);
+        frame->isIFrame = ((workload->frameIndex % workload->gop.gopLength) == 0) ? 1 : 0;
+        frame->size = (uint32_t)(((frame->isIFrame == 1) ? workload->iFrameSize : workload->pFrameSize) * (1.f + variation));
+        if (frame->size == 0)
+        {
+            frame->size = 1;
+        }
+        frame->timeUs = workload->frameIndex * 1000000 / workload->gop.fps;
+    }
+    workload->frameIndex++;
+}
+
+uint32_t ARSTREAM_Workload_GetMaxFrameSize (ARSTREAM_Workload_t *workload)
+{
+    return workload->maxFrameSize;
+}
@@ -0,0 +1,123 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Workload.h
+ * @brief Frame workloads for the testbenches : synthetic GOP streams, or replayed traces
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ */
+
+#ifndef _ARSTREAM_WORKLOAD_H_
+#define _ARSTREAM_WORKLOAD_H_
+
+#include <inttypes.h>
+
+/**
+ * @brief A source of frame descriptions (size, type, time), looping forever
+ */
+typedef struct ARSTREAM_Workload ARSTREAM_Workload_t;
+
+/**
+ * @brief Description of a frame of a workload
+ */
+typedef struct {
+    uint32_t size; /**< Size of the frame, in bytes */
+    int isIFrame; /**< 1 for key frames (sent as flush frames), 0 otherwise */
+    uint64_t timeUs; /**< Time of the frame from the start of the workload, in us. Keeps increasing when the workload loops */
+} ARSTREAM_Workload_Frame_t;
+
+/**
+ * @brief Parameters of a synthetic GOP (Group Of Pictures) stream
+ * Each GOP is one I-Frame followed by P-Frames. The mean bitrate is kept, whatever the I/P ratio
+ */
+typedef struct {
+    uint32_t bitrateKbps; /**< Mean bitrate, in kbit/s */
+    uint32_t fps; /**< Frame rate */
+    uint32_t gopLength; /**< Number of frames per GOP (1 : only I-Frames) */
+    float iToPRatio; /**< Size of the I-Frames relative to the P-Frames (typically 4 to 10 for H.264) */
+    float sizeVariation; /**< Random variation of each frame size, relative to its mean size, in [0, 1[ */
+    uint32_t seed; /**< Seed of the size variations */
+} ARSTREAM_Workload_GopConfig_t;
+
+/**
+ * @brief Creates a synthetic GOP workload
+ * @param config The GOP parameters. Copied
+ * @return The workload, or NULL if the parameters are invalid
+ */
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewGop (const ARSTREAM_Workload_GopConfig_t *config);
+
+/**
+ * @brief Creates a workload replaying a CSV trace
+ * Each line of the trace is "timeUs,size,type", where type is I, P or B (or 1 for key frames, 0 otherwise).
+ * Empty lines, and lines starting with '#' or a letter (headers) are ignored.
+ * The lines are the frames in sending order : their times must not decrease
+ * @param path Path of the CSV file
+ * @return The workload, or NULL if the trace can not be read, holds no frame, or has a decreasing time
+ */
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewFromCsv (const char *path);
+
+/**
+ * @brief Creates a workload replaying the frame sizes, types and times of an mp4 file
+ * @param path Path of the mp4 file
+ * @return The workload, or NULL if the file can not be read
+ */
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewFromMP4 (const char *path);
+
+/**
+ * @brief Creates a workload from a command line description
+ * - "gop:bitrateKbps[:fps[:gopLength[:iToPRatio[:sizeVariation]]]]", e.g. "gop:1200:30:15:6:0.2"
+ * - "csv:path"
+ * - "mp4:path"
+ * @param spec The description
+ * @param seed Seed of the synthetic workloads
+ * @return The workload, or NULL if the description is invalid
+ */
+ARSTREAM_Workload_t* ARSTREAM_Workload_NewFromSpec (const char *spec, uint32_t seed);
+
+/**
+ * @brief Deletes a workload
+ * @param workload Pointer to the ARSTREAM_Workload_t * to delete. Set to NULL
+ */
+void ARSTREAM_Workload_Delete (ARSTREAM_Workload_t **workload);
+
+/**
+ * @brief Gets the next frame of a workload
+ * @param workload The workload
+ * @param[out] frame The description of the frame
+ */
+void ARSTREAM_Workload_GetNextFrame (ARSTREAM_Workload_t *workload, ARSTREAM_Workload_Frame_t *frame);
+
+/**
+ * @brief Gets the size of the largest frame a workload can produce, in bytes
+ */
+uint32_t ARSTREAM_Workload_GetMaxFrameSize (ARSTREAM_Workload_t *workload);
+
+#endif /* _ARSTREAM_WORKLOAD_H_ */
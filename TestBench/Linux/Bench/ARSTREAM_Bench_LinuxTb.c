@@ -0,0 +1,964 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_Bench_LinuxTb.c
+ * @brief Throughput / latency benchmark of a sender and a reader over a local transport
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ *
+ * A sender and a reader of the same process stream frames over a loopback transport pair. Both
+ * transports are impaired (loss, RTT), so the whole stream logic is measured without any network noise.
+ * The frames come from a synthetic GOP workload (large I-Frames, smaller P-Frames) at the swept bitrate,
+ * or from a replayed trace. Each parameter (bitrate, fragment size, frames in queue, loss rate, RTT)
+ * is swept around a base point, and the results are written as JSON.
+ *
+ * With -t tcp, the same workload is streamed over a local TCP connection instead (length prefixed frames,
+ * TCP_NODELAY), as a baseline with the same metrics. An encoder feeding TCP can only drop a frame before
+ * writing it : frames are dropped (framesQueueFull) while the socket holds more than notSentLowat unsent
+ * bytes. The bitrate and notSentLowat are swept. Loss and RTT are left to the network (e.g. netem on lo).
+ *
+ * With -e, the library events (down to each fragment) are recorded to a binary event log during the whole
+ * run, so their cost shows in the measured CPU time. Decode it with ARSTREAM_EventLogDecoder_LinuxTb
+ * (-j exports a Chrome trace of the frames, send rounds and lock waits).
+ *
+ * Usage : ARSTREAM_Bench_LinuxTb [-t loopback|tcp] [-d secondsPerPoint] [-s seed] [-g gopLength[:iToPRatio[:sizeVariation]]] [-w csv:path|mp4:path] [-e events.bin] [-o output.json]
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Transport.h>
+#include <libARStream/ARSTREAM_Impairment.h>
+#include <libARStream/ARSTREAM_EventLog.h>
+
+#include "../../Common/Workload/ARSTREAM_Workload.h"
+#include "../../Common/TCP/ARSTREAM_TCP.h"
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "BENCH"
+
+#define BENCH_FPS (30)
+#define BENCH_DURATION_S_DEFAULT (3)
+#define BENCH_SEED_DEFAULT (42)
+#define BENCH_LOOPBACK_NB_SLOTS (128)
+#define BENCH_MAX_FRAMES_IN_QUEUE (16)
+#define BENCH_NB_BUFFERS (BENCH_MAX_FRAMES_IN_QUEUE + 2)
+#define BENCH_FRAME_HEADER_SIZE (12)
+#define BENCH_DRAIN_TIMEOUT_MS (2000)
+#define BENCH_GOP_LENGTH_DEFAULT (30)
+#define BENCH_I_TO_P_RATIO_DEFAULT (4.f)
+#define BENCH_SIZE_VARIATION_DEFAULT (0.1f)
+
+#define BENCH_BASE_BITRATE_KBPS (4000)
+#define BENCH_BASE_FRAGMENT_SIZE (1400)
+#define BENCH_BASE_FRAMES_IN_QUEUE (4)
+#define BENCH_BASE_LOSS_RATE (0.f)
+#define BENCH_BASE_RTT_MS (0)
+#define BENCH_BASE_NOT_SENT_LOWAT (16 * 1024)
+
+/*
+ * Types
+ */
+
+/**
+ * @brief Parameters of one point of the sweep
+ */
+typedef struct {
+    const char *sweep; /**< Name of the swept parameter */
+    uint32_t bitrateKbps;
+    uint32_t fragmentSize;
+    uint32_t framesInQueue;
+    float lossRate;
+    uint32_t rttMs;
+    uint32_t notSentLowat; /**< TCP only */
+} ARSTREAM_Bench_Point_t;
+
+/**
+ * @brief State of a run, shared by the callbacks
+ */
+typedef struct {
+    uint8_t *buffers [BENCH_NB_BUFFERS];
+    volatile int busy [BENCH_NB_BUFFERS];
+    uint8_t *readerFrame;
+    uint32_t maxFrameSize;
+    volatile int flushRequested;
+    volatile int nbDoneFrames;
+
+    uint32_t *latenciesUs;
+    int maxLatencies;
+    int nbReceivedFrames;
+    int nbSkippedFrames;
+    uint64_t receivedBytes;
+
+    int nbOffered;
+    int nbSent;
+    int nbIFrames;
+    int nbQueueFull;
+    int nbNoBuffer;
+    uint64_t transportBytes; /**< Bytes given to the transport, headers included */
+    double wall;
+    double cpu;
+
+    int socket; /**< TCP only : receiving socket */
+} ARSTREAM_Bench_Run_t;
+
+/*
+ * Globals
+ */
+
+static int g_DurationS = BENCH_DURATION_S_DEFAULT;
+static uint32_t g_Seed = BENCH_SEED_DEFAULT;
+static int g_NbResults = 0;
+static uint32_t g_GopLength = BENCH_GOP_LENGTH_DEFAULT;
+static float g_IToPRatio = BENCH_I_TO_P_RATIO_DEFAULT;
+static float g_SizeVariation = BENCH_SIZE_VARIATION_DEFAULT;
+static const char *g_WorkloadSpec = NULL;
+static int g_Tcp = 0;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Sender callback : releases the frame buffers, and records the flush frame requests
+ */
+void ARSTREAM_Bench_SenderCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
+
+/**
+ * @brief Reader callback : records the latency of each complete frame, and always reuses the same buffer
+ */
+uint8_t* ARSTREAM_Bench_ReaderCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
+
+/**
+ * @brief Records the latency of a received frame
+ */
+void ARSTREAM_Bench_RecordFrame (ARSTREAM_Bench_Run_t *run, const uint8_t *frame, uint32_t frameSize, int nbSkippedFrames);
+
+/**
+ * @brief TCP reader thread : reads frames until the connection is closed
+ * @param param The ARSTREAM_Bench_Run_t
+ */
+void* ARSTREAM_Bench_TcpReaderThread (void *param);
+
+/**
+ * @brief Gets the user + system CPU time of the process, in seconds
+ */
+double ARSTREAM_Bench_GetCpuTime (void);
+
+/**
+ * @brief Gets the monotonic time, in us
+ */
+uint64_t ARSTREAM_Bench_GetTimeUs (void);
+
+/**
+ * @brief Compares two latencies (qsort callback)
+ */
+int ARSTREAM_Bench_CompareLatencies (const void *a, const void *b);
+
+/**
+ * @brief Gets a percentile of sorted latencies, in ms
+ */
+double ARSTREAM_Bench_GetPercentileMs (const uint32_t *sortedLatenciesUs, int nbLatencies, double percentile);
+
+/**
+ * @brief Creates the workload of a point, and allocates the buffers of a run
+ * @return 0 on success
+ */
+int ARSTREAM_Bench_InitRun (ARSTREAM_Bench_Run_t *run, const ARSTREAM_Bench_Point_t *point, ARSTREAM_Workload_t **workload);
+
+/**
+ * @brief Frees the buffers of a run
+ */
+void ARSTREAM_Bench_CleanRun (ARSTREAM_Bench_Run_t *run);
+
+/**
+ * @brief Writes a string as a quoted JSON string, escaping the quotes, backslashes and control characters
+ */
+void ARSTREAM_Bench_WriteJsonString (FILE *out, const char *string);
+
+/**
+ * @brief Writes the JSON result of a run
+ */
+void ARSTREAM_Bench_WriteResult (const ARSTREAM_Bench_Point_t *point, ARSTREAM_Bench_Run_t *run, FILE *out);
+
+/**
+ * @brief Streams frames for one point of the sweep, and writes its JSON result
+ * @return 0 if the run succeeded
+ */
+int ARSTREAM_Bench_Run (const ARSTREAM_Bench_Point_t *point, FILE *out);
+
+/**
+ * @brief Streams frames for one point of the sweep over a local TCP connection, and writes its JSON result
+ * @return 0 if the run succeeded
+ */
+int ARSTREAM_Bench_RunTcp (const ARSTREAM_Bench_Point_t *point, FILE *out);
+
+/*
+ * Internal functions implementation
+ */
+
+void ARSTREAM_Bench_SenderCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
+{
+    ARSTREAM_Bench_Run_t *run = (ARSTREAM_Bench_Run_t *)custom;
+    int i;
+    (void)frameSize;
+
+    switch (status)
+    {
+    case ARSTREAM_SENDER_STATUS_FRAME_SENT:
+    case ARSTREAM_SENDER_STATUS_FRAME_CANCEL:
+        for (i = 0; i < BENCH_NB_BUFFERS; i++)
+        {
+            if (run->buffers [i] == framePointer)
+            {
+                __sync_lock_release (&run->busy [i]);
+            }
+        }
+        __sync_fetch_and_add (&run->nbDoneFrames, 1);
+        break;
+    case ARSTREAM_SENDER_STATUS_FLUSH_FRAME_REQUESTED:
+        run->flushRequested = 1;
+        break;
+    default:
+        break;
+    }
+}
+
+uint8_t* ARSTREAM_Bench_ReaderCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom)
+{
+    ARSTREAM_Bench_Run_t *run = (ARSTREAM_Bench_Run_t *)custom;
+    (void)isFlushFrame;
+
+    if (cause == ARSTREAM_READER_CAUSE_FRAME_COMPLETE)
+    {
+        ARSTREAM_Bench_RecordFrame (run, framePointer, frameSize, numberOfSkippedFrames);
+    }
+    *newBufferCapacity = run->maxFrameSize;
+    return run->readerFrame;
+}
+
+void ARSTREAM_Bench_RecordFrame (ARSTREAM_Bench_Run_t *run, const uint8_t *frame, uint32_t frameSize, int nbSkippedFrames)
+{
+    uint64_t sentUs;
+
+    if (frameSize >= BENCH_FRAME_HEADER_SIZE)
+    {
+        memcpy (&sentUs, &frame [4], sizeof (sentUs));
+        if (run->nbReceivedFrames < run->maxLatencies)
+        {
+            run->latenciesUs [run->nbReceivedFrames] = (uint32_t)(ARSTREAM_Bench_GetTimeUs () - sentUs);
+        }
+        run->nbReceivedFrames++;
+        run->nbSkippedFrames += nbSkippedFrames;
+        run->receivedBytes += frameSize;
+    }
+}
+
+void* ARSTREAM_Bench_TcpReaderThread (void *param)
+{
+    ARSTREAM_Bench_Run_t *run = (ARSTREAM_Bench_Run_t *)param;
+    ARSTREAM_TCP_Receiver_t *receiver = ARSTREAM_TCP_Receiver_New (run->socket, ARSTREAM_TCP_RING_SIZE_DEFAULT);
+    uint32_t number, expected = 0;
+    int size = 0;
+
+    while ((receiver != NULL) &&
+           (size >= 0))
+    {
+        size = ARSTREAM_TCP_Receiver_ReadFrame (receiver, run->readerFrame, run->maxFrameSize, &number);
+        if (size > 0)
+        {
+            ARSTREAM_Bench_RecordFrame (run, run->readerFrame, (uint32_t)size, (int)(number - expected));
+            expected = number + 1;
+        }
+    }
+    ARSTREAM_TCP_Receiver_Delete (&receiver);
+    return NULL;
+}
+
+double ARSTREAM_Bench_GetCpuTime (void)
+{
+    struct rusage usage;
+    getrusage (RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+uint64_t ARSTREAM_Bench_GetTimeUs (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int ARSTREAM_Bench_CompareLatencies (const void *a, const void *b)
+{
+    uint32_t la = *(const uint32_t *)a;
+    uint32_t lb = *(const uint32_t *)b;
+    return (la > lb) - (la < lb);
+}
+
+double ARSTREAM_Bench_GetPercentileMs (const uint32_t *sortedLatenciesUs, int nbLatencies, double percentile)
+{
+    int index;
+    if (nbLatencies <= 0)
+    {
+        return 0.;
+    }
+    /* Nearest rank */
+    index = (int)(percentile * nbLatencies + 0.999999) - 1;
+    if (index < 0)
+    {
+        index = 0;
+    }
+    if (index >= nbLatencies)
+    {
+        index = nbLatencies - 1;
+    }
+    return sortedLatenciesUs [index] / 1000.;
+}
+
+int ARSTREAM_Bench_InitRun (ARSTREAM_Bench_Run_t *run, const ARSTREAM_Bench_Point_t *point, ARSTREAM_Workload_t **workload)
+{
+    ARSTREAM_Workload_GopConfig_t gop;
+    int nbFrames = g_DurationS * BENCH_FPS;
+    int retVal = 0;
+    int i, j;
+
+    memset (run, 0, sizeof (*run));
+    /* Like a video stream, start with a flush frame (I-Frame) */
+    run->flushRequested = 1;
+    run->socket = -1;
+    if (g_WorkloadSpec != NULL)
+    {
+        *workload = ARSTREAM_Workload_NewFromSpec (g_WorkloadSpec, g_Seed);
+    }
+    else
+    {
+        gop.bitrateKbps = point->bitrateKbps;
+        gop.fps = BENCH_FPS;
+        gop.gopLength = g_GopLength;
+        gop.iToPRatio = g_IToPRatio;
+        gop.sizeVariation = g_SizeVariation;
+        gop.seed = g_Seed;
+        *workload = ARSTREAM_Workload_NewGop (&gop);
+    }
+    if (*workload == NULL)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Invalid workload");
+        return 1;
+    }
+    run->maxFrameSize = ARSTREAM_Workload_GetMaxFrameSize (*workload);
+    if (run->maxFrameSize < BENCH_FRAME_HEADER_SIZE)
+    {
+        run->maxFrameSize = BENCH_FRAME_HEADER_SIZE;
+    }
+
+    for (i = 0; i < BENCH_NB_BUFFERS; i++)
+    {
+        run->buffers [i] = malloc (run->maxFrameSize);
+        if (run->buffers [i] == NULL)
+        {
+            retVal = 1;
+        }
+        else
+        {
+            for (j = 0; j < (int)run->maxFrameSize; j++)
+            {
+                run->buffers [i][j] = (uint8_t)j;
+            }
+        }
+    }
+    run->readerFrame = malloc (run->maxFrameSize);
+    run->maxLatencies = nbFrames;
+    run->latenciesUs = malloc (nbFrames * sizeof (uint32_t));
+    if ((run->readerFrame == NULL) ||
+        (run->latenciesUs == NULL))
+    {
+        retVal = 1;
+    }
+    return retVal;
+}
+
+void ARSTREAM_Bench_CleanRun (ARSTREAM_Bench_Run_t *run)
+{
+    int i;
+    for (i = 0; i < BENCH_NB_BUFFERS; i++)
+    {
+        free (run->buffers [i]);
+    }
+    free (run->readerFrame);
+    free (run->latenciesUs);
+}
+
+void ARSTREAM_Bench_WriteJsonString (FILE *out, const char *string)
+{
+    const unsigned char *c;
+    fputc ('"', out);
+    for (c = (const unsigned char *)string; *c != '\0'; c++)
+    {
+        switch (*c)
+        {
+        case '"':
+            fputs ("\\\"", out);
+            break;
+        case '\\':
+            fputs ("\\\\", out);
+            break;
+        case '\n':
+            fputs ("\\n", out);
+            break;
+        case '\r':
+            fputs ("\\r", out);
+            break;
+        case '\t':
+            fputs ("\\t", out);
+            break;
+        default:
+            if (*c < 0x20)
+            {
+                fprintf (out, "\\u%04x", *c);
+            }
+            else
+            {
+                fputc (*c, out);
+            }
+            break;
+        }
+    }
+    fputc ('"', out);
+}
+
+void ARSTREAM_Bench_WriteResult (const ARSTREAM_Bench_Point_t *point, ARSTREAM_Bench_Run_t *run, FILE *out)
+{
+    if (run->nbReceivedFrames < run->maxLatencies)
+    {
+        run->maxLatencies = run->nbReceivedFrames;
+    }
+    qsort (run->latenciesUs, run->maxLatencies, sizeof (uint32_t), ARSTREAM_Bench_CompareLatencies);
+
+    fprintf (out, "%s    {\n", (g_NbResults > 0) ? ",\n" : "");
+    fprintf (out, "      \"sweep\": \"%s\",\n", point->sweep);
+    fprintf (out, "      \"bitrateKbps\": %u,\n", (g_WorkloadSpec == NULL) ? point->bitrateKbps : 0);
+    if (g_Tcp != 0)
+    {
+        fprintf (out, "      \"notSentLowat\": %u,\n", point->notSentLowat);
+    }
+    else
+    {
+        fprintf (out, "      \"fragmentSize\": %u,\n", point->fragmentSize);
+        fprintf (out, "      \"framesInQueue\": %u,\n", point->framesInQueue);
+        fprintf (out, "      \"lossRate\": %.3f,\n", point->lossRate);
+        fprintf (out, "      \"rttMs\": %u,\n", point->rttMs);
+    }
+    fprintf (out, "      \"maxFrameSize\": %u,\n", run->maxFrameSize);
+    fprintf (out, "      \"framesOffered\": %d,\n", run->nbOffered);
+    fprintf (out, "      \"framesSent\": %d,\n", run->nbSent);
+    fprintf (out, "      \"flushFramesSent\": %d,\n", run->nbIFrames);
+    fprintf (out, "      \"framesQueueFull\": %d,\n", run->nbQueueFull);
+    fprintf (out, "      \"framesNoBuffer\": %d,\n", run->nbNoBuffer);
+    fprintf (out, "      \"framesReceived\": %d,\n", run->nbReceivedFrames);
+    fprintf (out, "      \"framesSkipped\": %d,\n", run->nbSkippedFrames);
+    fprintf (out, "      \"framesPerSecond\": %.2f,\n", run->nbReceivedFrames / run->wall);
+    fprintf (out, "      \"mbitPerSecond\": %.3f,\n", run->receivedBytes * 8. / run->wall / 1000000.);
+    fprintf (out, "      \"latencyMs\": { \"p50\": %.3f, \"p99\": %.3f, \"p999\": %.3f },\n",
+             ARSTREAM_Bench_GetPercentileMs (run->latenciesUs, run->maxLatencies, 0.5),
+             ARSTREAM_Bench_GetPercentileMs (run->latenciesUs, run->maxLatencies, 0.99),
+             ARSTREAM_Bench_GetPercentileMs (run->latenciesUs, run->maxLatencies, 0.999));
+    fprintf (out, "      \"cpuUsPerFrame\": %.1f,\n", (run->nbReceivedFrames > 0) ? run->cpu * 1000000. / run->nbReceivedFrames : 0.);
+    fprintf (out, "      \"efficiency\": %.4f\n", (run->transportBytes > 0) ? (double)run->receivedBytes / run->transportBytes : 0.);
+    fprintf (out, "    }");
+    fflush (out);
+    g_NbResults++;
+}
+
+int ARSTREAM_Bench_Run (const ARSTREAM_Bench_Point_t *point, FILE *out)
+{
+    ARSTREAM_Bench_Run_t run;
+    ARSTREAM_Workload_t *workload = NULL;
+    ARSTREAM_Workload_Frame_t frame;
+    ARSTREAM_Impairment_Config_t config;
+    ARSTREAM_Impairment_Stats_t stats;
+    ARSTREAM_Transport_t *senderLoopback = NULL;
+    ARSTREAM_Transport_t *readerLoopback = NULL;
+    ARSTREAM_Transport_t *senderTransport = NULL;
+    ARSTREAM_Transport_t *readerTransport = NULL;
+    ARSTREAM_Sender_t *sender = NULL;
+    ARSTREAM_Reader_t *reader = NULL;
+    pthread_t senderData, senderAck, readerData, readerAck;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    uint32_t nbFragments;
+    uint64_t startUs, nowUs, endUs;
+    double startCpu;
+    int nbFrames = g_DurationS * BENCH_FPS;
+    int waitedMs = 0;
+    int retVal;
+    int i, j;
+
+    retVal = ARSTREAM_Bench_InitRun (&run, point, &workload);
+    if (workload == NULL)
+    {
+        return 1;
+    }
+    nbFragments = (run.maxFrameSize + point->fragmentSize - 1) / point->fragmentSize;
+
+    if ((nbFragments > ARSTREAM_READER_MAX_FRAGMENTS_PER_FRAME) ||
+        (point->framesInQueue > BENCH_MAX_FRAMES_IN_QUEUE))
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Invalid point : %u fragments per frame, %u frames in queue", nbFragments, point->framesInQueue);
+        ARSTREAM_Bench_CleanRun (&run);
+        ARSTREAM_Workload_Delete (&workload);
+        return 1;
+    }
+
+    memset (&config, 0, sizeof (config));
+    config.seed = g_Seed;
+    config.data.lossModel = (point->lossRate > 0.f) ? ARSTREAM_IMPAIRMENT_LOSS_BERNOULLI : ARSTREAM_IMPAIRMENT_LOSS_NONE;
+    config.data.lossRate = point->lossRate;
+    config.data.delayUs = point->rttMs * 1000 / 2;
+    config.ack = config.data;
+
+    if (retVal == 0)
+    {
+        err = ARSTREAM_Transport_NewLoopback (point->fragmentSize, BENCH_LOOPBACK_NB_SLOTS, &senderLoopback, &readerLoopback);
+    }
+    if ((retVal == 0) &&
+        (err == ARSTREAM_OK))
+    {
+        senderTransport = ARSTREAM_Transport_NewImpaired (senderLoopback, &config, &err);
+    }
+    if (senderTransport != NULL)
+    {
+        readerTransport = ARSTREAM_Transport_NewImpaired (readerLoopback, &config, &err);
+    }
+    if (readerTransport != NULL)
+    {
+        reader = ARSTREAM_Reader_NewWithTransport (readerTransport, ARSTREAM_Bench_ReaderCallback, run.readerFrame, run.maxFrameSize, point->fragmentSize, ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT, &run, &err);
+    }
+    if (reader != NULL)
+    {
+        sender = ARSTREAM_Sender_NewWithTransport (senderTransport, ARSTREAM_Bench_SenderCallback, point->framesInQueue, point->fragmentSize, nbFragments, &run, &err);
+    }
+
+    if (sender != NULL)
+    {
+        pthread_create (&readerData, NULL, ARSTREAM_Reader_RunDataThread, reader);
+        pthread_create (&readerAck, NULL, ARSTREAM_Reader_RunAckThread, reader);
+        pthread_create (&senderData, NULL, ARSTREAM_Sender_RunDataThread, sender);
+        pthread_create (&senderAck, NULL, ARSTREAM_Sender_RunAckThread, sender);
+
+        startCpu = ARSTREAM_Bench_GetCpuTime ();
+        startUs = ARSTREAM_Bench_GetTimeUs ();
+
+        for (i = 0; i < nbFrames; i++)
+        {
+            ARSTREAM_Workload_GetNextFrame (workload, &frame);
+            if (frame.size < BENCH_FRAME_HEADER_SIZE)
+            {
+                frame.size = BENCH_FRAME_HEADER_SIZE;
+            }
+            nowUs = ARSTREAM_Bench_GetTimeUs ();
+            if (nowUs < startUs + frame.timeUs)
+            {
+                usleep ((useconds_t)(startUs + frame.timeUs - nowUs));
+            }
+            run.nbOffered++;
+
+            /* Like an encoder, drop the frame if all the buffers are still owned by the sender */
+            for (j = 0; j < BENCH_NB_BUFFERS; j++)
+            {
+                if (__sync_lock_test_and_set (&run.busy [j], 1) == 0)
+                {
+                    break;
+                }
+            }
+            if (j == BENCH_NB_BUFFERS)
+            {
+                run.nbNoBuffer++;
+                continue;
+            }
+
+            nowUs = ARSTREAM_Bench_GetTimeUs ();
+            memcpy (&run.buffers [j][0], &i, sizeof (i));
+            memcpy (&run.buffers [j][4], &nowUs, sizeof (nowUs));
+            if (ARSTREAM_Sender_SendNewFrame (sender, run.buffers [j], frame.size, frame.isIFrame | run.flushRequested, NULL) == ARSTREAM_OK)
+            {
+                run.nbIFrames += frame.isIFrame | run.flushRequested;
+                run.flushRequested = 0;
+                run.nbSent++;
+            }
+            else
+            {
+                __sync_lock_release (&run.busy [j]);
+                run.nbQueueFull++;
+            }
+        }
+
+        /* Wait for the last frames to be acknowledged or cancelled */
+        while ((run.nbDoneFrames < run.nbSent) &&
+               (waitedMs < BENCH_DRAIN_TIMEOUT_MS))
+        {
+            usleep (1000);
+            waitedMs++;
+        }
+
+        endUs = ARSTREAM_Bench_GetTimeUs ();
+        run.cpu = ARSTREAM_Bench_GetCpuTime () - startCpu;
+        run.wall = (endUs - startUs) / 1000000.;
+
+        ARSTREAM_Sender_StopSender (sender);
+        ARSTREAM_Reader_StopReader (reader);
+        pthread_join (senderData, NULL);
+        pthread_join (senderAck, NULL);
+        pthread_join (readerData, NULL);
+        pthread_join (readerAck, NULL);
+
+        memset (&stats, 0, sizeof (stats));
+        ARSTREAM_Impairment_GetStats (senderTransport, ARSTREAM_TRANSPORT_CHANNEL_DATA, &stats);
+        run.transportBytes = stats.bytes;
+
+        ARSTREAM_Bench_WriteResult (point, &run, out);
+    }
+    else
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create the stream : %s", ARSTREAM_Error_ToString (err));
+        retVal = 1;
+    }
+
+    ARSTREAM_Sender_Delete (&sender);
+    ARSTREAM_Reader_Delete (&reader);
+    ARSTREAM_Transport_Delete (&senderTransport);
+    ARSTREAM_Transport_Delete (&readerTransport);
+    ARSTREAM_Transport_Delete (&senderLoopback);
+    ARSTREAM_Transport_Delete (&readerLoopback);
+    ARSTREAM_Bench_CleanRun (&run);
+    ARSTREAM_Workload_Delete (&workload);
+    return retVal;
+}
+
+int ARSTREAM_Bench_RunTcp (const ARSTREAM_Bench_Point_t *point, FILE *out)
+{
+    ARSTREAM_Bench_Run_t run;
+    ARSTREAM_Workload_t *workload = NULL;
+    ARSTREAM_Workload_Frame_t frame;
+    ARSTREAM_TCP_Options_t options;
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof (addr);
+    pthread_t readerThread;
+    uint64_t startUs, nowUs, endUs;
+    double startCpu;
+    int nbFrames = g_DurationS * BENCH_FPS;
+    int listenSocket = -1, senderSocket = -1;
+    int retVal;
+    int i;
+
+    retVal = ARSTREAM_Bench_InitRun (&run, point, &workload);
+    if (workload == NULL)
+    {
+        return 1;
+    }
+
+    /* Local connection : the receiving side is accepted, the sending side connects to it */
+    memset (&addr, 0, sizeof (addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    listenSocket = socket (AF_INET, SOCK_STREAM, 0);
+    if ((retVal != 0) ||
+        (listenSocket < 0) ||
+        (bind (listenSocket, (struct sockaddr *)&addr, sizeof (addr)) != 0) ||
+        (listen (listenSocket, 1) != 0) ||
+        (getsockname (listenSocket, (struct sockaddr *)&addr, &addrLen) != 0))
+    {
+        retVal = 1;
+    }
+    if (retVal == 0)
+    {
+        senderSocket = socket (AF_INET, SOCK_STREAM, 0);
+        if ((senderSocket < 0) ||
+            (connect (senderSocket, (struct sockaddr *)&addr, sizeof (addr)) != 0))
+        {
+            retVal = 1;
+        }
+    }
+    if (retVal == 0)
+    {
+        run.socket = accept (listenSocket, NULL, NULL);
+        options.noDelay = 1;
+        options.notSentLowat = point->notSentLowat;
+        if ((run.socket < 0) ||
+            (ARSTREAM_TCP_SetOptions (senderSocket, &options) != 0))
+        {
+            retVal = 1;
+        }
+    }
+
+    if (retVal == 0)
+    {
+        pthread_create (&readerThread, NULL, ARSTREAM_Bench_TcpReaderThread, &run);
+
+        startCpu = ARSTREAM_Bench_GetCpuTime ();
+        startUs = ARSTREAM_Bench_GetTimeUs ();
+
+        for (i = 0; i < nbFrames; i++)
+        {
+            int written;
+            ARSTREAM_Workload_GetNextFrame (workload, &frame);
+            if (frame.size < BENCH_FRAME_HEADER_SIZE)
+            {
+                frame.size = BENCH_FRAME_HEADER_SIZE;
+            }
+            nowUs = ARSTREAM_Bench_GetTimeUs ();
+            if (nowUs < startUs + frame.timeUs)
+            {
+                usleep ((useconds_t)(startUs + frame.timeUs - nowUs));
+            }
+            run.nbOffered++;
+
+            /* Like an encoder, drop the frame while the socket still holds the previous ones */
+            if (ARSTREAM_TCP_IsWritable (senderSocket) == 0)
+            {
+                run.nbQueueFull++;
+                continue;
+            }
+
+            /* The socket copies the frame : one buffer is enough */
+            nowUs = ARSTREAM_Bench_GetTimeUs ();
+            memcpy (&run.buffers [0][0], &i, sizeof (i));
+            memcpy (&run.buffers [0][4], &nowUs, sizeof (nowUs));
+            written = ARSTREAM_TCP_SendFrame (senderSocket, (uint32_t)run.nbSent, run.buffers [0], frame.size);
+            if (written < 0)
+            {
+                retVal = 1;
+                break;
+            }
+            run.nbIFrames += frame.isIFrame;
+            run.nbSent++;
+            run.transportBytes += (uint32_t)written;
+        }
+
+        /* The reader gets all the frames, then the end of the stream */
+        shutdown (senderSocket, SHUT_WR);
+        pthread_join (readerThread, NULL);
+
+        endUs = ARSTREAM_Bench_GetTimeUs ();
+        run.cpu = ARSTREAM_Bench_GetCpuTime () - startCpu;
+        run.wall = (endUs - startUs) / 1000000.;
+
+        ARSTREAM_Bench_WriteResult (point, &run, out);
+    }
+    else
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create the TCP connection");
+    }
+
+    if (run.socket >= 0)
+    {
+        close (run.socket);
+    }
+    if (senderSocket >= 0)
+    {
+        close (senderSocket);
+    }
+    if (listenSocket >= 0)
+    {
+        close (listenSocket);
+    }
+    ARSTREAM_Bench_CleanRun (&run);
+    ARSTREAM_Workload_Delete (&workload);
+    return retVal;
+}
+
+/*
+ * Implementation
+ */
+
+int main (int argc, char *argv[])
+{
+    static const uint32_t bitrates [] = { 1000, 2000, 4000, 8000 };
+    static const uint32_t fragmentSizes [] = { 1000, 1400, 8000, 60000 };
+    static const uint32_t framesInQueues [] = { 1, 4, 16 };
+    static const float lossRates [] = { 0.f, 0.01f, 0.05f, 0.1f };
+    static const uint32_t rtts [] = { 0, 20, 100 };
+    static const uint32_t notSentLowats [] = { 0, 4096, 16384, 65536 };
+    const ARSTREAM_Bench_Point_t base = { "base", BENCH_BASE_BITRATE_KBPS, BENCH_BASE_FRAGMENT_SIZE, BENCH_BASE_FRAMES_IN_QUEUE, BENCH_BASE_LOSS_RATE, BENCH_BASE_RTT_MS, BENCH_BASE_NOT_SENT_LOWAT };
+    ARSTREAM_Bench_Point_t point;
+    FILE *out = stdout;
+    const char *eventLogPath = NULL;
+    int retVal = 0;
+    unsigned int i;
+    int opt;
+
+    while ((opt = getopt (argc, argv, "t:d:s:g:w:e:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            if (strcmp (optarg, "tcp") == 0)
+            {
+                g_Tcp = 1;
+            }
+            else if (strcmp (optarg, "loopback") != 0)
+            {
+                g_DurationS = 0;
+            }
+            break;
+        case 'd':
+            g_DurationS = atoi (optarg);
+            break;
+        case 's':
+            g_Seed = (uint32_t)strtoul (optarg, NULL, 0);
+            break;
+        case 'g':
+            if (sscanf (optarg, "%u:%f:%f", &g_GopLength, &g_IToPRatio, &g_SizeVariation) < 1)
+            {
+                g_DurationS = 0;
+            }
+            break;
+        case 'w':
+            g_WorkloadSpec = optarg;
+            break;
+        case 'e':
+            eventLogPath = optarg;
+            break;
+        case 'o':
+            out = fopen (optarg, "w");
+            if (out == NULL)
+            {
+                perror (optarg);
+                return 1;
+            }
+            break;
+        default:
+            g_DurationS = 0;
+            break;
+        }
+    }
+    if (g_DurationS <= 0)
+    {
+        printf ("Usage : %s [-t loopback|tcp] [-d secondsPerPoint] [-s seed] [-g gopLength[:iToPRatio[:sizeVariation]]] [-w csv:path|mp4:path] [-e events.bin] [-o output.json]\n", argv[0]);
+        return 1;
+    }
+
+    if ((eventLogPath != NULL) &&
+        (ARSTREAM_EventLog_Start (eventLogPath, 0) != ARSTREAM_OK))
+    {
+        fprintf (stderr, "Unable to start the event log %s\n", eventLogPath);
+        return 1;
+    }
+
+    fprintf (out, "{\n  \"transport\": \"%s\",\n", (g_Tcp != 0) ? "tcp" : "loopback");
+    if (g_WorkloadSpec != NULL)
+    {
+        fprintf (out, "  \"workload\": ");
+        ARSTREAM_Bench_WriteJsonString (out, g_WorkloadSpec);
+        fprintf (out, ",\n");
+    }
+    else
+    {
+        fprintf (out, "  \"workload\": \"gop\",\n  \"fps\": %d,\n  \"gopLength\": %u,\n  \"iToPRatio\": %.2f,\n  \"sizeVariation\": %.2f,\n", BENCH_FPS, g_GopLength, g_IToPRatio, g_SizeVariation);
+    }
+    fprintf (out, "  \"secondsPerPoint\": %d,\n  \"seed\": %u,\n  \"results\": [\n", g_DurationS, g_Seed);
+
+    /* A replayed trace has its own bitrate */
+    for (i = 0; (g_WorkloadSpec == NULL) && (i < sizeof (bitrates) / sizeof (bitrates [0])); i++)
+    {
+        point = base;
+        point.sweep = "bitrate";
+        point.bitrateKbps = bitrates [i];
+        retVal |= (g_Tcp != 0) ? ARSTREAM_Bench_RunTcp (&point, out) : ARSTREAM_Bench_Run (&point, out);
+    }
+    for (i = 0; (g_Tcp != 0) && (i < sizeof (notSentLowats) / sizeof (notSentLowats [0])); i++)
+    {
+        point = base;
+        point.sweep = "notSentLowat";
+        point.notSentLowat = notSentLowats [i];
+        retVal |= ARSTREAM_Bench_RunTcp (&point, out);
+    }
+    /* The other parameters are the ARSTREAM ones */
+    for (i = 0; (g_Tcp == 0) && (i < sizeof (fragmentSizes) / sizeof (fragmentSizes [0])); i++)
+    {
+        point = base;
+        point.sweep = "fragmentSize";
+        point.fragmentSize = fragmentSizes [i];
+        retVal |= ARSTREAM_Bench_Run (&point, out);
+    }
+    for (i = 0; (g_Tcp == 0) && (i < sizeof (framesInQueues) / sizeof (framesInQueues [0])); i++)
+    {
+        point = base;
+        point.sweep = "framesInQueue";
+        point.framesInQueue = framesInQueues [i];
+        retVal |= ARSTREAM_Bench_Run (&point, out);
+    }
+    for (i = 0; (g_Tcp == 0) && (i < sizeof (lossRates) / sizeof (lossRates [0])); i++)
+    {
+        point = base;
+        point.sweep = "lossRate";
+        point.lossRate = lossRates [i];
+        retVal |= ARSTREAM_Bench_Run (&point, out);
+    }
+    for (i = 0; (g_Tcp == 0) && (i < sizeof (rtts) / sizeof (rtts [0])); i++)
+    {
+        point = base;
+        point.sweep = "rttMs";
+        point.rttMs = rtts [i];
+        retVal |= ARSTREAM_Bench_Run (&point, out);
+    }
+
+    fprintf (out, "\n  ]\n}\n");
+    ARSTREAM_EventLog_Stop ();
+    if (out != stdout)
+    {
+        fclose (out);
+    }
+    return retVal;
+}
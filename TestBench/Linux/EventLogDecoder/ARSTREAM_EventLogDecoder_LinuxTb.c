@@ -0,0 +1,473 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_EventLogDecoder_LinuxTb.c
+ * @brief Decoder of the binary event logs written by ARSTREAM_EventLog
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ *
+ * Prints the events of a log in time order (the threads are written one after the other by the
+ * drain thread), as text or as CSV, followed by the number of events of each type.
+ *
+ * The log can also be exported as a Chrome trace (chrome://tracing, or ui.perfetto.dev) :
+ * - each sender frame is an async slice from its queuing to its acknowledgement (or cancellation),
+ *   split into its time in the queue and its sending time,
+ * - each reader frame is an async slice from its first received fragment to its delivery (or drop),
+ * - application callbacks and lock waits are slices on the timeline of their thread,
+ * - all other events (fragments, acks, send rounds ...) are instant events, with named arguments.
+ *
+ * Usage : ARSTREAM_EventLogDecoder_LinuxTb [-c|-j] [-s] events.bin
+ *   -c : CSV output (timeUs,thread,event,arg0,arg1,arg2), times relative to the start of the log
+ *   -j : Chrome trace event JSON output
+ *   -s : only print the number of events of each type
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARStream/ARSTREAM_EventLog.h>
+
+/*
+ * Macros
+ */
+
+#define DECODER_OPEN_QUEUED (1 << 0) /**< The "queued" slice of a sender frame is open */
+#define DECODER_OPEN_SENDING (1 << 1) /**< The "sending" slice of a sender frame is open */
+#define DECODER_OPEN_FRAME (1 << 2) /**< The "frame" slice of a frame is open */
+#define DECODER_NB_FRAME_NUMBERS (65536)
+
+/*
+ * Types
+ */
+
+typedef struct {
+    ARSTREAM_EventLog_Event_t event;
+    uint32_t order; /**< Position in the file, to keep the order of events with the same time */
+} ARSTREAM_EventLogDecoder_Entry_t;
+
+/*
+ * Globals
+ */
+
+/**
+ * Names of the arguments of each libARStream event, in the Chrome trace
+ */
+static const char *g_ArgNames [ARSTREAM_EVENT_MAX][3] = {
+    [ARSTREAM_EVENT_LOST] = { "nbLost", NULL, NULL },
+    [ARSTREAM_EVENT_SENDER_FRAME_QUEUED] = { "frame", "size", "flush" },
+    [ARSTREAM_EVENT_SENDER_FRAME_STARTED] = { "frame", "size", "nbFragments" },
+    [ARSTREAM_EVENT_SENDER_FRAGMENT_SENT] = { "frame", "fragment", NULL },
+    [ARSTREAM_EVENT_SENDER_LATE_FRAGMENT_SENT] = { "frame", "currentFrame", NULL },
+    [ARSTREAM_EVENT_SENDER_ACK_RECEIVED] = { "frame", "nbAcknowledged", "nbFragments" },
+    [ARSTREAM_EVENT_SENDER_FRAME_CANCELLED] = { "frame", "nbAcknowledged", "nbFragments" },
+    [ARSTREAM_EVENT_SENDER_FLUSH_REQUESTED] = { "lastFrameSeen", NULL, NULL },
+    [ARSTREAM_EVENT_READER_FRAGMENT_RECEIVED] = { "frame", "fragment", "duplicate" },
+    [ARSTREAM_EVENT_READER_FRAME_COMPLETE] = { "frame", "size", "flush" },
+    [ARSTREAM_EVENT_READER_FRAME_DROPPED] = { "frame", "nbMissingFragments", NULL },
+    [ARSTREAM_EVENT_READER_FRAME_DISCARDED] = { "frame", NULL, NULL },
+    [ARSTREAM_EVENT_READER_FRAMES_MISSED] = { "nextFrame", "nbMissed", NULL },
+    [ARSTREAM_EVENT_READER_FLUSH_REQUESTED] = { NULL, NULL, NULL },
+    [ARSTREAM_EVENT_SENDER_FRAME_REJECTED] = { "size", NULL, NULL },
+    [ARSTREAM_EVENT_SENDER_FRAME_POPPED] = { "frame", "nbLeftInQueue", NULL },
+    [ARSTREAM_EVENT_SENDER_SEND_ROUND] = { "frame", "nbFragments", "round" },
+    [ARSTREAM_EVENT_SENDER_FRAME_ACKNOWLEDGED] = { "frame", "totalUs", NULL },
+    [ARSTREAM_EVENT_SENDER_CALLBACK_BEGIN] = { "status", NULL, NULL },
+    [ARSTREAM_EVENT_SENDER_CALLBACK_END] = { "status", NULL, NULL },
+    [ARSTREAM_EVENT_READER_FRAME_STARTED] = { "frame", "nbFragments", "flush" },
+    [ARSTREAM_EVENT_READER_FRAME_INCOMPLETE] = { "frame", "nbReceived", "nbFragments" },
+    [ARSTREAM_EVENT_READER_CALLBACK_BEGIN] = { "cause", "frame", NULL },
+    [ARSTREAM_EVENT_READER_CALLBACK_END] = { "cause", "frame", NULL },
+    [ARSTREAM_EVENT_LOCK_WAIT] = { "lock", "waitUs", NULL },
+};
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief qsort comparator : by time, then by position in the file
+ */
+static int ARSTREAM_EventLogDecoder_Compare (const void *a, const void *b);
+
+/**
+ * @brief Reads all the events of a log
+ * @param path Path of the log
+ * @param[out] header The header of the log
+ * @param[out] nbEntries Number of events read
+ * @return The events (to free), or NULL on error
+ */
+static ARSTREAM_EventLogDecoder_Entry_t* ARSTREAM_EventLogDecoder_Read (const char *path, ARSTREAM_EventLog_FileHeader_t *header, uint32_t *nbEntries);
+
+/**
+ * @brief Prints an event as a Chrome trace instant event, with its named arguments
+ */
+static void ARSTREAM_EventLogDecoder_PrintInstant (const ARSTREAM_EventLog_Event_t *event, int64_t timeUs);
+
+/**
+ * @brief Prints the begin or the end of an async slice of a frame
+ * @param category "sender" or "reader"
+ * @param name Name of the slice ("frame", "queued" ...)
+ * @param phase 'b' (begin) or 'e' (end)
+ * @param frameNumber The frame number, which identifies the slice
+ */
+static void ARSTREAM_EventLogDecoder_PrintAsync (const char *category, const char *name, char phase, uint32_t frameNumber, const ARSTREAM_EventLog_Event_t *event, int64_t timeUs);
+
+/**
+ * @brief Prints the events of a log as a Chrome trace event JSON document
+ */
+static void ARSTREAM_EventLogDecoder_PrintChromeTrace (const ARSTREAM_EventLog_FileHeader_t *header, const ARSTREAM_EventLogDecoder_Entry_t *entries, uint32_t nbEntries);
+
+/*
+ * Internal functions implementation
+ */
+
+static int ARSTREAM_EventLogDecoder_Compare (const void *a, const void *b)
+{
+    const ARSTREAM_EventLogDecoder_Entry_t *ea = (const ARSTREAM_EventLogDecoder_Entry_t *)a;
+    const ARSTREAM_EventLogDecoder_Entry_t *eb = (const ARSTREAM_EventLogDecoder_Entry_t *)b;
+    if (ea->event.timeUs != eb->event.timeUs)
+    {
+        return (ea->event.timeUs < eb->event.timeUs) ? -1 : 1;
+    }
+    return (ea->order < eb->order) ? -1 : (ea->order > eb->order);
+}
+
+static ARSTREAM_EventLogDecoder_Entry_t* ARSTREAM_EventLogDecoder_Read (const char *path, ARSTREAM_EventLog_FileHeader_t *header, uint32_t *nbEntries)
+{
+    ARSTREAM_EventLogDecoder_Entry_t *entries = NULL;
+    uint32_t capacity = 0;
+    uint32_t count = 0;
+    FILE *file = fopen (path, "rb");
+
+    if (file == NULL)
+    {
+        perror (path);
+        return NULL;
+    }
+    if (fread (header, sizeof (*header), 1, file) != 1)
+    {
+        fprintf (stderr, "%s : no event log header\n", path);
+        fclose (file);
+        return NULL;
+    }
+    if ((header->magic != ARSTREAM_EVENTLOG_MAGIC) ||
+        (header->version != ARSTREAM_EVENTLOG_VERSION) ||
+        (header->eventSize != sizeof (ARSTREAM_EventLog_Event_t)))
+    {
+        fprintf (stderr, "%s : not an event log of this version (or written on a host with another byte order)\n", path);
+        fclose (file);
+        return NULL;
+    }
+
+    for (;;)
+    {
+        if (count == capacity)
+        {
+            ARSTREAM_EventLogDecoder_Entry_t *grown;
+            capacity = (capacity == 0) ? 4096 : capacity * 2;
+            grown = realloc (entries, capacity * sizeof (ARSTREAM_EventLogDecoder_Entry_t));
+            if (grown == NULL)
+            {
+                fprintf (stderr, "%s : out of memory after %u events\n", path, count);
+                break;
+            }
+            entries = grown;
+        }
+        if (fread (&(entries [count].event), sizeof (ARSTREAM_EventLog_Event_t), 1, file) != 1)
+        {
+            break;
+        }
+        entries [count].order = count;
+        count++;
+    }
+    fclose (file);
+
+    qsort (entries, count, sizeof (ARSTREAM_EventLogDecoder_Entry_t), ARSTREAM_EventLogDecoder_Compare);
+    *nbEntries = count;
+    return entries;
+}
+
+static void ARSTREAM_EventLogDecoder_PrintInstant (const ARSTREAM_EventLog_Event_t *event, int64_t timeUs)
+{
+    int i;
+    printf (",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%u,\"args\":{", ARSTREAM_EventLog_GetEventName (event->id), timeUs, event->threadId);
+    for (i = 0; i < 3; i++)
+    {
+        const char *argName = (event->id < ARSTREAM_EVENT_MAX) ? g_ArgNames [event->id][i] : NULL;
+        if (argName != NULL)
+        {
+            printf ("%s\"%s\":%u", (i > 0) ? "," : "", argName, event->args [i]);
+        }
+        else if (event->id >= ARSTREAM_EVENT_USER)
+        {
+            printf ("%s\"arg%d\":%u", (i > 0) ? "," : "", i, event->args [i]);
+        }
+    }
+    if (event->id >= ARSTREAM_EVENT_USER)
+    {
+        printf (",\"id\":%u", event->id - ARSTREAM_EVENT_USER);
+    }
+    printf ("}}");
+}
+
+static void ARSTREAM_EventLogDecoder_PrintAsync (const char *category, const char *name, char phase, uint32_t frameNumber, const ARSTREAM_EventLog_Event_t *event, int64_t timeUs)
+{
+    printf (",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"id\":\"0x%x\",\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%u", name, category, phase, frameNumber, timeUs, event->threadId);
+    if (phase == 'b')
+    {
+        printf (",\"args\":{\"frame\":%u,\"%s\":%u}", frameNumber, g_ArgNames [event->id][1], event->args [1]);
+    }
+    printf ("}");
+}
+
+static void ARSTREAM_EventLogDecoder_PrintChromeTrace (const ARSTREAM_EventLog_FileHeader_t *header, const ARSTREAM_EventLogDecoder_Entry_t *entries, uint32_t nbEntries)
+{
+    uint8_t *senderFrames = calloc (DECODER_NB_FRAME_NUMBERS, 1);
+    uint8_t *readerFrames = calloc (DECODER_NB_FRAME_NUMBERS, 1);
+    uint32_t nbThreads = 0;
+    uint32_t i;
+
+    if ((senderFrames == NULL) ||
+        (readerFrames == NULL))
+    {
+        free (senderFrames);
+        free (readerFrames);
+        return;
+    }
+
+    printf ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    printf ("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"libARStream\"}}");
+    for (i = 0; i < nbEntries; i++)
+    {
+        if (entries [i].event.threadId > nbThreads)
+        {
+            nbThreads = entries [i].event.threadId;
+        }
+    }
+    for (i = 1; i <= nbThreads; i++)
+    {
+        printf (",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", i, i);
+    }
+
+    for (i = 0; i < nbEntries; i++)
+    {
+        const ARSTREAM_EventLog_Event_t *event = &(entries [i].event);
+        int64_t timeUs = (int64_t)(event->timeUs - header->startTimeUs);
+        uint16_t frame = (uint16_t)event->args [0];
+        switch (event->id)
+        {
+        case ARSTREAM_EVENT_SENDER_FRAME_QUEUED:
+            ARSTREAM_EventLogDecoder_PrintAsync ("sender", "frame", 'b', frame, event, timeUs);
+            ARSTREAM_EventLogDecoder_PrintAsync ("sender", "queued", 'b', frame, event, timeUs);
+            senderFrames [frame] = DECODER_OPEN_FRAME | DECODER_OPEN_QUEUED;
+            break;
+        case ARSTREAM_EVENT_SENDER_FRAME_POPPED:
+            if ((senderFrames [frame] & DECODER_OPEN_QUEUED) != 0)
+            {
+                ARSTREAM_EventLogDecoder_PrintAsync ("sender", "queued", 'e', frame, event, timeUs);
+                senderFrames [frame] &= ~DECODER_OPEN_QUEUED;
+            }
+            break;
+        case ARSTREAM_EVENT_SENDER_FRAME_STARTED:
+            if ((senderFrames [frame] & DECODER_OPEN_FRAME) != 0)
+            {
+                ARSTREAM_EventLogDecoder_PrintAsync ("sender", "sending", 'b', frame, event, timeUs);
+                senderFrames [frame] |= DECODER_OPEN_SENDING;
+            }
+            break;
+        case ARSTREAM_EVENT_SENDER_FRAME_ACKNOWLEDGED:
+        case ARSTREAM_EVENT_SENDER_FRAME_CANCELLED:
+            if ((senderFrames [frame] & DECODER_OPEN_SENDING) != 0)
+            {
+                ARSTREAM_EventLogDecoder_PrintAsync ("sender", "sending", 'e', frame, event, timeUs);
+            }
+            if ((senderFrames [frame] & DECODER_OPEN_QUEUED) != 0)
+            {
+                ARSTREAM_EventLogDecoder_PrintAsync ("sender", "queued", 'e', frame, event, timeUs);
+            }
+            if ((senderFrames [frame] & DECODER_OPEN_FRAME) != 0)
+            {
+                ARSTREAM_EventLogDecoder_PrintAsync ("sender", "frame", 'e', frame, event, timeUs);
+            }
+            senderFrames [frame] = 0;
+            ARSTREAM_EventLogDecoder_PrintInstant (event, timeUs);
+            break;
+        case ARSTREAM_EVENT_READER_FRAME_STARTED:
+            if ((readerFrames [frame] & DECODER_OPEN_FRAME) != 0)
+            {
+                ARSTREAM_EventLogDecoder_PrintAsync ("reader", "frame", 'e', frame, event, timeUs);
+            }
+            ARSTREAM_EventLogDecoder_PrintAsync ("reader", "frame", 'b', frame, event, timeUs);
+            readerFrames [frame] = DECODER_OPEN_FRAME;
+            break;
+        case ARSTREAM_EVENT_READER_FRAME_COMPLETE:
+        case ARSTREAM_EVENT_READER_FRAME_INCOMPLETE:
+        case ARSTREAM_EVENT_READER_FRAME_DROPPED:
+        case ARSTREAM_EVENT_READER_FRAME_DISCARDED:
+            if ((readerFrames [frame] & DECODER_OPEN_FRAME) != 0)
+            {
+                ARSTREAM_EventLogDecoder_PrintAsync ("reader", "frame", 'e', frame, event, timeUs);
+                readerFrames [frame] = 0;
+            }
+            ARSTREAM_EventLogDecoder_PrintInstant (event, timeUs);
+            break;
+        case ARSTREAM_EVENT_SENDER_CALLBACK_BEGIN:
+        case ARSTREAM_EVENT_READER_CALLBACK_BEGIN:
+            printf (",\n{\"name\":\"%s callback\",\"ph\":\"B\",\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%u,\"args\":{\"%s\":%u}}", (event->id == ARSTREAM_EVENT_SENDER_CALLBACK_BEGIN) ? "sender" : "reader", timeUs, event->threadId, g_ArgNames [event->id][0], event->args [0]);
+            break;
+        case ARSTREAM_EVENT_SENDER_CALLBACK_END:
+        case ARSTREAM_EVENT_READER_CALLBACK_END:
+            printf (",\n{\"ph\":\"E\",\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%u}", timeUs, event->threadId);
+            break;
+        case ARSTREAM_EVENT_LOCK_WAIT:
+            printf (",\n{\"name\":\"wait %s\",\"cat\":\"lock\",\"ph\":\"X\",\"ts\":%" PRId64 ",\"dur\":%u,\"pid\":1,\"tid\":%u}", ARSTREAM_EventLog_GetLockName (event->args [0]), timeUs - event->args [1], event->args [1], event->threadId);
+            break;
+        default:
+            ARSTREAM_EventLogDecoder_PrintInstant (event, timeUs);
+            break;
+        }
+    }
+    printf ("\n]}\n");
+
+    free (senderFrames);
+    free (readerFrames);
+}
+
+/*
+ * Implementation
+ */
+
+int main (int argc, char *argv[])
+{
+    ARSTREAM_EventLog_FileHeader_t header;
+    ARSTREAM_EventLogDecoder_Entry_t *entries;
+    uint32_t counts [ARSTREAM_EVENT_MAX + 1];
+    uint32_t nbEntries = 0;
+    uint32_t i;
+    int csv = 0;
+    int json = 0;
+    int summaryOnly = 0;
+    int opt;
+
+    while ((opt = getopt (argc, argv, "cjs")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            csv = 1;
+            json = 0;
+            break;
+        case 'j':
+            json = 1;
+            csv = 0;
+            break;
+        case 's':
+            summaryOnly = 1;
+            break;
+        default:
+            optind = argc;
+            break;
+        }
+    }
+    if (optind != argc - 1)
+    {
+        printf ("Usage : %s [-c|-j] [-s] events.bin\n", argv[0]);
+        return 1;
+    }
+
+    entries = ARSTREAM_EventLogDecoder_Read (argv[optind], &header, &nbEntries);
+    if (entries == NULL)
+    {
+        return 1;
+    }
+
+    if ((json == 1) &&
+        (summaryOnly == 0))
+    {
+        ARSTREAM_EventLogDecoder_PrintChromeTrace (&header, entries, nbEntries);
+        free (entries);
+        return 0;
+    }
+
+    /* The last counter holds the application events */
+    memset (counts, 0, sizeof (counts));
+    if ((csv == 1) && (summaryOnly == 0))
+    {
+        printf ("timeUs,thread,event,arg0,arg1,arg2\n");
+    }
+    for (i = 0; i < nbEntries; i++)
+    {
+        ARSTREAM_EventLog_Event_t *event = &(entries [i].event);
+        int64_t timeUs = (int64_t)(event->timeUs - header.startTimeUs);
+        counts [(event->id < ARSTREAM_EVENT_MAX) ? event->id : ARSTREAM_EVENT_MAX]++;
+        if (summaryOnly == 1)
+        {
+            continue;
+        }
+        if (csv == 1)
+        {
+            printf ("%" PRId64 ",%u,%s,%u,%u,%u\n", timeUs, event->threadId, ARSTREAM_EventLog_GetEventName (event->id), event->args [0], event->args [1], event->args [2]);
+        }
+        else if (event->id >= ARSTREAM_EVENT_USER)
+        {
+            printf ("%12.3f ms  T%-3u USER+%-24u %u %u %u\n", timeUs / 1000.0, event->threadId, event->id - ARSTREAM_EVENT_USER, event->args [0], event->args [1], event->args [2]);
+        }
+        else
+        {
+            printf ("%12.3f ms  T%-3u %-29s %u %u %u\n", timeUs / 1000.0, event->threadId, ARSTREAM_EventLog_GetEventName (event->id), event->args [0], event->args [1], event->args [2]);
+        }
+    }
+
+    if ((csv == 0) || (summaryOnly == 1))
+    {
+        printf ("%s%u events\n", (summaryOnly == 1) ? "" : "\n", nbEntries);
+        for (i = 0; i <= ARSTREAM_EVENT_MAX; i++)
+        {
+            if (counts [i] > 0)
+            {
+                printf ("  %-29s %u\n", (i < ARSTREAM_EVENT_MAX) ? ARSTREAM_EventLog_GetEventName ((uint16_t)i) : "USER", counts [i]);
+            }
+        }
+    }
+
+    free (entries);
+    return 0;
+}
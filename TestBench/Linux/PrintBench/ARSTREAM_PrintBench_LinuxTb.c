@@ -0,0 +1,209 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_PrintBench_LinuxTb.c
+ * @brief Cost of a per-fragment log, before and after the compile-time log level gating
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ *
+ * Times, in ns per call, a debug log with per-fragment arguments :
+ * - "loop" : the loop alone, without any log (reference),
+ * - "ARSAL_PRINT" : the log as the library did before, filtered by libARSAL at runtime,
+ * - "ARSTREAM_PRINT" : the log as the library does now, compiled out above the level given to
+ *   configure (--with-max-log-level, info by default in release builds).
+ * When the configured level keeps the debug logs, ARSTREAM_PRINT costs as much as ARSAL_PRINT.
+ *
+ * The whole pipeline can be compared the same way, with "make bench" in a build configured
+ * with --with-max-log-level=verbose (before) and in a default build (after).
+ *
+ * Usage : ARSTREAM_PrintBench_LinuxTb [nbCalls] >/dev/null
+ * (the results go to stderr, stdout receives the logs that libARSAL does not filter out)
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+
+/*
+ * Private Headers
+ */
+
+#include "../../../Sources/ARSTREAM_Print.h"
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "PRINT_BENCH"
+
+#define BENCH_NB_CALLS_DEFAULT (10000000)
+#define BENCH_NB_RUNS (5)
+
+/*
+ * Types
+ */
+
+typedef enum {
+    BENCH_MODE_LOOP = 0,
+    BENCH_MODE_ARSAL_PRINT,
+    BENCH_MODE_ARSTREAM_PRINT,
+    BENCH_MODE_MAX,
+} eBENCH_MODE;
+
+/*
+ * Globals
+ */
+
+static const char *g_ModeNames [BENCH_MODE_MAX] = {
+    "loop",
+    "ARSAL_PRINT",
+    "ARSTREAM_PRINT",
+};
+
+/* Volatile, so that the compiler can not hoist the arguments out of the loops */
+static volatile int g_FrameNumber = 0;
+static volatile int g_FragmentIndex = 0;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Gets a monotonic time, in ns
+ */
+static uint64_t ARSTREAM_PrintBench_GetTimeNs (void);
+
+/**
+ * @brief Runs one mode for a number of calls
+ * @return The mean time per call, in ns
+ */
+static double ARSTREAM_PrintBench_Run (eBENCH_MODE mode, int nbCalls);
+
+/*
+ * Internal functions implementation
+ */
+
+static uint64_t ARSTREAM_PrintBench_GetTimeNs (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static double ARSTREAM_PrintBench_Run (eBENCH_MODE mode, int nbCalls)
+{
+    uint64_t start, end;
+    int i;
+
+    start = ARSTREAM_PrintBench_GetTimeNs ();
+    switch (mode)
+    {
+    case BENCH_MODE_LOOP:
+        for (i = 0; i < nbCalls; i++)
+        {
+            g_FragmentIndex = g_FrameNumber + i;
+        }
+        break;
+    case BENCH_MODE_ARSAL_PRINT:
+        for (i = 0; i < nbCalls; i++)
+        {
+            g_FragmentIndex = g_FrameNumber + i;
+            ARSAL_PRINT (ARSAL_PRINT_DEBUG, __TAG__, "Sent packet %d/%d of frame %d", g_FragmentIndex, i, g_FrameNumber);
+        }
+        break;
+    case BENCH_MODE_ARSTREAM_PRINT:
+        for (i = 0; i < nbCalls; i++)
+        {
+            g_FragmentIndex = g_FrameNumber + i;
+            ARSTREAM_PRINT (ARSAL_PRINT_DEBUG, __TAG__, "Sent packet %d/%d of frame %d", g_FragmentIndex, i, g_FrameNumber);
+        }
+        break;
+    default:
+        break;
+    }
+    end = ARSTREAM_PrintBench_GetTimeNs ();
+
+    return (double)(end - start) / nbCalls;
+}
+
+/*
+ * Implementation
+ */
+
+int main (int argc, char *argv[])
+{
+    int nbCalls = BENCH_NB_CALLS_DEFAULT;
+    double best [BENCH_MODE_MAX];
+    int mode, run;
+
+    if (argc > 1)
+    {
+        nbCalls = atoi (argv[1]);
+    }
+    if (nbCalls <= 0)
+    {
+        fprintf (stderr, "Usage : %s [nbCalls]\n", argv[0]);
+        return 1;
+    }
+
+    /* Best of several runs, to hide the scheduling noise */
+    for (mode = 0; mode < BENCH_MODE_MAX; mode++)
+    {
+        best[mode] = -1.0;
+        for (run = 0; run < BENCH_NB_RUNS; run++)
+        {
+            double nsPerCall = ARSTREAM_PrintBench_Run (mode, nbCalls);
+            if ((best[mode] < 0.0) || (nsPerCall < best[mode]))
+            {
+                best[mode] = nsPerCall;
+            }
+        }
+    }
+
+    fprintf (stderr, "Debug log, %d calls, best of %d runs (ARSTREAM_MAX_LOG_LEVEL = %d)\n", nbCalls, BENCH_NB_RUNS, (int)ARSTREAM_MAX_LOG_LEVEL);
+    for (mode = 0; mode < BENCH_MODE_MAX; mode++)
+    {
+        fprintf (stderr, "%-16s : %8.2f ns/call (%+8.2f ns over the loop)\n", g_ModeNames[mode], best[mode], best[mode] - best[BENCH_MODE_LOOP]);
+    }
+
+    return 0;
+}
@@ -107,16 +107,18 @@ void* reportMain (void *params)
     params = params;
 
     ARSTREAM_Logger_t *logger = ARSTREAM_Logger_NewWithDefaultName ();
-    ARSTREAM_Logger_Log (logger, "Latency (ms); PercentOK (%%); Missed frames; Mean time between frames (ms); Efficiency");
-    ARSAL_PRINT (ARSAL_PRINT_DEBUG, __TAG__, "Latency (ms); PercentOK (%%); Missed frames; Mean time between frames (ms); Efficiency");
+    ARSTREAM_Logger_Log (logger, "Latency (ms); PercentOK (%%); Missed frames; Mean time between frames (ms); Efficiency; Frame latency p50 (ms); Frame latency p99 (ms)");
+    ARSAL_PRINT (ARSAL_PRINT_DEBUG, __TAG__, "Latency (ms); PercentOK (%%); Missed frames; Mean time between frames (ms); Efficiency; Frame latency p50 (ms); Frame latency p99 (ms)");
     while (1)
     {
         int lat = ARSTREAM_ReaderTb_GetLatency ();
         int missed = ARSTREAM_ReaderTb_GetMissedFrames ();
         int dt = ARSTREAM_ReaderTb_GetMeanTimeBetweenFrames ();
         float eff = ARSTREAM_ReaderTb_GetEfficiency ();
-        ARSAL_PRINT (ARSAL_PRINT_DEBUG, __TAG__,"%4d; %5.2f; %3d; %4d; %5.3f", lat, ARSTREAM_Reader_PercentOk, missed, dt, eff);
-        ARSTREAM_Logger_Log (logger, "%4d; %5.2f; %3d; %4d; %5.3f", lat, ARSTREAM_Reader_PercentOk, missed, dt, eff);
+        int p50 = ARSTREAM_ReaderTb_GetFrameLatency (50.f);
+        int p99 = ARSTREAM_ReaderTb_GetFrameLatency (99.f);
+        ARSAL_PRINT (ARSAL_PRINT_DEBUG, __TAG__,"%4d; %5.2f; %3d; %4d; %5.3f; %4d; %4d", lat, ARSTREAM_Reader_PercentOk, missed, dt, eff, p50, p99);
+        ARSTREAM_Logger_Log (logger, "%4d; %5.2f; %3d; %4d; %5.3f; %4d; %4d", lat, ARSTREAM_Reader_PercentOk, missed, dt, eff, p50, p99);
         usleep (1000 * REPORT_DELAY_MS);
     }
     ARSTREAM_Logger_Delete (&logger);
@@ -0,0 +1,261 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_ThreadBench_LinuxTb.c
+ * @brief Scheduling latency of the stream threads, with and without affinity and real-time settings
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ *
+ * Measures, with ARSTREAM_Thread_MeasureSchedulingLatency, how late a thread wakes up for
+ * periodic deadlines, while busy threads (standing for the encoder) load the CPUs :
+ * - "default" : inherited settings, like threads created by the application,
+ * - "pinned" : the thread is bound to one CPU (-c),
+ * - "nice" : pinned, with a negative nice value (-N),
+ * - "fifo" : pinned, with a SCHED_FIFO priority (-f).
+ * The load threads run at the default priority. With -c, they are bound to the same CPU,
+ * which is the worst case for the measured thread.
+ * The nice and fifo settings need privileges (CAP_SYS_NICE, or root) : without them,
+ * their line reports the error.
+ *
+ * Usage : ARSTREAM_ThreadBench_LinuxTb [-p periodUs] [-n nbSamples] [-c cpu] [-N nice] [-f fifoPriority] [-l nbLoadThreads]
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/*
+ * System Headers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARStream/ARStream.h>
+
+/*
+ * Macros
+ */
+
+#define BENCH_PERIOD_US_DEFAULT (1000)
+#define BENCH_NB_SAMPLES_DEFAULT (5000)
+#define BENCH_NICE_DEFAULT (-10)
+#define BENCH_FIFO_PRIORITY_DEFAULT (50)
+
+/*
+ * Types
+ */
+
+typedef enum {
+    BENCH_CONFIG_DEFAULT = 0,
+    BENCH_CONFIG_PINNED,
+    BENCH_CONFIG_NICE,
+    BENCH_CONFIG_FIFO,
+    BENCH_CONFIG_MAX,
+} eBENCH_CONFIG;
+
+typedef struct {
+    pthread_t thread;
+    int cpu;
+} BENCH_LoadThread_t;
+
+/*
+ * Globals
+ */
+
+static const char *g_ConfigNames [BENCH_CONFIG_MAX] = {
+    "default",
+    "pinned",
+    "nice",
+    "fifo",
+};
+
+static volatile int g_LoadShouldStop = 0;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Busy loop, standing for a CPU bound encoder thread
+ * @param param The BENCH_LoadThread_t
+ */
+static void* ARSTREAM_ThreadBench_RunLoad (void *param);
+
+/*
+ * Internal functions implementation
+ */
+
+static void* ARSTREAM_ThreadBench_RunLoad (void *param)
+{
+    BENCH_LoadThread_t *load = (BENCH_LoadThread_t *)param;
+    volatile uint64_t counter = 0;
+
+    if (load->cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO (&cpus);
+        CPU_SET (load->cpu, &cpus);
+        pthread_setaffinity_np (pthread_self (), sizeof (cpus), &cpus);
+    }
+    while (g_LoadShouldStop == 0)
+    {
+        counter++;
+    }
+    return NULL;
+}
+
+/*
+ * Implementation
+ */
+
+int main (int argc, char *argv[])
+{
+    uint32_t periodUs = BENCH_PERIOD_US_DEFAULT;
+    uint32_t nbSamples = BENCH_NB_SAMPLES_DEFAULT;
+    int cpu = -1;
+    int niceValue = BENCH_NICE_DEFAULT;
+    int fifoPriority = BENCH_FIFO_PRIORITY_DEFAULT;
+    int nbLoadThreads = (int)sysconf (_SC_NPROCESSORS_ONLN);
+    BENCH_LoadThread_t *loads = NULL;
+    ARSTREAM_Histogram_t latencies;
+    int opt, i;
+
+    while ((opt = getopt (argc, argv, "p:n:c:N:f:l:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            periodUs = (uint32_t)strtoul (optarg, NULL, 10);
+            break;
+        case 'n':
+            nbSamples = (uint32_t)strtoul (optarg, NULL, 10);
+            break;
+        case 'c':
+            cpu = atoi (optarg);
+            break;
+        case 'N':
+            niceValue = atoi (optarg);
+            break;
+        case 'f':
+            fifoPriority = atoi (optarg);
+            break;
+        case 'l':
+            nbLoadThreads = atoi (optarg);
+            break;
+        default:
+            fprintf (stderr, "Usage : %s [-p periodUs] [-n nbSamples] [-c cpu] [-N nice] [-f fifoPriority] [-l nbLoadThreads]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cpu < 0)
+    {
+        /* Pin to the last CPU by default : the one least likely to be isolated for something else */
+        cpu = (int)sysconf (_SC_NPROCESSORS_ONLN) - 1;
+    }
+    if ((periodUs == 0) ||
+        (nbSamples == 0) ||
+        (cpu < 0) ||
+        (cpu >= 64) ||
+        (nbLoadThreads < 0))
+    {
+        fprintf (stderr, "Invalid parameters\n");
+        return 1;
+    }
+
+    if (nbLoadThreads > 0)
+    {
+        loads = calloc (nbLoadThreads, sizeof (BENCH_LoadThread_t));
+        if (loads == NULL)
+        {
+            return 1;
+        }
+    }
+    for (i = 0; i < nbLoadThreads; i++)
+    {
+        loads[i].cpu = cpu;
+        pthread_create (&(loads[i].thread), NULL, ARSTREAM_ThreadBench_RunLoad, &loads[i]);
+    }
+
+    printf ("# %u samples, period %u us, %d load threads on CPU %d\n", nbSamples, periodUs, nbLoadThreads, cpu);
+    printf ("%-8s %-12s %8s %8s %8s %8s %8s %8s\n", "config", "result", "min", "mean", "p50", "p99", "p99.9", "max");
+    for (i = 0; i < BENCH_CONFIG_MAX; i++)
+    {
+        ARSTREAM_Thread_Config_t config;
+        eARSTREAM_ERROR err;
+
+        memset (&config, 0, sizeof (config));
+        if (i != BENCH_CONFIG_DEFAULT)
+        {
+            config.cpuMask = 1ULL << cpu;
+        }
+        if (i == BENCH_CONFIG_NICE)
+        {
+            config.niceValue = niceValue;
+        }
+        if (i == BENCH_CONFIG_FIFO)
+        {
+            config.fifoPriority = fifoPriority;
+        }
+
+        err = ARSTREAM_Thread_MeasureSchedulingLatency (&config, periodUs, nbSamples, &latencies);
+        if (err != ARSTREAM_OK)
+        {
+            printf ("%-8s %-12s\n", g_ConfigNames[i], (err == ARSTREAM_ERROR_PERMISSION) ? "denied" : "error");
+            continue;
+        }
+        printf ("%-8s %-12s %8u %8u %8u %8u %8u %8u\n", g_ConfigNames[i], "ok",
+                latencies.min, ARSTREAM_Histogram_GetMean (&latencies),
+                ARSTREAM_Histogram_GetPercentile (&latencies, 50.f),
+                ARSTREAM_Histogram_GetPercentile (&latencies, 99.f),
+                ARSTREAM_Histogram_GetPercentile (&latencies, 99.9f),
+                latencies.max);
+    }
+    printf ("# latencies in us\n");
+
+    g_LoadShouldStop = 1;
+    for (i = 0; i < nbLoadThreads; i++)
+    {
+        pthread_join (loads[i].thread, NULL);
+    }
+    free (loads);
+    return 0;
+}
@@ -0,0 +1,288 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file ARSTREAM_UDPBench_LinuxTb.c
+ * @brief CPU cost of the raw UDP transport modes (per-fragment, sendmmsg/recvmmsg, GSO, GRO)
+ * @date 10/18/2026
+ * @author nicolas.brulez@parrot.com
+ *
+ * A sender and a reader stream the same frames over the loopback interface, once per
+ * transport mode. The process CPU time (both sides) is reported per Gbit of delivered frames.
+ *
+ * Usage : ARSTREAM_UDPBench_LinuxTb [nbFrames]
+ */
+
+/*
+ * System Headers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+/*
+ * ARSDK Headers
+ */
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARStream/ARSTREAM_Sender.h>
+#include <libARStream/ARSTREAM_Reader.h>
+#include <libARStream/ARSTREAM_Transport.h>
+
+/*
+ * Macros
+ */
+
+#define __TAG__ "UDP_BENCH"
+
+#define BENCH_FRAG_SIZE (1400)
+#define BENCH_NB_FRAG_PER_FRAME (64)
+#define BENCH_FRAME_SIZE (BENCH_FRAG_SIZE * BENCH_NB_FRAG_PER_FRAME)
+#define BENCH_NB_FRAMES_DEFAULT (5000)
+#define BENCH_NB_BUFFERS (4)
+#define BENCH_END_TIMEOUT_MS (5000)
+#define BENCH_BASE_PORT (45100)
+
+/*
+ * Types
+ */
+
+typedef struct {
+    const char *name;
+    uint32_t flags;
+} ARSTREAM_UDPBench_Mode_t;
+
+/*
+ * Globals
+ */
+
+static const ARSTREAM_UDPBench_Mode_t g_Modes [] = {
+    { "per-fragment", ARSTREAM_TRANSPORT_UDP_FLAG_NONE },
+    { "sendmmsg/recvmmsg", ARSTREAM_TRANSPORT_UDP_FLAG_BATCH },
+    { "GSO", ARSTREAM_TRANSPORT_UDP_FLAG_BATCH | ARSTREAM_TRANSPORT_UDP_FLAG_GSO },
+    { "GSO+GRO", ARSTREAM_TRANSPORT_UDP_FLAG_BATCH | ARSTREAM_TRANSPORT_UDP_FLAG_GSO | ARSTREAM_TRANSPORT_UDP_FLAG_GRO },
+};
+
+static uint8_t g_SenderFrame [BENCH_FRAME_SIZE];
+static uint8_t g_ReaderFrame [BENCH_FRAME_SIZE];
+static volatile int g_NbReceivedFrames = 0;
+static volatile int g_NbDoneFrames = 0;
+
+/*
+ * Internal functions declarations
+ */
+
+/**
+ * @brief Sender callback : counts the frames which are no longer used by the sender
+ */
+void ARSTREAM_UDPBench_SenderCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom);
+
+/**
+ * @brief Reader callback : counts the received frames, and always reuses the same buffer
+ */
+uint8_t* ARSTREAM_UDPBench_ReaderCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom);
+
+/**
+ * @brief Gets the user + system CPU time of the process, in seconds
+ */
+double ARSTREAM_UDPBench_GetCpuTime (void);
+
+/**
+ * @brief Gets the monotonic time, in seconds
+ */
+double ARSTREAM_UDPBench_GetWallTime (void);
+
+/**
+ * @brief Streams nbFrames frames with the given transport mode, and prints the results
+ * @return 0 if the run succeeded
+ */
+int ARSTREAM_UDPBench_Run (const ARSTREAM_UDPBench_Mode_t *mode, int port, int nbFrames);
+
+/*
+ * Internal functions implementation
+ */
+
+void ARSTREAM_UDPBench_SenderCallback (eARSTREAM_SENDER_STATUS status, uint8_t *framePointer, uint32_t frameSize, void *custom)
+{
+    (void)framePointer;
+    (void)frameSize;
+    (void)custom;
+    if ((status == ARSTREAM_SENDER_STATUS_FRAME_SENT) ||
+        (status == ARSTREAM_SENDER_STATUS_FRAME_CANCEL))
+    {
+        __sync_fetch_and_add (&g_NbDoneFrames, 1);
+    }
+}
+
+uint8_t* ARSTREAM_UDPBench_ReaderCallback (eARSTREAM_READER_CAUSE cause, uint8_t *framePointer, uint32_t frameSize, int numberOfSkippedFrames, int isFlushFrame, uint32_t *newBufferCapacity, void *custom)
+{
+    (void)framePointer;
+    (void)frameSize;
+    (void)numberOfSkippedFrames;
+    (void)isFlushFrame;
+    (void)custom;
+    if (cause == ARSTREAM_READER_CAUSE_FRAME_COMPLETE)
+    {
+        g_NbReceivedFrames++;
+    }
+    *newBufferCapacity = BENCH_FRAME_SIZE;
+    return g_ReaderFrame;
+}
+
+double ARSTREAM_UDPBench_GetCpuTime (void)
+{
+    struct rusage usage;
+    getrusage (RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+double ARSTREAM_UDPBench_GetWallTime (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+int ARSTREAM_UDPBench_Run (const ARSTREAM_UDPBench_Mode_t *mode, int port, int nbFrames)
+{
+    ARSTREAM_Transport_t *senderTransport = NULL;
+    ARSTREAM_Transport_t *readerTransport = NULL;
+    ARSTREAM_Sender_t *sender = NULL;
+    ARSTREAM_Reader_t *reader = NULL;
+    pthread_t senderData, senderAck, readerData, readerAck;
+    eARSTREAM_ERROR err = ARSTREAM_OK;
+    double startCpu, startWall, cpu, wall, gbits;
+    int waitedMs = 0;
+    int i;
+
+    g_NbReceivedFrames = 0;
+    g_NbDoneFrames = 0;
+
+    readerTransport = ARSTREAM_Transport_NewUDP ("127.0.0.1", port + 1, port, BENCH_FRAG_SIZE, mode->flags, &err);
+    if (readerTransport != NULL)
+    {
+        senderTransport = ARSTREAM_Transport_NewUDP ("127.0.0.1", port, port + 1, BENCH_FRAG_SIZE, mode->flags, &err);
+    }
+    if (senderTransport != NULL)
+    {
+        reader = ARSTREAM_Reader_NewWithTransport (readerTransport, ARSTREAM_UDPBench_ReaderCallback, g_ReaderFrame, BENCH_FRAME_SIZE, BENCH_FRAG_SIZE, ARSTREAM_READER_MAX_ACK_INTERVAL_DEFAULT, NULL, &err);
+    }
+    if (reader != NULL)
+    {
+        sender = ARSTREAM_Sender_NewWithTransport (senderTransport, ARSTREAM_UDPBench_SenderCallback, BENCH_NB_BUFFERS, BENCH_FRAG_SIZE, BENCH_NB_FRAG_PER_FRAME, NULL, &err);
+    }
+    if (sender == NULL)
+    {
+        ARSAL_PRINT (ARSAL_PRINT_ERROR, __TAG__, "Unable to create the %s stream : %s", mode->name, ARSTREAM_Error_ToString (err));
+        ARSTREAM_Reader_Delete (&reader);
+        ARSTREAM_Transport_Delete (&senderTransport);
+        ARSTREAM_Transport_Delete (&readerTransport);
+        return 1;
+    }
+
+    pthread_create (&readerData, NULL, ARSTREAM_Reader_RunDataThread, reader);
+    pthread_create (&readerAck, NULL, ARSTREAM_Reader_RunAckThread, reader);
+    pthread_create (&senderData, NULL, ARSTREAM_Sender_RunDataThread, sender);
+    pthread_create (&senderAck, NULL, ARSTREAM_Sender_RunAckThread, sender);
+
+    startCpu = ARSTREAM_UDPBench_GetCpuTime ();
+    startWall = ARSTREAM_UDPBench_GetWallTime ();
+
+    for (i = 0; i < nbFrames; i++)
+    {
+        while (ARSTREAM_Sender_SendNewFrame (sender, g_SenderFrame, BENCH_FRAME_SIZE, 0, NULL) == ARSTREAM_ERROR_QUEUE_FULL)
+        {
+            usleep (100);
+        }
+    }
+    while ((g_NbDoneFrames < nbFrames) &&
+           (waitedMs < BENCH_END_TIMEOUT_MS))
+    {
+        usleep (1000);
+        waitedMs++;
+    }
+
+    cpu = ARSTREAM_UDPBench_GetCpuTime () - startCpu;
+    wall = ARSTREAM_UDPBench_GetWallTime () - startWall;
+
+    ARSTREAM_Sender_StopSender (sender);
+    ARSTREAM_Reader_StopReader (reader);
+    pthread_join (senderData, NULL);
+    pthread_join (senderAck, NULL);
+    pthread_join (readerData, NULL);
+    pthread_join (readerAck, NULL);
+    ARSTREAM_Sender_Delete (&sender);
+    ARSTREAM_Reader_Delete (&reader);
+    ARSTREAM_Transport_Delete (&senderTransport);
+    ARSTREAM_Transport_Delete (&readerTransport);
+
+    gbits = (double)g_NbReceivedFrames * BENCH_FRAME_SIZE * 8. / 1000000000.;
+    printf ("%-18s; %6d; %8.1f; %6.1f; %8.3f\n", mode->name, g_NbReceivedFrames, gbits * 1000. / wall, 100. * cpu / wall, (gbits > 0.) ? cpu / gbits : 0.);
+    return 0;
+}
+
+/*
+ * Implementation
+ */
+
+int main (int argc, char *argv[])
+{
+    int nbFrames = BENCH_NB_FRAMES_DEFAULT;
+    int retVal = 0;
+    unsigned int i;
+
+    if (argc > 1)
+    {
+        nbFrames = atoi (argv[1]);
+    }
+    if (nbFrames <= 0)
+    {
+        printf ("Usage : %s [nbFrames]\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < BENCH_FRAME_SIZE; i++)
+    {
+        g_SenderFrame [i] = (uint8_t)i;
+    }
+
+    printf ("Mode; Received frames; Throughput (Mbit/s); CPU (%%); CPU seconds per Gbit\n");
+    for (i = 0; i < sizeof (g_Modes) / sizeof (g_Modes [0]); i++)
+    {
+        retVal |= ARSTREAM_UDPBench_Run (&g_Modes [i], BENCH_BASE_PORT + 2 * i, nbFrames);
+    }
+    return retVal;
+}